@@ -2,9 +2,12 @@
 #define PACK_CELL
 
 #include "containers/bounded_object.hpp"
+#include "containers/rectanglepacker.hpp"
+#include <glm/glm.hpp>
 #include <vector>
 #include <algorithm>
 #include <optional>
+#include <utility>
 
 namespace BlueBear::Containers {
 
@@ -22,100 +25,37 @@ namespace BlueBear::Containers {
 		std::vector< PackedCell< T > > cells;
 		int totalWidth;
 		int totalHeight;
+		// Fraction of totalWidth x totalHeight covered by cells
+		double occupancy;
 	};
 
 	template< typename T >
-	PackedCellMap< T > packCells( std::vector< BoundedObject< T > > items, int defaultWidth, int defaultHeight ) {
-		int totalWidth = defaultWidth;
-		int totalHeight = defaultHeight;
+	PackedCellMap< T > packCells( std::vector< BoundedObject< T > > items, int defaultWidth, int defaultHeight, RectanglePacker::Heuristic heuristic = RectanglePacker::Heuristic::BEST_SHORT_SIDE_FIT ) {
+		RectanglePacker packer( defaultWidth, defaultHeight, heuristic );
 		std::vector< PackedCell< T > > packed;
-		std::vector< PackedCell< T > > unpacked{ PackedCell< T >{ 0, 0, defaultWidth, defaultHeight, {} } };
+		double usedArea = 0.0;
 
-		// Sort items by max( width, height )
+		// Largest first, so that small items fill the gaps left around the big ones
 		std::sort( items.begin(), items.end(), []( const BoundedObject< T >& boundedObject1, const BoundedObject< T >& boundedObject2 ) {
-			return std::max( boundedObject1.width, boundedObject1.height ) < std::max( boundedObject2.width, boundedObject2.height );
+			return std::make_pair( std::max( boundedObject1.width, boundedObject1.height ), boundedObject1.width * boundedObject1.height ) >
+				std::make_pair( std::max( boundedObject2.width, boundedObject2.height ), boundedObject2.width * boundedObject2.height );
 		} );
 
 		for( const auto& boundedObject : items ) {
-			// Get first fit, if it exists
-			auto nextFreeBox = unpacked.end();
-			for( auto it = unpacked.begin(); it != unpacked.end(); ++it ) {
-				if( boundedObject.width <= it->width && boundedObject.height <= it->height ) {
-					nextFreeBox = it;
-					break;
-				}
+			std::optional< RectanglePacker::Rectangle > rectangle;
+			while( !( rectangle = packer.insert( boundedObject.width, boundedObject.height ) ) ) {
+				packer.grow( boundedObject.width, boundedObject.height );
 			}
 
-			if( nextFreeBox != unpacked.end() ) {
-				// Use box that first fits
-				// Data is placed in top left of next free box
-				PackedCell< T > newCell {
-					nextFreeBox->x,
-					nextFreeBox->y,
-					boundedObject.width,
-					boundedObject.height,
-					boundedObject.object
-				};
-
-				// New empty box is created to the left
-				PackedCell< T > rightEmpty{
-					nextFreeBox->x + boundedObject.width,
-					nextFreeBox->y,
-					nextFreeBox->width - boundedObject.width,
-					boundedObject.height,
-					{}
-				};
-
-				// New empty box is created to the bottom
-				PackedCell< T > bottomEmpty{
-					nextFreeBox->x,
-					nextFreeBox->y + boundedObject.height,
-					nextFreeBox->width,
-					nextFreeBox->height - boundedObject.height,
-					{}
-				};
-
-				unpacked.erase( nextFreeBox );
-
-				// Do not place either new box if width/height is entirely used up
-				if( rightEmpty.width > 0 && rightEmpty.height > 0 ) { unpacked.emplace_back( std::move( rightEmpty ) ); }
-				if( bottomEmpty.width > 0 && bottomEmpty.height > 0 ) { unpacked.emplace_back( std::move( bottomEmpty ) ); }
-
-				packed.emplace_back( std::move( newCell ) );
-			} else {
-				// Must add new cell to right of previous region
-				PackedCell< T > newCell{ totalWidth, 0, boundedObject.width, boundedObject.height, boundedObject.object };
-
-				int difference = boundedObject.height - totalHeight;
-				if( difference > 0 ) {
-					// Need to add new region to the left instead of underneath
-					PackedCell< T > leftEmpty { 0, totalHeight, totalWidth, difference, {} };
-
-					totalWidth += boundedObject.width;
-					totalHeight += difference;
-
-					unpacked.emplace_back( std::move( leftEmpty ) );
-				} else {
-					// Empty box below us needs to match totalHeight
-					// New cell goes underneath
-					PackedCell< T > bottomEmpty{
-						totalWidth,
-						boundedObject.height,
-						boundedObject.width,
-						totalHeight - boundedObject.height,
-						{}
-					};
-
-					totalWidth += boundedObject.width;
-
-					unpacked.emplace_back( std::move( bottomEmpty ) );
-				}
-
-				packed.emplace_back( std::move( newCell ) );
-			}
+			usedArea += ( double ) rectangle->width * rectangle->height;
+			packed.emplace_back( PackedCell< T >{ rectangle->x, rectangle->y, rectangle->width, rectangle->height, boundedObject.object } );
 		}
 
-		return { packed, totalWidth, totalHeight };
+		glm::ivec2 extent = packer.getUsedExtent();
+		int totalWidth = std::max( defaultWidth, extent.x );
+		int totalHeight = std::max( defaultHeight, extent.y );
+
+		return { packed, totalWidth, totalHeight, totalWidth && totalHeight ? usedArea / ( ( double ) totalWidth * totalHeight ) : 0.0 };
 	};
 
 }
@@ -0,0 +1,63 @@
+#ifndef RECTANGLE_PACKER
+#define RECTANGLE_PACKER
+
+#include <glm/glm.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace BlueBear::Containers {
+
+	/**
+	 * MaxRects bin packer. The free area is kept as a list of maximal (possibly overlapping) rectangles,
+	 * and every placement splits the free rectangles it touches. Rectangles can be inserted and removed
+	 * one at a time, and the bin can grow without moving anything already placed.
+	 */
+	class RectanglePacker {
+	public:
+		enum class Heuristic { BEST_SHORT_SIDE_FIT, BEST_LONG_SIDE_FIT, BEST_AREA_FIT, BOTTOM_LEFT };
+
+		struct Rectangle {
+			int x = 0;
+			int y = 0;
+			int width = 0;
+			int height = 0;
+
+			bool operator==( const Rectangle& rhs ) const;
+			bool contains( const Rectangle& rhs ) const;
+			bool overlaps( const Rectangle& rhs ) const;
+		};
+
+	private:
+		int width;
+		int height;
+		Heuristic heuristic;
+		long usedArea = 0;
+		std::vector< Rectangle > freeRectangles;
+		std::vector< Rectangle > usedRectangles;
+
+		glm::ivec2 score( const Rectangle& freeRectangle, int width, int height ) const;
+		void splitFreeRectangles( const Rectangle& used );
+		void pruneFreeRectangles();
+		void rebuildFreeRectangles();
+		void releaseFreeRectangle( const Rectangle& released );
+
+	public:
+		RectanglePacker( int width, int height, Heuristic heuristic = Heuristic::BEST_SHORT_SIDE_FIT );
+
+		static Heuristic getHeuristic( const std::string& name );
+
+		std::optional< Rectangle > insert( int width, int height );
+		bool remove( const Rectangle& rectangle );
+		void grow( int width, int height );
+
+		int getWidth() const;
+		int getHeight() const;
+		glm::ivec2 getUsedExtent() const;
+		double getOccupancy() const;
+		const std::vector< Rectangle >& getUsedRectangles() const;
+	};
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef TIMER_WHEEL
+#define TIMER_WHEEL
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BlueBear::Containers {
+
+  /**
+   * Hierarchical timing wheel: four levels of 256 buckets, each level counting ticks 256 times coarser than the last.
+   * A timer goes into the finest level whose span covers its delay and moves down a level each time its coarse bucket
+   * comes round, so schedule and cancel are O(1) and a tick touches only the timers expiring or cascading on it.
+   */
+  template< typename T > class TimerWheel {
+    static constexpr unsigned int LEVEL_BITS = 8;
+    static constexpr unsigned int LEVEL_SIZE = 1 << LEVEL_BITS;
+    static constexpr unsigned int LEVELS = 4;
+    static constexpr uint64_t MAX_DELAY = ( uint64_t( 1 ) << ( LEVEL_BITS * LEVELS ) ) - 1;
+    static constexpr uint32_t NONE = std::numeric_limits< uint32_t >::max();
+    // Bucket index of the list being fired
+    static constexpr uint32_t FIRING = LEVELS * LEVEL_SIZE;
+
+    struct Node {
+      int id;
+      uint64_t expiry;
+      uint32_t bucket;
+      uint32_t previous;
+      uint32_t next;
+      std::optional< T > value;
+    };
+
+    // Intrusive lists threaded through nodes; freed nodes are chained through next
+    std::vector< Node > nodes;
+    std::array< uint32_t, LEVELS * LEVEL_SIZE + 1 > heads;
+    uint32_t freeList = NONE;
+    std::unordered_map< int, uint32_t > slots;
+    int nextId = 0;
+    // Last tick processed
+    uint64_t current = 0;
+
+    void link( uint32_t index, uint32_t bucket ) {
+      Node& node = nodes[ index ];
+      node.bucket = bucket;
+      node.previous = NONE;
+      node.next = heads[ bucket ];
+      if( node.next != NONE ) {
+        nodes[ node.next ].previous = index;
+      }
+      heads[ bucket ] = index;
+    };
+
+    void unlink( uint32_t index ) {
+      Node& node = nodes[ index ];
+      if( node.previous != NONE ) {
+        nodes[ node.previous ].next = node.next;
+      } else {
+        heads[ node.bucket ] = node.next;
+      }
+
+      if( node.next != NONE ) {
+        nodes[ node.next ].previous = node.previous;
+      }
+    };
+
+    void place( uint32_t index ) {
+      uint64_t expiry = nodes[ index ].expiry;
+      uint64_t delta = expiry - current;
+
+      unsigned int level = 0;
+      while( level != LEVELS - 1 && delta >= ( uint64_t( 1 ) << ( LEVEL_BITS * ( level + 1 ) ) ) ) {
+        level++;
+      }
+
+      link( index, level * LEVEL_SIZE + ( ( expiry >> ( LEVEL_BITS * level ) ) & ( LEVEL_SIZE - 1 ) ) );
+    };
+
+    void release( uint32_t index ) {
+      Node& node = nodes[ index ];
+      slots.erase( node.id );
+      node.value.reset();
+      node.next = freeList;
+      freeList = index;
+    };
+
+    // Redistribute a coarse bucket now that its span has come round; everything in it lands on a finer level
+    void cascade( unsigned int level ) {
+      uint32_t bucket = level * LEVEL_SIZE + ( ( current >> ( LEVEL_BITS * level ) ) & ( LEVEL_SIZE - 1 ) );
+      uint32_t index = heads[ bucket ];
+      heads[ bucket ] = NONE;
+
+      while( index != NONE ) {
+        uint32_t next = nodes[ index ].next;
+        place( index );
+        index = next;
+      }
+    };
+
+  public:
+    TimerWheel() {
+      heads.fill( NONE );
+    };
+
+    /**
+     * Schedule value to come back from the advance() that is delay ticks after the next one. Returns an id for cancel().
+     */
+    int schedule( uint64_t delay, T value ) {
+      uint32_t index;
+      if( freeList != NONE ) {
+        index = freeList;
+        freeList = nodes[ index ].next;
+      } else {
+        index = nodes.size();
+        nodes.emplace_back();
+      }
+
+      int id = nextId;
+      nextId = nextId == std::numeric_limits< int >::max() ? 0 : nextId + 1;
+
+      Node& node = nodes[ index ];
+      node.id = id;
+      node.expiry = current + 1 + std::min( delay, MAX_DELAY - 1 );
+      node.value.emplace( std::move( value ) );
+      slots[ id ] = index;
+      place( index );
+
+      return id;
+    };
+
+    /**
+     * Safe from inside an advance() callback, including for timers due on the same tick. Returns false if the id
+     * already fired or was cancelled.
+     */
+    bool cancel( int id ) {
+      auto it = slots.find( id );
+      if( it == slots.end() ) {
+        return false;
+      }
+
+      uint32_t index = it->second;
+      unlink( index );
+      release( index );
+      return true;
+    };
+
+    /**
+     * Move on one tick and pass every timer due on it to fire, which may schedule or cancel freely.
+     */
+    template< typename Function > void advance( Function fire ) {
+      current++;
+
+      for( unsigned int level = 1; level != LEVELS && ( current & ( ( uint64_t( 1 ) << ( LEVEL_BITS * level ) ) - 1 ) ) == 0; level++ ) {
+        cascade( level );
+      }
+
+      uint32_t bucket = current & ( LEVEL_SIZE - 1 );
+      heads[ FIRING ] = heads[ bucket ];
+      heads[ bucket ] = NONE;
+      for( uint32_t index = heads[ FIRING ]; index != NONE; index = nodes[ index ].next ) {
+        nodes[ index ].bucket = FIRING;
+      }
+
+      while( heads[ FIRING ] != NONE ) {
+        uint32_t index = heads[ FIRING ];
+        unlink( index );
+
+        T value = std::move( *nodes[ index ].value );
+        release( index );
+        fire( value );
+      }
+    };
+
+    size_t size() const {
+      return slots.size();
+    };
+  };
+
+}
+
+#endif
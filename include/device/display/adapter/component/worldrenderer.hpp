@@ -10,10 +10,13 @@
 #include "graphics/camera.hpp"
 #include "graphics/uniform_cache.hpp"
 #include "graphics/scenegraph/resourcebank.hpp"
+#include "graphics/scenegraph/modelpicker.hpp"
+#include "graphics/scenegraph/modelloader/loadscheduler.hpp"
+#include "graphics/scenegraph/renderqueue.hpp"
 #include "graphics/utilities/shader_manager.hpp"
 #include "graphics/utilities/mouse_navigator.hpp"
+#include "graphics/utilities/texture_streamer.hpp"
 #include "exceptions/genexc.hpp"
-#include "tools/async_table.hpp"
 #include "eventmanager.hpp"
 #include "serializable.hpp"
 #include <glm/glm.hpp>
@@ -58,11 +61,6 @@ namespace BlueBear {
             BasicEvent< void*, std::shared_ptr< Graphics::SceneGraph::Model > > MODEL_REMOVED;
 
           private:
-            struct ModelPushdown {
-              const std::map< std::string, glm::mat4 >* bones = nullptr;
-              glm::mat4 levelTransform;
-            };
-
             struct ModelRegistration {
               const std::string originalId;
               const std::set< std::string > instanceClasses;
@@ -76,29 +74,21 @@ namespace BlueBear {
 
             Graphics::Camera camera;
             Graphics::Utilities::ShaderManager& shaderManager;
+            Graphics::Utilities::TextureStreamer textureStreamer;
             Graphics::SceneGraph::ResourceBank cache;
             const ModelRegistration* previousMove = nullptr;
             std::unordered_map< std::string, std::shared_ptr< Graphics::SceneGraph::Model > > originals;
             std::vector< std::unique_ptr< ModelRegistration > > models;
-            Tools::AsyncTable asyncTasks;
-
-            struct ModelUniforms {
-              Graphics::Shader::Uniform transformUniform;
-
-              ModelUniforms() = default;
-              ModelUniforms( const Graphics::Shader& shader ) : transformUniform( shader.getUniform( "model" ) ) {}
-            };
-            Graphics::UniformCache< ModelUniforms > modelUniforms;
+            Graphics::SceneGraph::ModelPicker picker;
+            Graphics::SceneGraph::RenderQueue renderQueue;
+            std::unique_ptr< Graphics::SceneGraph::ModelLoader::LoadScheduler > loadScheduler;
+            unsigned int uploadsPerFrame;
 
             std::optional< Graphics::Utilities::MouseNavigator > mouseNavigator;
 
             std::unique_ptr< Graphics::SceneGraph::ModelLoader::FileModelLoader > getFileModelLoader( bool deferGLOperations );
 
-            void getModelAtMouse(
-              const Geometry::Ray& ray,
-              const std::vector< const ModelRegistration* >& candidateModels,
-              const std::function< void( const ModelRegistration* ) >& callback
-            );
+            const ModelRegistration* getModelAtMouse( const Geometry::Ray& ray );
 
             void fireInOutEvents( const ModelRegistration* selected, const Device::Input::Metadata& event );
 
@@ -106,8 +96,6 @@ namespace BlueBear {
             void onMouseUp( Device::Input::Metadata metadata );
             void onMouseMoved( Device::Input::Metadata metadata );
 
-            std::vector< const ModelRegistration* > getModels();
-
           public:
             EXCEPTION_TYPE( ObjectIDNotRegisteredException, "Object ID not registered!" );
             WorldRenderer( Display& display, Graphics::Utilities::ShaderManager& shaderManager );
@@ -137,10 +125,13 @@ namespace BlueBear {
             );
 
             Graphics::Camera& getCamera();
+            const Graphics::SceneGraph::RenderQueue::Statistics& getRenderStatistics() const;
+            Graphics::SceneGraph::ModelLoader::LoadScheduler::Progress getLoadingProgress() const;
+            Graphics::Utilities::TextureStreamer::Statistics getTextureStatistics() const;
+            void loadPathsAsync( const std::vector< std::pair< std::string, std::string > >& paths );
             void loadPathsParallel( const std::vector< std::pair< std::string, std::string > >& paths );
             void loadPaths( const std::vector< std::pair< std::string, std::string > >& paths );
             void loadDirect( const std::string& id, const std::shared_ptr< Graphics::SceneGraph::Model >& model );
-            void drawTree( const Graphics::SceneGraph::Model* model, ModelPushdown pushdown );
             void nextFrame() override;
           };
 
@@ -10,17 +10,19 @@
 #include "models/infrastructure.hpp"
 #include "models/wallsegment.hpp"
 #include "models/room.hpp"
+#include "gameplay/wallpanelindex.hpp"
 #include "tools/intersection_map.hpp"
 #include "tools/sector_discovery.hpp"
 #include <jsoncpp/json/json.h>
 #include <glm/glm.hpp>
-#include <unordered_map>
+#include <map>
 #include <optional>
 #include <memory>
 #include <vector>
 
 namespace BlueBear::State { class HouseholdGameplayState; }
 namespace BlueBear::Graphics::Utilities{ class ShaderManager; }
+namespace BlueBear::Graphics::SceneGraph::ModelLoader{ class WallModelLoader; }
 namespace BlueBear::Gameplay {
 
 	class InfrastructureManager : public State::Substate, public Serializable {
@@ -45,15 +47,19 @@ namespace BlueBear::Gameplay {
 
 		std::shared_ptr< Graphics::SceneGraph::Model > floorModel;
 		std::shared_ptr< Graphics::SceneGraph::Model > wallModel;
+		std::unique_ptr< Graphics::SceneGraph::ModelLoader::WallModelLoader > wallModelLoader;
 
 		std::vector< std::vector< Models::Room > > rooms;
+		std::vector< WallPanelIndex > wallPanels;
 
-		std::unordered_map< Graphics::SceneGraph::Model*, Animation > activeWallAnims;
+		std::map< WallPanel, Animation > activeWallAnims;
 
 		void generateWallRig();
 		void generateFloorRig();
 
-		void enqueueAnimation( Graphics::SceneGraph::Model* key, const Animation&& animation );
+		void indexWallPanels();
+
+		void enqueueAnimation( const WallPanel& key, const Animation&& animation );
 		void updateAnimations();
 
 		void updateWallMode();
@@ -75,6 +81,7 @@ namespace BlueBear::Gameplay {
 		void load( const Json::Value& data ) override;
 
 		void generateRooms();
+		void updateWallRig();
 
 		int getCurrentLevel() const;
 		void setCurrentLevel( int currentLevel );
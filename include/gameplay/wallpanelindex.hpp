@@ -0,0 +1,54 @@
+#ifndef GAMEPLAY_WALL_PANEL_INDEX
+#define GAMEPLAY_WALL_PANEL_INDEX
+
+#include "models/room.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph { class Model; }
+namespace BlueBear::Gameplay {
+
+	struct WallPanel {
+		Graphics::SceneGraph::Model* model;
+		// Index into the "pieces" uniform of a merged chunk, or -1 for a standalone piece model
+		int piece;
+
+		float getOffset() const;
+		void setOffset( float offset ) const;
+
+		bool operator==( const WallPanel& rhs ) const;
+		bool operator<( const WallPanel& rhs ) const;
+	};
+
+	/**
+	 * Uniform grid over the wall panels of one level. Each cell holds one slot per piece orientation,
+	 * so finding the panel under a wall step is a single lookup instead of a scan over every panel.
+	 */
+	class WallPanelIndex {
+		glm::ivec2 dimensions{ 0, 0 };
+		std::vector< WallPanel > panels;
+		// Index into panels for each cell and orientation, or -1
+		std::vector< std::array< int, 4 > > cells;
+
+		static int getOrientation( const std::string& id );
+		static int getOrientation( const glm::vec2& direction );
+
+		std::optional< glm::ivec2 > locationToCell( const glm::vec2& location ) const;
+		void insert( const WallPanel& panel, const std::string& id, const glm::vec2& location );
+
+	public:
+		WallPanelIndex() = default;
+		WallPanelIndex( const Graphics::SceneGraph::Model& level, const glm::ivec2& dimensions );
+
+		const std::vector< WallPanel >& getPanels() const;
+		std::optional< WallPanel > find( const glm::vec2& direction, const glm::vec2& location ) const;
+		std::set< WallPanel > getCutaways( std::vector< Models::Room >& rooms, float cameraRotation ) const;
+	};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef CONCORDIA_GEOMETRY_BVH
+#define CONCORDIA_GEOMETRY_BVH
+
+#include "geometry/aabb.hpp"
+#include "geometry/ray.hpp"
+#include <glm/glm.hpp>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace BlueBear::Geometry {
+
+	/**
+	 * Flat bounding volume hierarchy over a set of primitive AABBs. The hierarchy stores only
+	 * primitive indices; the caller supplies the exact primitive test during traversal.
+	 */
+	class BVH {
+		static constexpr unsigned int MAX_LEAF_SIZE = 4;
+
+		struct Node {
+			AABB bounds;
+			// Leaf: first index into primitives. Interior: index of right child (left child is always node + 1).
+			unsigned int offset = 0;
+			// Leaf: number of primitives. Interior: 0.
+			unsigned int count = 0;
+		};
+
+		std::vector< Node > nodes;
+		std::vector< unsigned int > primitives;
+
+		unsigned int buildRecursive( const std::vector< AABB >& boxes, std::vector< glm::vec3 >& centroids, unsigned int begin, unsigned int end );
+
+	public:
+		struct Hit {
+			unsigned int primitive;
+			float distance;
+		};
+
+		static std::optional< std::pair< float, float > > getSlabInterval( const Ray& ray, const glm::vec3& inverseDirection, const AABB& box );
+		static AABB merge( const AABB& lhs, const AABB& rhs );
+
+		void build( const std::vector< AABB >& boxes );
+		void refit( const std::vector< AABB >& boxes );
+		void clear();
+
+		bool empty() const;
+		size_t size() const;
+		const AABB& getBounds() const;
+
+		/**
+		 * Nearest-hit traversal. Visits nodes front to back and skips any node whose entry distance is beyond
+		 * the nearest hit found so far. test( primitive ) must return the parametric ray distance of a hit, or nothing.
+		 */
+		template< typename Test >
+		std::optional< Hit > raycast( const Ray& ray, Test test ) const {
+			std::optional< Hit > result;
+			if( nodes.empty() ) {
+				return result;
+			}
+
+			const glm::vec3 inverseDirection = 1.0f / ray.direction;
+			float nearest = std::numeric_limits< float >::max();
+
+			if( !getSlabInterval( ray, inverseDirection, nodes[ 0 ].bounds ) ) {
+				return result;
+			}
+
+			unsigned int stack[ 64 ];
+			unsigned int stackSize = 0;
+			stack[ stackSize++ ] = 0;
+
+			while( stackSize ) {
+				const Node& node = nodes[ stack[ --stackSize ] ];
+
+				if( node.count ) {
+					for( unsigned int i = node.offset; i != node.offset + node.count; i++ ) {
+						if( std::optional< float > distance = test( primitives[ i ] ) ) {
+							if( *distance >= 0.0f && *distance < nearest ) {
+								nearest = *distance;
+								result = Hit{ primitives[ i ], *distance };
+							}
+						}
+					}
+
+					continue;
+				}
+
+				unsigned int nodeIndex = &node - nodes.data();
+				unsigned int near = nodeIndex + 1;
+				unsigned int far = node.offset;
+				auto nearInterval = getSlabInterval( ray, inverseDirection, nodes[ near ].bounds );
+				auto farInterval = getSlabInterval( ray, inverseDirection, nodes[ far ].bounds );
+
+				if( nearInterval && farInterval && farInterval->first < nearInterval->first ) {
+					std::swap( near, far );
+					std::swap( nearInterval, farInterval );
+				}
+
+				// Push far first so that near is visited first
+				if( farInterval && farInterval->first <= nearest ) {
+					stack[ stackSize++ ] = far;
+				}
+
+				if( nearInterval && nearInterval->first <= nearest ) {
+					stack[ stackSize++ ] = near;
+				}
+			}
+
+			return result;
+		}
+	};
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 
 namespace BlueBear::Geometry {
 
+	std::optional< float > getIntersectionDistance( const Ray& ray, const Triangle& triangle );
 	std::optional< glm::vec3 > getIntersectionPoint( const Ray& ray, const Triangle& triangle );
 	std::optional< glm::vec3 > getIntersectionPoint( const Ray& ray, const AABB& aabb );
 
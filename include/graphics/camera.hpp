@@ -61,6 +61,7 @@ namespace BlueBear {
         void position();
         glm::mat4 getOrthoView();
         glm::mat4 getOrthoMatrix();
+        glm::mat4 getViewProjection() const;
         glm::vec2 getScaledCoordinates() const;
         unsigned int rotateRight();
         unsigned int rotateLeft();
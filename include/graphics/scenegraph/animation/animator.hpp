@@ -3,10 +3,13 @@
 
 #include "graphics/scenegraph/animation/animation.hpp"
 #include "graphics/scenegraph/animation/bone.hpp"
+#include "graphics/scenegraph/animation/skeleton.hpp"
+#include <glm/glm.hpp>
 #include <memory>
 #include <string>
 #include <optional>
 #include <map>
+#include <vector>
 
 namespace BlueBear {
   namespace Graphics {
@@ -16,18 +19,25 @@ namespace BlueBear {
         // This will sit on the root node of the model to be animated
         // So be careful when pulling apart animated models
         class Animator {
-          Bone bindSkeleton;
-          Bone currentSkeleton;
+          std::shared_ptr< const Skeleton > skeleton;
 
           std::optional< Animation > animation;
           std::map< std::string, Animation > animationList;
 
-          std::map< std::string, glm::mat4 > computedMatrices;
+          // Per-joint channel for the current animation; nullptr holds the joint at its bind pose
+          std::vector< const Channel* > channels;
+          // Per-joint keyframe cursor, so that sequential playback never searches the channel
+          std::vector< unsigned int > cursors;
+          std::vector< glm::mat4 > localMatrices;
+          std::vector< glm::mat4 > globalMatrices;
+          std::vector< glm::mat4 > computedMatrices;
 
           double frame = 0.0f;
           bool paused = false;
 
           double getFPS();
+          void samplePose();
+          void resetPose();
           void computeMatrices();
 
         public:
@@ -35,14 +45,12 @@ namespace BlueBear {
           Animator( const Animator& animator );
           Animator(
             const Bone& bindSkeleton,
-            const Bone& currentSkeleton,
             const std::map< std::string, Animation >& animationList
           );
 
-          const std::map< std::string, glm::mat4 >& getComputedMatrices();
-
-          Bone& getBindSkeletonRef();
-          Bone& getCurrentSkeletonRef();
+          // Indexed by Skeleton joint index
+          const std::vector< glm::mat4 >& getComputedMatrices() const;
+          const std::shared_ptr< const Skeleton >& getSkeleton() const;
 
           bool updating() const;
 
@@ -1,6 +1,7 @@
 #ifndef SG_BONE
 #define SG_BONE
 
+#include "graphics/scenegraph/animation/channel.hpp"
 #include "exceptions/genexc.hpp"
 #include <glm/glm.hpp>
 #include <vector>
@@ -15,7 +16,7 @@ namespace BlueBear {
 
         class Bone {
         public:
-          using AnimationMap = std::map< std::string, std::map< double, glm::mat4 > >;
+          using AnimationMap = std::map< std::string, Channel >;
 
         private:
           Bone* parent = nullptr;
@@ -36,6 +37,9 @@ namespace BlueBear {
           Bone( const Bone& other );
           Bone& operator=( const Bone& other );
 
+          const std::string& getId() const;
+          const std::vector< Bone >& getChildren() const;
+          std::shared_ptr< AnimationMap > getAnimations() const;
           std::vector< std::string > getAllIds() const;
           Bone getAnimationCopy( const std::string& animationId, double animationTick ) const;
           void addChild( const Bone& bone );
@@ -0,0 +1,48 @@
+#ifndef SG_ANIMATION_CHANNEL
+#define SG_ANIMATION_CHANNEL
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+namespace BlueBear {
+  namespace Graphics {
+    namespace SceneGraph {
+      namespace Animation {
+
+        /**
+         * Keyframes for one bone in one animation, stored as parallel translation/rotation/scale arrays
+         * on a shared, strictly increasing timeline. Sampling interpolates the components directly, so no
+         * matrix is ever decomposed during playback.
+         */
+        class Channel {
+          std::vector< double > times;
+          std::vector< glm::vec3 > translations;
+          std::vector< glm::quat > rotations;
+          std::vector< glm::vec3 > scales;
+
+          unsigned int seek( double tick, unsigned int cursor ) const;
+
+        public:
+          void addKeyframe( double time, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale );
+
+          bool empty() const;
+          size_t size() const;
+
+          static glm::mat4 compose( const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale );
+
+          /**
+           * cursor is the keyframe found by the last call. Playback that moves forward resumes the search from it
+           * in constant time; any other tick falls back to a binary search. Ticks outside the timeline clamp to the
+           * first or last keyframe, and a channel with no keyframes samples as identity.
+           */
+          glm::mat4 sample( double tick, unsigned int& cursor ) const;
+          glm::mat4 sample( double tick ) const;
+        };
+
+      }
+    }
+  }
+}
+
+#endif
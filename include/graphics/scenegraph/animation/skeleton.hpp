@@ -0,0 +1,53 @@
+#ifndef SG_ANIMATION_SKELETON
+#define SG_ANIMATION_SKELETON
+
+#include "graphics/scenegraph/animation/bone.hpp"
+#include "exceptions/genexc.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BlueBear {
+  namespace Graphics {
+    namespace SceneGraph {
+      namespace Animation {
+
+        /**
+         * Immutable, flattened form of a Bone tree. Joints are stored in preorder, so a joint's parent always
+         * precedes it and a single forward pass can compute every global transform.
+         */
+        class Skeleton {
+        public:
+          struct Joint {
+            std::string id;
+            // Index of the parent joint, or -1 for the root
+            int parent;
+            glm::mat4 bindLocal;
+            glm::mat4 inverseBindGlobal;
+            std::shared_ptr< Bone::AnimationMap > animations;
+          };
+
+        private:
+          std::vector< Joint > joints;
+          std::unordered_map< std::string, unsigned int > indices;
+
+          void addJoint( const Bone& root, const Bone& bone, int parent );
+
+        public:
+          EXCEPTION_TYPE( JointNotFoundException, "Joint not found!" );
+
+          Skeleton( const Bone& root );
+
+          const std::vector< Joint >& getJoints() const;
+          unsigned int getIndex( const std::string& id ) const;
+          size_t size() const;
+        };
+
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef LIGHTMAP_BUFFERS
+#define LIGHTMAP_BUFFERS
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph::Light {
+	class DirectionalLight;
+
+	// struct DirectionalLight in system/shaders/common/directional_light.glsl; each vec3 takes a 16-byte slot under std140
+	struct Std140DirectionalLight {
+		glm::vec4 direction;
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+		glm::vec4 specular;
+	};
+	static_assert( sizeof( Std140DirectionalLight ) == 64, "std140 DirectionalLight stride is 64 bytes" );
+
+	// struct Room in system/shaders/common/room.glsl; 28 bytes of members, rounded up to a 16-byte array stride
+	struct Std140Room {
+		glm::vec2 lowerLeft;
+		glm::vec2 upperRight;
+		glm::ivec2 mapLocation;
+		int level = -1;
+		int padding = 0;
+	};
+	static_assert( sizeof( Std140Room ) == 32, "std140 Room stride is 32 bytes" );
+
+	/**
+	 * Room slots overlapping each whole-unit tile of each level, in slot order. entries holds ( first, count ) into rooms
+	 * for every texel of the index texture, which stacks the levels vertically: tile ( x, y ) of level l is texel
+	 * ( x - origin.x, ( l * size.y ) + y - origin.y ).
+	 */
+	struct RoomTileIndex {
+		glm::ivec2 origin{ 0, 0 };
+		glm::ivec2 size{ 1, 1 };
+		int levels = 1;
+		std::vector< glm::ivec2 > entries{ { 0, 0 } };
+		std::vector< int > rooms;
+	};
+
+	RoomTileIndex indexRoomTiles( const std::vector< Std140Room >& rooms );
+
+	std::vector< unsigned char > packLights( const std::vector< const DirectionalLight* >& lights );
+	std::vector< unsigned char > packRooms( const std::vector< Std140Room >& rooms, const RoomTileIndex& index );
+	std::vector< unsigned char > packTileRooms( const RoomTileIndex& index );
+
+}
+
+#endif
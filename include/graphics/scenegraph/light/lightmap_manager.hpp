@@ -2,9 +2,10 @@
 #define LIGHTMAP_MANAGER
 
 #include "graphics/scenegraph/light/directionallight.hpp"
+#include "graphics/scenegraph/light/lightmap_buffers.hpp"
+#include "graphics/shader_tools/shader_storage.hpp"
 #include "graphics/uniform_cache.hpp"
-#include "containers/bounded_object.hpp"
-#include "containers/packed_cell.hpp"
+#include "containers/rectanglepacker.hpp"
 #include "models/room.hpp"
 #include "graphics/shader.hpp"
 #include "graphics/texture.hpp"
@@ -20,41 +21,69 @@ namespace BlueBear::Graphics{ class Shader; }
 namespace BlueBear::Graphics::SceneGraph::Light {
 
 	class LightmapManager {
+	protected:
+		/**
+		 * One slot of the room list; room n samples light n + 1. Slots keep their room, mask and atlas region
+		 * until that room changes, so unchanged rooms are never rasterized or uploaded again.
+		 */
 		struct ShaderRoom {
 			glm::vec2 lowerLeft;
 			glm::vec2 upperRight;
 			glm::ivec2 mapLocation;
 			int level = -1;
+			// Mask rows run bottom to top, the order they take in the texture
 			std::unique_ptr< float[] > mapData;
+			glm::ivec2 dimensions;
+			size_t hash = 0;
+			std::vector< glm::vec2 > points;
+			Containers::RectanglePacker::Rectangle region;
+		};
+		struct RegionUpdate {
+			// Slots rasterized this update, which must be uploaded
+			std::vector< size_t > dirty;
+			// Regions of vanished rooms, which must be zeroed
+			std::vector< Containers::RectanglePacker::Rectangle > cleared;
+			// The atlas grew, so the texture must be reallocated with every region
+			bool resized = false;
 		};
 		struct UniformBundle {
-			std::vector< Shader::Uniform > directionalLightsDirection;
-			std::vector< Shader::Uniform > directionalLightsAmbient;
-			std::vector< Shader::Uniform > directionalLightsDiffuse;
-			std::vector< Shader::Uniform > directionalLightsSpecular;
-			std::vector< Shader::Uniform > roomsLowerLeft;
-			std::vector< Shader::Uniform > roomsUpperRight;
-			std::vector< Shader::Uniform > roomsMapLocation;
-			std::vector< Shader::Uniform > roomsLevel;
 			Shader::Uniform roomData;
+			Shader::Uniform roomIndex;
 
 			UniformBundle() = default;
 			UniformBundle( const Shader& shader );
 		};
 
+		std::vector< ShaderRoom > generatedRooms;
+		glm::ivec2 textureSize{ 0, 0 };
+
+		static size_t hashRoom( const Models::Room& room, int level );
+		ShaderRoom getFragmentData( const Models::Room& room, int level, int lightIndex );
+		RegionUpdate updateRegions();
+		std::vector< Std140Room > getStd140Rooms() const;
+
+	private:
 		std::vector< std::vector< Models::Room > > roomLevels;
 		DirectionalLight outdoorLight;
+		Containers::RectanglePacker packer;
 
 		UniformCache< UniformBundle > uniforms;
 		std::optional< Graphics::Texture > generatedRoomData;
-		std::vector< ShaderRoom > generatedRooms;
 		std::vector< const DirectionalLight* > generatedLightList;
 		std::optional< unsigned int > claimedTextureUnit;
+		std::optional< unsigned int > claimedIndexUnit;
+
+		// Lights are compared against the last upload on every shader change; rooms are resent after calculateLightmaps
+		ShaderTools::ShaderStorage lightBuffer;
+		ShaderTools::ShaderStorage roomBuffer;
+		ShaderTools::ShaderStorage tileRoomBuffer;
+		RoomTileIndex tileIndex;
+		GLuint tileIndexTexture = 0;
+		bool roomsChanged = true;
 
 		std::vector< Geometry::LineSegment< glm::vec2 > > getEdges( const Models::Room& room );
-		ShaderRoom getFragmentData( const Models::Room& room, int level, int lightIndex );
-		std::vector< Containers::BoundedObject< ShaderRoom* > > getBoundedObjects( std::vector< ShaderRoom >& shaderRooms );
-		void setTexture( const Containers::PackedCellMap< ShaderRoom* >& packedCells );
+		void uploadRegions( const RegionUpdate& update );
+		void uploadRooms();
 
 	public:
 		LightmapManager();
@@ -66,7 +95,6 @@ namespace BlueBear::Graphics::SceneGraph::Light {
 
 		void send( const Shader& shader );
 	};
-
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef SG_BONE_PALETTE
+#define SG_BONE_PALETTE
+
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace BlueBear {
+  namespace Graphics {
+    namespace SceneGraph {
+      namespace Animation {
+        class Animator;
+      }
+
+      namespace Mesh {
+        class BoneUniform;
+
+        /**
+         * One frame's skinning matrices for every animated instance, packed back to back. An array of mat4 has a
+         * 64-byte stride under std140, which is exactly glm::mat4, so the CPU-side vector is uploaded as-is.
+         * Packing needs no GL context; only upload() touches the buffer.
+         */
+        class BonePalette {
+          static_assert( sizeof( glm::mat4 ) == 64, "std140 mat4 stride must match glm::mat4" );
+
+          std::vector< glm::mat4 > matrices;
+          std::map< std::pair< const BoneUniform*, const Animation::Animator* >, unsigned int > offsets;
+
+          GLuint ssbo = 0;
+
+        public:
+          BonePalette() = default;
+          BonePalette( const BonePalette& ) = delete;
+          BonePalette& operator=( const BonePalette& ) = delete;
+          ~BonePalette();
+
+          void clear();
+          bool empty() const;
+
+          /**
+           * Pack the matrices for this mesh bone list posed by this animator, returning the index of its first matrix.
+           * Meshes drawn more than once per frame with the same animator are only packed once.
+           */
+          unsigned int add( BoneUniform& boneUniform, const Animation::Animator& animator );
+          const std::vector< glm::mat4 >& getMatrices() const;
+
+          /**
+           * Upload to the shader storage buffer at BLUEBEAR_BONE_PALETTE_BINDING. Returns false if storage buffers are
+           * unavailable, in which case draws should fall back to per-draw bone uniforms.
+           */
+          bool upload();
+        };
+
+      }
+    }
+  }
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 namespace BlueBear {
@@ -17,6 +18,8 @@ namespace BlueBear {
 
       namespace Animation {
         class BonePackage;
+        class Animator;
+        class Skeleton;
       }
 
       namespace Mesh {
@@ -25,15 +28,28 @@ namespace BlueBear {
           std::vector< std::string > boneIDs;
           std::vector< glm::mat4 > boneUniform;
 
-          std::unordered_map< const void*, Shader::Uniform > uniforms;
-          Shader::Uniform getUniform( const Shader* shader );
+          // Joint index of each entry in boneIDs, resolved once per skeleton
+          std::shared_ptr< const Animation::Skeleton > resolvedSkeleton;
+          std::vector< unsigned int > jointIndices;
+
+          // Set while this mesh's matrices are in the frame's BonePalette, so that only the offset is sent
+          std::optional< unsigned int > paletteOffset;
+
+          struct BoneUniformBundle {
+            Shader::Uniform bonesUniform;
+            Shader::Uniform boneOffsetUniform;
+          };
+          std::unordered_map< const void*, BoneUniformBundle > uniforms;
+          const BoneUniformBundle& getUniforms( const Shader* shader );
 
         public:
           BoneUniform( const std::vector< std::string >& boneIDs );
           std::unique_ptr< Uniform > copy() override;
 
-          void configure( const std::map< std::string, glm::mat4 >& computedBones );
+          void configure( const Animation::Animator& animator );
           const std::vector< glm::mat4 >& getBoneList() const;
+          bool supportsPalette( const Shader& shader );
+          void setPaletteOffset( std::optional< unsigned int > offset );
           void send( const Shader& shader ) override;
         };
 
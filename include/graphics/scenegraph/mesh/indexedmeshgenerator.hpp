@@ -3,7 +3,11 @@
 
 #include "graphics/scenegraph/mesh/meshdefinition.hpp"
 #include "graphics/scenegraph/mesh/triangle.hpp"
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "log.hpp"
@@ -13,20 +17,94 @@ namespace BlueBear::Graphics::SceneGraph::Mesh {
 
   template< typename VertexType >
   class IndexedMeshGenerator {
+    /**
+     * VertexType::operator== compares positions with a relative epsilon (Tools::Utility::equalEpsilon). Mapping each
+     * coordinate onto its ordered integer representation turns that into a bounded ULP distance (under 4096 ULPs at
+     * 1e-4), so any vertex that compares equal lies in the same or a neighbouring bucket of 8192 ULPs per axis.
+     */
+    static constexpr int BUCKET_SHIFT = 13;
+    // Small meshes (e.g. single wall pieces) are faster to search directly than to hash
+    static constexpr unsigned int LINEAR_SEARCH_LIMIT = 32;
+
+    std::unordered_map< std::uint64_t, std::vector< unsigned int > > buckets;
+
+    static std::int32_t getBucket( float value ) {
+      std::int32_t bits;
+      std::memcpy( &bits, &value, sizeof( float ) );
+
+      // Two's complement ordering for sign-magnitude floats: -0.0 and +0.0 end up adjacent
+      std::int32_t ordered = bits < 0 ? std::numeric_limits< std::int32_t >::min() - bits : bits;
+      return ordered >> BUCKET_SHIFT;
+    }
+
+    static std::uint64_t getBucketKey( std::int32_t x, std::int32_t y, std::int32_t z ) {
+      // 19 significant bits per axis after the shift
+      constexpr std::uint64_t mask = ( 1 << 21 ) - 1;
+      return ( ( std::uint64_t( x ) & mask ) << 42 ) | ( ( std::uint64_t( y ) & mask ) << 21 ) | ( std::uint64_t( z ) & mask );
+    }
+
+    void addToBucket( unsigned int index ) {
+      const glm::vec3& position = vertices[ index ].position;
+      buckets[ getBucketKey( getBucket( position.x ), getBucket( position.y ), getBucket( position.z ) ) ].push_back( index );
+    }
+
   protected:
     std::vector< VertexType > vertices;
     std::vector< Triangle > triangles;
 
     unsigned int insertVertex( VertexType vertex ) {
-      for( unsigned int i = 0; i != vertices.size(); i++ ) {
-        const VertexType& indexedVertex = vertices[ i ];
+      if( vertices.size() < LINEAR_SEARCH_LIMIT ) {
+        for( unsigned int i = 0; i != vertices.size(); i++ ) {
+          if( vertex == vertices[ i ] ) {
+            return i;
+          }
+        }
 
-        if( vertex == indexedVertex ) {
-          return i;
+        vertices.push_back( vertex );
+        if( vertices.size() == LINEAR_SEARCH_LIMIT ) {
+          for( unsigned int i = 0; i != vertices.size(); i++ ) {
+            addToBucket( i );
+          }
+        }
+
+        return vertices.size() - 1;
+      }
+
+      std::int32_t x = getBucket( vertex.position.x );
+      std::int32_t y = getBucket( vertex.position.y );
+      std::int32_t z = getBucket( vertex.position.z );
+
+      // Equality is not transitive, so keep the behaviour of a linear search: the earliest matching vertex wins
+      unsigned int match = vertices.size();
+      for( std::int32_t dx = -1; dx <= 1; dx++ ) {
+        for( std::int32_t dy = -1; dy <= 1; dy++ ) {
+          for( std::int32_t dz = -1; dz <= 1; dz++ ) {
+            auto bucket = buckets.find( getBucketKey( x + dx, y + dy, z + dz ) );
+            if( bucket == buckets.end() ) {
+              continue;
+            }
+
+            // Buckets are in insertion order, so the first hit in each is its earliest
+            for( unsigned int index : bucket->second ) {
+              if( index >= match ) {
+                break;
+              }
+
+              if( vertex == vertices[ index ] ) {
+                match = index;
+                break;
+              }
+            }
+          }
         }
       }
 
+      if( match != vertices.size() ) {
+        return match;
+      }
+
       vertices.push_back( vertex );
+      addToBucket( vertices.size() - 1 );
       return vertices.size() - 1;
     };
 
@@ -40,45 +118,43 @@ namespace BlueBear::Graphics::SceneGraph::Mesh {
     };
 
     void generateNormals() {
-      std::vector< glm::vec3 > triangleNormals;
+      std::vector< glm::vec3 > normalTotals( vertices.size(), glm::vec3( 0.0f, 0.0f, 0.0f ) );
+      std::vector< unsigned int > triangleCounts( vertices.size(), 0 );
 
-      // Generate the normals for each triangle
+      // Accumulate each face normal onto its vertices, in triangle order so that the sums are unchanged
       for( const auto& triangle : triangles ) {
-        triangleNormals.emplace_back(
-          glm::cross(
-            vertices[ triangle[ 1 ] ].position - vertices[ triangle[ 0 ] ].position,
-            vertices[ triangle[ 2 ] ].position - vertices[ triangle[ 0 ] ].position
-          )
+        glm::vec3 triangleNormal = glm::cross(
+          vertices[ triangle[ 1 ] ].position - vertices[ triangle[ 0 ] ].position,
+          vertices[ triangle[ 2 ] ].position - vertices[ triangle[ 0 ] ].position
         );
-      }
 
-      // For each vertex, determine what triangles it belongs to and average all their normals
-      for( unsigned int vertexIndex = 0; vertexIndex != vertices.size(); vertexIndex++ ) {
-        std::vector< unsigned int > triangleIndices;
-
-        // Find indices for each triangle this vertex belongs to
-        for( unsigned int triangleIndex = 0; triangleIndex != triangles.size(); triangleIndex++ ) {
-          const auto& triangle = triangles.at( triangleIndex );
-          for( unsigned int triangleVertexIndex : triangle ) {
-            if ( triangleVertexIndex == vertexIndex ) {
-              triangleIndices.emplace_back( triangleIndex );
-              break;
-            }
+        // A degenerate triangle that repeats a vertex still only counts once for it
+        for( unsigned int i = 0; i != 3; i++ ) {
+          if( ( i > 0 && triangle[ i ] == triangle[ 0 ] ) || ( i > 1 && triangle[ i ] == triangle[ 1 ] ) ) {
+            continue;
           }
-        }
 
-        // Take the normal average of every triangle this vertex belongs to
-        glm::vec3 normalTotal;
-        for( unsigned int triangleIndex : triangleIndices ) {
-          normalTotal += triangleNormals[ triangleIndex ];
+          normalTotals[ triangle[ i ] ] += triangleNormal;
+          triangleCounts[ triangle[ i ] ]++;
         }
+      }
 
-        float numTriangles = triangleIndices.size();
-        vertices.at( vertexIndex ).normal = glm::normalize( normalTotal / numTriangles );
+      // Take the normal average of every triangle each vertex belongs to
+      for( unsigned int vertexIndex = 0; vertexIndex != vertices.size(); vertexIndex++ ) {
+        float numTriangles = triangleCounts[ vertexIndex ];
+        vertices[ vertexIndex ].normal = glm::normalize( normalTotals[ vertexIndex ] / numTriangles );
       }
     };
 
-    std::shared_ptr< MeshDefinition< VertexType > > generateMesh() {
+    const std::vector< VertexType >& getVertices() const {
+      return vertices;
+    };
+
+    const std::vector< Triangle >& getTriangles() const {
+      return triangles;
+    };
+
+    std::shared_ptr< MeshDefinition< VertexType > > generateMesh( bool defer = false ) {
       // For safety - Don't think we can create meshes with no vertices
       if( vertices.empty() ) {
         return nullptr;
@@ -92,7 +168,7 @@ namespace BlueBear::Graphics::SceneGraph::Mesh {
         unrolledIndices.push_back( triangle[ 2 ] );
       }
 
-      return std::make_shared< MeshDefinition< VertexType > >( vertices, unrolledIndices );
+      return std::make_shared< MeshDefinition< VertexType > >( vertices, unrolledIndices, defer );
     };
   };
 
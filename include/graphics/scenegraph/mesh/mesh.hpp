@@ -3,6 +3,7 @@
 
 #include "graphics/scenegraph/uniform.hpp"
 #include "geometry/triangle.hpp"
+#include "geometry/aabb.hpp"
 #include <GL/glew.h>
 #include <functional>
 #include <memory>
@@ -10,6 +11,7 @@
 #include <utility>
 #include <vector>
 #include <map>
+#include <optional>
 
 namespace BlueBear {
   namespace Graphics {
@@ -21,6 +23,8 @@ namespace BlueBear {
         class Mesh {
         protected:
           std::vector< Geometry::Triangle > genericTriangles;
+          std::optional< Geometry::AABB > localBounds;
+          bool localBoundsComputed = false;
 
         public:
           std::map< std::string, std::shared_ptr< Uniform > > meshUniforms;
@@ -32,6 +36,8 @@ namespace BlueBear {
           virtual void drawElements( const Shader& ) = 0;
 
           virtual std::vector< Geometry::Triangle > getTriangles() = 0;
+
+          const std::optional< Geometry::AABB >& getLocalBounds();
         };
 
       }
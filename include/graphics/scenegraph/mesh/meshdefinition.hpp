@@ -155,10 +155,22 @@ namespace BlueBear {
             } else {
               genericTransformMethod = std::bind( &MeshDefinition::defaultGenericTransform, this, std::placeholders::_1 );
             }
+
+            // Bounds are taken through this method, so they must be taken again
+            this->localBounds.reset();
+            this->localBoundsComputed = false;
+          }
+
+          const std::vector< VertexType >& getVertices() const {
+            return vertices;
+          }
+
+          const std::vector< GLuint >& getIndices() const {
+            return indices;
           }
 
           void sendDeferred() override {
-            if( vertices.size() ) {
+            if( !loaded && vertices.size() ) {
               if( indices.size() ) {
                 loadIndexed();
               } else {
@@ -0,0 +1,38 @@
+#ifndef SG_WALL_VERTEX
+#define SG_WALL_VERTEX
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <utility>
+#include <string>
+
+namespace BlueBear {
+  namespace Graphics {
+    class Shader;
+
+    namespace SceneGraph {
+      namespace Mesh {
+
+        /**
+         * Wall vertex of a merged wall chunk. The wallpaper still comes from the atlas texture coordinates;
+         * piece selects this vertex's slot in the chunk's per-piece offsets.
+         */
+        struct WallVertex {
+          glm::vec3 position;
+          glm::vec3 normal;
+          glm::vec2 textureCoordinates;
+          int piece = 0;
+
+          bool operator==( const WallVertex& rhs ) const;
+
+          static void setupShaderAttributes();
+          static std::pair< std::string, std::string > getDefaultShader();
+        };
+
+      }
+    }
+  }
+}
+
+
+#endif
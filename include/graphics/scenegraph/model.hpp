@@ -8,6 +8,8 @@
 #include "graphics/scenegraph/modeltriangle.hpp"
 #include "geometry/triangle.hpp"
 #include "geometry/ray.hpp"
+#include "geometry/aabb.hpp"
+#include "geometry/bvh.hpp"
 #include "graphics/shader.hpp"
 #include <sol.hpp>
 #include <string>
@@ -30,6 +32,13 @@ namespace BlueBear {
       }
 
       class Model : public std::enable_shared_from_this< Model > {
+        // World-space triangles of this model and its children, with a BVH over them for picking
+        struct PickingHierarchy {
+          std::vector< Geometry::Triangle > triangles;
+          Geometry::BVH hierarchy;
+          bool stale = false;
+        };
+
         std::string id;
         Transform transform;
         std::weak_ptr< Model > parent;
@@ -38,6 +47,7 @@ namespace BlueBear {
         std::vector< std::shared_ptr< Model > > submodels;
         std::map< std::string, std::unique_ptr< Uniform > > uniforms;
         std::unique_ptr< BoundingVolume::BoundingVolume > boundingVolume;
+        std::unique_ptr< PickingHierarchy > pickingHierarchy;
 
         std::unordered_map< const void*, Shader::Uniform > transformUniform;
 
@@ -46,6 +56,7 @@ namespace BlueBear {
         Model( const Model& other );
 
         void generateBoundingVolume();
+        void updatePickingHierarchy();
         glm::mat4 getHierarchicalTransform();
         Shader::Uniform getTransformUniform( const Shader* shader );
 
@@ -90,6 +101,8 @@ namespace BlueBear {
 
         std::vector< ModelTriangle > getModelTriangles( Animation::Animator* parentAnimator = nullptr ) const;
         bool intersectsBoundingVolume( const Geometry::Ray& ray );
+        std::optional< Geometry::AABB > getBoundingBox();
+        std::optional< float > getIntersectionDistance( const Geometry::Ray& ray );
         void invalidateBoundingVolume();
       };
 
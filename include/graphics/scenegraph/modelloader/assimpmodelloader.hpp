@@ -4,15 +4,19 @@
 #include "exceptions/genexc.hpp"
 #include "graphics/scenegraph/animation/animation.hpp"
 #include "graphics/scenegraph/modelloader/filemodelloader.hpp"
+#include "graphics/scenegraph/modelloader/modeldescription.hpp"
 #include "graphics/scenegraph/animation/bone.hpp"
 #include <glm/glm.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <GL/glew.h>
+#include <cstdint>
 #include <exception>
 #include <vector>
 #include <memory>
 #include <map>
+#include <optional>
+#include <string>
 
 namespace BlueBear {
   namespace Graphics {
@@ -40,6 +44,16 @@ namespace BlueBear {
             unsigned int logIndentation = 0;
           } context;
 
+          // Up to four bone slots for one vertex; unused slots keep the vertex defaults
+          struct BoneInfluence {
+            glm::ivec4 boneIDs = glm::ivec4( 0, 0, 0, 0 );
+            glm::vec4 boneWeights = glm::vec4( 1.0f, 0.0f, 0.0f, 0.0f );
+            unsigned int count = 0;
+            // Bones are scattered one at a time, so only the last bone to touch a vertex can repeat on it
+            int lastBoneID = 0;
+            bool truncated = false;
+          };
+
           void log( const std::string& tag, const std::string& message );
 
           std::shared_ptr< Shader > getShader( const std::string& vertexPath, const std::string& fragmentPath );
@@ -47,23 +61,34 @@ namespace BlueBear {
           template < typename... Signature > std::shared_ptr< Material > getMaterial( Signature... params );
 
           unsigned int getFlags();
-          std::vector< GLuint > getIndices( aiMesh* mesh );
-          std::vector< std::shared_ptr< Texture > > getTextureList( aiMaterial* material, aiTextureType type );
+          std::vector< uint32_t > getIndices( aiMesh* mesh );
+          std::vector< std::string > getTextureList( aiMaterial* material, aiTextureType type );
           std::vector< std::string > getBoneIds( aiBone** bones, unsigned int numBones );
           template < typename VertexType > VertexType getVertex( const aiVector3D& vertex, const aiVector3D& normal );
-          template < typename VertexType > void assignBonesToVertex( VertexType& vertex, unsigned int vertexIndex, aiBone** bones, unsigned int numBones );
-          std::shared_ptr< Mesh::Mesh > getMesh( aiMesh* mesh, aiMatrix4x4 transform );
-          std::shared_ptr< Material > getMaterial( aiMaterial* material );
-          std::shared_ptr< Model > getNode( aiNode* node, aiMatrix4x4 parentTransform = {} );
-          std::map< double, glm::mat4 > getKeyframes( aiNodeAnim* nodeAnim );
-          std::shared_ptr< Animation::Bone::AnimationMap > getAnimationMapForBone( const std::string& boneId );
-          Animation::Bone getBoneFromNode( aiNode* node );
+          template < typename VertexType > void assignBonesToVertex( VertexType& vertex, const BoneInfluence& influence );
+          template < typename VertexType > void setVertices( ModelDescription::Mesh& result, const std::vector< VertexType >& vertices );
+          ModelDescription::Mesh getMesh( aiMesh* mesh, aiMatrix4x4 transform );
+          ModelDescription::Material getMaterialDescription( aiMaterial* material );
+          void getNode( ModelDescription& description, aiNode* node, aiMatrix4x4 parentTransform = {} );
+          std::vector< ModelDescription::Keyframe > getKeyframes( aiNodeAnim* nodeAnim );
+          std::map< std::string, std::vector< ModelDescription::Keyframe > > getChannelsForBone( const std::string& boneId );
+          uint32_t getBoneFromNode( ModelDescription& description, aiNode* node );
           std::map< std::string, Animation::Animation > getAnimationList();
-          std::shared_ptr< Animation::Animator > getAnimator( aiNode* node );
+          ModelDescription describe();
+
+          template < typename VertexType > std::shared_ptr< Mesh::Mesh > buildMeshDefinition( const ModelDescription::Mesh& mesh );
+          std::shared_ptr< Mesh::Mesh > buildMesh( const ModelDescription::Mesh& mesh );
+          std::vector< std::shared_ptr< Texture > > buildTextureList( const std::vector< std::string >& paths );
+          std::shared_ptr< Material > buildMaterial( const ModelDescription::Material& material );
+          Animation::Bone buildBone( const ModelDescription& description, uint32_t index );
+          std::shared_ptr< Model > buildNode( const ModelDescription& description, uint32_t index );
+
+        protected:
+          static std::vector< BoneInfluence > getBoneInfluences( aiBone** bones, unsigned int numBones, unsigned int numVertices );
+          std::optional< uint64_t > getCacheKey( const std::string& filename );
 
         public:
           EXCEPTION_TYPE( MalformedAnimationException, "Malformed animation data" );
-          EXCEPTION_TYPE( TooManyBonesException, "Too many bones for this vertex!" );
 
           AssimpModelLoader( Utilities::ShaderManager& shaderManager );
 
@@ -72,7 +97,11 @@ namespace BlueBear {
           bool useBones = true;
           bool deferGLOperations = false;
           SceneGraph::ResourceBank* cache = nullptr;
+          // Imported models are stored here as ModelCache files; empty disables the cache
+          std::string cacheDirectory;
 
+          // Texture names in the description are resolved against directory
+          std::shared_ptr< Model > build( const ModelDescription& description, const std::string& directory );
           std::shared_ptr< Model > get( const std::string& filename ) override;
         };
 
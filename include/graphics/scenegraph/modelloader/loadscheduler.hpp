@@ -0,0 +1,75 @@
+#ifndef SG_MODEL_LOAD_SCHEDULER
+#define SG_MODEL_LOAD_SCHEDULER
+
+#include "graphics/scenegraph/modelloader/filemodelloader.hpp"
+#include "tools/objectpool.hpp"
+#include <tbb/task_arena.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph { class Model; }
+namespace BlueBear::Graphics::SceneGraph::ModelLoader {
+
+	/**
+	 * Loads models on worker threads and hands them back to the GL thread. Workers parse model files, decode textures
+	 * and read shader sources; collect() then does the GL uploads for a bounded number of finished models, so a lot
+	 * with hundreds of objects streams in over several frames instead of stalling one.
+	 *
+	 * Ids naming the same file share a single load. Textures and shaders shared between files are deduplicated by
+	 * the ResourceBank and ShaderManager the loaders were created with.
+	 */
+	class LoadScheduler {
+	public:
+		using Result = std::pair< std::string, std::shared_ptr< Model > >;
+
+		struct Progress {
+			unsigned int requested = 0;
+			// Finished on a worker, including failures
+			unsigned int parsed = 0;
+			unsigned int uploaded = 0;
+			unsigned int failed = 0;
+
+			float getFraction() const;
+		};
+
+	private:
+		Tools::ObjectPool< FileModelLoader > pool;
+		tbb::task_arena arena;
+
+		mutable std::mutex mutex;
+		std::condition_variable parsedCondition;
+		// Ids requested and not yet collected or failed
+		std::unordered_set< std::string > pending;
+		// Path -> ids waiting on its load; present while a worker has the file
+		std::unordered_map< std::string, std::vector< std::string > > inFlight;
+		// Parsed models in completion order, waiting for their GL upload
+		std::deque< Result > parsed;
+		Progress progress;
+
+		void load( const std::string& path );
+		static void prepareShaders( const Model& model );
+
+	public:
+		LoadScheduler( std::function< std::unique_ptr< FileModelLoader >() > createLoader );
+		~LoadScheduler();
+
+		bool enqueue( const std::string& id, const std::string& path );
+		std::vector< Result > collect( unsigned int budget );
+		std::shared_ptr< Model > finish( const std::string& id );
+		std::vector< Result > finishAll();
+
+		bool isPending( const std::string& id ) const;
+		Progress getProgress() const;
+	};
+
+}
+
+#endif
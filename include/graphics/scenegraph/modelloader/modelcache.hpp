@@ -0,0 +1,37 @@
+#ifndef SG_MODEL_CACHE
+#define SG_MODEL_CACHE
+
+#include "exceptions/genexc.hpp"
+#include "graphics/scenegraph/modelloader/modeldescription.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph::ModelLoader {
+
+	/**
+	 * Versioned binary cache of imported models. Each file holds one ModelDescription and is named for its key,
+	 * a hash of the source file contents and the import options, so a changed source or different options miss
+	 * the cache. Files written by another format version are rejected by the version in their header.
+	 */
+	class ModelCache {
+	public:
+		EXCEPTION_TYPE( CorruptCacheException, "Model cache file is truncated or malformed" );
+
+		static constexpr uint32_t VERSION = 2;
+
+		static std::optional< uint64_t > getKey( const std::string& sourcePath, const std::vector< uint32_t >& options );
+		static std::string getPath( const std::string& directory, uint64_t key );
+
+		static std::vector< unsigned char > serialize( const ModelDescription& description, uint64_t key );
+		static std::optional< ModelDescription > deserialize( const unsigned char* data, size_t size, uint64_t key );
+
+		static std::optional< ModelDescription > load( const std::string& path, uint64_t key );
+		static bool store( const std::string& path, uint64_t key, const ModelDescription& description );
+	};
+
+}
+
+#endif
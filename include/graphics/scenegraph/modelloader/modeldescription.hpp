@@ -0,0 +1,95 @@
+#ifndef SG_MODEL_DESCRIPTION
+#define SG_MODEL_DESCRIPTION
+
+#include "graphics/scenegraph/animation/animation.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph::ModelLoader {
+
+	/**
+	 * Everything AssimpModelLoader pulls out of an imported scene, in plain arrays with no GL or Assimp objects.
+	 * Mesh vertices are already in their final MeshDefinition layout, so building a Model from this is only allocation.
+	 */
+	struct ModelDescription {
+		enum class VertexFormat : uint32_t { BASIC, TEXTURED, RIGGED, TEXTURED_RIGGED };
+
+		struct Mesh {
+			VertexFormat format = VertexFormat::BASIC;
+			bool indexed = false;
+			// Tightly packed array of the vertex type selected by format
+			std::vector< unsigned char > vertices;
+			std::vector< uint32_t > indices;
+			std::vector< std::string > boneIds;
+
+			bool operator==( const Mesh& rhs ) const;
+		};
+
+		struct Material {
+			glm::vec3 ambient{ 0.0f };
+			glm::vec3 diffuse{ 0.0f };
+			glm::vec3 specular{ 0.0f };
+			// As named in the source file, relative to its directory
+			std::vector< std::string > diffuseTextures;
+			std::vector< std::string > specularTextures;
+			float shininess = 0.0f;
+			float opacity = 1.0f;
+
+			bool operator==( const Material& rhs ) const;
+		};
+
+		struct Drawable {
+			uint32_t mesh;
+			uint32_t material;
+
+			bool operator==( const Drawable& rhs ) const;
+		};
+
+		struct Keyframe {
+			double time;
+			glm::vec3 translation;
+			glm::quat rotation;
+			glm::vec3 scale;
+
+			bool operator==( const Keyframe& rhs ) const;
+		};
+
+		struct Bone {
+			std::string id;
+			glm::mat4 transform;
+			// Animation name -> keyframes; a bone with no channels gets no animation map at all
+			std::map< std::string, std::vector< Keyframe > > channels;
+			std::vector< uint32_t > children;
+
+			bool operator==( const Bone& rhs ) const;
+		};
+
+		struct Node {
+			std::string name;
+			std::vector< Drawable > drawables;
+			std::vector< uint32_t > children;
+			// Index into bones of the root bone of this node's animator, or -1
+			int32_t skeleton = -1;
+
+			bool operator==( const Node& rhs ) const;
+		};
+
+		std::vector< Mesh > meshes;
+		std::vector< Material > materials;
+		std::vector< Bone > bones;
+		// nodes[ 0 ] is the root
+		std::vector< Node > nodes;
+		std::map< std::string, Animation::Animation > animations;
+
+		static size_t getVertexSize( VertexFormat format );
+
+		bool operator==( const ModelDescription& rhs ) const;
+	};
+
+}
+
+#endif
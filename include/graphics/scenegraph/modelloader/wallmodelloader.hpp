@@ -4,54 +4,70 @@
 #include "graphics/scenegraph/modelloader/proceduralmodelloader.hpp"
 #include "graphics/scenegraph/mesh/indexedmeshgenerator.hpp"
 #include "graphics/scenegraph/mesh/texturedvertex.hpp"
+#include "graphics/scenegraph/mesh/wallvertex.hpp"
+#include "graphics/scenegraph/uniforms/wall_pieces_uniform.hpp"
 #include "graphics/utilities/textureatlas.hpp"
 #include "graphics/scenegraph/drawable.hpp"
 #include "models/infrastructure.hpp"
 #include "models/wallsegment.hpp"
+#include <SFML/Graphics/Image.hpp>
+#include <functional>
 #include <vector>
 #include <optional>
 
-namespace BlueBear::Graphics { class Texture; }
+namespace BlueBear::Graphics { class Texture; class Shader; }
 namespace BlueBear::Graphics::Utilities{ class TextureAtlas; class ShaderManager; }
 namespace BlueBear::Graphics::Vector{ class Renderer; }
+namespace BlueBear::Graphics::SceneGraph { class Material; }
 namespace BlueBear::Graphics::SceneGraph::ModelLoader {
 
   class WallModelLoader : public ProceduralModelLoader {
+  protected:
     using PlaneGroup = std::map< std::string, std::array< Mesh::TexturedVertex, 6 > >;
 
+    struct Piece {
+      std::optional< Models::Sides > model;
+      PlaneGroup stagedMesh;
+    };
+
     struct Corner {
-      struct {
-        std::optional< Models::Sides > model;
-        PlaneGroup stagedMesh;
-      } horizontal;
-
-      struct {
-        std::optional< Models::Sides > model;
-        PlaneGroup stagedMesh;
-      } vertical;
-
-      struct {
-        std::optional< Models::Sides > model;
-        PlaneGroup stagedMesh;
-      } diagonal;
-
-      struct {
-        std::optional< Models::Sides > model;
-        PlaneGroup stagedMesh;
-      } reverseDiagonal;
+      Piece horizontal;
+      Piece vertical;
+      Piece diagonal;
+      Piece reverseDiagonal;
+
+      bool empty() const;
+    };
+
+    struct Level {
+      glm::ivec2 dimensions{ 0, 0 };
+      std::vector< std::vector< Corner > > cornerMap;
     };
 
-    glm::ivec2 dimensions;
+    struct MergedChunk {
+      std::vector< Mesh::WallVertex > vertices;
+      std::vector< unsigned int > indices;
+      std::vector< Uniforms::WallPiecesUniform::Piece > pieces;
+    };
+
+    // Four pieces per cell must fit the offsets of one chunk
+    static constexpr int MAX_CHUNK_SIZE = 8;
+    static_assert( 4 * MAX_CHUNK_SIZE * MAX_CHUNK_SIZE <= Uniforms::WallPiecesUniform::MAX_PIECES );
+
+    bool merged;
+    int chunkSize;
     int currentLevel = 0;
     const std::vector< Models::Infrastructure::FloorLevel >& floorLevels;
-    std::vector< std::vector< Corner > > cornerMap;
+    std::vector< Level > levels;
     std::shared_ptr< Shader > shader;
+    std::shared_ptr< Material > material;
     Utilities::TextureAtlas atlas;
 
     Corner* getCorner( const glm::ivec2& location );
     glm::vec3 getPositionById( const PlaneGroup& group, const std::string& face, int index ) const;
     void updateStagedMesh( PlaneGroup& group, const glm::vec3& position, const glm::vec3& addValue, bool replace = false );
     glm::vec3 indexToLocation( const glm::ivec2& position );
+    glm::ivec2 locationToIndex( const glm::vec2& location );
 
     bool adjustTopLeft( const glm::ivec2& index );
     bool adjustTopRight( const glm::ivec2& index );
@@ -64,22 +80,42 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
     bool adjustDiagonalTop7( const glm::ivec2& index );
 
     void fixCorners( const glm::ivec2& startingIndex );
-    void initTopTexture( Vector::Renderer& renderer );
+    static std::shared_ptr< Shader > getShader( Utilities::ShaderManager& shaderManager );
+    static std::shared_ptr< sf::Image > generateTopTexture( Vector::Renderer& renderer );
     void initCornerMap();
 
+    void walkSegment( const Models::WallSegment& segment, const std::function< void( const glm::ivec2&, Piece Corner::*, const Models::Sides& ) >& functor );
     void insertCornerMapSegment( const Models::WallSegment& segment );
-    void insertIntoAtlas( const std::vector< Models::Sides >& sides, Utilities::TextureAtlas& atlas );
+    bool insertIntoAtlas( const std::vector< Models::Sides >& sides, Utilities::TextureAtlas& atlas );
 
     std::array< Mesh::TexturedVertex, 6 > getPlane( const glm::vec3& origin, const glm::vec3& width, const glm::vec3& height, const glm::vec3& normal, const std::string& wallpaperId );
     PlaneGroup sideToStagedMesh( const Models::Sides& sides, const glm::vec3& origin, const glm::vec3& width, float thickness = 0.1f );
+    void stageCorner( const glm::ivec2& cursor );
     void generateDeferredMeshes();
+    void loadCornerMap();
+    std::vector< glm::ivec2 > reloadCornerMap();
+    std::vector< glm::ivec2 > restageCells( const std::vector< glm::ivec2 >& dirtyCells );
+    void stageLevel();
+
     void addToGenerator( Mesh::IndexedMeshGenerator< Mesh::TexturedVertex >& generator, const PlaneGroup& planeGroup );
+    std::shared_ptr< Model > getPiece( const std::string& id, const PlaneGroup& planeGroup, const glm::ivec2& cell );
+    void addPieces( Model& level, const glm::ivec2& cell );
+    void mergePiece( MergedChunk& chunk, const std::string& id, const PlaneGroup& planeGroup, const glm::ivec2& cell );
+    MergedChunk mergeChunk( const glm::ivec2& chunk );
+    std::shared_ptr< Model > getChunk( const glm::ivec2& chunk );
+    void patchLevel( Model& level, const std::vector< glm::ivec2 >& cells );
+    void generateMaterial();
     std::shared_ptr< Model > getLevel();
 
   public:
+    // Leave meshes and the atlas texture for Model::sendDeferredObjects
+    bool deferGLOperations = false;
+
     WallModelLoader( const std::vector< Models::Infrastructure::FloorLevel >& floorLevels, Vector::Renderer& renderer, Utilities::ShaderManager& shaderManager );
+    WallModelLoader( const std::vector< Models::Infrastructure::FloorLevel >& floorLevels, std::shared_ptr< Shader > shader, std::shared_ptr< sf::Image > topTexture );
 
     std::shared_ptr< Model > get() override;
+    void update( Model& rig );
   };
 
 }
@@ -0,0 +1,32 @@
+#ifndef SG_MODEL_PICKER
+#define SG_MODEL_PICKER
+
+#include "geometry/aabb.hpp"
+#include "geometry/bvh.hpp"
+#include "geometry/ray.hpp"
+#include <memory>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph {
+	class Model;
+
+	/**
+	 * Top-level BVH over model instances. Each instance resolves the exact hit against its own triangle BVH.
+	 */
+	class ModelPicker {
+		std::vector< std::shared_ptr< Model > > models;
+		std::vector< unsigned int > candidates;
+		Geometry::BVH hierarchy;
+		bool dirty = true;
+
+	public:
+		void insert( const std::shared_ptr< Model >& model );
+		void remove( const std::shared_ptr< Model >& model );
+		void clear();
+
+		std::shared_ptr< Model > pick( const Geometry::Ray& ray );
+	};
+
+}
+
+#endif
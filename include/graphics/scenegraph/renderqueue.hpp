@@ -0,0 +1,82 @@
+#ifndef SG_RENDER_QUEUE
+#define SG_RENDER_QUEUE
+
+#include "geometry/aabb.hpp"
+#include "graphics/shader.hpp"
+#include "graphics/uniform_cache.hpp"
+#include "graphics/scenegraph/mesh/bonepalette.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph {
+	class Model;
+	class Uniform;
+	struct Drawable;
+
+	namespace Animation {
+		class Animator;
+	}
+
+	/**
+	 * Retained per-frame draw list. Models are flattened into items, frustum culled against the camera volume,
+	 * sorted by shader -> material -> mesh, and drawn with redundant state changes skipped. Translucent items are
+	 * drawn after all opaque ones, in submission order.
+	 */
+	class RenderQueue {
+	public:
+		struct Statistics {
+			unsigned int submitted = 0;
+			unsigned int culled = 0;
+			unsigned int drawCalls = 0;
+			unsigned int shaderChanges = 0;
+			unsigned int materialChanges = 0;
+			unsigned int meshChanges = 0;
+			unsigned int uniformChanges = 0;
+		};
+
+		struct Item {
+			const Drawable* drawable;
+			glm::mat4 transform;
+			const Animation::Animator* animator;
+			// First matrix of this draw in the bone palette, or -1 if the mesh is not skinned
+			int boneOffset;
+			// Range in the uniform pool: model uniforms of this node and all of its ancestors
+			unsigned int uniformsBegin;
+			unsigned int uniformsEnd;
+		};
+
+	private:
+		struct ModelUniforms {
+			Shader::Uniform transformUniform;
+
+			ModelUniforms() = default;
+			ModelUniforms( const Shader& shader ) : transformUniform( shader.getUniform( "model" ) ) {}
+		};
+		UniformCache< ModelUniforms > modelUniforms;
+
+		glm::mat4 viewProjection;
+		std::vector< Item > items;
+		Mesh::BonePalette bonePalette;
+		std::vector< Uniform* > uniformPool;
+		std::vector< Uniform* > uniformStack;
+		Statistics statistics;
+
+		void submitTree( const Model& model, glm::mat4 transform, const Animation::Animator* animator );
+		bool sameUniforms( const Item& lhs, const Item& rhs ) const;
+
+	public:
+		static bool isVisible( const Geometry::AABB& localBounds, const glm::mat4& clipTransform );
+
+		void begin( const glm::mat4& viewProjection );
+		void submit( const Model& model, const Animation::Animator* animator );
+		void sort();
+		void draw();
+
+		const std::vector< Item >& getItems() const;
+		const Statistics& getStatistics() const;
+		const Mesh::BonePalette& getBonePalette() const;
+	};
+
+}
+
+#endif
@@ -2,8 +2,9 @@
 #define BB_RESOURCE_BANK
 
 #include "graphics/scenegraph/material.hpp"
-#include <tbb/concurrent_vector.h>
+#include <tbb/concurrent_hash_map.h>
 #include <glm/glm.hpp>
+#include <future>
 #include <unordered_map>
 #include <vector>
 #include <mutex>
@@ -15,6 +16,7 @@ namespace BlueBear {
 
     namespace Utilities {
       class ShaderManager;
+      class TextureStreamer;
     }
 
     namespace SceneGraph {
@@ -23,17 +25,44 @@ namespace BlueBear {
        * Facilitates reuse of common by-ref objects used in Models
        */
       class ResourceBank {
+        /**
+         * Everything a material is built from. Textures are compared by identity, and the fields an overload does
+         * not take stay zeroed, so materials made through different overloads never alias.
+         */
+        struct MaterialKey {
+          bool diffuseTextured;
+          bool specularTextured;
+          glm::vec3 ambient;
+          glm::vec3 diffuse;
+          glm::vec3 specular;
+          std::vector< const Texture* > diffuseTextures;
+          std::vector< const Texture* > specularTextures;
+          float shininess;
+          float opacity;
+
+          MaterialKey( const glm::vec3& ambient, float shininess, float opacity );
+          void setDiffuse( const glm::vec3& color );
+          void setDiffuse( const TextureList& textures );
+          void setSpecular( const glm::vec3& color );
+          void setSpecular( const TextureList& textures );
+        };
+        struct MaterialKeyHashCompare {
+          static size_t hash( const MaterialKey& key );
+          static bool equal( const MaterialKey& lhs, const MaterialKey& rhs );
+        };
+
         Utilities::ShaderManager& shaderManager;
-        tbb::concurrent_vector< std::shared_ptr< Material > > materials;
-        std::unordered_map< std::string, std::shared_ptr< Texture > > textures;
-        std::mutex materialsMutex;
+        Utilities::TextureStreamer* textureStreamer;
+        tbb::concurrent_hash_map< MaterialKey, std::shared_ptr< Material >, MaterialKeyHashCompare > materials;
+        // Futures, so that a texture is decoded once and outside the lock while other requests for it wait
+        std::unordered_map< std::string, std::shared_future< std::shared_ptr< Texture > > > textures;
         std::mutex texturesMutex;
-        std::mutex shadersMutex;
 
-        bool listsCongruent( const TextureList& list1, const TextureList& list2 );
+        template< typename Diffuse, typename Specular >
+        std::shared_ptr< Material > getOrCreateMaterial( const MaterialKey& key, const glm::vec3& ambient, const Diffuse& diffuse, const Specular& specular );
 
       public:
-        ResourceBank( Utilities::ShaderManager& shaderManager );
+        ResourceBank( Utilities::ShaderManager& shaderManager, Utilities::TextureStreamer* textureStreamer = nullptr );
 
         std::shared_ptr< Shader > getOrCreateShader( const std::string& vertexPath, const std::string& fragmentPath, bool defer );
 
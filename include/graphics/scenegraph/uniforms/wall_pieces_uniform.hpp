@@ -0,0 +1,54 @@
+#ifndef WALL_PIECES_UNIFORM
+#define WALL_PIECES_UNIFORM
+
+#include "exceptions/genexc.hpp"
+#include "graphics/scenegraph/uniform.hpp"
+#include "graphics/shader.hpp"
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+namespace BlueBear::Graphics::SceneGraph::Uniforms {
+
+	/**
+	 * Per-piece bookkeeping for a merged wall chunk. Each piece keeps its range of the chunk's vertex and index
+	 * buffers, and a sink offset that takes the place of the transform a standalone piece model would animate.
+	 */
+	class WallPiecesUniform : public Uniform {
+	public:
+		static constexpr unsigned int MAX_PIECES = 256;
+
+		struct Piece {
+			// Same id and position as the LevelUniform of a standalone piece ("__horizontal", etc.)
+			std::string id;
+			glm::vec2 position;
+			unsigned int vertexBegin;
+			unsigned int vertexCount;
+			unsigned int indexBegin;
+			unsigned int indexCount;
+		};
+
+	private:
+		std::vector< Piece > pieces;
+		std::vector< float > offsets;
+
+		std::unordered_map< const void*, Shader::Uniform > uniforms;
+
+	public:
+		EXCEPTION_TYPE( TooManyPiecesException, "Too many pieces for one wall chunk" );
+
+		WallPiecesUniform( const std::vector< Piece >& pieces );
+		std::unique_ptr< Uniform > copy() override;
+
+		const std::vector< Piece >& getPieces() const;
+
+		float getOffset( unsigned int piece ) const;
+		void setOffset( unsigned int piece, float offset );
+
+		void send( const Shader& shader ) override;
+	};
+
+}
+
+#endif
@@ -6,6 +6,8 @@
 #include <GL/glew.h>
 #include <string>
 #include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
 #include <unordered_set>
 
 namespace BlueBear {
@@ -18,6 +20,10 @@ namespace BlueBear {
         std::string vertex;
         std::string fragment;
       };
+      // Preprocessed sources waiting for sendDeferred; read ahead of time by prepare()
+      std::unique_ptr< FilePackage > sources;
+      std::mutex sourcesMutex;
+      bool sent = false;
 
       std::string getFile( const std::string& path );
       FilePackage getFilePair();
@@ -41,6 +47,7 @@ namespace BlueBear {
       Shader( const GLchar* vertexPath, const GLchar* fragmentPath );
       Shader( const std::string& vertexPath, const std::string& fragmentPath, bool defer = false );
 
+      void prepare();
       void sendDeferred();
 
       Uniform getUniform( const std::string& id ) const;
@@ -54,6 +61,7 @@ namespace BlueBear {
       void sendData( Uniform uniform, const unsigned int value ) const;
       void sendData( Uniform uniform, const float value ) const;
       void sendData( Uniform uniform, unsigned int size, const GLfloat* value ) const;
+      void sendData1fv( Uniform uniform, unsigned int size, const GLfloat* value ) const;
 
       void use( bool silent = false );
     };
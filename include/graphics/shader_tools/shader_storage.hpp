@@ -0,0 +1,51 @@
+#ifndef CONCORDIA_SHADER_STORAGE
+#define CONCORDIA_SHADER_STORAGE
+
+#include <GL/glew.h>
+#include <utility>
+#include <vector>
+
+namespace BlueBear::Graphics::ShaderTools {
+
+    /**
+     * Shader storage buffer at a fixed binding. The buffer is created on first upload and only respecified when its
+     * contents differ from the last upload, so constructing one needs no GL context.
+     */
+    class ShaderStorage {
+        GLuint binding;
+        GLuint ssbo = 0;
+        std::vector< unsigned char > contents;
+
+    public:
+        ShaderStorage( GLuint binding ) : binding( binding ) {}
+        ShaderStorage( const ShaderStorage& ) = delete;
+        ShaderStorage& operator=( const ShaderStorage& ) = delete;
+
+        ~ShaderStorage() {
+            if( ssbo ) {
+                glDeleteBuffers( 1, &ssbo );
+            }
+        }
+
+        bool update( std::vector< unsigned char > data ) {
+            if( ssbo && data == contents ) {
+                return false;
+            }
+
+            contents = std::move( data );
+            if( !ssbo ) {
+                glGenBuffers( 1, &ssbo );
+            }
+
+            glBindBuffer( GL_SHADER_STORAGE_BUFFER, ssbo );
+                glBufferData( GL_SHADER_STORAGE_BUFFER, contents.size(), contents.data(), GL_DYNAMIC_DRAW );
+            glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 );
+
+            glBindBufferBase( GL_SHADER_STORAGE_BUFFER, binding, ssbo );
+            return true;
+        }
+    };
+
+}
+
+#endif
@@ -11,9 +11,19 @@
 
 namespace BlueBear {
   namespace Graphics {
+    namespace Utilities {
+      class TextureStreamer;
+      class TextureUploader;
+    }
 
     class Texture {
+        friend class Utilities::TextureStreamer;
+
         std::unique_ptr< sf::Image > deferred;
+        // False while a streamed texture still shows the placeholder it doesn't own
+        bool owned = true;
+        // Set once a streamed texture has its own storage, which goes back to the uploader that made it
+        std::shared_ptr< Utilities::TextureUploader > uploader;
 
         Texture( const Texture& );
         Texture& operator=( const Texture& );
@@ -21,16 +31,19 @@ namespace BlueBear {
         void prepareTextureFromImage( const sf::Image& texture );
         void prepareTextureFromData( const glm::uvec2& size, const GLvoid* data );
 
+        Texture( GLuint placeholder );
+
       public:
         EXCEPTION_TYPE( ImageLoadFailureException, "Image could not be loaded!" );
         GLuint id;
 
-        Texture( const sf::Image& texture );
+        Texture( const sf::Image& texture, bool defer = false );
         Texture( const glm::uvec2& dimensions, const GLvoid* data );
         Texture( const std::string& texFromFile, bool defer = false );
         ~Texture();
 
         void sendDeferred();
+        void update( const glm::uvec2& offset, const glm::uvec2& size, const GLvoid* data );
     };
   }
 }
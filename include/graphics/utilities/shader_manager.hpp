@@ -4,12 +4,15 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <mutex>
 
 namespace BlueBear::Graphics{ class Shader; }
 namespace BlueBear::Graphics::Utilities {
 
 	class ShaderManager {
 		std::map< std::pair< std::string, std::string >, std::shared_ptr< Shader > > shaders;
+		// Model loader threads request shaders while the main thread does
+		std::mutex shadersMutex;
 
 		ShaderManager( const ShaderManager& shaderManager ) = delete;
 		ShaderManager& operator=( const ShaderManager& shaderManager ) = delete;
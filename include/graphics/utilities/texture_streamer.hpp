@@ -0,0 +1,110 @@
+#ifndef TEXTURE_STREAMER
+#define TEXTURE_STREAMER
+
+#include <GL/glew.h>
+#include <SFML/Graphics.hpp>
+#include <glm/glm.hpp>
+#include <tbb/task_arena.h>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace BlueBear::Graphics { class Texture; }
+namespace BlueBear::Graphics::Utilities {
+
+	/**
+	 * The GL half of texture streaming: RGBA8 storage, uploaded a band of rows at a time.
+	 */
+	class TextureUploader {
+	public:
+		virtual ~TextureUploader() = default;
+
+		// Storage for a texture of this size; contents undefined until uploaded
+		virtual GLuint create( const glm::uvec2& size ) = 0;
+		// size is the band's width and row count; pixels are tightly packed
+		virtual void upload( GLuint id, unsigned int firstRow, const glm::uvec2& size, const unsigned char* pixels ) = 0;
+		// Every row is in
+		virtual void finish( GLuint id ) = 0;
+		virtual void destroy( GLuint id ) = 0;
+	};
+
+	/**
+	 * Stages each band in an orphaned pixel unpack buffer, so glTexSubImage2D copies from GPU-visible memory and
+	 * returns without waiting on the transfer.
+	 */
+	class PixelBufferUploader : public TextureUploader {
+		GLuint pixelBuffer = 0;
+
+	public:
+		~PixelBufferUploader();
+
+		GLuint create( const glm::uvec2& size ) override;
+		void upload( GLuint id, unsigned int firstRow, const glm::uvec2& size, const unsigned char* pixels ) override;
+		void finish( GLuint id ) override;
+		void destroy( GLuint id ) override;
+	};
+
+	/**
+	 * Decodes image files on worker threads and uploads them on the GL thread within a byte budget per frame.
+	 * Textures handed out by request() show a shared placeholder until their last row is in, then switch over
+	 * in place, so materials built from them need no further attention.
+	 */
+	class TextureStreamer {
+	public:
+		using Decoder = std::function< std::unique_ptr< sf::Image >( const std::string& ) >;
+
+		struct Statistics {
+			unsigned int requested = 0;
+			unsigned int decoded = 0;
+			unsigned int uploaded = 0;
+			unsigned int failed = 0;
+			size_t bytesUploaded = 0;
+		};
+
+	private:
+		struct Job {
+			std::weak_ptr< Texture > texture;
+			std::unique_ptr< sf::Image > image;
+			GLuint id = 0;
+			unsigned int nextRow = 0;
+		};
+
+		// Shared with every finished texture, which hands its storage back on destruction
+		std::shared_ptr< TextureUploader > uploader;
+		Decoder decode;
+		size_t bytesPerFrame;
+		GLuint placeholder;
+		tbb::task_arena arena;
+
+		mutable std::mutex mutex;
+		std::condition_variable decodedCondition;
+		unsigned int decoding = 0;
+		std::deque< Job > decoded;
+		Statistics statistics;
+
+		// GL thread only
+		std::deque< Job > uploading;
+
+		void load( const std::string& path, std::weak_ptr< Texture > texture );
+
+	public:
+		TextureStreamer( std::shared_ptr< TextureUploader > uploader, size_t bytesPerFrame, Decoder decode = decodeFile );
+		~TextureStreamer();
+
+		std::shared_ptr< Texture > request( const std::string& path );
+		size_t update();
+
+		bool isIdle() const;
+		Statistics getStatistics() const;
+		GLuint getPlaceholder() const;
+
+		static std::unique_ptr< sf::Image > decodeFile( const std::string& path );
+	};
+
+}
+
+#endif
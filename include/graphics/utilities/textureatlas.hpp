@@ -27,6 +27,7 @@ namespace BlueBear::Graphics::Utilities {
     };
 
     void addTexture( const std::string& id, std::shared_ptr< sf::Image > image );
+    bool hasTexture( const std::string& id ) const;
     TextureData getTextureData( const std::string& id ) const;
     std::shared_ptr< sf::Image > generateAtlas();
   };
@@ -18,6 +18,10 @@ namespace BlueBear::Models {
     EXCEPTION_TYPE( InvalidWallpaperException, "Wallpaper not found" );
 
     Sides( const Json::Value& sides, Utilities::WorldCache& worldCache );
+    Sides( const std::pair< std::string, Wallpaper >& front, const std::pair< std::string, Wallpaper >& back );
+
+    bool operator==( const Sides& other ) const;
+    bool operator!=( const Sides& other ) const;
   };
 
   struct WallSegment {
@@ -28,6 +32,7 @@ namespace BlueBear::Models {
     EXCEPTION_TYPE( InvalidFormatException, "Invalid format" );
 
     WallSegment( const Json::Value& segment, Utilities::WorldCache& worldCache );
+    WallSegment( const glm::ivec2& start, const glm::ivec2& end, const std::vector< Sides >& faces );
   };
 
 }
@@ -1,7 +1,7 @@
 #ifndef NEW_ENGINE
 #define NEW_ENGINE
 
-#include "containers/reusableobjectvector.hpp"
+#include "containers/timerwheel.hpp"
 #include "containers/visitor.hpp"
 #include "eventmanager.hpp"
 #include "state/substate.hpp"
@@ -21,7 +21,7 @@ namespace BlueBear::Scripting {
     static constexpr const char* SYSTEM_MODPACK_DIRECTORY = "modpacks/system/";
 
     sol::state lua;
-    Containers::ReusableObjectVector< std::pair< int, Callback > > queuedCallbacks;
+    Containers::TimerWheel< Callback > queuedCallbacks;
 
     void setupCoreEnvironment();
 
@@ -4,12 +4,15 @@
 #include "exceptions/genexc.hpp"
 #include "serializable.hpp"
 #include <sol.hpp>
+#include <optional>
+#include <string>
 
 namespace BlueBear::Scripting::EntityKit {
   class Entity;
 
   class Component : public Serializable, public std::enable_shared_from_this< Component > {
     std::string componentId;
+    unsigned int type;
     Entity* entity = nullptr;
 
   protected:
@@ -28,6 +31,10 @@ namespace BlueBear::Scripting::EntityKit {
     void attach( Entity* entity );
 
     const std::string& getId() const;
+    unsigned int getType() const;
+
+    static unsigned int intern( const std::string& componentId );
+    static std::optional< unsigned int > findType( const std::string& componentId );
 
     virtual void init( sol::object object );
     virtual void drop();
@@ -30,6 +30,7 @@ namespace BlueBear::Scripting::EntityKit::Components {
     std::shared_ptr< Graphics::SceneGraph::Model > placeObject( const std::string& modelId, sol::table classes );
     void removeObject( Graphics::SceneGraph::Model& model );
 
+    float getLoadingProgress() const;
     std::vector< std::string > getPotentialModels();
     std::vector< std::pair< std::string, std::shared_ptr< Graphics::SceneGraph::Model > > > getModels() const;
   };
@@ -0,0 +1,51 @@
+#ifndef ENTITYKIT_COMPONENT_TEMPLATE
+#define ENTITYKIT_COMPONENT_TEMPLATE
+
+#include "exceptions/genexc.hpp"
+#include <sol.hpp>
+#include <vector>
+
+namespace BlueBear::Scripting::EntityKit {
+
+  /**
+   * A registered component table compiled once into what instantiate() needs to build each instance: the layout of
+   * every table in it and their default values, held in one constants table. Functions at the top level go into a
+   * prototype shared through the instance's metatable rather than being copied in; every other field, including
+   * nested tables, is the instance's own, as it was with copyTable. The definition is captured as it stands at
+   * compile time.
+   */
+  class ComponentTemplate {
+    struct Field {
+      int key;
+      int value;
+      // Index into layouts when the default is a nested table, otherwise -1
+      int child;
+    };
+
+    struct Layout {
+      int arraySize;
+      int recordSize;
+      std::vector< Field > fields;
+    };
+
+    // layouts[ 0 ] is the component itself
+    std::vector< Layout > layouts;
+    sol::table constants;
+    sol::table metatable;
+    int constantCount = 0;
+
+    int compile( lua_State* L, int constantsIndex, int prototypeIndex, int index, std::vector< const void* >& path );
+    int addConstant( lua_State* L, int constantsIndex );
+    void push( lua_State* L, int constantsIndex, int layout ) const;
+
+  public:
+    EXCEPTION_TYPE( CyclicDefinitionException, "Component definition contains itself!" );
+
+    ComponentTemplate( sol::table definition );
+
+    sol::table instantiate() const;
+  };
+
+}
+
+#endif
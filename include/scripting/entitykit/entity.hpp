@@ -10,15 +10,24 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <optional>
 #include <vector>
 
 namespace BlueBear::Scripting::EntityKit {
 
   class Entity : public std::enable_shared_from_this< Entity > {
+    struct IndexEntry {
+      unsigned int type;
+      Components::ComponentReturn component;
+    };
+
     std::string entityId;
     std::vector< std::shared_ptr< Component > > components;
+    // Sorted by type, attachment order within a type; components already cast for return
+    std::vector< IndexEntry > index;
 
     void associate( Entity* pointer );
+    void addToIndex( const std::shared_ptr< Component >& component );
 
   public:
     static BasicEvent< void*, std::shared_ptr< Entity > > ENTITY_CLOSING;
@@ -37,6 +46,8 @@ namespace BlueBear::Scripting::EntityKit {
     static void submitLuaContributions( sol::state& lua, sol::table types );
 
     std::vector< Components::ComponentReturn > findComponents( const std::string& componentId );
+    std::vector< Components::ComponentReturn > findComponents( unsigned int type );
+    std::optional< Components::ComponentReturn > findComponent( unsigned int type );
   };
 
 }
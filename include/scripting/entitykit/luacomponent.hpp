@@ -17,6 +17,7 @@ namespace BlueBear::Scripting::EntityKit {
 	public:
 		LuaComponent( const std::string& componentId, const sol::table& table );
 
+		Json::Value save() override;
 		void load( const Json::Value& data ) override;
 
 		void init( sol::object object ) override;
@@ -5,19 +5,26 @@
 #include "exceptions/genexc.hpp"
 #include "scripting/entitykit/entity.hpp"
 #include "scripting/entitykit/component.hpp"
+#include "scripting/entitykit/componenttemplate.hpp"
 #include <sol.hpp>
 #include <string>
 #include <optional>
 #include <variant>
 #include <memory>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace BlueBear::Scripting::EntityKit {
 
   class Registry {
+    using NativeComponent = std::shared_ptr< Component >(*)();
+    using ComponentMap = std::unordered_map< std::string, std::variant< NativeComponent, ComponentTemplate > >;
+
     sol::state* engineState;
-    std::map< std::string, sol::table > components;
-    std::map< std::string, std::vector< std::string > > entities;
+    ComponentMap components;
+    // Resolved at registration; unordered_map never moves its elements
+    std::unordered_map< std::string, std::vector< const ComponentMap::value_type* > > entities;
 
     void submitLuaContributions( sol::state& lua );
     void registerComponent( const std::string& id, sol::table table );
@@ -25,6 +32,9 @@ namespace BlueBear::Scripting::EntityKit {
 
     bool entityRegistered( const std::string& id );
     bool componentRegistered( const std::string& id );
+    std::optional< unsigned int > getComponentType( const std::string& id );
+
+    std::shared_ptr< Component > createComponent( const ComponentMap::value_type& registered, sol::object initArgs );
 
   public:
     EXCEPTION_TYPE( InvalidIDException, "Invalid ID!" );
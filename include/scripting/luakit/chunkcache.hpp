@@ -0,0 +1,35 @@
+#ifndef LUA_CHUNK_CACHE
+#define LUA_CHUNK_CACHE
+
+#include <cstdint>
+#include <string>
+
+struct lua_State;
+
+namespace BlueBear::Scripting::LuaKit {
+
+  /**
+   * Precompiled Lua chunks (lua_dump output), one file per source path. An entry is used only when the source's
+   * mtime, content hash and the Lua release all match what was recorded with it; anything else, including a chunk
+   * Lua itself refuses, is compiled from source again and the entry replaced.
+   */
+  class ChunkCache {
+    static constexpr uint32_t VERSION = 1;
+
+    std::string directory;
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+
+  public:
+    ChunkCache( const std::string& directory );
+
+    int load( lua_State* L, const std::string& path );
+    std::string getPath( const std::string& sourcePath ) const;
+
+    unsigned int getHits() const;
+    unsigned int getMisses() const;
+  };
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define NEW_MODPACK_LOADER
 
 #include "bbtypes.hpp"
+#include "scripting/luakit/chunkcache.hpp"
 #include <sol.hpp>
 #include <string>
 #include <map>
@@ -13,6 +14,7 @@ namespace BlueBear::Scripting::LuaKit {
 
     sol::state& lua;
     std::string currentModpackDirectory;
+    ChunkCache chunkCache;
     std::map< std::string, ModpackStatus > loadedModpacks;
 
     bool loadModpack( const std::string& name );
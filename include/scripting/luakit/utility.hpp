@@ -3,6 +3,7 @@
 
 #include "exceptions/genexc.hpp"
 #include "log.hpp"
+#include <jsoncpp/json/json.h>
 #include <sol.hpp>
 #include <functional>
 #include <string>
@@ -13,6 +14,7 @@ namespace BlueBear::Scripting::LuaKit {
 
   struct Utility {
     EXCEPTION_TYPE( InvalidTypeException, "Invalid type!" );
+    EXCEPTION_TYPE( UnserializableValueException, "Value cannot be represented as JSON!" );
 
     template< typename... Args >
     static std::function< void( Args... ) > bagFunction( sol::function f ) {
@@ -27,6 +29,10 @@ namespace BlueBear::Scripting::LuaKit {
     };
 
     static sol::table copyTable( sol::state& lua, sol::table original, bool deep );
+
+    static sol::object jsonToLua( lua_State* L, const Json::Value& value );
+    static Json::Value luaToJson( const sol::object& object );
+    static Json::Value savedToJson( const sol::object& saved );
     static void submitLuaContributions( sol::state& lua );
 
     static std::function< sol::table( sol::table, bool ) > copy;
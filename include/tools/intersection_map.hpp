@@ -3,6 +3,8 @@
 
 #include "tools/vector_hash.hpp"
 #include <glm/glm.hpp>
+#include <functional>
+#include <future>
 #include <unordered_map>
 #include <vector>
 
@@ -19,8 +21,10 @@ namespace BlueBear::Tools::Intersection {
 
 	using IntersectionList = std::vector< IntersectionLineSegment >;
 	using IntersectionMap = std::unordered_map< glm::ivec2, IntersectionList >;
+	using IntersectionCallback = std::function< void( IntersectionList ) >;
 
 	IntersectionList generateIntersectionalList( IntersectionList lineSegments, const glm::ivec2& totalDimensions );
+	std::future< void > generateIntersectionalListAsync( IntersectionList lineSegments, const glm::ivec2& totalDimensions, IntersectionCallback callback );
 
 }
 
@@ -36,4 +40,4 @@ namespace std {
 }
 
 
-#endif
\ No newline at end of file
+#endif
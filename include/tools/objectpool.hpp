@@ -4,7 +4,6 @@
 #include <tbb/concurrent_queue.h>
 #include <functional>
 #include <memory>
-#include <mutex>
 
 namespace BlueBear {
   namespace Tools {
@@ -18,16 +17,9 @@ namespace BlueBear {
       ObjectPool( std::function< std::unique_ptr< Class >() > createMethod ) : createMethod( createMethod ) {}
 
       void acquire( std::function< void( Class& ) > predicate ) {
-        static std::mutex mutex;
-
-        // Acquire or create resource
+        // Acquire or create resource; the queue is already safe to share between threads
         std::unique_ptr< Class > resource;
-        bool obtained;
-        {
-          std::lock_guard< std::mutex > lock( mutex );
-          obtained = pool.try_pop( resource );
-        }
-        if( !obtained ) {
+        if( !pool.try_pop( resource ) ) {
           resource = createMethod();
         }
 
@@ -35,10 +27,7 @@ namespace BlueBear {
         predicate( *resource );
 
         // Replace resource
-        {
-          std::lock_guard< std::mutex > lock( mutex );
-          pool.push( std::move( resource ) );
-        }
+        pool.push( std::move( resource ) );
       }
     };
 
@@ -4,28 +4,35 @@
 #include "tools/vector_hash.hpp"
 #include <glm/glm.hpp>
 #include <unordered_map>
-#include <set>
-#include <list>
+#include <vector>
 
 namespace BlueBear::Tools {
 
 	struct SectorDiscoveryNode {
 		glm::ivec2 position;
-		bool visited = false;
-		struct SectorDiscoveryNode* visitParent = nullptr;
-		std::list< struct SectorDiscoveryNode* > links;
+		// Sorted counterclockwise by direction once sectors are requested
+		std::vector< struct SectorDiscoveryNode* > links;
+		// One flag per link, set once the half-edge leaving through that link has been walked
+		std::vector< bool > walked;
 	};
 
 	using SectorDiscoveryGraph = std::unordered_map< glm::ivec2, SectorDiscoveryNode >;
 	using Sector = std::vector< const SectorDiscoveryNode* >;
 	using SectorBundle = std::vector< Sector >;
 
+	/**
+	 * Finds the rooms enclosed by a planar graph of walls. Each undirected edge is split into two half-edges,
+	 * and every half-edge is walked exactly once, always taking the sharpest left turn. Every walk traces one
+	 * face, so the whole pass is O(E log E) in the number of edges, dominated by sorting links around each node.
+	 */
 	class SectorIdentifier {
 		SectorDiscoveryGraph graph;
 
-		void addSectorToList( SectorBundle& targetSet, const Sector& newSector );
-		SectorBundle getSectors( SectorDiscoveryNode* node, const SectorDiscoveryNode* parent, std::list< const SectorDiscoveryNode* > discovered = {} );
+		static bool directionLess( const glm::ivec2& lhs, const glm::ivec2& rhs );
+		static long long getDoubleArea( const Sector& sector );
 
+		void sortLinks();
+		void addFace( SectorBundle& result, const Sector& walk );
 
 	public:
 		void addEdge( const glm::ivec2& origin, const glm::ivec2& destination );
@@ -9,6 +9,7 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
 #include <thread>
@@ -31,6 +32,8 @@ namespace BlueBear {
 
 				static std::vector< std::string > getSubdirectoryList( const char* rootSubDirectory );
 
+				static bool replaceFile( const std::string& path, const std::vector< std::string_view >& parts );
+
 				static std::vector<std::string> split(const std::string &text, char sep);
 
 				static std::string join( const std::vector< std::string >& strings, const std::string& token );
@@ -55,6 +58,9 @@ namespace BlueBear {
 					return !str[ h ] ? 5381 : ( hash( str, h+1 ) * 33 ) ^ str[ h ];
 				};
 
+				static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+				static uint64_t fnv1a( const void* data, size_t size, uint64_t hash = FNV_OFFSET );
+
 				static std::string decodeUTF8( const std::string& encoded );
 
 				/**
@@ -103,8 +103,7 @@ end
 function Panel:close()
 end
 
-function Panel:load( jsonString )
-  local x = bluebear.util.json.decode( jsonString )
+function Panel:load( saved )
 end
 
 function Panel:save()
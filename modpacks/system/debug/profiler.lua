@@ -2,6 +2,7 @@ local TEST_MODEL = 'bgb'
 local TEST_ANIMATION = 'Armature|ArmatureAction.002'
 local origin = bluebear.util.types.Vec2.new( -9.5, 9.5 )
 local dimensions = bluebear.util.types.Vec2.new( 10.0, 10.0 )
+local MODEL_MANAGER = bluebear.entity.component_type( 'system.component.model_manager' )
 
 local Profiler = {
 	instances = nil
@@ -38,13 +39,7 @@ function Profiler:animate_all()
 end
 
 function Profiler:get_model_manager()
-	local matches = self:get_entity():find_components( 'system.component.model_manager' )
-
-	if #matches > 0 then
-		return matches[ 1 ]
-	else
-		return nil
-	end
+	return self:get_entity():find_component( MODEL_MANAGER )
 end
 
 bluebear.entity.register_component( 'system.component.model_profiler', Profiler )
@@ -17,16 +17,14 @@ function WaterLevel:init( decay_rate )
   )
 end
 
-function WaterLevel:load( jsonString )
-  local saved = bluebear.util.json.decode( jsonString )
-
+function WaterLevel:load( saved )
   self.level = saved.level
 end
 
 function WaterLevel:save()
-  return bluebear.util.json.encode( {
+  return {
     level = self.level
-  } )
+  }
 end
 
 function WaterLevel:close()
@@ -1,6 +1,9 @@
 bluebear.engine.require_modpack( 'component_water' )
 
 -- TEST shit
+local MODEL_MANAGER = bluebear.entity.component_type( 'system.component.model_manager' )
+local INTERACTION_SET = bluebear.entity.component_type( 'system.component.interaction_set' )
+
 local Demo = {
   instance = nil
 }
@@ -13,9 +16,9 @@ function Demo:init()
      local interaction = bluebear.util.types.Interaction.new( "animate", "Animate", bluebear.util.bind( self.play_animation, self ) )
      local interaction2 = bluebear.util.types.Interaction.new( "move", "Move", bluebear.util.bind( self.move_object, self ) )
      local interaction3 = bluebear.util.types.Interaction.new( "remove", "Remove", bluebear.util.bind( self.remove_object, self ) )
-     self:get_entity():find_components( 'system.component.interaction_set' )[ 1 ]:associate_interaction( self.instance, interaction )
-     self:get_entity():find_components( 'system.component.interaction_set' )[ 1 ]:associate_interaction( self.instance, interaction2 )
-     self:get_entity():find_components( 'system.component.interaction_set' )[ 1 ]:associate_interaction( self.instance, interaction3 )
+     self:get_entity():find_component( INTERACTION_SET ):associate_interaction( self.instance, interaction )
+     self:get_entity():find_component( INTERACTION_SET ):associate_interaction( self.instance, interaction2 )
+     self:get_entity():find_component( INTERACTION_SET ):associate_interaction( self.instance, interaction3 )
     end
   end )
 
@@ -44,13 +47,7 @@ function Demo:move_object()
 end
 
 function Demo:get_model_manager()
-  local matches = self:get_entity():find_components( 'system.component.model_manager' )
-
-  if #matches > 0 then
-    return matches[ 1 ]
-  else
-    return nil
-  end
+  return self:get_entity():find_component( MODEL_MANAGER )
 end
 
 bluebear.entity.register_component( 'game.component.plant_keys', Demo )
@@ -35,13 +35,18 @@ namespace BlueBear {
     configRoot[ "wall_texture_size" ] = 48;
     configRoot[ "sector_resolution" ] = 1;
     configRoot[ "bounding_volume_method" ] = "aabb";
+    configRoot[ "model_cache_path" ] = "cache/models";
+    configRoot[ "lua_cache_path" ] = "cache/lua";
+    configRoot[ "model_uploads_per_frame" ] = 8;
+    configRoot[ "texture_upload_bytes_per_frame" ] = 4194304;
     configRoot[ "shader_max_diffuse_textures" ] = 4;
     configRoot[ "shader_max_specular_textures" ] = 4;
-    configRoot[ "shader_max_lights" ] = 16;
-    configRoot[ "shader_max_rooms" ] = 16;
     configRoot[ "shader_room_map_min_width" ] = 1000;
     configRoot[ "shader_room_map_min_height"] = 1000;
+    configRoot[ "shader_room_map_pack_heuristic" ] = "best_short_side_fit";
     configRoot[ "wall_cutaway_animation_speed" ] = 1000;
+    configRoot[ "wall_merged_meshes" ] = false;
+    configRoot[ "wall_chunk_size" ] = 8;
     configRoot[ "shader_grid_selectable_tiles" ] = 32;
     configRoot[ "shader_grid_line_size" ] = 25;
     configRoot[ "debug_console_trim" ] = 50;
@@ -0,0 +1,242 @@
+#include "containers/rectanglepacker.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace BlueBear::Containers {
+
+	bool RectanglePacker::Rectangle::operator==( const Rectangle& rhs ) const {
+		return x == rhs.x && y == rhs.y && width == rhs.width && height == rhs.height;
+	}
+
+	bool RectanglePacker::Rectangle::contains( const Rectangle& rhs ) const {
+		return rhs.x >= x && rhs.y >= y && rhs.x + rhs.width <= x + width && rhs.y + rhs.height <= y + height;
+	}
+
+	bool RectanglePacker::Rectangle::overlaps( const Rectangle& rhs ) const {
+		return rhs.x < x + width && rhs.x + rhs.width > x && rhs.y < y + height && rhs.y + rhs.height > y;
+	}
+
+	RectanglePacker::RectanglePacker( int width, int height, Heuristic heuristic ) : width( width ), height( height ), heuristic( heuristic ) {
+		freeRectangles.emplace_back( Rectangle{ 0, 0, width, height } );
+	}
+
+	RectanglePacker::Heuristic RectanglePacker::getHeuristic( const std::string& name ) {
+		if( name == "best_long_side_fit" ) { return Heuristic::BEST_LONG_SIDE_FIT; }
+		if( name == "best_area_fit" ) { return Heuristic::BEST_AREA_FIT; }
+		if( name == "bottom_left" ) { return Heuristic::BOTTOM_LEFT; }
+
+		if( name != "best_short_side_fit" ) {
+			Log::getInstance().warn( "RectanglePacker::getHeuristic", "Unknown pack heuristic: " + name + ", defaulting to \"best_short_side_fit\"" );
+		}
+
+		return Heuristic::BEST_SHORT_SIDE_FIT;
+	}
+
+	/**
+	 * Lower is better; the second component breaks ties.
+	 */
+	glm::ivec2 RectanglePacker::score( const Rectangle& freeRectangle, int width, int height ) const {
+		int leftoverX = freeRectangle.width - width;
+		int leftoverY = freeRectangle.height - height;
+
+		switch( heuristic ) {
+			case Heuristic::BEST_LONG_SIDE_FIT:
+				return { std::max( leftoverX, leftoverY ), std::min( leftoverX, leftoverY ) };
+			case Heuristic::BEST_AREA_FIT:
+				return { ( freeRectangle.width * freeRectangle.height ) - ( width * height ), std::min( leftoverX, leftoverY ) };
+			case Heuristic::BOTTOM_LEFT:
+				return { freeRectangle.y + height, freeRectangle.x };
+			default:
+				return { std::min( leftoverX, leftoverY ), std::max( leftoverX, leftoverY ) };
+		}
+	}
+
+	void RectanglePacker::splitFreeRectangles( const Rectangle& used ) {
+		std::vector< Rectangle > pieces;
+
+		for( auto it = freeRectangles.begin(); it != freeRectangles.end(); ) {
+			const Rectangle free = *it;
+			if( !free.overlaps( used ) ) {
+				++it;
+				continue;
+			}
+
+			// Up to four maximal pieces of the free rectangle survive around the used one
+			if( used.x > free.x ) {
+				pieces.emplace_back( Rectangle{ free.x, free.y, used.x - free.x, free.height } );
+			}
+			if( used.x + used.width < free.x + free.width ) {
+				pieces.emplace_back( Rectangle{ used.x + used.width, free.y, ( free.x + free.width ) - ( used.x + used.width ), free.height } );
+			}
+			if( used.y > free.y ) {
+				pieces.emplace_back( Rectangle{ free.x, free.y, free.width, used.y - free.y } );
+			}
+			if( used.y + used.height < free.y + free.height ) {
+				pieces.emplace_back( Rectangle{ free.x, used.y + used.height, free.width, ( free.y + free.height ) - ( used.y + used.height ) } );
+			}
+
+			it = freeRectangles.erase( it );
+		}
+
+		freeRectangles.insert( freeRectangles.end(), pieces.begin(), pieces.end() );
+		pruneFreeRectangles();
+	}
+
+	void RectanglePacker::pruneFreeRectangles() {
+		for( size_t i = 0; i < freeRectangles.size(); i++ ) {
+			for( size_t j = i + 1; j < freeRectangles.size(); ) {
+				if( freeRectangles[ j ].contains( freeRectangles[ i ] ) ) {
+					freeRectangles.erase( freeRectangles.begin() + i );
+					i--;
+					break;
+				}
+
+				if( freeRectangles[ i ].contains( freeRectangles[ j ] ) ) {
+					freeRectangles.erase( freeRectangles.begin() + j );
+				} else {
+					j++;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Give a removed rectangle's area back without rebuilding: it joins the free list, as does every strip formed by
+	 * joining it with a free rectangle it touches, and then those strips with their own neighbours. Only rectangles
+	 * around the freed area are examined. The list can miss a maximal rectangle that a rebuild would find, but
+	 * everything on it is free.
+	 */
+	void RectanglePacker::releaseFreeRectangle( const Rectangle& released ) {
+		std::vector< Rectangle > pending{ released };
+
+		while( !pending.empty() ) {
+			Rectangle candidate = pending.back();
+			pending.pop_back();
+
+			if( std::any_of( freeRectangles.begin(), freeRectangles.end(), [ & ]( const Rectangle& free ) { return free.contains( candidate ); } ) ) {
+				continue;
+			}
+			freeRectangles.erase(
+				std::remove_if( freeRectangles.begin(), freeRectangles.end(), [ & ]( const Rectangle& free ) { return candidate.contains( free ); } ),
+				freeRectangles.end()
+			);
+
+			for( const Rectangle& free : freeRectangles ) {
+				int left = std::min( candidate.x, free.x );
+				int right = std::max( candidate.x + candidate.width, free.x + free.width );
+				int top = std::min( candidate.y, free.y );
+				int bottom = std::max( candidate.y + candidate.height, free.y + free.height );
+				int overlapX = std::min( candidate.x + candidate.width, free.x + free.width ) - std::max( candidate.x, free.x );
+				int overlapY = std::min( candidate.y + candidate.height, free.y + free.height ) - std::max( candidate.y, free.y );
+
+				// Touching or overlapping side by side: the shared rows span both
+				if( overlapX >= 0 && overlapY > 0 ) {
+					pending.emplace_back( Rectangle{ left, std::max( candidate.y, free.y ), right - left, overlapY } );
+				}
+				// Likewise one above the other: the shared columns span both
+				if( overlapY >= 0 && overlapX > 0 ) {
+					pending.emplace_back( Rectangle{ std::max( candidate.x, free.x ), top, overlapX, bottom - top } );
+				}
+			}
+
+			freeRectangles.emplace_back( candidate );
+		}
+	}
+
+	/**
+	 * Free space is recomputed from the placed rectangles, which stay where they are.
+	 */
+	void RectanglePacker::rebuildFreeRectangles() {
+		freeRectangles = { Rectangle{ 0, 0, width, height } };
+
+		for( const Rectangle& used : usedRectangles ) {
+			splitFreeRectangles( used );
+		}
+	}
+
+	std::optional< RectanglePacker::Rectangle > RectanglePacker::insert( int width, int height ) {
+		if( width <= 0 || height <= 0 ) {
+			return Rectangle{ 0, 0, std::max( width, 0 ), std::max( height, 0 ) };
+		}
+
+		std::optional< Rectangle > best;
+		glm::ivec2 bestScore{ std::numeric_limits< int >::max(), std::numeric_limits< int >::max() };
+		for( const Rectangle& free : freeRectangles ) {
+			if( width <= free.width && height <= free.height ) {
+				glm::ivec2 current = score( free, width, height );
+				if( current.x < bestScore.x || ( current.x == bestScore.x && current.y < bestScore.y ) ) {
+					bestScore = current;
+					best = Rectangle{ free.x, free.y, width, height };
+				}
+			}
+		}
+
+		if( best ) {
+			usedRectangles.emplace_back( *best );
+			usedArea += ( long ) width * height;
+			splitFreeRectangles( *best );
+		}
+
+		return best;
+	}
+
+	bool RectanglePacker::remove( const Rectangle& rectangle ) {
+		auto it = std::find( usedRectangles.begin(), usedRectangles.end(), rectangle );
+		if( it == usedRectangles.end() ) {
+			return false;
+		}
+
+		usedRectangles.erase( it );
+		usedArea -= ( long ) rectangle.width * rectangle.height;
+		releaseFreeRectangle( rectangle );
+		return true;
+	}
+
+	/**
+	 * Grow the bin until a width x height rectangle could fit: stretch any side that is too short for it,
+	 * otherwise double the shorter side.
+	 */
+	void RectanglePacker::grow( int width, int height ) {
+		if( width > this->width || height > this->height ) {
+			this->width = std::max( this->width, width );
+			this->height = std::max( this->height, height );
+		} else if( this->width <= this->height ) {
+			this->width = std::max( this->width * 2, 1 );
+		} else {
+			this->height = std::max( this->height * 2, 1 );
+		}
+
+		rebuildFreeRectangles();
+	}
+
+	int RectanglePacker::getWidth() const {
+		return width;
+	}
+
+	int RectanglePacker::getHeight() const {
+		return height;
+	}
+
+	glm::ivec2 RectanglePacker::getUsedExtent() const {
+		glm::ivec2 result{ 0, 0 };
+		for( const Rectangle& used : usedRectangles ) {
+			result = glm::max( result, glm::ivec2{ used.x + used.width, used.y + used.height } );
+		}
+
+		return result;
+	}
+
+	/**
+	 * Fraction of the used extent covered by placed rectangles.
+	 */
+	double RectanglePacker::getOccupancy() const {
+		glm::ivec2 extent = getUsedExtent();
+		return extent.x && extent.y ? usedArea / ( ( double ) extent.x * extent.y ) : 0.0;
+	}
+
+	const std::vector< RectanglePacker::Rectangle >& RectanglePacker::getUsedRectangles() const {
+		return usedRectangles;
+	}
+
+}
@@ -10,14 +10,10 @@
 #include "graphics/scenegraph/modelloader/filemodelloader.hpp"
 #include "graphics/scenegraph/modelloader/assimpmodelloader.hpp"
 #include "graphics/scenegraph/uniforms/highlight_uniform.hpp"
-#include "tools/objectpool.hpp"
 #include "tools/utility.hpp"
 #include "scripting/luakit/utility.hpp"
 #include "configmanager.hpp"
 #include "log.hpp"
-#include <tbb/concurrent_unordered_map.h>
-#include <tbb/task_group.h>
-#include <tbb/concurrent_queue.h>
 #include <functional>
 #include <mutex>
 
@@ -30,10 +26,12 @@ namespace BlueBear {
           WorldRenderer::WorldRenderer( Device::Display::Display& display, Graphics::Utilities::ShaderManager& shaderManager ) :
             Adapter::Adapter( display ),
             camera( Graphics::Camera( ConfigManager::getInstance().getIntValue( "viewport_x" ), ConfigManager::getInstance().getIntValue( "viewport_y" ) ) ),
-            shaderManager( shaderManager ), cache( shaderManager ) {
+            shaderManager( shaderManager ),
+            textureStreamer( std::make_unique< Graphics::Utilities::PixelBufferUploader >(), ConfigManager::getInstance().getIntValue( "texture_upload_bytes_per_frame" ) ),
+            cache( shaderManager, &textureStreamer ),
+            loadScheduler( std::make_unique< Graphics::SceneGraph::ModelLoader::LoadScheduler >( std::bind( &WorldRenderer::getFileModelLoader, this, true ) ) ),
+            uploadsPerFrame( ConfigManager::getInstance().getIntValue( "model_uploads_per_frame" ) ) {
               eventManager.LUA_STATE_READY.listen( this, std::bind( &WorldRenderer::submitLuaContributions, this, std::placeholders::_1 ) );
-
-              asyncTasks.setAmountPerFrame( 3000 );
             }
 
           WorldRenderer::~WorldRenderer() {
@@ -73,6 +71,44 @@ namespace BlueBear {
               loadPaths( models );
             } );
 
+            world.set_function( "get_render_statistics", [ this, &lua ]() {
+              const Graphics::SceneGraph::RenderQueue::Statistics& statistics = getRenderStatistics();
+
+              return lua.create_table_with(
+                "submitted", statistics.submitted,
+                "culled", statistics.culled,
+                "draw_calls", statistics.drawCalls,
+                "shader_changes", statistics.shaderChanges,
+                "material_changes", statistics.materialChanges,
+                "mesh_changes", statistics.meshChanges,
+                "uniform_changes", statistics.uniformChanges
+              );
+            } );
+
+            world.set_function( "get_loading_progress", [ this, &lua ]() {
+              Graphics::SceneGraph::ModelLoader::LoadScheduler::Progress progress = getLoadingProgress();
+
+              return lua.create_table_with(
+                "requested", progress.requested,
+                "parsed", progress.parsed,
+                "uploaded", progress.uploaded,
+                "failed", progress.failed,
+                "fraction", progress.getFraction()
+              );
+            } );
+
+            world.set_function( "get_texture_statistics", [ this, &lua ]() {
+              Graphics::Utilities::TextureStreamer::Statistics statistics = getTextureStatistics();
+
+              return lua.create_table_with(
+                "requested", statistics.requested,
+                "decoded", statistics.decoded,
+                "uploaded", statistics.uploaded,
+                "failed", statistics.failed,
+                "bytes_uploaded", statistics.bytesUploaded
+              );
+            } );
+
             Graphics::SceneGraph::Model::submitLuaContributions( lua );
           }
 
@@ -128,24 +164,14 @@ namespace BlueBear {
 
             Geometry::Ray ray = camera.getPickingRay( metadata.mouseLocation, display.getDimensions() );
 
-            std::vector< const ModelRegistration* > candidates = getModels();
-            std::vector< const ModelRegistration* > relevant;
-            for( const ModelRegistration* registration : candidates ) {
-              if( registration->instance->intersectsBoundingVolume( ray ) ) {
-                relevant.emplace_back( registration );
-              }
-            }
-
-            getModelAtMouse( ray, relevant, [ this, metadata ]( const ModelRegistration* found ) {
-              if( found ) {
-                auto it = found->events.find( "mouse-down" );
-                if( it != found->events.end() ) {
-                  for( const auto& f : it->second ) {
-                    if( f ) { f( metadata, found->instance ); }
-                  }
+            if( const ModelRegistration* found = getModelAtMouse( ray ) ) {
+              auto it = found->events.find( "mouse-down" );
+              if( it != found->events.end() ) {
+                for( const auto& f : it->second ) {
+                  if( f ) { f( metadata, found->instance ); }
                 }
               }
-            } );
+            }
           }
 
           void WorldRenderer::onMouseUp( Device::Input::Metadata metadata ) {
@@ -156,24 +182,14 @@ namespace BlueBear {
 
             Geometry::Ray ray = camera.getPickingRay( metadata.mouseLocation, display.getDimensions() );
 
-            std::vector< const ModelRegistration* > candidates = getModels();
-            std::vector< const ModelRegistration* > relevant;
-            for( const ModelRegistration* registration : candidates ) {
-              if( registration->instance->intersectsBoundingVolume( ray ) ) {
-                relevant.emplace_back( registration );
-              }
-            }
-
-            getModelAtMouse( ray, relevant, [ this, metadata ]( const ModelRegistration* found ) {
-              if( found ) {
-                auto it = found->events.find( "mouse-up" );
-                if( it != found->events.end() ) {
-                  for( const auto& f : it->second ) {
-                    if( f ) { f( metadata, found->instance ); }
-                  }
+            if( const ModelRegistration* found = getModelAtMouse( ray ) ) {
+              auto it = found->events.find( "mouse-up" );
+              if( it != found->events.end() ) {
+                for( const auto& f : it->second ) {
+                  if( f ) { f( metadata, found->instance ); }
                 }
               }
-            } );
+            }
           }
 
           void WorldRenderer::onMouseMoved( Device::Input::Metadata metadata ) {
@@ -182,103 +198,40 @@ namespace BlueBear {
               return;
             }
 
-            static bool inProgress = false;
-            if( inProgress ) {
-              return;
-            }
-
-            inProgress = true;
-
-            std::vector< const ModelRegistration* > candidates = getModels();
-
             Geometry::Ray ray = camera.getPickingRay( metadata.mouseLocation, display.getDimensions() );
 
-            // Create a "relevant" list only for items which intersect the bounding volume
-            std::vector< const ModelRegistration* > relevant;
-            for( const ModelRegistration* registration : candidates ) {
-              if( registration->instance->intersectsBoundingVolume( ray ) ) {
-                relevant.emplace_back( registration );
-              }
-            }
-
-            getModelAtMouse( ray, relevant, [ this, metadata ]( const ModelRegistration* found ) {
-              fireInOutEvents( found, metadata );
-              inProgress = false;
-            } );
+            fireInOutEvents( getModelAtMouse( ray ), metadata );
           }
 
-          std::vector< const WorldRenderer::ModelRegistration* > WorldRenderer::getModels() {
-            std::vector< const ModelRegistration* > result;
-
-            for( const auto& registration : models ) {
-              if( registration ) {
-                  result.emplace_back( registration.get() );
-              }
-            }
-
-            return result;
-          }
-
-          void WorldRenderer::getModelAtMouse(
-            const Geometry::Ray& ray,
-            const std::vector< const ModelRegistration* >& candidateModels,
-            const std::function< void( const ModelRegistration* ) >& callback
-          ) {
-            struct ModelTriangle {
-              std::pair< Geometry::Triangle, glm::mat4 > modelTriangle;
-              const ModelRegistration* registration;
-            };
-
-            std::vector< ModelTriangle > modelTriangles;
-            for( const ModelRegistration* registration : candidateModels ) {
-              auto trianglePairs = registration->instance->getModelTriangles();
-              // Unzip triangles
-              for( const auto& trianglePair : trianglePairs ) {
-                modelTriangles.emplace_back( ModelTriangle{ trianglePair, registration } );
-              }
-            }
-
-            struct HeapObject {
-              const ModelRegistration* result = nullptr;
-              float lastDistance = std::numeric_limits< float >::max();
-            };
-            std::shared_ptr< HeapObject > heap = std::make_shared< HeapObject >();
-
-            std::vector< Tools::AsyncTable::Task > tasks;
-            for( const auto& candidate : modelTriangles ) {
-              tasks.emplace_back( [ heap, ray, candidate ]() {
-                Geometry::Triangle triangle{
-                  candidate.modelTriangle.second * glm::vec4{ candidate.modelTriangle.first[ 0 ], 1.0f },
-                  candidate.modelTriangle.second * glm::vec4{ candidate.modelTriangle.first[ 1 ], 1.0f },
-                  candidate.modelTriangle.second * glm::vec4{ candidate.modelTriangle.first[ 2 ], 1.0f }
-                };
-
-                if( auto potentialIntersection = Geometry::getIntersectionPoint( ray, triangle ) ) {
-                  float distance = Tools::Utility::distance( ray.origin, *potentialIntersection );
-                  if( distance < heap->lastDistance ) {
-                    heap->lastDistance = distance;
-                    heap->result = candidate.registration;
-                  }
+          const WorldRenderer::ModelRegistration* WorldRenderer::getModelAtMouse( const Geometry::Ray& ray ) {
+            if( std::shared_ptr< Graphics::SceneGraph::Model > found = picker.pick( ray ) ) {
+              for( const auto& registration : models ) {
+                if( registration && registration->instance == found ) {
+                  return registration.get();
                 }
-              } );
+              }
             }
 
-            asyncTasks.enqueue( tasks, [ heap, callback ]() {
-              if( callback ) {
-                callback( heap->result );
-              }
-            } );
+            return nullptr;
           }
 
           std::shared_ptr< Graphics::SceneGraph::Model > WorldRenderer::placeObject( const std::string& objectId, const std::set< std::string >& classes ) {
             auto it = originals.find( objectId );
 
+            // Placed before its turn in the upload queue: wait for just this model instead of failing
+            if( it == originals.end() && loadScheduler->isPending( objectId ) ) {
+              if( std::shared_ptr< Graphics::SceneGraph::Model > model = loadScheduler->finish( objectId ) ) {
+                it = originals.emplace( objectId, model ).first;
+              }
+            }
+
             if( it != originals.end() ) {
               std::shared_ptr< Graphics::SceneGraph::Model > copy = it->second->copy();
 
               std::unique_ptr< ModelRegistration > registration = std::make_unique< ModelRegistration >( ModelRegistration{ objectId, classes, copy, {} } );
 
               models.emplace_back( std::move( registration ) );
+              picker.insert( copy );
               MODEL_ADDED.trigger( copy );
 
               return copy;
@@ -330,6 +283,7 @@ namespace BlueBear {
                 }
 
                 models.erase( it );
+                picker.remove( model );
                 MODEL_REMOVED.trigger( model );
                 return;
               } else {
@@ -391,6 +345,10 @@ namespace BlueBear {
             return camera;
           }
 
+          const Graphics::SceneGraph::RenderQueue::Statistics& WorldRenderer::getRenderStatistics() const {
+            return renderQueue.getStatistics();
+          }
+
           std::unique_ptr< Graphics::SceneGraph::ModelLoader::FileModelLoader > WorldRenderer::getFileModelLoader( bool deferGLOperations ) {
             std::unique_ptr< Graphics::SceneGraph::ModelLoader::FileModelLoader > result = std::make_unique< Graphics::SceneGraph::ModelLoader::AssimpModelLoader >( shaderManager );
 
@@ -401,40 +359,29 @@ namespace BlueBear {
             return result;
           }
 
-          void WorldRenderer::loadPathsParallel( const std::vector< std::pair< std::string, std::string > >& paths ) {
-            tbb::concurrent_unordered_map< std::string, std::shared_ptr< Graphics::SceneGraph::Model > > concurrentOriginals;
-            tbb::task_group group;
-            Tools::ObjectPool< Graphics::SceneGraph::ModelLoader::FileModelLoader > pool( std::bind( &WorldRenderer::getFileModelLoader, this, true ) );
-
-            for( auto& path : paths ) {
-              group.run( [ & ]() {
-                if( concurrentOriginals.find( path.first ) == concurrentOriginals.end() ) {
-                  pool.acquire( [ & ]( Graphics::SceneGraph::ModelLoader::FileModelLoader& loader ) {
-                    try {
-                      if( std::shared_ptr< Graphics::SceneGraph::Model > model = loader.get( path.second ) ) {
-                        concurrentOriginals[ path.first ] = model;
-                      }
-                    } catch( std::exception& e ) {
-                      Log::getInstance().error( "WorldRenderer::loadPathsParallel", std::string( "Could not load model " ) + path.second + ": " + e.what() );
-                    }
-                  } );
-                } else {
-                  Log::getInstance().warn( "WorldRenderer::loadPathsParallel", path.first + " is already inserted into this map; skipping" );
-                }
-              } );
-            }
+          Graphics::SceneGraph::ModelLoader::LoadScheduler::Progress WorldRenderer::getLoadingProgress() const {
+            return loadScheduler->getProgress();
+          }
 
-            group.wait();
+          Graphics::Utilities::TextureStreamer::Statistics WorldRenderer::getTextureStatistics() const {
+            return textureStreamer.getStatistics();
+          }
 
+          /**
+           * Models are parsed on worker threads and uploaded a few per frame from nextFrame.
+           */
+          void WorldRenderer::loadPathsAsync( const std::vector< std::pair< std::string, std::string > >& paths ) {
             for( auto& path : paths ) {
-              auto pair = concurrentOriginals.find( path.first );
-              if( pair != concurrentOriginals.end() ) {
-                pair->second->sendDeferredObjects();
+              if( !loadScheduler->enqueue( path.first, path.second ) ) {
+                Log::getInstance().warn( "WorldRenderer::loadPathsAsync", path.first + " is already being loaded; skipping" );
               }
             }
+          }
 
-            // Copy concurrent map to originals
-            for( auto& pair : concurrentOriginals ) {
+          void WorldRenderer::loadPathsParallel( const std::vector< std::pair< std::string, std::string > >& paths ) {
+            loadPathsAsync( paths );
+
+            for( auto& pair : loadScheduler->finishAll() ) {
               originals.emplace( pair.first, pair.second );
             }
           }
@@ -462,72 +409,37 @@ namespace BlueBear {
             originals[ id ] = model;
           }
 
-          void WorldRenderer::drawTree( const Graphics::SceneGraph::Model* model, WorldRenderer::ModelPushdown pushdown ) {
-            pushdown.levelTransform *= model->getLocalTransform().getMatrix();
-
-            // Do the draw
-            for( const auto& pair : model->getUniforms() ) {
-              pair.second->update();
-              Graphics::Shader::SHADER_CHANGE.listen( pair.second.get(), [ ptr = pair.second.get() ]( const Graphics::Shader& shader ) {
-                ptr->send( shader );
-              } );
-            }
-
-            for( const Graphics::SceneGraph::Drawable& drawable : model->getDrawableList() ) {
-              if( drawable ) {
-                drawable.shader->use();
-                if( pushdown.bones ) {
-                  auto it = drawable.mesh->meshUniforms.find( "bone" );
-                  if( it != drawable.mesh->meshUniforms.end() ) {
-                    Graphics::SceneGraph::Mesh::BoneUniform* boneUniform = ( Graphics::SceneGraph::Mesh::BoneUniform* ) it->second.get();
-                    boneUniform->configure( *pushdown.bones );
-                  }
-                }
-                drawable.shader->sendData( modelUniforms.getUniforms( *drawable.shader ).transformUniform, pushdown.levelTransform );
-                drawable.material->send( *drawable.shader );
-                drawable.mesh->drawElements( *drawable.shader );
-                drawable.material->releaseTextureUnits();
-              }
-            }
-
-            for( const auto& child : model->getChildren() ) {
-              drawTree( child.get(), pushdown );
-            }
-
-            for( const auto& pair : model->getUniforms() ) {
-              Graphics::Shader::SHADER_CHANGE.stopListening( pair.second.get() );
-            }
-          }
-
-          /**
-           * TODO: Optimized renderer that sorts by shader to minimize shader changes
-           */
           void WorldRenderer::nextFrame() {
-            asyncTasks.update();
-
             if( mouseNavigator ) {
               mouseNavigator->updateCamera();
             }
 
+            for( auto& pair : loadScheduler->collect( uploadsPerFrame ) ) {
+              originals[ pair.first ] = pair.second;
+            }
+            textureStreamer.update();
+
             // Position camera
             camera.position();
 
+            renderQueue.begin( camera.getViewProjection() );
             for( auto& registration : models ) {
               if( registration ) {
-                //registration->instance->draw();
-                ModelPushdown pushdown{ nullptr, glm::mat4( 1.0f ) };
-                if( const auto& animator = registration->instance->getAnimator() ) {
+                const auto& animator = registration->instance->getAnimator();
+                if( animator ) {
                   if( animator->updating() ) {
                     registration->instance->invalidateBoundingVolume();
                   }
 
                   animator->update();
-                  pushdown.bones = &animator->getComputedMatrices();
                 }
 
-                drawTree( registration->instance.get(), pushdown );
+                renderQueue.submit( *registration->instance, animator.get() );
               }
             }
+
+            renderQueue.sort();
+            renderQueue.draw();
           }
 
         }
@@ -10,8 +10,7 @@
 #include "application.hpp"
 #include "configmanager.hpp"
 #include <bezier.hpp>
-#include <unordered_set>
-#include <glm/gtx/string_cast.hpp>
+#include <algorithm>
 
 namespace BlueBear::Gameplay {
 
@@ -19,34 +18,6 @@ namespace BlueBear::Gameplay {
 		return { origin.x + value.x, origin.y - value.y };
 	}
 
-	static std::vector< std::shared_ptr< Graphics::SceneGraph::Model > > findByCell(
-		const std::vector< std::shared_ptr< Graphics::SceneGraph::Model > >& list,
-		const glm::vec2& direction,
-		const glm::vec2& cell,
-		int currentLevel
-	) {
-		std::vector< std::shared_ptr< Graphics::SceneGraph::Model > > result;
-		std::string match;
-
-		if( direction == glm::vec2{ 1.0f, 0.0f } ) {
-			match = "__horizontal";
-		} else if ( direction == glm::vec2{ 0.0f, -1.0f } ) {
-			match = "__vertical";
-		} else if ( direction == glm::vec2{ 1.0f, -1.0f } ) {
-			match = "__diagonal";
-		} else if ( direction == glm::vec2{ 1.0f, 1.0f } ) {
-			match = "__reverseDiagonal";
-		}
-
-		std::copy_if( list.begin(), list.end(), std::back_inserter( result ), [ & ]( const std::shared_ptr< Graphics::SceneGraph::Model >& model ) {
-			Graphics::SceneGraph::Uniforms::LevelUniform* uniform = ( Graphics::SceneGraph::Uniforms::LevelUniform* ) model->getUniform( "level" );
-
-			return model->getId() == match && uniform->getLevel() == currentLevel && uniform->getPosition() == cell;
-		} );
-
-		return result;
-	}
-
 	InfrastructureManager::InfrastructureManager( State::State& state ) : State::Substate( state ) {}
 
 	InfrastructureManager::~InfrastructureManager() {
@@ -78,21 +49,37 @@ namespace BlueBear::Gameplay {
 			}
 		}
 
-		generateWallRig();
-		generateFloorRig();
-
 		auto& worldRenderer = state.as< State::HouseholdGameplayState >().getWorldRenderer();
 
-		worldRenderer.loadDirect( "__floorrig", floorModel );
-		worldRenderer.loadDirect( "__wallrig", wallModel );
+		if( wallModelLoader ) {
+			// Infrastructure was reloaded over placed rigs: swap out the floors and patch the walls in place
+			currentLevel = std::min( currentLevel, ( int ) model.getLevels().size() - 1 );
 
-		worldRenderer.placeObject( "__floorrig", {} );
-		worldRenderer.placeObject( "__wallrig", {} );
+			for( std::shared_ptr< Graphics::SceneGraph::Model > floorRigInstance : worldRenderer.findObjectsByType( "__floorrig" ) ) {
+				worldRenderer.removeObject( floorRigInstance );
+			}
 
-		generateRooms();
+			generateFloorRig();
+			worldRenderer.loadDirect( "__floorrig", floorModel );
+			worldRenderer.placeObject( "__floorrig", {} );
 
-		hideUpperLevels();
-		updateWallMode();
+			updateWallRig();
+		} else {
+			generateWallRig();
+			generateFloorRig();
+
+			worldRenderer.loadDirect( "__floorrig", floorModel );
+			worldRenderer.loadDirect( "__wallrig", wallModel );
+
+			worldRenderer.placeObject( "__floorrig", {} );
+			worldRenderer.placeObject( "__wallrig", {} );
+
+			indexWallPanels();
+			generateRooms();
+
+			hideUpperLevels();
+			updateWallMode();
+		}
 
 		const glm::ivec2& dimensions = model.getLevels()[ currentLevel ].dimensions;
 		grid.setParams( { -( dimensions.x * 0.5f ), -( dimensions.y * 0.5f ) }, { dimensions.x, dimensions.y } );
@@ -103,14 +90,43 @@ namespace BlueBear::Gameplay {
 	void InfrastructureManager::generateWallRig() {
 		Graphics::Vector::Renderer vectorRenderer( state.as< State::HouseholdGameplayState >().getApplication().getDisplayDevice() );
 
-		Graphics::SceneGraph::ModelLoader::WallModelLoader wallModelLoader(
+		wallModelLoader = std::make_unique< Graphics::SceneGraph::ModelLoader::WallModelLoader >(
 			model.getLevels(),
 			vectorRenderer,
 			state.as< State::HouseholdGameplayState >().getShaderManager()
 		);
-		wallModel = wallModelLoader.get();
+		wallModel = wallModelLoader->get();
+
+		activeWallAnims.clear();
+	}
+
+	/**
+	 * Patch the placed wall rig after the wall segments of the infrastructure model were edited or reloaded
+	 */
+	void InfrastructureManager::updateWallRig() {
+		std::shared_ptr< Graphics::SceneGraph::Model > wallRigInstance = state.as< State::HouseholdGameplayState >().getWorldRenderer().findObjectsByType( "__wallrig" )[ 0 ];
+		wallModelLoader->update( *wallRigInstance );
 
+		// Replaced pieces may still be keyed here
 		activeWallAnims.clear();
+		indexWallPanels();
+
+		generateRooms();
+		hideUpperLevels();
+		updateWallMode();
+	}
+
+	/**
+	 * Rebuild the cell grid over the placed wall rig, one per level
+	 */
+	void InfrastructureManager::indexWallPanels() {
+		std::shared_ptr< Graphics::SceneGraph::Model > wallRigInstance = state.as< State::HouseholdGameplayState >().getWorldRenderer().findObjectsByType( "__wallrig" )[ 0 ];
+		const auto& levels = wallRigInstance->getChildren();
+
+		wallPanels.clear();
+		for( size_t i = 0; i != levels.size(); i++ ) {
+			wallPanels.emplace_back( *levels[ i ], model.getLevels()[ i ].dimensions );
+		}
 	}
 
 	void InfrastructureManager::generateFloorRig() {
@@ -130,7 +146,7 @@ namespace BlueBear::Gameplay {
 			if( pair.second.currentFrame <= pair.second.maxFrames ) {
 				float step = ( float ) pair.second.currentFrame / ( float ) pair.second.maxFrames;
 				float span = pair.second.destination - pair.second.source;
-				pair.first->getLocalTransform().setPosition( { 0.0f, 0.0f, pair.second.source + ( span * cubicBezier.valueAt( step ).y ) } );
+				pair.first.setOffset( pair.second.source + ( span * cubicBezier.valueAt( step ).y ) );
 				pair.second.currentFrame++;
 
 				++it;
@@ -140,8 +156,8 @@ namespace BlueBear::Gameplay {
 		}
 	}
 
-	void InfrastructureManager::enqueueAnimation( Graphics::SceneGraph::Model* key, const InfrastructureManager::Animation&& animation ) {
-		float source = key->getLocalTransform().getPosition().z;
+	void InfrastructureManager::enqueueAnimation( const WallPanel& key, const InfrastructureManager::Animation&& animation ) {
+		float source = key.getOffset();
 
 		auto it = activeWallAnims.find( key );
 		if( it == activeWallAnims.end() ) {
@@ -178,13 +194,9 @@ namespace BlueBear::Gameplay {
 	 */
 	void InfrastructureManager::hideUpperLevels() {
 		static int numFrames = ConfigManager::getInstance().getIntValue( "fps_overview" ) * ( ( float ) ConfigManager::getInstance().getIntValue( "wall_cutaway_animation_speed" ) / 1000.0f );
-		std::shared_ptr< Graphics::SceneGraph::Model > wallRigInstance = state.as< State::HouseholdGameplayState >().getWorldRenderer().findObjectsByType( "__wallrig" )[ 0 ];
-		const auto& levels = wallRigInstance->getChildren();
-
-		for( size_t i = currentLevel + 1; i < levels.size(); i++ ) {
-			const auto& level = levels[ i ]->getChildren();
-			for( const auto& wall : level ) {
-				enqueueAnimation( wall.get(), { 0, numFrames, -4.0f } );
+		for( size_t i = currentLevel + 1; i < wallPanels.size(); i++ ) {
+			for( const WallPanel& wall : wallPanels[ i ].getPanels() ) {
+				enqueueAnimation( wall, { 0, numFrames, -4.0f } );
 			}
 		}
 	}
@@ -198,69 +210,24 @@ namespace BlueBear::Gameplay {
 	 */
 	void InfrastructureManager::setWallCutaways() {
 		static int numFrames = ConfigManager::getInstance().getIntValue( "fps_overview" ) * ( ( float ) ConfigManager::getInstance().getIntValue( "wall_cutaway_animation_speed" ) / 1000.0f );
-		std::shared_ptr< Graphics::SceneGraph::Model > wallRigInstance = state.as< State::HouseholdGameplayState >().getWorldRenderer().findObjectsByType( "__wallrig" )[ 0 ];
 		const auto& camera = state.as< State::HouseholdGameplayState >().getWorldRenderer().getCamera();
-		auto& roomLevel = rooms[ currentLevel ];
-		auto& segments = wallRigInstance->getChildren()[ currentLevel ]->getChildren();
-
-		std::unordered_set< Graphics::SceneGraph::Model* > selectedSegments;
-
-		// For each room on the current level, walk its walls in the winding direction and set the walls to animate down to -z3.75
-		// if the angle of the wall is between 135 and 225 relative to the camera.
-		for( auto& room : roomLevel ) {
-			const auto& normals = room.getWallNormals();
-			for( const auto& wall : normals ) {
-				float angle = Tools::Utility::positiveAngle(
-					Tools::Utility::positiveAngle( glm::degrees( glm::atan( wall.perpendicular.y, wall.perpendicular.x ) ) ) +
-					camera.getRotationAngle()
-				);
-
-				Log::getInstance().debug(
-					"InfrastructureManager::setWallCutaways",
-					"segment from " + glm::to_string( wall.segment.first ) + " to " + glm::to_string( wall.segment.second ) +
-					" direction: " + glm::to_string( wall.direction ) + " perpendicular: " + glm::to_string( wall.perpendicular ) + " // angle: " + std::to_string( angle )
-				);
+		const WallPanelIndex& index = wallPanels[ currentLevel ];
 
-				if( angle >= 225.0f && angle <= 315.0f ) {
-					glm::vec2 start;
-					glm::vec2 finish;
-					glm::vec2 direction;
-					if( wall.direction == glm::vec2{ -1.0f, 0.0f } || wall.direction == glm::vec2{ 0.0f, 1.0f } || wall.direction == glm::vec2{ -1.0f, -1.0f } || wall.direction == glm::vec2{ -1.0f, 1.0f } ) {
-						start = wall.segment.second;
-						finish = wall.segment.first;
-						direction = glm::vec2{ -wall.direction.x, -wall.direction.y };
-					} else {
-						start = wall.segment.first;
-						finish = wall.segment.second;
-						direction = wall.direction;
-					}
-
-					int totalSteps = std::abs( glm::distance( finish, start ) );
-					glm::vec2 cursor = start;
-					for( int i = 0; i < totalSteps; i++ ) {
-						auto matchingSides = findByCell( segments, direction, cursor, currentLevel );
-						for( const auto& match : matchingSides ) {
-							selectedSegments.insert( match.get() );
-							enqueueAnimation( match.get(), { 0, numFrames, -3.75f } );
-						}
-
-						cursor += direction;
-					}
-				}
-			}
+		std::set< WallPanel > selectedSegments = index.getCutaways( rooms[ currentLevel ], camera.getRotationAngle() );
+		for( const WallPanel& match : selectedSegments ) {
+			enqueueAnimation( match, { 0, numFrames, -3.75f } );
 		}
 
 		// For all wall panels that were not selected in the process above, and are lower than their default configuration
 		// Set an animation to return them back to z+0
-		for( const auto& segment : segments ) {
-			if( selectedSegments.find( segment.get() ) == selectedSegments.end() ) {
-				auto& segmentTransform = segment->getLocalTransform();
-				if( segmentTransform.getPosition() != glm::vec3{ 0.0f, 0.0f, 0.0f } ) {
-					enqueueAnimation( segment.get(), { 0, numFrames, 0.0f } );
+		for( const WallPanel& segment : index.getPanels() ) {
+			if( selectedSegments.find( segment ) == selectedSegments.end() ) {
+				if( segment.getOffset() != 0.0f ) {
+					enqueueAnimation( segment, { 0, numFrames, 0.0f } );
 				} else {
 					// Element has been queued for animation previously, but it has not yet moved,
 					// and has not been selected for this run. Remove the animation in its entirety.
-					activeWallAnims.erase( segment.get() );
+					activeWallAnims.erase( segment );
 				}
 			}
 		}
@@ -268,21 +235,15 @@ namespace BlueBear::Gameplay {
 
 	void InfrastructureManager::setWallsDown() {
 		static int numFrames = ConfigManager::getInstance().getIntValue( "fps_overview" ) * ( ( float ) ConfigManager::getInstance().getIntValue( "wall_cutaway_animation_speed" ) / 1000.0f );
-		std::shared_ptr< Graphics::SceneGraph::Model > wallRigInstance = state.as< State::HouseholdGameplayState >().getWorldRenderer().findObjectsByType( "__wallrig" )[ 0 ];
-		auto& segments = wallRigInstance->getChildren()[ currentLevel ]->getChildren();
-
-		for( const auto& segment : segments ) {
-			enqueueAnimation( segment.get(), { 0, numFrames, -3.75f } );
+		for( const WallPanel& segment : wallPanels[ currentLevel ].getPanels() ) {
+			enqueueAnimation( segment, { 0, numFrames, -3.75f } );
 		}
 	}
 
 	void InfrastructureManager::setWallsUp() {
 		static int numFrames = ConfigManager::getInstance().getIntValue( "fps_overview" ) * ( ( float ) ConfigManager::getInstance().getIntValue( "wall_cutaway_animation_speed" ) / 1000.0f );
-		std::shared_ptr< Graphics::SceneGraph::Model > wallRigInstance = state.as< State::HouseholdGameplayState >().getWorldRenderer().findObjectsByType( "__wallrig" )[ 0 ];
-		auto& segments = wallRigInstance->getChildren()[ currentLevel ]->getChildren();
-
-		for( const auto& segment : segments ) {
-			enqueueAnimation( segment.get(), { 0, numFrames, 0.0f } );
+		for( const WallPanel& segment : wallPanels[ currentLevel ].getPanels() ) {
+			enqueueAnimation( segment, { 0, numFrames, 0.0f } );
 		}
 	}
 
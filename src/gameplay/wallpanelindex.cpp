@@ -0,0 +1,167 @@
+#include "gameplay/wallpanelindex.hpp"
+#include "graphics/scenegraph/model.hpp"
+#include "graphics/scenegraph/uniforms/level_uniform.hpp"
+#include "graphics/scenegraph/uniforms/wall_pieces_uniform.hpp"
+#include "tools/utility.hpp"
+#include <tuple>
+
+namespace BlueBear::Gameplay {
+
+	float WallPanel::getOffset() const {
+		if( piece == -1 ) {
+			return model->getLocalTransform().getPosition().z;
+		}
+
+		return ( ( Graphics::SceneGraph::Uniforms::WallPiecesUniform* ) model->getUniform( "pieces" ) )->getOffset( piece );
+	}
+
+	void WallPanel::setOffset( float offset ) const {
+		if( piece == -1 ) {
+			model->getLocalTransform().setPosition( { 0.0f, 0.0f, offset } );
+		} else {
+			( ( Graphics::SceneGraph::Uniforms::WallPiecesUniform* ) model->getUniform( "pieces" ) )->setOffset( piece, offset );
+		}
+	}
+
+	bool WallPanel::operator==( const WallPanel& rhs ) const {
+		return model == rhs.model && piece == rhs.piece;
+	}
+
+	bool WallPanel::operator<( const WallPanel& rhs ) const {
+		return std::tie( model, piece ) < std::tie( rhs.model, rhs.piece );
+	}
+
+	/**
+	 * Index every wall piece of a level, whether it is a model of its own or a range within a merged chunk
+	 */
+	WallPanelIndex::WallPanelIndex( const Graphics::SceneGraph::Model& level, const glm::ivec2& dimensions )
+		: dimensions( dimensions ), cells( dimensions.x * dimensions.y, { -1, -1, -1, -1 } ) {
+		for( const auto& child : level.getChildren() ) {
+			Graphics::SceneGraph::Uniforms::WallPiecesUniform* pieces = ( Graphics::SceneGraph::Uniforms::WallPiecesUniform* ) child->getUniform( "pieces" );
+			if( pieces ) {
+				for( int i = 0; i != ( int ) pieces->getPieces().size(); i++ ) {
+					const auto& piece = pieces->getPieces()[ i ];
+					insert( { child.get(), i }, piece.id, piece.position );
+				}
+			} else {
+				Graphics::SceneGraph::Uniforms::LevelUniform* uniform = ( Graphics::SceneGraph::Uniforms::LevelUniform* ) child->getUniform( "level" );
+				insert( { child.get(), -1 }, child->getId(), uniform->getPosition() );
+			}
+		}
+	}
+
+	int WallPanelIndex::getOrientation( const std::string& id ) {
+		switch( Tools::Utility::hash( id.c_str() ) ) {
+			case Tools::Utility::hash( "__horizontal" ):
+				return 0;
+			case Tools::Utility::hash( "__vertical" ):
+				return 1;
+			case Tools::Utility::hash( "__diagonal" ):
+				return 2;
+			case Tools::Utility::hash( "__reverseDiagonal" ):
+				return 3;
+			default:
+				return -1;
+		}
+	}
+
+	int WallPanelIndex::getOrientation( const glm::vec2& direction ) {
+		if( direction == glm::vec2{ 1.0f, 0.0f } ) {
+			return 0;
+		} else if ( direction == glm::vec2{ 0.0f, -1.0f } ) {
+			return 1;
+		} else if ( direction == glm::vec2{ 1.0f, -1.0f } ) {
+			return 2;
+		} else if ( direction == glm::vec2{ 1.0f, 1.0f } ) {
+			return 3;
+		}
+
+		return -1;
+	}
+
+	/**
+	 * Panels are placed at whole cells in origin-corrected space; anything else cannot hold a panel
+	 */
+	std::optional< glm::ivec2 > WallPanelIndex::locationToCell( const glm::vec2& location ) const {
+		glm::vec2 cell{ location.x + ( dimensions.x * 0.5f ), ( dimensions.y * 0.5f ) - location.y };
+		if( cell != glm::floor( cell ) || cell.x < 0.0f || cell.y < 0.0f || cell.x >= dimensions.x || cell.y >= dimensions.y ) {
+			return {};
+		}
+
+		return glm::ivec2( cell );
+	}
+
+	void WallPanelIndex::insert( const WallPanel& panel, const std::string& id, const glm::vec2& location ) {
+		panels.emplace_back( panel );
+
+		int orientation = getOrientation( id );
+		std::optional< glm::ivec2 > cell = locationToCell( location );
+		if( orientation != -1 && cell ) {
+			cells[ ( cell->y * dimensions.x ) + cell->x ][ orientation ] = panels.size() - 1;
+		}
+	}
+
+	const std::vector< WallPanel >& WallPanelIndex::getPanels() const {
+		return panels;
+	}
+
+	std::optional< WallPanel > WallPanelIndex::find( const glm::vec2& direction, const glm::vec2& location ) const {
+		int orientation = getOrientation( direction );
+		std::optional< glm::ivec2 > cell = locationToCell( location );
+		if( orientation == -1 || !cell ) {
+			return {};
+		}
+
+		int panel = cells[ ( cell->y * dimensions.x ) + cell->x ][ orientation ];
+		if( panel == -1 ) {
+			return {};
+		}
+
+		return panels[ panel ];
+	}
+
+	/**
+	 * For each room, walk its walls in the winding direction and collect every panel whose face vector falls
+	 * within 225 and 315 degrees of the camera rotation
+	 */
+	std::set< WallPanel > WallPanelIndex::getCutaways( std::vector< Models::Room >& rooms, float cameraRotation ) const {
+		std::set< WallPanel > result;
+
+		for( auto& room : rooms ) {
+			for( const auto& wall : room.getWallNormals() ) {
+				float angle = Tools::Utility::positiveAngle(
+					Tools::Utility::positiveAngle( glm::degrees( glm::atan( wall.perpendicular.y, wall.perpendicular.x ) ) ) +
+					cameraRotation
+				);
+
+				if( angle >= 225.0f && angle <= 315.0f ) {
+					glm::vec2 start;
+					glm::vec2 finish;
+					glm::vec2 direction;
+					if( wall.direction == glm::vec2{ -1.0f, 0.0f } || wall.direction == glm::vec2{ 0.0f, 1.0f } || wall.direction == glm::vec2{ -1.0f, -1.0f } || wall.direction == glm::vec2{ -1.0f, 1.0f } ) {
+						start = wall.segment.second;
+						finish = wall.segment.first;
+						direction = glm::vec2{ -wall.direction.x, -wall.direction.y };
+					} else {
+						start = wall.segment.first;
+						finish = wall.segment.second;
+						direction = wall.direction;
+					}
+
+					int totalSteps = std::abs( glm::distance( finish, start ) );
+					glm::vec2 cursor = start;
+					for( int i = 0; i < totalSteps; i++ ) {
+						if( std::optional< WallPanel > match = find( direction, cursor ) ) {
+							result.insert( *match );
+						}
+
+						cursor += direction;
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+}
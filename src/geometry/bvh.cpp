@@ -0,0 +1,124 @@
+#include "geometry/bvh.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace BlueBear::Geometry {
+
+	std::optional< std::pair< float, float > > BVH::getSlabInterval( const Ray& ray, const glm::vec3& inverseDirection, const AABB& box ) {
+		glm::vec3 t1 = ( box.minima - ray.origin ) * inverseDirection;
+		glm::vec3 t2 = ( box.maxima - ray.origin ) * inverseDirection;
+
+		glm::vec3 tMin = glm::min( t1, t2 );
+		glm::vec3 tMax = glm::max( t1, t2 );
+
+		float entry = std::max( std::max( tMin.x, tMin.y ), std::max( tMin.z, 0.0f ) );
+		float exit = std::min( std::min( tMax.x, tMax.y ), tMax.z );
+
+		if( exit < entry ) {
+			return {};
+		}
+
+		return std::make_pair( entry, exit );
+	}
+
+	AABB BVH::merge( const AABB& lhs, const AABB& rhs ) {
+		return { glm::min( lhs.minima, rhs.minima ), glm::max( lhs.maxima, rhs.maxima ) };
+	}
+
+	unsigned int BVH::buildRecursive( const std::vector< AABB >& boxes, std::vector< glm::vec3 >& centroids, unsigned int begin, unsigned int end ) {
+		unsigned int nodeIndex = nodes.size();
+		nodes.emplace_back();
+
+		AABB bounds = boxes[ primitives[ begin ] ];
+		AABB centroidBounds{ centroids[ primitives[ begin ] ], centroids[ primitives[ begin ] ] };
+		for( unsigned int i = begin + 1; i != end; i++ ) {
+			bounds = merge( bounds, boxes[ primitives[ i ] ] );
+			centroidBounds = merge( centroidBounds, { centroids[ primitives[ i ] ], centroids[ primitives[ i ] ] } );
+		}
+		nodes[ nodeIndex ].bounds = bounds;
+
+		if( end - begin <= MAX_LEAF_SIZE ) {
+			nodes[ nodeIndex ].offset = begin;
+			nodes[ nodeIndex ].count = end - begin;
+			return nodeIndex;
+		}
+
+		// Median split along the longest axis of the centroid bounds
+		glm::vec3 extent = centroidBounds.maxima - centroidBounds.minima;
+		int axis = 0;
+		if( extent.y > extent[ axis ] ) { axis = 1; }
+		if( extent.z > extent[ axis ] ) { axis = 2; }
+
+		unsigned int middle = begin + ( ( end - begin ) / 2 );
+		std::nth_element(
+			primitives.begin() + begin, primitives.begin() + middle, primitives.begin() + end,
+			[ &centroids, axis ]( unsigned int lhs, unsigned int rhs ) {
+				return centroids[ lhs ][ axis ] < centroids[ rhs ][ axis ];
+			}
+		);
+
+		buildRecursive( boxes, centroids, begin, middle );
+		unsigned int right = buildRecursive( boxes, centroids, middle, end );
+		nodes[ nodeIndex ].offset = right;
+
+		return nodeIndex;
+	}
+
+	void BVH::build( const std::vector< AABB >& boxes ) {
+		clear();
+
+		if( boxes.empty() ) {
+			return;
+		}
+
+		primitives.resize( boxes.size() );
+		std::iota( primitives.begin(), primitives.end(), 0 );
+
+		std::vector< glm::vec3 > centroids;
+		centroids.reserve( boxes.size() );
+		for( const AABB& box : boxes ) {
+			centroids.emplace_back( ( box.minima + box.maxima ) * 0.5f );
+		}
+
+		nodes.reserve( ( 2 * boxes.size() ) / MAX_LEAF_SIZE + 1 );
+		buildRecursive( boxes, centroids, 0, boxes.size() );
+	}
+
+	/**
+	 * Recompute node bounds in place for primitives that moved but kept their count and order (e.g. skinned meshes).
+	 * Children are always stored after their parent, so a reverse pass visits children first.
+	 */
+	void BVH::refit( const std::vector< AABB >& boxes ) {
+		for( auto it = nodes.rbegin(); it != nodes.rend(); ++it ) {
+			Node& node = *it;
+
+			if( node.count ) {
+				node.bounds = boxes[ primitives[ node.offset ] ];
+				for( unsigned int i = node.offset + 1; i != node.offset + node.count; i++ ) {
+					node.bounds = merge( node.bounds, boxes[ primitives[ i ] ] );
+				}
+			} else {
+				unsigned int nodeIndex = &node - nodes.data();
+				node.bounds = merge( nodes[ nodeIndex + 1 ].bounds, nodes[ node.offset ].bounds );
+			}
+		}
+	}
+
+	void BVH::clear() {
+		nodes.clear();
+		primitives.clear();
+	}
+
+	bool BVH::empty() const {
+		return nodes.empty();
+	}
+
+	size_t BVH::size() const {
+		return primitives.size();
+	}
+
+	const AABB& BVH::getBounds() const {
+		return nodes.at( 0 ).bounds;
+	}
+
+}
@@ -5,8 +5,10 @@ namespace BlueBear::Geometry {
 	/**
 	 * mit licenced moller-trumbore algorithm
 	 * https://github.com/substack/ray-triangle-intersection/blob/master/index.js
+	 *
+	 * Returns the parametric distance along the ray
 	 */
-	std::optional< glm::vec3 > getIntersectionPoint( const Ray& ray, const Triangle& triangle ) {
+	std::optional< float > getIntersectionDistance( const Ray& ray, const Triangle& triangle ) {
 		glm::vec3 edge1 = triangle[ 1 ] - triangle[ 0 ];
 		glm::vec3 edge2 = triangle[ 2 ] - triangle[ 0 ];
 
@@ -27,8 +29,15 @@ namespace BlueBear::Geometry {
 			return {};
 		}
 
-		float t = glm::dot( edge2, qvec ) / determinant;
-		return ray.origin + t * ray.direction;
+		return glm::dot( edge2, qvec ) / determinant;
+	}
+
+	std::optional< glm::vec3 > getIntersectionPoint( const Ray& ray, const Triangle& triangle ) {
+		if( std::optional< float > t = getIntersectionDistance( ray, triangle ) ) {
+			return ray.origin + *t * ray.direction;
+		}
+
+		return {};
 	}
 
 	/**
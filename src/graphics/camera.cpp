@@ -137,6 +137,10 @@ namespace BlueBear {
       return ortho;
     }
 
+    glm::mat4 Camera::getViewProjection() const {
+      return projection * view;
+    }
+
     glm::vec2 Camera::getScaledCoordinates() const {
       return { widthHalf, heightHalf };
     }
@@ -7,36 +7,68 @@ namespace BlueBear {
     namespace SceneGraph {
       namespace Animation {
 
-        Animator::Animator( const Bone& bindSkeleton, const Bone& currentSkeleton, const std::map< std::string, Animation >& animationList ) :
-          bindSkeleton( bindSkeleton ), currentSkeleton( currentSkeleton ), animationList( animationList ) {}
+        Animator::Animator( const Bone& bindSkeleton, const std::map< std::string, Animation >& animationList ) :
+          skeleton( std::make_shared< Skeleton >( bindSkeleton ) ),
+          animationList( animationList ),
+          channels( skeleton->size(), nullptr ),
+          cursors( skeleton->size(), 0 ),
+          localMatrices( skeleton->size() ),
+          globalMatrices( skeleton->size() ),
+          computedMatrices( skeleton->size() ) {
+            resetPose();
+            computeMatrices();
+          }
 
-        Animator::Animator( const Animator& animator ) {
-          currentSkeleton = bindSkeleton = animator.bindSkeleton;
-          animationList = animator.animationList;
-        }
+        Animator::Animator( const Animator& animator ) :
+          skeleton( animator.skeleton ),
+          animationList( animator.animationList ),
+          channels( skeleton->size(), nullptr ),
+          cursors( skeleton->size(), 0 ),
+          localMatrices( skeleton->size() ),
+          globalMatrices( skeleton->size() ),
+          computedMatrices( skeleton->size() ) {
+            resetPose();
+            computeMatrices();
+          }
 
         double Animator::getFPS() {
           return animation->fps / ConfigManager::getInstance().getIntValue( "fps_overview" );
         }
 
-        void Animator::computeMatrices() {
-          std::vector< std::string > boneIDs = bindSkeleton.getAllIds();
+        void Animator::samplePose() {
+          const std::vector< Skeleton::Joint >& joints = skeleton->getJoints();
 
-          for( const std::string& id : boneIDs ) {
-            computedMatrices[ id ] = currentSkeleton.getMatrixById( id ) * glm::inverse( bindSkeleton.getMatrixById( id ) );
+          for( size_t i = 0; i != joints.size(); i++ ) {
+            localMatrices[ i ] = channels[ i ] ? channels[ i ]->sample( frame, cursors[ i ] ) : joints[ i ].bindLocal;
           }
         }
 
-        const std::map< std::string, glm::mat4 >& Animator::getComputedMatrices() {
-          return computedMatrices;
+        void Animator::resetPose() {
+          const std::vector< Skeleton::Joint >& joints = skeleton->getJoints();
+
+          for( size_t i = 0; i != joints.size(); i++ ) {
+            localMatrices[ i ] = joints[ i ].bindLocal;
+          }
+        }
+
+        void Animator::computeMatrices() {
+          const std::vector< Skeleton::Joint >& joints = skeleton->getJoints();
+
+          for( size_t i = 0; i != joints.size(); i++ ) {
+            const Skeleton::Joint& joint = joints[ i ];
+
+            // Joints are in preorder, so the parent's global matrix is already current
+            globalMatrices[ i ] = joint.parent == -1 ? localMatrices[ i ] : globalMatrices[ joint.parent ] * localMatrices[ i ];
+            computedMatrices[ i ] = globalMatrices[ i ] * joint.inverseBindGlobal;
+          }
         }
 
-        Bone& Animator::getBindSkeletonRef() {
-          return bindSkeleton;
+        const std::vector< glm::mat4 >& Animator::getComputedMatrices() const {
+          return computedMatrices;
         }
 
-        Bone& Animator::getCurrentSkeletonRef() {
-          return currentSkeleton;
+        const std::shared_ptr< const Skeleton >& Animator::getSkeleton() const {
+          return skeleton;
         }
 
         bool Animator::updating() const {
@@ -49,6 +81,20 @@ namespace BlueBear {
             animation = it->second;
             frame = -getFPS();
             paused = false;
+
+            // Resolve channels once here instead of searching every bone's animation map each frame
+            const std::vector< Skeleton::Joint >& joints = skeleton->getJoints();
+            for( size_t i = 0; i != joints.size(); i++ ) {
+              channels[ i ] = nullptr;
+              cursors[ i ] = 0;
+
+              if( joints[ i ].animations ) {
+                auto channel = joints[ i ].animations->find( animationId );
+                if( channel != joints[ i ].animations->end() && !channel->second.empty() ) {
+                  channels[ i ] = &channel->second;
+                }
+              }
+            }
           } else {
             throw AnimationNotFoundException();
           }
@@ -60,7 +106,8 @@ namespace BlueBear {
 
         void Animator::setFrame( double frame ) {
           if( animation ) {
-            currentSkeleton = bindSkeleton.getAnimationCopy( animation->id, this->frame = frame );
+            this->frame = frame;
+            samplePose();
           } else {
             Log::getInstance().warn( "Animator::setFrame", "Can't set frame; no animation currently set" );
           }
@@ -70,7 +117,8 @@ namespace BlueBear {
           animation.reset();
           frame = 0.0f;
           paused = false;
-          currentSkeleton = bindSkeleton;
+          std::fill( channels.begin(), channels.end(), nullptr );
+          resetPose();
         }
 
         void Animator::update() {
@@ -79,7 +127,7 @@ namespace BlueBear {
             if( frame + currentFps <= animation->duration ) {
               frame += currentFps;
 
-              currentSkeleton = bindSkeleton.getAnimationCopy( animation->id, frame );
+              samplePose();
             } else {
               // That was the last frame
               reset();
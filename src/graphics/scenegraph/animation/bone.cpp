@@ -30,6 +30,18 @@ namespace BlueBear {
           animations = other.animations;
         }
 
+        const std::string& Bone::getId() const {
+          return id;
+        }
+
+        const std::vector< Bone >& Bone::getChildren() const {
+          return children;
+        }
+
+        std::shared_ptr< Bone::AnimationMap > Bone::getAnimations() const {
+          return animations;
+        }
+
         void Bone::setToAnimation( const std::string& animationId, double animationTick ) {
           if( !animations ) {
             throw AnimationNotFoundException();
@@ -40,27 +52,7 @@ namespace BlueBear {
             throw AnimationNotFoundException();
           }
 
-          const std::map< double, glm::mat4 >& keyframes = ksIterator->second;
-          auto keyframePair = keyframes.find( animationTick );
-          if( keyframePair != keyframes.end() ) {
-            // Keyframe directly exists: replace the matrix directly
-            matrix = keyframePair->second;
-          } else {
-            // Keyframe must be linearly interpolated between the one before and the next one
-            auto lastIterator = keyframes.upper_bound( animationTick );
-            auto firstIterator = std::prev( lastIterator, 1 );
-
-            Transform result = Transform::interpolate(
-              Transform( firstIterator->second ),
-              Transform( lastIterator->second ),
-              (
-                ( animationTick - firstIterator->first ) /
-                ( lastIterator->first - firstIterator->first )
-              )
-            );
-
-            matrix = result.getMatrix();
-          }
+          matrix = ksIterator->second.sample( animationTick );
 
           for( Bone& child : children ) {
             child.setToAnimation( animationId, animationTick );
@@ -96,8 +88,12 @@ namespace BlueBear {
         }
 
         void Bone::addChild( const Bone& bone ) {
-          Bone& child = *children.insert( children.end(), bone );
-          child.parent = this;
+          children.push_back( bone );
+
+          // Growing the vector copies existing children, which drops their parent pointer
+          for( Bone& child : children ) {
+            child.parent = this;
+          }
         }
 
         const Bone* Bone::getChildById( const std::string& id ) const {
@@ -0,0 +1,89 @@
+#include "graphics/scenegraph/animation/channel.hpp"
+#include <algorithm>
+
+namespace BlueBear {
+  namespace Graphics {
+    namespace SceneGraph {
+      namespace Animation {
+
+        void Channel::addKeyframe( double time, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale ) {
+          times.push_back( time );
+          translations.push_back( translation );
+          rotations.push_back( rotation );
+          scales.push_back( scale );
+        }
+
+        bool Channel::empty() const {
+          return times.empty();
+        }
+
+        size_t Channel::size() const {
+          return times.size();
+        }
+
+        /**
+         * Same result as glm::translate * glm::toMat4 * glm::scale, without the two matrix products
+         */
+        glm::mat4 Channel::compose( const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale ) {
+          glm::mat3 basis = glm::mat3_cast( rotation );
+
+          return glm::mat4(
+            glm::vec4( basis[ 0 ] * scale.x, 0.0f ),
+            glm::vec4( basis[ 1 ] * scale.y, 0.0f ),
+            glm::vec4( basis[ 2 ] * scale.z, 0.0f ),
+            glm::vec4( translation, 1.0f )
+          );
+        }
+
+        /**
+         * Returns the last keyframe at or before tick (0 if tick precedes the timeline or there are no keyframes)
+         */
+        unsigned int Channel::seek( double tick, unsigned int cursor ) const {
+          if( times.empty() ) {
+            return 0;
+          }
+
+          unsigned int last = times.size() - 1;
+
+          if( cursor <= last && times[ cursor ] <= tick ) {
+            while( cursor != last && times[ cursor + 1 ] <= tick ) {
+              cursor++;
+            }
+
+            return cursor;
+          }
+
+          auto next = std::upper_bound( times.begin(), times.end(), tick );
+          return next == times.begin() ? 0 : ( next - times.begin() ) - 1;
+        }
+
+        glm::mat4 Channel::sample( double tick, unsigned int& cursor ) const {
+          cursor = seek( tick, cursor );
+          if( times.empty() ) {
+            return glm::mat4( 1.0f );
+          }
+
+          if( cursor == times.size() - 1 || tick <= times[ cursor ] ) {
+            return compose( translations[ cursor ], rotations[ cursor ], scales[ cursor ] );
+          }
+
+          unsigned int next = cursor + 1;
+          float alpha = ( tick - times[ cursor ] ) / ( times[ next ] - times[ cursor ] );
+
+          return compose(
+            glm::mix( translations[ cursor ], translations[ next ], alpha ),
+            glm::slerp( rotations[ cursor ], rotations[ next ], alpha ),
+            glm::mix( scales[ cursor ], scales[ next ], alpha )
+          );
+        }
+
+        glm::mat4 Channel::sample( double tick ) const {
+          // An out-of-range cursor always takes the binary search
+          unsigned int cursor = times.size();
+          return sample( tick, cursor );
+        }
+
+      }
+    }
+  }
+}
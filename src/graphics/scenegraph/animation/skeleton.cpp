@@ -0,0 +1,50 @@
+#include "graphics/scenegraph/animation/skeleton.hpp"
+
+namespace BlueBear {
+  namespace Graphics {
+    namespace SceneGraph {
+      namespace Animation {
+
+        Skeleton::Skeleton( const Bone& root ) {
+          addJoint( root, root, -1 );
+        }
+
+        void Skeleton::addJoint( const Bone& root, const Bone& bone, int parent ) {
+          int index = joints.size();
+
+          indices[ bone.getId() ] = index;
+          joints.emplace_back( Joint{
+            bone.getId(),
+            parent,
+            bone.getLocalMatrix(),
+            // Same expression the tree-walking path evaluates, so inverse bind matrices are unchanged
+            glm::inverse( root.getMatrixById( bone.getId() ) ),
+            bone.getAnimations()
+          } );
+
+          for( const Bone& child : bone.getChildren() ) {
+            addJoint( root, child, index );
+          }
+        }
+
+        const std::vector< Skeleton::Joint >& Skeleton::getJoints() const {
+          return joints;
+        }
+
+        unsigned int Skeleton::getIndex( const std::string& id ) const {
+          auto it = indices.find( id );
+          if( it == indices.end() ) {
+            throw JointNotFoundException();
+          }
+
+          return it->second;
+        }
+
+        size_t Skeleton::size() const {
+          return joints.size();
+        }
+
+      }
+    }
+  }
+}
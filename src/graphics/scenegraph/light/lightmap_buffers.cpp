@@ -0,0 +1,124 @@
+#include "graphics/scenegraph/light/lightmap_buffers.hpp"
+#include "graphics/scenegraph/light/directionallight.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace BlueBear::Graphics::SceneGraph::Light {
+
+	template< typename T >
+	static void appendBytes( std::vector< unsigned char >& buffer, const T* data, size_t count ) {
+		size_t offset = buffer.size();
+		buffer.resize( offset + ( sizeof( T ) * count ) );
+		if( count ) {
+			std::memcpy( buffer.data() + offset, data, sizeof( T ) * count );
+		}
+	}
+
+	RoomTileIndex indexRoomTiles( const std::vector< Std140Room >& rooms ) {
+		RoomTileIndex result;
+
+		glm::ivec2 minimum{ std::numeric_limits< int >::max(), std::numeric_limits< int >::max() };
+		glm::ivec2 maximum{ std::numeric_limits< int >::lowest(), std::numeric_limits< int >::lowest() };
+		int levels = 0;
+		for( const Std140Room& room : rooms ) {
+			if( room.level != -1 ) {
+				minimum = glm::min( minimum, glm::ivec2( glm::floor( room.lowerLeft ) ) );
+				maximum = glm::max( maximum, glm::ivec2( glm::floor( room.upperRight ) ) );
+				levels = std::max( levels, room.level + 1 );
+			}
+		}
+
+		if( !levels ) {
+			return result;
+		}
+
+		// Rooms are tested against their closed bounding box, so the tile holding the upper right corner counts too
+		result.origin = minimum;
+		result.size = maximum - minimum + 1;
+		result.levels = levels;
+
+		std::vector< int > counts( result.size.x * result.size.y * levels, 0 );
+		auto forEachTile = [ & ]( const Std140Room& room, auto functor ) {
+			glm::ivec2 lower = glm::ivec2( glm::floor( room.lowerLeft ) ) - result.origin;
+			glm::ivec2 upper = glm::ivec2( glm::floor( room.upperRight ) ) - result.origin;
+
+			for( int y = lower.y; y <= upper.y; y++ ) {
+				for( int x = lower.x; x <= upper.x; x++ ) {
+					functor( ( ( ( room.level * result.size.y ) + y ) * result.size.x ) + x );
+				}
+			}
+		};
+
+		for( const Std140Room& room : rooms ) {
+			if( room.level != -1 ) {
+				forEachTile( room, [ &counts ]( int texel ) { counts[ texel ]++; } );
+			}
+		}
+
+		result.entries.resize( counts.size() );
+		int first = 0;
+		for( size_t i = 0; i != counts.size(); i++ ) {
+			result.entries[ i ] = { first, 0 };
+			first += counts[ i ];
+		}
+
+		result.rooms.resize( first );
+		for( size_t slot = 0; slot != rooms.size(); slot++ ) {
+			if( rooms[ slot ].level != -1 ) {
+				forEachTile( rooms[ slot ], [ & ]( int texel ) {
+					glm::ivec2& entry = result.entries[ texel ];
+					result.rooms[ entry.x + entry.y++ ] = slot;
+				} );
+			}
+		}
+
+		return result;
+	}
+
+	std::vector< unsigned char > packLights( const std::vector< const DirectionalLight* >& lights ) {
+		std::vector< Std140DirectionalLight > packed;
+		packed.reserve( lights.size() );
+
+		for( const DirectionalLight* light : lights ) {
+			packed.emplace_back( Std140DirectionalLight{
+				glm::vec4( light->getDirection(), 0.0f ),
+				glm::vec4( light->getAmbient(), 0.0f ),
+				glm::vec4( light->getDiffuse(), 0.0f ),
+				glm::vec4( light->getSpecular(), 0.0f )
+			} );
+		}
+
+		std::vector< unsigned char > result;
+		appendBytes( result, packed.data(), packed.size() );
+		return result;
+	}
+
+	/**
+	 * The buffer opens with the tile grid ( origin.xy, size.xy ) as an ivec4, followed by the room array.
+	 */
+	std::vector< unsigned char > packRooms( const std::vector< Std140Room >& rooms, const RoomTileIndex& index ) {
+		glm::ivec4 grid{ index.origin, index.size };
+
+		std::vector< unsigned char > result;
+		appendBytes( result, &grid, 1 );
+		appendBytes( result, rooms.data(), rooms.size() );
+		return result;
+	}
+
+	/**
+	 * A plain int array (std430). An empty list still takes one element, since a buffer needs storage to be bound.
+	 */
+	std::vector< unsigned char > packTileRooms( const RoomTileIndex& index ) {
+		std::vector< unsigned char > result;
+		appendBytes( result, index.rooms.data(), index.rooms.size() );
+
+		if( result.empty() ) {
+			result.resize( sizeof( int ), 0 );
+		}
+
+		return result;
+	}
+
+}
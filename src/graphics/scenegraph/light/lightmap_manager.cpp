@@ -5,12 +5,32 @@
 #include "log.hpp"
 #include <GL/glew.h>
 #include <glm/gtx/string_cast.hpp>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
 
 namespace BlueBear::Graphics::SceneGraph::Light {
 
 	static const glm::vec2 LIGHTMAP_SECTOR_MULTIPLIER{ LIGHTMAP_SECTOR_RESOLUTION, LIGHTMAP_SECTOR_RESOLUTION };
 
-	LightmapManager::LightmapManager() : outdoorLight( { 0.5, 0.5, -0.1 }, { 0.6, 0.6, 0.6 }, { 1.0, 1.0, 1.0 }, { 0.1, 0.1, 0.1 } ) {
+	// Must match system/shaders/common/ubo_bindings.glsl
+	static constexpr GLuint DIRECTIONAL_LIGHTS_BINDING = 2;
+	static constexpr GLuint ROOMS_BINDING = 3;
+	static constexpr GLuint ROOM_TILES_BINDING = 4;
+
+	LightmapManager::LightmapManager() :
+		outdoorLight( { 0.5, 0.5, -0.1 }, { 0.6, 0.6, 0.6 }, { 1.0, 1.0, 1.0 }, { 0.1, 0.1, 0.1 } ),
+		packer(
+			ConfigManager::getInstance().getIntValue( "shader_room_map_min_width" ),
+			ConfigManager::getInstance().getIntValue( "shader_room_map_min_height" ),
+			Containers::RectanglePacker::getHeuristic( ConfigManager::getInstance().getValue( "shader_room_map_pack_heuristic" ) )
+		),
+		generatedLightList{ &outdoorLight },
+		lightBuffer( DIRECTIONAL_LIGHTS_BINDING ),
+		roomBuffer( ROOMS_BINDING ),
+		tileRoomBuffer( ROOM_TILES_BINDING ) {
 		Shader::SHADER_CHANGE.listen( this, std::bind( &LightmapManager::send, this, std::placeholders::_1 ) );
 	}
 
@@ -20,20 +40,14 @@ namespace BlueBear::Graphics::SceneGraph::Light {
 		if( claimedTextureUnit ) {
 			Tools::OpenGL::returnTextureUnits( { *claimedTextureUnit } );
 		}
-	}
-
-	static std::unique_ptr< float[] > verticalFlip( std::unique_ptr< float[] > original, int width, int height ) {
-		std::unique_ptr< float[] > result = std::make_unique< float[] >( width * height );
 
-		for( int y = 0; y != height; y++ ) {
-			for( int x = 0; x != width; x++ ) {
-				int adjustedY = height - 1 - y;
-
-				result[ ( y * width ) + x ] = original[ ( adjustedY * width ) + x ];
-			}
+		if( claimedIndexUnit ) {
+			Tools::OpenGL::returnTextureUnits( { *claimedIndexUnit } );
 		}
 
-		return result;
+		if( tileIndexTexture ) {
+			glDeleteTextures( 1, &tileIndexTexture );
+		}
 	}
 
 	void LightmapManager::setRooms( const std::vector< std::vector< Models::Room > >& roomLevels ) {
@@ -57,47 +71,16 @@ namespace BlueBear::Graphics::SceneGraph::Light {
 		return edges;
 	}
 
-	std::vector< Containers::BoundedObject< LightmapManager::ShaderRoom* > > LightmapManager::getBoundedObjects( std::vector< LightmapManager::ShaderRoom >& shaderRooms ) {
-		std::vector< Containers::BoundedObject< ShaderRoom* > > result;
-
-		for( auto& shaderRoom : shaderRooms ) {
-			glm::vec2 start{ shaderRoom.lowerLeft.x, shaderRoom.upperRight.y };
-			glm::vec2 end{ shaderRoom.upperRight.x, shaderRoom.lowerLeft.y };
-
-			glm::ivec2 dims{
-				( ( end.x - start.x ) * LIGHTMAP_SECTOR_RESOLUTION ),
-				( ( start.y - end.y ) * LIGHTMAP_SECTOR_RESOLUTION )
-			};
-
-			result.emplace_back( Containers::BoundedObject< ShaderRoom* >{ dims.x, dims.y, &shaderRoom } );
+	size_t LightmapManager::hashRoom( const Models::Room& room, int level ) {
+		size_t result = std::hash< int >()( level );
+		for( const glm::vec2& point : room.getPoints() ) {
+			result = result * 31 + std::hash< float >()( point.x );
+			result = result * 31 + std::hash< float >()( point.y );
 		}
 
 		return result;
 	}
 
-	void LightmapManager::setTexture( const Containers::PackedCellMap< LightmapManager::ShaderRoom* >& packedCells ) {
-		// Get the dimensions of the board
-		glm::ivec2 totalDimensions = { packedCells.totalWidth, packedCells.totalHeight };
-
-		// Place all the submaps in the map
-		std::unique_ptr< float[] > data = std::make_unique< float[] >( totalDimensions.x * totalDimensions.y );
-		Log::getInstance().debug( "LightmapManager::setTexture", "Room boxpack texture is " + std::to_string( totalDimensions.x ) + " by " + std::to_string( totalDimensions.y ) );
-		for( const auto& cell : packedCells.cells ) {
-			ShaderRoom* room = *cell.object;
-			room->mapLocation = glm::ivec2{ cell.x, totalDimensions.y - 1 - ( cell.y + cell.height ) };
-
-			for( int y = 0; y != cell.height; y++ ) {
-				for( int x = 0; x != cell.width; x++ ) {
-					glm::ivec2 mapCoordinates = { cell.x + x, cell.y + y };
-
-					data[ ( mapCoordinates.y * totalDimensions.x ) + mapCoordinates.x ] = room->mapData[ ( y * cell.width ) + x ];
-				}
-			}
-		}
-
-		generatedRoomData.emplace( totalDimensions, verticalFlip( std::move( data ), totalDimensions.x, totalDimensions.y ).get() );
-	}
-
 	LightmapManager::ShaderRoom LightmapManager::getFragmentData( const Models::Room& room, int level, int lightIndex ) {
 		ShaderRoom result;
 		result.level = level;
@@ -126,26 +109,78 @@ namespace BlueBear::Graphics::SceneGraph::Light {
 			( ( start.y - end.y ) )
 		);
 
-		auto edges = getEdges( room );
 		int arrayWidth = ( end.x - start.x );
+		result.dimensions = { arrayWidth, start.y - end.y };
+
+		// A texel is inside the room if a ray cast toward +x from its corner crosses an odd number of edges. Per row, the
+		// exact ray test against one edge holds for a prefix of the row, so each edge only needs to be tested around its
+		// analytic crossing; the parity of every texel then follows from the prefix lengths.
+		auto hit = [ arrayWidth ]( int x, float rowY, const Geometry::LineSegment< glm::vec2 >& edge ) {
+			glm::vec2 asFloat{ x / ( float ) LIGHTMAP_SECTOR_RESOLUTION, rowY };
+			Geometry::LineSegment< glm::vec2 > needle{ { asFloat.x, asFloat.y }, { asFloat.x + arrayWidth, asFloat.y } };
+
+			return Geometry::segmentsIntersect( needle, edge );
+		};
+
+		// Edge table, ordered by the first row each edge may cross. Horizontal edges are collinear with every ray.
+		struct TableEntry {
+			int top;
+			int bottom;
+			Geometry::LineSegment< glm::vec2 > edge;
+		};
+		std::vector< TableEntry > edgeTable;
+		for( const auto& edge : getEdges( room ) ) {
+			if( edge.from.y != edge.to.y ) {
+				edgeTable.emplace_back( TableEntry{
+					( int ) std::floor( std::max( edge.from.y, edge.to.y ) * LIGHTMAP_SECTOR_RESOLUTION ) + 1,
+					( int ) std::floor( std::min( edge.from.y, edge.to.y ) * LIGHTMAP_SECTOR_RESOLUTION ) - 1,
+					edge
+				} );
+			}
+		}
+		std::sort( edgeTable.begin(), edgeTable.end(), []( const TableEntry& lhs, const TableEntry& rhs ) { return lhs.top > rhs.top; } );
+
+		std::vector< const TableEntry* > activeEdges;
+		std::vector< unsigned char > toggles( arrayWidth + 1 );
+		auto nextEntry = edgeTable.begin();
 
 		for( int y = start.y; y > end.y; y-- ) {
-			for( int x = start.x; x < end.x; x++ ) {
-				glm::vec2 asFloat{ x / ( float ) LIGHTMAP_SECTOR_RESOLUTION, y / ( float ) LIGHTMAP_SECTOR_RESOLUTION };
+			float rowY = y / ( float ) LIGHTMAP_SECTOR_RESOLUTION;
 
-				Geometry::LineSegment< glm::vec2 > needle{ { asFloat.x, asFloat.y }, { asFloat.x + arrayWidth, asFloat.y } };
+			for( ; nextEntry != edgeTable.end() && nextEntry->top >= y; ++nextEntry ) {
+				activeEdges.emplace_back( &*nextEntry );
+			}
+			activeEdges.erase( std::remove_if( activeEdges.begin(), activeEdges.end(), [ y ]( const TableEntry* entry ) { return entry->bottom > y; } ), activeEdges.end() );
+
+			std::fill( toggles.begin(), toggles.end(), 0 );
+			for( const TableEntry* entry : activeEdges ) {
+				const auto& edge = entry->edge;
+				if( !hit( start.x, rowY, edge ) ) {
+					continue;
+				}
 
-				unsigned int intersections = 0;
-				for( const auto& edge : edges ) {
-					if( Geometry::segmentsIntersect( needle, edge ) ) {
-						intersections++;
+				double crossing = edge.from.x + ( ( edge.to.x - edge.from.x ) * ( ( ( double ) rowY - edge.from.y ) / ( edge.to.y - edge.from.y ) ) );
+				int last = std::clamp( ( int ) std::floor( crossing * LIGHTMAP_SECTOR_RESOLUTION ), start.x, end.x - 1 );
+				if( hit( last, rowY, edge ) ) {
+					while( last + 1 < end.x && hit( last + 1, rowY, edge ) ) {
+						last++;
+					}
+				} else {
+					while( !hit( last, rowY, edge ) ) {
+						last--;
 					}
 				}
 
-				if( ( intersections % 2 ) != 0 ) {
-					glm::ivec2 indices{ ( x - start.x ), ( start.y - y ) };
+				toggles[ 0 ] ^= 1;
+				toggles[ last - start.x + 1 ] ^= 1;
+			}
 
-					result.mapData[ ( indices.y * arrayWidth ) + indices.x ] = lightIndex;
+			float* row = &result.mapData[ ( y - end.y - 1 ) * arrayWidth ];
+			unsigned char parity = 0;
+			for( int x = 0; x != arrayWidth; x++ ) {
+				parity ^= toggles[ x ];
+				if( parity ) {
+					row[ x ] = lightIndex;
 				}
 			}
 		}
@@ -154,88 +189,223 @@ namespace BlueBear::Graphics::SceneGraph::Light {
 	}
 
 	/**
-	 * This should be called any time rooms are modified. Room nodes are immutable, so entire levels will be resent after user does something like modify a wall.
+	 * Match the current rooms against the slots from the last update. A room whose level and points are unchanged keeps
+	 * its slot, mask and atlas region; anything else is rasterized into a free slot and placed into the atlas.
 	 */
-	void LightmapManager::calculateLightmaps() {
-		generatedRoomData.reset();
-		generatedRooms.clear();
-		generatedLightList.clear();
+	LightmapManager::RegionUpdate LightmapManager::updateRegions() {
+		RegionUpdate update;
+
+		std::unordered_multimap< size_t, size_t > slotsByHash;
+		for( size_t slot = 0; slot != generatedRooms.size(); slot++ ) {
+			if( generatedRooms[ slot ].level != -1 ) {
+				slotsByHash.emplace( generatedRooms[ slot ].hash, slot );
+			}
+		}
 
-		generatedLightList.emplace_back( &outdoorLight );
+		struct Placement {
+			const Models::Room* room;
+			int level;
+			size_t hash;
+			std::optional< size_t > slot;
+		};
+		std::vector< Placement > placements;
+		std::vector< bool > taken( generatedRooms.size(), false );
 
 		int level = 0;
 		for( const auto& roomLevel : roomLevels ) {
 			for( const auto& room : roomLevel ) {
-				generatedLightList.emplace_back( &room.getBackgroundLight() );
-				generatedRooms.emplace_back( getFragmentData( room, level, generatedLightList.size() - 1 ) );
+				Placement placement{ &room, level, hashRoom( room, level ), {} };
+
+				auto range = slotsByHash.equal_range( placement.hash );
+				for( auto it = range.first; it != range.second; ++it ) {
+					const ShaderRoom& existing = generatedRooms[ it->second ];
+					if( !taken[ it->second ] && existing.level == level && existing.points == room.getPoints() ) {
+						taken[ it->second ] = true;
+						placement.slot = it->second;
+						break;
+					}
+				}
+
+				placements.emplace_back( std::move( placement ) );
 			}
 
 			level++;
 		}
 
-		static int textureWidth = ConfigManager::getInstance().getIntValue( "shader_room_map_min_width" );
-		static int textureHeight = ConfigManager::getInstance().getIntValue( "shader_room_map_min_height" );
+		// Vacate the slots of rooms that are gone
+		for( size_t slot = 0; slot != generatedRooms.size(); slot++ ) {
+			if( !taken[ slot ] && generatedRooms[ slot ].level != -1 ) {
+				if( packer.remove( generatedRooms[ slot ].region ) ) {
+					update.cleared.emplace_back( generatedRooms[ slot ].region );
+				}
 
-		setTexture( Containers::packCells( getBoundedObjects( generatedRooms ), textureWidth, textureHeight ) );
-	}
+				generatedRooms[ slot ] = ShaderRoom{};
+			}
+		}
 
-	void LightmapManager::send( const Shader& shader ) {
-		const UniformBundle& bundle = uniforms.getUniforms( shader );
+		// New rooms take the lowest free slot
+		size_t nextFree = 0;
+		for( Placement& placement : placements ) {
+			if( !placement.slot ) {
+				while( nextFree != taken.size() && taken[ nextFree ] ) {
+					nextFree++;
+				}
+
+				if( nextFree == taken.size() ) {
+					taken.emplace_back( true );
+					generatedRooms.emplace_back();
+				} else {
+					taken[ nextFree ] = true;
+				}
 
-		for( size_t i = 0; i != generatedLightList.size(); i++ ) {
-			shader.sendData( bundle.directionalLightsDirection[ i ], generatedLightList[ i ]->getDirection() );
-			shader.sendData( bundle.directionalLightsAmbient[ i ], generatedLightList[ i ]->getAmbient() );
-			shader.sendData( bundle.directionalLightsDiffuse[ i ], generatedLightList[ i ]->getDiffuse() );
-			shader.sendData( bundle.directionalLightsSpecular[ i ], generatedLightList[ i ]->getSpecular() );
+				placement.slot = nextFree;
+				update.dirty.emplace_back( nextFree );
+			}
 		}
 
-		for( size_t i = 0; i != generatedRooms.size(); i++ ) {
-			shader.sendData( bundle.roomsLowerLeft[ i ], generatedRooms[ i ].lowerLeft );
-			shader.sendData( bundle.roomsUpperRight[ i ], generatedRooms[ i ].upperRight );
-			shader.sendData2i( bundle.roomsMapLocation[ i ], generatedRooms[ i ].mapLocation );
-			shader.sendData( bundle.roomsLevel[ i ], generatedRooms[ i ].level );
+		while( !generatedRooms.empty() && generatedRooms.back().level == -1 && !taken[ generatedRooms.size() - 1 ] ) {
+			generatedRooms.pop_back();
 		}
 
-		int lastUnsetRoom = generatedRooms.size();
-		int numRoomSlots  = bundle.roomsLowerLeft.size() - lastUnsetRoom;
-		for( int i = 0; i != numRoomSlots; i++ ) {
-			shader.sendData( bundle.roomsLevel[ lastUnsetRoom + i ], ( int ) -1 );
+		generatedLightList.assign( generatedRooms.size() + 1, &outdoorLight );
+		std::vector< const Placement* > dirtyPlacements( generatedRooms.size() );
+		for( const Placement& placement : placements ) {
+			generatedLightList[ *placement.slot + 1 ] = &placement.room->getBackgroundLight();
+			dirtyPlacements[ *placement.slot ] = &placement;
 		}
 
-		if( generatedRoomData ) {
-			if( !claimedTextureUnit ) {
-				claimedTextureUnit = Tools::OpenGL::getTextureUnit();
-				if ( !claimedTextureUnit ) {
-					Log::getInstance().error( "LightmapManager::send", "Failed to obtain texture unit!" );
-					return;
+		tbb::parallel_for( ( size_t ) 0, update.dirty.size(), [ & ]( size_t i ) {
+			size_t slot = update.dirty[ i ];
+			const Placement& placement = *dirtyPlacements[ slot ];
+
+			ShaderRoom& shaderRoom = generatedRooms[ slot ] = getFragmentData( *placement.room, placement.level, slot + 1 );
+			shaderRoom.hash = placement.hash;
+			shaderRoom.points = placement.room->getPoints();
+		} );
+
+		for( size_t slot : update.dirty ) {
+			ShaderRoom& shaderRoom = generatedRooms[ slot ];
+
+			std::optional< Containers::RectanglePacker::Rectangle > region;
+			while( !( region = packer.insert( shaderRoom.dimensions.x, shaderRoom.dimensions.y ) ) ) {
+				packer.grow( shaderRoom.dimensions.x, shaderRoom.dimensions.y );
+			}
+
+			shaderRoom.region = *region;
+			shaderRoom.mapLocation = glm::ivec2{ region->x, region->y - 1 };
+		}
+
+		glm::ivec2 packedSize{ packer.getWidth(), packer.getHeight() };
+		update.resized = packedSize != textureSize;
+		textureSize = packedSize;
+
+		return update;
+	}
+
+	void LightmapManager::uploadRegions( const RegionUpdate& update ) {
+		if( update.resized || !generatedRoomData ) {
+			std::vector< float > blank( textureSize.x * textureSize.y, 0.0f );
+			generatedRoomData.emplace( glm::uvec2( textureSize ), blank.data() );
+			Log::getInstance().debug( "LightmapManager::uploadRegions", "Room boxpack texture is " + std::to_string( textureSize.x ) + " by " + std::to_string( textureSize.y ) + ", " + std::to_string( packer.getOccupancy() * 100.0 ) + "% occupied" );
+
+			for( const ShaderRoom& shaderRoom : generatedRooms ) {
+				if( shaderRoom.level != -1 && shaderRoom.region.width && shaderRoom.region.height ) {
+					generatedRoomData->update( glm::uvec2( shaderRoom.region.x, shaderRoom.region.y ), glm::uvec2( shaderRoom.dimensions ), shaderRoom.mapData.get() );
 				}
 			}
 
-			glActiveTexture( GL_TEXTURE0 + *claimedTextureUnit );
-			glBindTexture( GL_TEXTURE_2D, generatedRoomData->id );
-			shader.sendData( bundle.roomData, ( int ) *claimedTextureUnit );
+			return;
+		}
+
+		for( const auto& region : update.cleared ) {
+			std::vector< float > blank( region.width * region.height, 0.0f );
+			generatedRoomData->update( glm::uvec2( region.x, region.y ), glm::uvec2( region.width, region.height ), blank.data() );
+		}
+
+		for( size_t slot : update.dirty ) {
+			const ShaderRoom& shaderRoom = generatedRooms[ slot ];
+			if( shaderRoom.region.width && shaderRoom.region.height ) {
+				generatedRoomData->update( glm::uvec2( shaderRoom.region.x, shaderRoom.region.y ), glm::uvec2( shaderRoom.dimensions ), shaderRoom.mapData.get() );
+			}
 		}
 	}
 
-	LightmapManager::UniformBundle::UniformBundle( const Shader& shader ) {
-		static int numLights = ConfigManager::getInstance().getIntValue( "shader_max_lights" );
-		static int numRooms = ConfigManager::getInstance().getIntValue( "shader_max_rooms" );
+	std::vector< Std140Room > LightmapManager::getStd140Rooms() const {
+		std::vector< Std140Room > result;
+		result.reserve( generatedRooms.size() );
 
-		for( int i = 0; i != numLights; i++ ) {
-			directionalLightsDirection.emplace_back( shader.getUniform( "directionalLights[" + std::to_string( i ) + "].direction" ) );
-			directionalLightsAmbient.emplace_back( shader.getUniform( "directionalLights[" + std::to_string( i ) + "].ambient" ) );
-			directionalLightsDiffuse.emplace_back( shader.getUniform( "directionalLights[" + std::to_string( i ) + "].diffuse" ) );
-			directionalLightsSpecular.emplace_back( shader.getUniform( "directionalLights[" + std::to_string( i ) + "].specular" ) );
+		for( const ShaderRoom& shaderRoom : generatedRooms ) {
+			result.emplace_back( Std140Room{ shaderRoom.lowerLeft, shaderRoom.upperRight, shaderRoom.mapLocation, shaderRoom.level } );
 		}
 
-		for( int i = 0; i != numRooms; i++ ) {
-			roomsLowerLeft.emplace_back( shader.getUniform( "rooms[" + std::to_string( i ) + "].lowerLeft" ) );
-			roomsUpperRight.emplace_back( shader.getUniform( "rooms[" + std::to_string( i ) + "].upperRight" ) );
-			roomsMapLocation.emplace_back( shader.getUniform( "rooms[" + std::to_string( i ) + "].mapLocation" ) );
-			roomsLevel.emplace_back( shader.getUniform( "rooms[" + std::to_string( i ) + "].level" ) );
+		return result;
+	}
+
+	void LightmapManager::uploadRooms() {
+		std::vector< Std140Room > rooms = getStd140Rooms();
+		tileIndex = indexRoomTiles( rooms );
+
+		roomBuffer.update( packRooms( rooms, tileIndex ) );
+		tileRoomBuffer.update( packTileRooms( tileIndex ) );
+
+		if( !tileIndexTexture ) {
+			glGenTextures( 1, &tileIndexTexture );
 		}
 
+		glBindTexture( GL_TEXTURE_2D, tileIndexTexture );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0 );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RG32I, tileIndex.size.x, tileIndex.size.y * tileIndex.levels, 0, GL_RG_INTEGER, GL_INT, tileIndex.entries.data() );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		roomsChanged = false;
+	}
+
+	/**
+	 * This should be called any time rooms are modified. Only rooms that differ from the last call are rasterized and uploaded.
+	 */
+	void LightmapManager::calculateLightmaps() {
+		uploadRegions( updateRegions() );
+		roomsChanged = true;
+	}
+
+	/**
+	 * Rooms and lights live in storage buffers bound to fixed binding points, so a shader change only needs the samplers.
+	 */
+	void LightmapManager::send( const Shader& shader ) {
+		const UniformBundle& bundle = uniforms.getUniforms( shader );
+
+		lightBuffer.update( packLights( generatedLightList ) );
+		if( roomsChanged ) {
+			uploadRooms();
+		}
+
+		if( !claimedTextureUnit ) {
+			claimedTextureUnit = Tools::OpenGL::getTextureUnit();
+		}
+		if( !claimedIndexUnit ) {
+			claimedIndexUnit = Tools::OpenGL::getTextureUnit();
+		}
+		if ( !claimedTextureUnit || !claimedIndexUnit ) {
+			Log::getInstance().error( "LightmapManager::send", "Failed to obtain texture unit!" );
+			return;
+		}
+
+		if( generatedRoomData ) {
+			glActiveTexture( GL_TEXTURE0 + *claimedTextureUnit );
+			glBindTexture( GL_TEXTURE_2D, generatedRoomData->id );
+			shader.sendData( bundle.roomData, ( int ) *claimedTextureUnit );
+		}
+
+		glActiveTexture( GL_TEXTURE0 + *claimedIndexUnit );
+		glBindTexture( GL_TEXTURE_2D, tileIndexTexture );
+		shader.sendData( bundle.roomIndex, ( int ) *claimedIndexUnit );
+	}
+
+	LightmapManager::UniformBundle::UniformBundle( const Shader& shader ) {
 		roomData = shader.getUniform( "roomData" );
+		roomIndex = shader.getUniform( "roomIndex" );
 	}
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+#include "graphics/scenegraph/mesh/bonepalette.hpp"
+#include "graphics/scenegraph/mesh/boneuniform.hpp"
+
+namespace BlueBear {
+  namespace Graphics {
+    namespace SceneGraph {
+      namespace Mesh {
+
+        // Must match BLUEBEAR_BONE_PALETTE_BINDING in system/shaders/common/ubo_bindings.glsl
+        static constexpr GLuint BONE_PALETTE_BINDING = 1;
+
+        BonePalette::~BonePalette() {
+          if( ssbo ) {
+            glDeleteBuffers( 1, &ssbo );
+          }
+        }
+
+        void BonePalette::clear() {
+          matrices.clear();
+          offsets.clear();
+        }
+
+        bool BonePalette::empty() const {
+          return matrices.empty();
+        }
+
+        unsigned int BonePalette::add( BoneUniform& boneUniform, const Animation::Animator& animator ) {
+          auto it = offsets.find( { &boneUniform, &animator } );
+          if( it != offsets.end() ) {
+            return it->second;
+          }
+
+          unsigned int offset = matrices.size();
+
+          boneUniform.configure( animator );
+          const std::vector< glm::mat4 >& boneList = boneUniform.getBoneList();
+          matrices.insert( matrices.end(), boneList.begin(), boneList.end() );
+
+          return offsets[ { &boneUniform, &animator } ] = offset;
+        }
+
+        const std::vector< glm::mat4 >& BonePalette::getMatrices() const {
+          return matrices;
+        }
+
+        bool BonePalette::upload() {
+          if( !GLEW_VERSION_4_3 ) {
+            return false;
+          }
+
+          if( !ssbo ) {
+            glGenBuffers( 1, &ssbo );
+          }
+
+          // Respecifying the whole store each frame lets the driver orphan last frame's copy instead of stalling on it
+          glBindBuffer( GL_SHADER_STORAGE_BUFFER, ssbo );
+            glBufferData( GL_SHADER_STORAGE_BUFFER, matrices.size() * sizeof( glm::mat4 ), matrices.data(), GL_STREAM_DRAW );
+          glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 );
+
+          glBindBufferBase( GL_SHADER_STORAGE_BUFFER, BONE_PALETTE_BINDING, ssbo );
+          return true;
+        }
+
+      }
+    }
+  }
+}
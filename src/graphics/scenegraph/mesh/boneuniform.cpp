@@ -18,23 +18,33 @@ namespace BlueBear {
           return std::make_unique< BoneUniform >( boneIDs );
         }
 
-        Shader::Uniform BoneUniform::getUniform( const Shader* shader ) {
+        const BoneUniform::BoneUniformBundle& BoneUniform::getUniforms( const Shader* shader ) {
           auto it = uniforms.find( shader );
           if( it != uniforms.end() ) {
             return it->second;
           }
 
-          return uniforms[ shader ] = shader->getUniform( "bones" );
+          return uniforms[ shader ] = BoneUniformBundle{ shader->getUniform( "bones" ), shader->getUniform( "boneOffset" ) };
         }
 
-        void BoneUniform::configure( const std::map< std::string, glm::mat4 >& computedBones ) {
-          boneUniform.clear();
+        void BoneUniform::configure( const Animation::Animator& animator ) {
+          const std::shared_ptr< const Animation::Skeleton >& skeleton = animator.getSkeleton();
+          if( resolvedSkeleton != skeleton ) {
+            jointIndices.clear();
+            for( const std::string& bone : boneIDs ) {
+              jointIndices.push_back( skeleton->getIndex( bone ) );
+            }
 
-          // Matrix 0 is always identity
-          boneUniform.push_back( glm::mat4() );
+            resolvedSkeleton = skeleton;
+            boneUniform.resize( boneIDs.size() + 1 );
+          }
 
-          for( const std::string& bone : boneIDs ) {
-            boneUniform.push_back( computedBones.find( bone )->second );
+          const std::vector< glm::mat4 >& computedBones = animator.getComputedMatrices();
+
+          // Matrix 0 is always identity
+          boneUniform[ 0 ] = glm::mat4();
+          for( size_t i = 0; i != jointIndices.size(); i++ ) {
+            boneUniform[ i + 1 ] = computedBones[ jointIndices[ i ] ];
           }
         }
 
@@ -42,12 +52,31 @@ namespace BlueBear {
           return boneUniform;
         }
 
+        bool BoneUniform::supportsPalette( const Shader& shader ) {
+          return getUniforms( &shader ).boneOffsetUniform != -1;
+        }
+
+        void BoneUniform::setPaletteOffset( std::optional< unsigned int > offset ) {
+          paletteOffset = offset;
+        }
+
         void BoneUniform::send( const Shader& shader ) {
+          const BoneUniformBundle& bundle = getUniforms( &shader );
+
+          if( paletteOffset && bundle.boneOffsetUniform != -1 ) {
+            shader.sendData( bundle.boneOffsetUniform, ( int ) *paletteOffset );
+            return;
+          }
+
           shader.sendData(
-            getUniform( &shader ),
+            bundle.bonesUniform,
             boneUniform.size(),
             glm::value_ptr( boneUniform[ 0 ] )
           );
+
+          if( bundle.boneOffsetUniform != -1 ) {
+            shader.sendData( bundle.boneOffsetUniform, -1 );
+          }
         }
 
       }
@@ -2,5 +2,27 @@
 
 namespace BlueBear::Graphics::SceneGraph::Mesh {
 
+	/**
+	 * Bind-pose bounds in mesh space, through the same transform as getTriangles(). Vertex data never changes after
+	 * construction, so this is computed once per generic transform method.
+	 */
+	const std::optional< Geometry::AABB >& Mesh::getLocalBounds() {
+		if( !localBoundsComputed ) {
+			localBoundsComputed = true;
 
-}
\ No newline at end of file
+			for( const Geometry::Triangle& triangle : getTriangles() ) {
+				for( const glm::vec3& point : triangle ) {
+					if( localBounds ) {
+						localBounds->minima = glm::min( localBounds->minima, point );
+						localBounds->maxima = glm::max( localBounds->maxima, point );
+					} else {
+						localBounds = Geometry::AABB{ point, point };
+					}
+				}
+			}
+		}
+
+		return localBounds;
+	}
+
+}
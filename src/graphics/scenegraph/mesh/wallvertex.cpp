@@ -0,0 +1,42 @@
+#include "graphics/scenegraph/mesh/wallvertex.hpp"
+#include "graphics/shader.hpp"
+#include "tools/utility.hpp"
+#include <GL/glew.h>
+
+namespace BlueBear {
+  namespace Graphics {
+    namespace SceneGraph {
+      namespace Mesh {
+
+        bool WallVertex::operator==( const WallVertex& rhs ) const {
+          return Tools::Utility::equalEpsilon( position, rhs.position ) &&
+            Tools::Utility::equalEpsilon( normal, rhs.normal ) &&
+            Tools::Utility::equalEpsilon( textureCoordinates, rhs.textureCoordinates ) &&
+            piece == rhs.piece;
+        }
+
+        void WallVertex::setupShaderAttributes() {
+          glEnableVertexAttribArray( 0 );
+          glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( WallVertex ), ( GLvoid* ) 0 );
+
+          glEnableVertexAttribArray( 1 );
+          glVertexAttribPointer( 1, 3, GL_FLOAT, GL_FALSE, sizeof( WallVertex ), ( GLvoid* ) offsetof( WallVertex, normal ) );
+
+          glEnableVertexAttribArray( 2 );
+          glVertexAttribPointer( 2, 2, GL_FLOAT, GL_FALSE, sizeof( WallVertex ), ( GLvoid* ) offsetof( WallVertex, textureCoordinates ) );
+
+          glEnableVertexAttribArray( 3 );
+          glVertexAttribIPointer( 3, 1, GL_INT, sizeof( WallVertex ), ( GLvoid* ) offsetof( WallVertex, piece ) );
+        }
+
+        std::pair< std::string, std::string > WallVertex::getDefaultShader() {
+          return std::pair< std::string, std::string >(
+            "system/shaders/infr_wall/merged_vertex.glsl",
+            "system/shaders/infr_wall/fragment.glsl"
+          );
+        }
+
+      }
+    }
+  }
+}
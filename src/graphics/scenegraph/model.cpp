@@ -178,7 +178,7 @@ namespace BlueBear {
       }
 
       Transform& Model::getLocalTransform() {
-        boundingVolume = nullptr;
+        invalidateBoundingVolume();
         return transform;
       }
 
@@ -187,7 +187,7 @@ namespace BlueBear {
       }
 
       void Model::setLocalTransform( Transform transform ) {
-        boundingVolume = nullptr;
+        invalidateBoundingVolume();
         this->transform = transform;
       }
 
@@ -278,7 +278,7 @@ namespace BlueBear {
               if( it != drawable.mesh->meshUniforms.end() ) {
                 Mesh::BoneUniform* boneUniform = ( Mesh::BoneUniform* ) it->second.get();
                 // This doesn't hurt too much because the bone uniform will have configure called again before send
-                boneUniform->configure( parentAnimator->getComputedMatrices() );
+                boneUniform->configure( *parentAnimator );
 
                 std::vector< glm::mat4 > boneList = boneUniform->getBoneList();
 
@@ -340,6 +340,69 @@ namespace BlueBear {
 
       void Model::invalidateBoundingVolume() {
         boundingVolume = nullptr;
+
+        // Keep the hierarchy topology around; if the triangle count survives, it only needs a refit
+        if( pickingHierarchy ) {
+          pickingHierarchy->stale = true;
+        }
+      }
+
+      void Model::updatePickingHierarchy() {
+        if( pickingHierarchy && !pickingHierarchy->stale ) {
+          return;
+        }
+
+        std::vector< ModelTriangle > modelTriangles = getModelTriangles( animator.get() );
+
+        std::vector< Geometry::Triangle > triangles;
+        std::vector< Geometry::AABB > boxes;
+        triangles.reserve( modelTriangles.size() );
+        boxes.reserve( modelTriangles.size() );
+        for( const auto& modelTriangle : modelTriangles ) {
+          const Geometry::Triangle& triangle = triangles.emplace_back( Geometry::Triangle{
+            modelTriangle.second * glm::vec4{ modelTriangle.first[ 0 ], 1.0f },
+            modelTriangle.second * glm::vec4{ modelTriangle.first[ 1 ], 1.0f },
+            modelTriangle.second * glm::vec4{ modelTriangle.first[ 2 ], 1.0f }
+          } );
+
+          boxes.emplace_back( Geometry::AABB{
+            glm::min( triangle[ 0 ], glm::min( triangle[ 1 ], triangle[ 2 ] ) ),
+            glm::max( triangle[ 0 ], glm::max( triangle[ 1 ], triangle[ 2 ] ) )
+          } );
+        }
+
+        if( pickingHierarchy && pickingHierarchy->triangles.size() == triangles.size() ) {
+          pickingHierarchy->hierarchy.refit( boxes );
+        } else {
+          pickingHierarchy = std::make_unique< PickingHierarchy >();
+          pickingHierarchy->hierarchy.build( boxes );
+        }
+
+        pickingHierarchy->triangles = std::move( triangles );
+        pickingHierarchy->stale = false;
+      }
+
+      std::optional< Geometry::AABB > Model::getBoundingBox() {
+        updatePickingHierarchy();
+
+        if( pickingHierarchy->hierarchy.empty() ) {
+          return {};
+        }
+
+        return pickingHierarchy->hierarchy.getBounds();
+      }
+
+      std::optional< float > Model::getIntersectionDistance( const Geometry::Ray& ray ) {
+        updatePickingHierarchy();
+
+        const std::vector< Geometry::Triangle >& triangles = pickingHierarchy->triangles;
+        if( auto hit = pickingHierarchy->hierarchy.raycast( ray, [ & ]( unsigned int index ) {
+          return Geometry::getIntersectionDistance( ray, triangles[ index ] );
+        } ) ) {
+          return hit->distance;
+        }
+
+        return {};
       }
 
     }
@@ -1,4 +1,5 @@
 #include "graphics/scenegraph/modelloader/assimpmodelloader.hpp"
+#include "graphics/scenegraph/modelloader/modelcache.hpp"
 #include "graphics/scenegraph/drawable.hpp"
 #include "graphics/scenegraph/animation/animator.hpp"
 #include "graphics/scenegraph/mesh/meshdefinition.hpp"
@@ -9,24 +10,28 @@
 #include "graphics/scenegraph/mesh/boneuniform.hpp"
 #include "graphics/scenegraph/model.hpp"
 #include "graphics/scenegraph/material.hpp"
-#include "graphics/scenegraph/transform.hpp"
 #include "graphics/scenegraph/resourcebank.hpp"
 #include "graphics/utilities/shader_manager.hpp"
 #include "graphics/texture.hpp"
 #include "graphics/shader.hpp"
 #include "tools/assimptools.hpp"
+#include "configmanager.hpp"
 #include "log.hpp"
 #include <assimp/postprocess.h>
 #include <assimp/matrix4x4.h>
 #include <assimp/material.h>
+#include <algorithm>
+#include <cstring>
 #include <map>
+#include <optional>
 
 namespace BlueBear {
   namespace Graphics {
     namespace SceneGraph {
       namespace ModelLoader {
 
-        AssimpModelLoader::AssimpModelLoader( Utilities::ShaderManager& shaderManager ) : shaderManager( shaderManager ) {}
+        AssimpModelLoader::AssimpModelLoader( Utilities::ShaderManager& shaderManager ) :
+          shaderManager( shaderManager ), cacheDirectory( ConfigManager::getInstance().getValue( "model_cache_path" ) ) {}
 
         void AssimpModelLoader::log( const std::string& tag, const std::string& message ) {
           std::string indents;
@@ -73,8 +78,8 @@ namespace BlueBear {
           return result;
         }
 
-        std::vector< GLuint > AssimpModelLoader::getIndices( aiMesh* mesh ) {
-          std::vector< GLuint > indices;
+        std::vector< uint32_t > AssimpModelLoader::getIndices( aiMesh* mesh ) {
+          std::vector< uint32_t > indices;
 
           for( size_t i = 0; i < mesh->mNumFaces; i++ ) {
             aiFace face = mesh->mFaces[ i ];
@@ -108,36 +113,85 @@ namespace BlueBear {
         template Mesh::TexturedVertex AssimpModelLoader::getVertex( const aiVector3D&, const aiVector3D& );
         template Mesh::BasicVertex AssimpModelLoader::getVertex( const aiVector3D&, const aiVector3D& );
 
-        template < typename VertexType >
-        void AssimpModelLoader::assignBonesToVertex( VertexType& vertex, unsigned int vertexIndex, aiBone** bones, unsigned int numBones ) {
-          // Max 4 bones per vertex
-          unsigned int vertexBoneNumber = 0;
+        /**
+         * One pass over every bone's weight list, scattering each weight into its vertex's slots. A vertex with more than
+         * four influences keeps the strongest four (ties keep the earlier bone) and has its weights renormalised.
+         */
+        std::vector< AssimpModelLoader::BoneInfluence > AssimpModelLoader::getBoneInfluences( aiBone** bones, unsigned int numBones, unsigned int numVertices ) {
+          std::vector< BoneInfluence > influences( numVertices );
 
           for( size_t boneIndex = 0; boneIndex < numBones; boneIndex++ ) {
             aiBone* bone = bones[ boneIndex ];
+            // boneIndex + 1, because bone 0 is always an identity bone
+            int boneID = boneIndex + 1;
 
             for( size_t weightIndex = 0; weightIndex < bone->mNumWeights; weightIndex++ ) {
-              aiVertexWeight& vertexWeight = bone->mWeights[ weightIndex ];
+              const aiVertexWeight& vertexWeight = bone->mWeights[ weightIndex ];
+              if( vertexWeight.mVertexId >= numVertices ) {
+                continue;
+              }
+
+              BoneInfluence& influence = influences[ vertexWeight.mVertexId ];
+
+              // This same bone is not going to influence the same vertex twice; the first weight wins, even when it was not kept
+              if( influence.lastBoneID == boneID ) {
+                continue;
+              }
+              influence.lastBoneID = boneID;
+
+              if( influence.count < 4 ) {
+                influence.boneIDs[ influence.count ] = boneID;
+                influence.boneWeights[ influence.count ] = vertexWeight.mWeight;
+                influence.count++;
+              } else {
+                influence.truncated = true;
+
+                // Among equal weights the latest bone is the weakest, so the outcome never depends on slot order
+                unsigned int weakest = 0;
+                for( unsigned int slot = 1; slot != 4; slot++ ) {
+                  if(
+                    influence.boneWeights[ slot ] < influence.boneWeights[ weakest ] ||
+                    ( influence.boneWeights[ slot ] == influence.boneWeights[ weakest ] && influence.boneIDs[ slot ] > influence.boneIDs[ weakest ] )
+                  ) {
+                    weakest = slot;
+                  }
+                }
 
-              if( vertexWeight.mVertexId == vertexIndex ) {
-                if( vertexBoneNumber >= 4 ) {
-                  throw TooManyBonesException();
+                if( vertexWeight.mWeight > influence.boneWeights[ weakest ] ) {
+                  influence.boneIDs[ weakest ] = boneID;
+                  influence.boneWeights[ weakest ] = vertexWeight.mWeight;
                 }
+              }
+            }
+          }
 
-                // boneIndex + 1, because bone 0 is always an identity bone
-                vertex.boneIDs[ vertexBoneNumber ] = boneIndex + 1;
-                vertex.boneWeights[ vertexBoneNumber ] = vertexWeight.mWeight;
-                vertexBoneNumber++;
-                // This same bone is not going to influence the same vertex twice
-                break;
+          for( BoneInfluence& influence : influences ) {
+            if( influence.truncated ) {
+              float total = influence.boneWeights.x + influence.boneWeights.y + influence.boneWeights.z + influence.boneWeights.w;
+              if( total > 0.0f ) {
+                influence.boneWeights /= total;
               }
             }
           }
+
+          return influences;
+        }
+
+        template < typename VertexType >
+        void AssimpModelLoader::assignBonesToVertex( VertexType& vertex, const BoneInfluence& influence ) {
+          vertex.boneIDs = influence.boneIDs;
+          vertex.boneWeights = influence.boneWeights;
         }
-        template void AssimpModelLoader::assignBonesToVertex( Mesh::TexturedRiggedVertex&, unsigned int, aiBone**, unsigned int );
-        template void AssimpModelLoader::assignBonesToVertex( Mesh::RiggedVertex&, unsigned int, aiBone**, unsigned int );
+        template void AssimpModelLoader::assignBonesToVertex( Mesh::TexturedRiggedVertex&, const BoneInfluence& );
+        template void AssimpModelLoader::assignBonesToVertex( Mesh::RiggedVertex&, const BoneInfluence& );
 
-        std::shared_ptr< Mesh::Mesh > AssimpModelLoader::getMesh( aiMesh* mesh, aiMatrix4x4 transform ) {
+        template < typename VertexType >
+        void AssimpModelLoader::setVertices( ModelDescription::Mesh& result, const std::vector< VertexType >& vertices ) {
+          const unsigned char* data = reinterpret_cast< const unsigned char* >( vertices.data() );
+          result.vertices.assign( data, data + ( vertices.size() * sizeof( VertexType ) ) );
+        }
+
+        ModelDescription::Mesh AssimpModelLoader::getMesh( aiMesh* mesh, aiMatrix4x4 transform ) {
           bool usesBones = useBones && mesh->HasBones();
           bool usesTextures = (
             (
@@ -150,41 +204,45 @@ namespace BlueBear {
           log( "AssimpModelLoader::getMesh", usesIndices ? "Uses indices" : "Doesn't use indices" );
           log( "AssimpModelLoader::getMesh", std::to_string( mesh->mNumVertices ) + " vertices" );
 
-          std::shared_ptr< Mesh::Mesh > result;
+          ModelDescription::Mesh result;
+          result.indexed = usesIndices;
+          if( usesIndices ) {
+            result.indices = getIndices( mesh );
+          }
 
           if( usesBones ) {
+            result.boneIds = getBoneIds( mesh->mBones, mesh->mNumBones );
+
+            std::vector< BoneInfluence > influences = getBoneInfluences( mesh->mBones, mesh->mNumBones, mesh->mNumVertices );
+            size_t truncated = std::count_if( influences.begin(), influences.end(), []( const BoneInfluence& influence ) { return influence.truncated; } );
+            if( truncated ) {
+              log( "AssimpModelLoader::getMesh", std::to_string( truncated ) + " vertices have more than 4 bones; keeping the strongest 4" );
+            }
+
             if( usesTextures ) {
               // usesBones && usesTextures - TexturedRiggedVertex (textured material, bones)
               std::vector< Mesh::TexturedRiggedVertex > vertices;
               for( size_t i = 0; i < mesh->mNumVertices; i++ ) {
                 Mesh::TexturedRiggedVertex vertex = getVertex< Mesh::TexturedRiggedVertex >( transform * mesh->mVertices[ i ], transform * mesh->mNormals[ i ] );
                 vertex.textureCoordinates = glm::vec2( mesh->mTextureCoords[ 0 ][ i ].x, mesh->mTextureCoords[ 0 ][ i ].y );
-                assignBonesToVertex( vertex, i, mesh->mBones, mesh->mNumBones );
+                assignBonesToVertex( vertex, influences[ i ] );
                 vertices.push_back( vertex );
               }
 
-              auto md = usesIndices ?
-                std::make_shared< Mesh::MeshDefinition< Mesh::TexturedRiggedVertex > >( vertices, getIndices( mesh ), deferGLOperations ) :
-                std::make_shared< Mesh::MeshDefinition< Mesh::TexturedRiggedVertex > >( vertices, deferGLOperations );
-
-              md->meshUniforms.emplace( "bone", std::make_unique< Mesh::BoneUniform >( getBoneIds( mesh->mBones, mesh->mNumBones ) ) );
-              result = md;
+              result.format = ModelDescription::VertexFormat::TEXTURED_RIGGED;
+              setVertices( result, vertices );
 
             } else {
               // usesBones && !usesTextures - RiggedVertex (solid material, bones)
               std::vector< Mesh::RiggedVertex > vertices;
               for( size_t i = 0; i < mesh->mNumVertices; i++ ) {
                 Mesh::RiggedVertex vertex = getVertex< Mesh::RiggedVertex >( transform * mesh->mVertices[ i ], transform * mesh->mNormals[ i ] );
-                assignBonesToVertex( vertex, i, mesh->mBones, mesh->mNumBones );
+                assignBonesToVertex( vertex, influences[ i ] );
                 vertices.push_back( vertex );
               }
 
-              auto md = usesIndices ?
-                std::make_shared< Mesh::MeshDefinition< Mesh::RiggedVertex > >( vertices, getIndices( mesh ), deferGLOperations ) :
-                std::make_shared< Mesh::MeshDefinition< Mesh::RiggedVertex > >( vertices, deferGLOperations );
-
-              md->meshUniforms.emplace( "bone", std::make_unique< Mesh::BoneUniform >( getBoneIds( mesh->mBones, mesh->mNumBones ) ) );
-              result = md;
+              result.format = ModelDescription::VertexFormat::RIGGED;
+              setVertices( result, vertices );
 
             }
           } else {
@@ -197,9 +255,8 @@ namespace BlueBear {
                 vertices.push_back( vertex );
               }
 
-              result = usesIndices ?
-                std::make_shared< Mesh::MeshDefinition< Mesh::TexturedVertex > >( vertices, getIndices( mesh ), deferGLOperations ) :
-                std::make_shared< Mesh::MeshDefinition< Mesh::TexturedVertex > >( vertices, deferGLOperations );
+              result.format = ModelDescription::VertexFormat::TEXTURED;
+              setVertices( result, vertices );
 
             } else {
               // !usesBones && !usesTextures - BasicVertex (solid material, no bones)
@@ -208,34 +265,30 @@ namespace BlueBear {
                 vertices.push_back( getVertex< Mesh::BasicVertex >( transform * mesh->mVertices[ i ], transform * mesh->mNormals[ i ] ) );
               }
 
-              result = usesIndices ?
-                std::make_shared< Mesh::MeshDefinition< Mesh::BasicVertex > >( vertices, getIndices( mesh ), deferGLOperations ) :
-                std::make_shared< Mesh::MeshDefinition< Mesh::BasicVertex > >( vertices, deferGLOperations );
+              result.format = ModelDescription::VertexFormat::BASIC;
+              setVertices( result, vertices );
             }
           }
 
           return result;
         }
 
-        std::vector< std::shared_ptr< Texture > > AssimpModelLoader::getTextureList( aiMaterial* material, aiTextureType type ) {
-          std::vector< std::shared_ptr< Texture > > textures;
+        std::vector< std::string > AssimpModelLoader::getTextureList( aiMaterial* material, aiTextureType type ) {
+          std::vector< std::string > textures;
 
           unsigned int texCount = material->GetTextureCount( type );
           for( size_t i = 0; i < texCount; i++ ) {
             aiString filename;
             material->GetTexture( type, i, &filename );
-            textures.push_back( getTexture( context.directory + "/" + filename.C_Str() ) );
+            // Kept relative, so that the cached description does not depend on where the model file lives
+            textures.push_back( filename.C_Str() );
           }
 
           return textures;
         }
 
-        std::shared_ptr< Material > AssimpModelLoader::getMaterial( aiMaterial* material ) {
-          std::shared_ptr< Material > result;
-
-          // Determine the magic combo of solids and textures
-          unsigned int diffuseTextures = material->GetTextureCount( aiTextureType_DIFFUSE );
-          unsigned int specularTextures = material->GetTextureCount( aiTextureType_SPECULAR );
+        ModelDescription::Material AssimpModelLoader::getMaterialDescription( aiMaterial* material ) {
+          ModelDescription::Material result;
 
           // Defaults
           aiColor3D ambient( 0.f, 0.f, 0.f );
@@ -244,56 +297,28 @@ namespace BlueBear {
           material->Get( AI_MATKEY_COLOR_DIFFUSE, diffuse );
           aiColor3D specular( 0.f, 0.f, 0.f );
           material->Get( AI_MATKEY_COLOR_SPECULAR, specular );
-          float shininess = 0.0f;
-          material->Get( AI_MATKEY_SHININESS, shininess );
-          float opacity = 1.0f;
-          material->Get( AI_MATKEY_OPACITY, opacity );
-
-          if( diffuseTextures && specularTextures ) {
-            result = getMaterial(
-              Tools::AssimpTools::aiColorToGLMvec3( ambient ),
-              getTextureList( material, aiTextureType_DIFFUSE ),
-              getTextureList( material, aiTextureType_SPECULAR ),
-              shininess,
-              opacity
-            );
-          } else if ( diffuseTextures ) {
-            result = getMaterial(
-              Tools::AssimpTools::aiColorToGLMvec3( ambient ),
-              getTextureList( material, aiTextureType_DIFFUSE ),
-              Tools::AssimpTools::aiColorToGLMvec3( specular ),
-              shininess,
-              opacity
-            );
-          } else if ( specularTextures ) {
-            result = getMaterial(
-              Tools::AssimpTools::aiColorToGLMvec3( ambient ),
-              Tools::AssimpTools::aiColorToGLMvec3( diffuse ),
-              getTextureList( material, aiTextureType_SPECULAR ),
-              shininess,
-              opacity
-            );
-          } else {
-            // Solid colours only
-            log( "AssimpModelLoader::getMaterial", "colours" );
-            log( "AssimpModelLoader::getMaterial", "Ambient: " + std::to_string( ambient.r ) + " " + std::to_string( ambient.g ) + " " + std::to_string( ambient.b ) );
-            log( "AssimpModelLoader::getMaterial", "Diffuse: " + std::to_string( diffuse.r ) + " " + std::to_string( diffuse.g ) + " " + std::to_string( diffuse.b ) );
-            log( "AssimpModelLoader::getMaterial", "Specular: " + std::to_string( specular.r ) + " " + std::to_string( specular.g ) + " " + std::to_string( specular.b ) );
-            log( "AssimpModelLoader::getMaterial", "Opacity: " + std::to_string( opacity ) );
-            result = getMaterial(
-              Tools::AssimpTools::aiColorToGLMvec3( ambient ),
-              Tools::AssimpTools::aiColorToGLMvec3( diffuse ),
-              Tools::AssimpTools::aiColorToGLMvec3( specular ),
-              shininess,
-              opacity
-            );
+          material->Get( AI_MATKEY_SHININESS, result.shininess );
+          material->Get( AI_MATKEY_OPACITY, result.opacity );
+
+          result.ambient = Tools::AssimpTools::aiColorToGLMvec3( ambient );
+          result.diffuse = Tools::AssimpTools::aiColorToGLMvec3( diffuse );
+          result.specular = Tools::AssimpTools::aiColorToGLMvec3( specular );
+          result.diffuseTextures = getTextureList( material, aiTextureType_DIFFUSE );
+          result.specularTextures = getTextureList( material, aiTextureType_SPECULAR );
+
+          if( result.diffuseTextures.empty() && result.specularTextures.empty() ) {
+            log( "AssimpModelLoader::getMaterialDescription", "colours" );
+            log( "AssimpModelLoader::getMaterialDescription", "Ambient: " + std::to_string( ambient.r ) + " " + std::to_string( ambient.g ) + " " + std::to_string( ambient.b ) );
+            log( "AssimpModelLoader::getMaterialDescription", "Diffuse: " + std::to_string( diffuse.r ) + " " + std::to_string( diffuse.g ) + " " + std::to_string( diffuse.b ) );
+            log( "AssimpModelLoader::getMaterialDescription", "Specular: " + std::to_string( specular.r ) + " " + std::to_string( specular.g ) + " " + std::to_string( specular.b ) );
+            log( "AssimpModelLoader::getMaterialDescription", "Opacity: " + std::to_string( result.opacity ) );
           }
 
           return result;
         }
 
-        std::map< double, glm::mat4 > AssimpModelLoader::getKeyframes( aiNodeAnim* nodeAnim ) {
-          std::map< double, glm::mat4 > result;
+        std::vector< ModelDescription::Keyframe > AssimpModelLoader::getKeyframes( aiNodeAnim* nodeAnim ) {
+          std::vector< ModelDescription::Keyframe > result;
 
           // Animation must have fully-formed first keyframe
           if( nodeAnim->mNumPositionKeys && nodeAnim->mNumRotationKeys && nodeAnim->mNumScalingKeys ) {
@@ -323,12 +348,13 @@ namespace BlueBear {
               if( !triplet.rotation ) { triplet.rotation = std::prev( it, 1 )->second.rotation; }
               if( !triplet.scale    ) { triplet.scale    = std::prev( it, 1 )->second.scale;    }
 
-              // Use triplet to assemble a glm::mat4 from a Transform
-              result[ it->first ] = Transform::componentsToMatrix(
+              // Keep the components as-is; the channel interpolates them without going through a matrix
+              result.emplace_back( ModelDescription::Keyframe{
+                it->first,
                 Tools::AssimpTools::aiToGLMvec3( *triplet.position ),
                 Tools::AssimpTools::aiToGLMquat( *triplet.rotation ),
                 Tools::AssimpTools::aiToGLMvec3( *triplet.scale )
-              );
+              } );
             }
 
           } else {
@@ -338,45 +364,49 @@ namespace BlueBear {
           return result;
         }
 
-        std::shared_ptr< Animation::Bone::AnimationMap > AssimpModelLoader::getAnimationMapForBone( const std::string& boneId ) {
-          if( context.scene->HasAnimations() ) {
-            std::shared_ptr< Animation::Bone::AnimationMap > animationMap = std::make_shared< Animation::Bone::AnimationMap >();
-
-            for( size_t i = 0; i < context.scene->mNumAnimations; i++ ) {
-              aiAnimation* animation = context.scene->mAnimations[ i ];
+        std::map< std::string, std::vector< ModelDescription::Keyframe > > AssimpModelLoader::getChannelsForBone( const std::string& boneId ) {
+          std::map< std::string, std::vector< ModelDescription::Keyframe > > channels;
 
-              for( size_t j = 0; j < animation->mNumChannels; j++ ) {
-                aiNodeAnim* nodeAnim = animation->mChannels[ j ];
-                if( std::string( nodeAnim->mNodeName.C_Str() ) == boneId ) {
-
-                  try {
-                    ( *animationMap )[ animation->mName.C_Str() ] = getKeyframes( nodeAnim );
-                  } catch( MalformedAnimationException& e ) {
-                    log(
-                      "AssimpModelLoader::getAnimationMapForBone",
-                       std::string( "Malformed animation " ) + animation->mName.C_Str() + " for bone ID " + boneId
-                     );
-                  }
+          for( size_t i = 0; i < context.scene->mNumAnimations; i++ ) {
+            aiAnimation* animation = context.scene->mAnimations[ i ];
 
+            for( size_t j = 0; j < animation->mNumChannels; j++ ) {
+              aiNodeAnim* nodeAnim = animation->mChannels[ j ];
+              if( std::string( nodeAnim->mNodeName.C_Str() ) == boneId ) {
+
+                try {
+                  channels[ animation->mName.C_Str() ] = getKeyframes( nodeAnim );
+                } catch( MalformedAnimationException& e ) {
+                  log(
+                    "AssimpModelLoader::getChannelsForBone",
+                     std::string( "Malformed animation " ) + animation->mName.C_Str() + " for bone ID " + boneId
+                   );
                 }
+
               }
             }
-
-            return animationMap->empty() ? nullptr : animationMap;
-          } else {
-            return nullptr;
           }
+
+          return channels;
         }
 
-        Animation::Bone AssimpModelLoader::getBoneFromNode( aiNode* node ) {
+        uint32_t AssimpModelLoader::getBoneFromNode( ModelDescription& description, aiNode* node ) {
+          uint32_t index = description.bones.size();
           std::string boneId = node->mName.C_Str();
-          Animation::Bone result( boneId, Tools::AssimpTools::aiToGLMmat4( node->mTransformation ), getAnimationMapForBone( boneId ) );
+
+          description.bones.emplace_back( ModelDescription::Bone{
+            boneId,
+            Tools::AssimpTools::aiToGLMmat4( node->mTransformation ),
+            getChannelsForBone( boneId ),
+            {}
+          } );
 
           for( size_t i = 0; i < node->mNumChildren; i++ ) {
-            result.addChild( getBoneFromNode( node->mChildren[ i ] ) );
+            uint32_t child = getBoneFromNode( description, node->mChildren[ i ] );
+            description.bones[ index ].children.push_back( child );
           }
 
-          return result;
+          return index;
         }
 
         std::map< std::string, Animation::Animation > AssimpModelLoader::getAnimationList() {
@@ -403,63 +433,183 @@ namespace BlueBear {
           return animList;
         }
 
-        std::shared_ptr< Animation::Animator > AssimpModelLoader::getAnimator( aiNode* node ) {
-          Animation::Bone rootSkeleton = getBoneFromNode( node );
-
-          return std::make_shared< Animation::Animator >(
-            rootSkeleton,
-            rootSkeleton,
-            getAnimationList()
-          );
-        }
-
-        std::shared_ptr< Model > AssimpModelLoader::getNode( aiNode* node, aiMatrix4x4 parentTransform ) {
+        void AssimpModelLoader::getNode( ModelDescription& description, aiNode* node, aiMatrix4x4 parentTransform ) {
           log( "AssimpModelLoader::getNode", std::string( "Node " ) + node->mName.C_Str() + " {" );
           context.logIndentation++;
 
           aiMatrix4x4 transform = parentTransform * node->mTransformation;
 
-          std::vector< Drawable > drawables;
+          uint32_t index = description.nodes.size();
+          description.nodes.emplace_back();
+          description.nodes[ index ].name = node->mName.C_Str();
+
           for( unsigned int i = 0; i != node->mNumMeshes; i++ ) {
             aiMesh* rawMesh = context.scene->mMeshes[ node->mMeshes[ i ] ];
 
-            std::shared_ptr< Mesh::Mesh > mesh = getMesh( rawMesh, transform );
-
-            std::shared_ptr< Shader > shader;
-            std::pair< std::string, std::string > shaderPair = mesh->getDefaultShader();
-            log( "AssimpModelLoader::getNode", std::string( "Attaching default shader " ) + shaderPair.first + ";" + shaderPair.second );
-            shader = getShader( shaderPair.first, shaderPair.second );
-
-            std::shared_ptr< Material > material;
-            unsigned int materialIndex = rawMesh->mMaterialIndex;
-
-            material = getMaterial( context.scene->mMaterials[ materialIndex ] );
-
-
-            drawables.push_back( Drawable{ mesh, shader, material } );
+            description.nodes[ index ].drawables.emplace_back( ModelDescription::Drawable{ ( uint32_t ) description.meshes.size(), rawMesh->mMaterialIndex } );
+            description.meshes.emplace_back( getMesh( rawMesh, transform ) );
           }
 
-          std::shared_ptr< Model > model = Model::create( node->mName.C_Str(), drawables );
-
           for( size_t i = 0; i < node->mNumChildren; i++ ) {
             aiNode* assimpChild = node->mChildren[ i ];
             // A skeleton is contained within a node called "Armature", with a single root bone as its child
             if( std::string( assimpChild->mName.C_Str() ) == "Armature" && assimpChild->mNumChildren == 1 ) {
               log( "AssimpModelLoader::getNode", "Adding animator skeleton" );
-              model->setAnimator( getAnimator( assimpChild->mChildren[ 0 ] ) );
+              int32_t skeleton = getBoneFromNode( description, assimpChild->mChildren[ 0 ] );
+              description.nodes[ index ].skeleton = skeleton;
             } else {
-              model->addChild( getNode( assimpChild, transform ) );
+              uint32_t child = description.nodes.size();
+              getNode( description, assimpChild, transform );
+              description.nodes[ index ].children.push_back( child );
             }
           }
 
           context.logIndentation--;
           log( "AssimpModelLoader::getNode", "}" );
+        }
+
+        ModelDescription AssimpModelLoader::describe() {
+          ModelDescription description;
+
+          for( size_t i = 0; i < context.scene->mNumMaterials; i++ ) {
+            description.materials.emplace_back( getMaterialDescription( context.scene->mMaterials[ i ] ) );
+          }
+
+          getNode( description, context.scene->mRootNode );
+          description.animations = getAnimationList();
+
+          return description;
+        }
+
+        template < typename VertexType >
+        std::shared_ptr< Mesh::Mesh > AssimpModelLoader::buildMeshDefinition( const ModelDescription::Mesh& mesh ) {
+          std::vector< VertexType > vertices( mesh.vertices.size() / sizeof( VertexType ) );
+          std::memcpy( vertices.data(), mesh.vertices.data(), vertices.size() * sizeof( VertexType ) );
+
+          auto md = mesh.indexed ?
+            std::make_shared< Mesh::MeshDefinition< VertexType > >( vertices, mesh.indices, deferGLOperations ) :
+            std::make_shared< Mesh::MeshDefinition< VertexType > >( vertices, deferGLOperations );
+
+          if( !mesh.boneIds.empty() ) {
+            md->meshUniforms.emplace( "bone", std::make_unique< Mesh::BoneUniform >( mesh.boneIds ) );
+          }
+
+          return md;
+        }
+
+        std::shared_ptr< Mesh::Mesh > AssimpModelLoader::buildMesh( const ModelDescription::Mesh& mesh ) {
+          switch( mesh.format ) {
+            case ModelDescription::VertexFormat::TEXTURED_RIGGED:
+              return buildMeshDefinition< Mesh::TexturedRiggedVertex >( mesh );
+            case ModelDescription::VertexFormat::RIGGED:
+              return buildMeshDefinition< Mesh::RiggedVertex >( mesh );
+            case ModelDescription::VertexFormat::TEXTURED:
+              return buildMeshDefinition< Mesh::TexturedVertex >( mesh );
+            case ModelDescription::VertexFormat::BASIC:
+            default:
+              return buildMeshDefinition< Mesh::BasicVertex >( mesh );
+          }
+        }
+
+        std::vector< std::shared_ptr< Texture > > AssimpModelLoader::buildTextureList( const std::vector< std::string >& paths ) {
+          std::vector< std::shared_ptr< Texture > > textures;
+
+          for( const std::string& path : paths ) {
+            textures.push_back( getTexture( context.directory + "/" + path ) );
+          }
+
+          return textures;
+        }
+
+        std::shared_ptr< Material > AssimpModelLoader::buildMaterial( const ModelDescription::Material& material ) {
+          // Determine the magic combo of solids and textures
+          if( !material.diffuseTextures.empty() && !material.specularTextures.empty() ) {
+            return getMaterial( material.ambient, buildTextureList( material.diffuseTextures ), buildTextureList( material.specularTextures ), material.shininess, material.opacity );
+          } else if ( !material.diffuseTextures.empty() ) {
+            return getMaterial( material.ambient, buildTextureList( material.diffuseTextures ), material.specular, material.shininess, material.opacity );
+          } else if ( !material.specularTextures.empty() ) {
+            return getMaterial( material.ambient, material.diffuse, buildTextureList( material.specularTextures ), material.shininess, material.opacity );
+          } else {
+            // Solid colours only
+            return getMaterial( material.ambient, material.diffuse, material.specular, material.shininess, material.opacity );
+          }
+        }
+
+        Animation::Bone AssimpModelLoader::buildBone( const ModelDescription& description, uint32_t index ) {
+          const ModelDescription::Bone& bone = description.bones[ index ];
+
+          std::shared_ptr< Animation::Bone::AnimationMap > animationMap;
+          if( !bone.channels.empty() ) {
+            animationMap = std::make_shared< Animation::Bone::AnimationMap >();
+            for( const auto& [ animation, keyframes ] : bone.channels ) {
+              Animation::Channel& channel = ( *animationMap )[ animation ];
+              for( const ModelDescription::Keyframe& keyframe : keyframes ) {
+                channel.addKeyframe( keyframe.time, keyframe.translation, keyframe.rotation, keyframe.scale );
+              }
+            }
+          }
+
+          Animation::Bone result( bone.id, bone.transform, animationMap );
+          for( uint32_t child : bone.children ) {
+            result.addChild( buildBone( description, child ) );
+          }
+
+          return result;
+        }
+
+        std::shared_ptr< Model > AssimpModelLoader::buildNode( const ModelDescription& description, uint32_t index ) {
+          const ModelDescription::Node& node = description.nodes[ index ];
+
+          std::vector< Drawable > drawables;
+          for( const ModelDescription::Drawable& drawable : node.drawables ) {
+            std::shared_ptr< Mesh::Mesh > mesh = buildMesh( description.meshes[ drawable.mesh ] );
+
+            std::pair< std::string, std::string > shaderPair = mesh->getDefaultShader();
+            std::shared_ptr< Shader > shader = getShader( shaderPair.first, shaderPair.second );
+
+            drawables.push_back( Drawable{ mesh, shader, buildMaterial( description.materials[ drawable.material ] ) } );
+          }
+
+          std::shared_ptr< Model > model = Model::create( node.name, drawables );
+
+          for( uint32_t child : node.children ) {
+            model->addChild( buildNode( description, child ) );
+          }
+
+          if( node.skeleton != -1 ) {
+            model->setAnimator( std::make_shared< Animation::Animator >( buildBone( description, node.skeleton ), description.animations ) );
+          }
+
           return model;
         }
 
+        std::shared_ptr< Model > AssimpModelLoader::build( const ModelDescription& description, const std::string& directory ) {
+          context.directory = directory;
+          return buildNode( description, 0 );
+        }
+
+        std::optional< uint64_t > AssimpModelLoader::getCacheKey( const std::string& filename ) {
+          if( cacheDirectory.empty() ) {
+            return {};
+          }
+
+          // Key covers everything that changes what describe() produces
+          return ModelCache::getKey( filename, { getFlags(), useIndices, useBones } );
+        }
+
         std::shared_ptr< Model > AssimpModelLoader::get( const std::string& filename ) {
           Log::getInstance().debug( "AssimpModelLoader::get", std::string( "Attempting to load " ) + filename );
 
+          std::string directory = filename.substr( 0, filename.find_last_of( '/' ) );
+
+          std::optional< uint64_t > key = getCacheKey( filename );
+          if( key ) {
+            if( std::optional< ModelDescription > description = ModelCache::load( ModelCache::getPath( cacheDirectory, *key ), *key ) ) {
+              Log::getInstance().debug( "AssimpModelLoader::get", std::string( "Loaded " ) + filename + " from model cache" );
+              return build( *description, directory );
+            }
+          }
+
           context = ImportContext();
 
           context.scene = importer.ReadFile( filename, getFlags() );
@@ -469,17 +619,21 @@ namespace BlueBear {
             return nullptr;
           }
 
-          context.directory = filename.substr( 0, filename.find_last_of( '/' ) );
+          context.directory = directory;
           // Fix Assimp's incoorect root transformation for COLLADA imports
           context.scene->mRootNode->mTransformation = aiMatrix4x4();
 
-          std::shared_ptr< Model > result = getNode( context.scene->mRootNode );
+          ModelDescription description = describe();
 
           importer.FreeScene();
 
+          if( key && !ModelCache::store( ModelCache::getPath( cacheDirectory, *key ), *key, description ) ) {
+            Log::getInstance().warn( "AssimpModelLoader::get", std::string( "Could not write model cache for " ) + filename );
+          }
+
           Log::getInstance().debug( "AssimpModelLoader::get", std::string( "Succesfully loaded " ) + filename );
 
-          return result;
+          return build( description, directory );
         }
 
       }
@@ -0,0 +1,158 @@
+#include "graphics/scenegraph/modelloader/loadscheduler.hpp"
+#include "graphics/scenegraph/model.hpp"
+#include "graphics/shader.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace BlueBear::Graphics::SceneGraph::ModelLoader {
+
+	float LoadScheduler::Progress::getFraction() const {
+		return requested ? ( float ) ( uploaded + failed ) / requested : 1.0f;
+	}
+
+	LoadScheduler::LoadScheduler( std::function< std::unique_ptr< FileModelLoader >() > createLoader ) : pool( createLoader ) {}
+
+	LoadScheduler::~LoadScheduler() {
+		// Workers hold this; they must all be out before it goes
+		std::unique_lock< std::mutex > lock( mutex );
+		parsedCondition.wait( lock, [ & ]() { return inFlight.empty(); } );
+	}
+
+	void LoadScheduler::prepareShaders( const Model& model ) {
+		for( const Drawable& drawable : model.getDrawableList() ) {
+			if( drawable.shader ) {
+				drawable.shader->prepare();
+			}
+		}
+
+		for( const std::shared_ptr< Model >& child : model.getChildren() ) {
+			prepareShaders( *child );
+		}
+	}
+
+	void LoadScheduler::load( const std::string& path ) {
+		std::shared_ptr< Model > model;
+
+		// Around the whole acquire, so that whatever throws, creating a loader included, still reaches the bookkeeping below
+		try {
+			pool.acquire( [ & ]( FileModelLoader& loader ) {
+				model = loader.get( path );
+				if( model ) {
+					prepareShaders( *model );
+				}
+			} );
+		} catch( std::exception& e ) {
+			model = nullptr;
+			Log::getInstance().error( "LoadScheduler::load", std::string( "Could not load model " ) + path + ": " + e.what() );
+		} catch( ... ) {
+			model = nullptr;
+			Log::getInstance().error( "LoadScheduler::load", std::string( "Could not load model " ) + path + ": unknown error" );
+		}
+
+		std::lock_guard< std::mutex > lock( mutex );
+		auto it = inFlight.find( path );
+		for( const std::string& id : it->second ) {
+			if( model ) {
+				parsed.emplace_back( id, model );
+			} else {
+				pending.erase( id );
+				progress.failed++;
+			}
+		}
+
+		progress.parsed += it->second.size();
+		inFlight.erase( it );
+		parsedCondition.notify_all();
+	}
+
+	bool LoadScheduler::enqueue( const std::string& id, const std::string& path ) {
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			if( !pending.insert( id ).second ) {
+				return false;
+			}
+			progress.requested++;
+
+			std::vector< std::string >& ids = inFlight[ path ];
+			ids.emplace_back( id );
+			if( ids.size() > 1 ) {
+				return true;
+			}
+		}
+
+		// Enqueued rather than spawned, so the load runs even while the GL thread never waits on the arena
+		arena.enqueue( [ this, path ]() { load( path ); } );
+		return true;
+	}
+
+	/**
+	 * Upload at most budget finished models on the calling (GL) thread.
+	 */
+	std::vector< LoadScheduler::Result > LoadScheduler::collect( unsigned int budget ) {
+		std::vector< Result > results;
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			while( results.size() < budget && !parsed.empty() ) {
+				results.emplace_back( std::move( parsed.front() ) );
+				parsed.pop_front();
+				pending.erase( results.back().first );
+			}
+		}
+
+		for( const Result& result : results ) {
+			result.second->sendDeferredObjects();
+		}
+
+		std::lock_guard< std::mutex > lock( mutex );
+		progress.uploaded += results.size();
+		return results;
+	}
+
+	/**
+	 * Wait for one model, out of turn, and upload it. Returns nullptr if the id was never requested or failed to load.
+	 */
+	std::shared_ptr< Model > LoadScheduler::finish( const std::string& id ) {
+		std::unique_lock< std::mutex > lock( mutex );
+		auto find = [ & ]() {
+			return std::find_if( parsed.begin(), parsed.end(), [ & ]( const Result& result ) { return result.first == id; } );
+		};
+		parsedCondition.wait( lock, [ & ]() { return !pending.count( id ) || find() != parsed.end(); } );
+
+		auto it = find();
+		if( it == parsed.end() ) {
+			return nullptr;
+		}
+
+		std::shared_ptr< Model > model = it->second;
+		parsed.erase( it );
+		pending.erase( id );
+		lock.unlock();
+
+		model->sendDeferredObjects();
+
+		lock.lock();
+		progress.uploaded++;
+		return model;
+	}
+
+	std::vector< LoadScheduler::Result > LoadScheduler::finishAll() {
+		{
+			std::unique_lock< std::mutex > lock( mutex );
+			parsedCondition.wait( lock, [ & ]() { return inFlight.empty(); } );
+		}
+
+		return collect( std::numeric_limits< unsigned int >::max() );
+	}
+
+	bool LoadScheduler::isPending( const std::string& id ) const {
+		std::lock_guard< std::mutex > lock( mutex );
+		return pending.count( id );
+	}
+
+	LoadScheduler::Progress LoadScheduler::getProgress() const {
+		std::lock_guard< std::mutex > lock( mutex );
+		return progress;
+	}
+
+}
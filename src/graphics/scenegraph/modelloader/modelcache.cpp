@@ -0,0 +1,412 @@
+#include "graphics/scenegraph/modelloader/modelcache.hpp"
+#include "tools/utility.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BlueBear::Graphics::SceneGraph::ModelLoader {
+
+	namespace {
+
+		constexpr char MAGIC[ 4 ] = { 'B', 'B', 'M', 'C' };
+
+		class Writer {
+			std::vector< unsigned char > bytes;
+
+		public:
+			template < typename T > void write( const T& value ) {
+				static_assert( std::is_trivially_copyable_v< T > );
+				const unsigned char* data = reinterpret_cast< const unsigned char* >( &value );
+				bytes.insert( bytes.end(), data, data + sizeof( T ) );
+			}
+
+			template < typename T > void writeArray( const std::vector< T >& values ) {
+				static_assert( std::is_trivially_copyable_v< T > );
+				write( ( uint32_t ) values.size() );
+				const unsigned char* data = reinterpret_cast< const unsigned char* >( values.data() );
+				bytes.insert( bytes.end(), data, data + ( values.size() * sizeof( T ) ) );
+			}
+
+			void write( const std::string& value ) {
+				write( ( uint32_t ) value.size() );
+				bytes.insert( bytes.end(), value.begin(), value.end() );
+			}
+
+			void write( const std::vector< std::string >& values ) {
+				write( ( uint32_t ) values.size() );
+				for( const std::string& value : values ) {
+					write( value );
+				}
+			}
+
+			std::vector< unsigned char > release() {
+				return std::move( bytes );
+			}
+		};
+
+		/**
+		 * Bounds-checked cursor over a mapped cache file. Every read that would run past the end throws,
+		 * so a truncated or foreign file is rejected instead of producing a half-built model.
+		 */
+		class Reader {
+			const unsigned char* cursor;
+			const unsigned char* end;
+
+			void require( size_t size ) {
+				if( ( size_t ) ( end - cursor ) < size ) {
+					throw ModelCache::CorruptCacheException();
+				}
+			}
+
+		public:
+			Reader( const unsigned char* data, size_t size ) : cursor( data ), end( data + size ) {}
+
+			template < typename T > T read() {
+				static_assert( std::is_trivially_copyable_v< T > );
+				require( sizeof( T ) );
+
+				T value;
+				std::memcpy( &value, cursor, sizeof( T ) );
+				cursor += sizeof( T );
+				return value;
+			}
+
+			template < typename T > std::vector< T > readArray() {
+				static_assert( std::is_trivially_copyable_v< T > );
+				size_t count = read< uint32_t >();
+				require( count * sizeof( T ) );
+
+				std::vector< T > values( count );
+				std::memcpy( values.data(), cursor, count * sizeof( T ) );
+				cursor += count * sizeof( T );
+				return values;
+			}
+
+			std::string readString() {
+				size_t size = read< uint32_t >();
+				require( size );
+
+				std::string value( reinterpret_cast< const char* >( cursor ), size );
+				cursor += size;
+				return value;
+			}
+
+			std::vector< std::string > readStrings() {
+				size_t count = read< uint32_t >();
+				std::vector< std::string > values;
+				values.reserve( std::min( count, ( size_t ) ( end - cursor ) ) );
+				for( size_t i = 0; i != count; i++ ) {
+					values.emplace_back( readString() );
+				}
+
+				return values;
+			}
+
+			uint32_t readIndex( size_t limit ) {
+				uint32_t index = read< uint32_t >();
+				if( index >= limit ) {
+					throw ModelCache::CorruptCacheException();
+				}
+
+				return index;
+			}
+
+			bool atEnd() const {
+				return cursor == end;
+			}
+		};
+
+		/**
+		 * Read-only view of a whole file; mmap where available so the vertex arrays are copied straight out of the page cache.
+		 */
+		class MappedFile {
+			const unsigned char* data = nullptr;
+			size_t size = 0;
+#ifdef _WIN32
+			std::vector< unsigned char > buffer;
+#endif
+
+		public:
+			MappedFile( const std::string& path ) {
+#ifdef _WIN32
+				std::ifstream stream( path, std::ios::binary );
+				if( stream ) {
+					buffer.assign( std::istreambuf_iterator< char >( stream ), std::istreambuf_iterator< char >() );
+					data = buffer.data();
+					size = buffer.size();
+				}
+#else
+				int descriptor = open( path.c_str(), O_RDONLY );
+				if( descriptor == -1 ) {
+					return;
+				}
+
+				struct stat status;
+				if( fstat( descriptor, &status ) == 0 && status.st_size > 0 ) {
+					void* mapping = mmap( nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+					if( mapping != MAP_FAILED ) {
+						data = static_cast< const unsigned char* >( mapping );
+						size = status.st_size;
+					}
+				}
+
+				close( descriptor );
+#endif
+			}
+
+			~MappedFile() {
+#ifndef _WIN32
+				if( data ) {
+					munmap( const_cast< unsigned char* >( data ), size );
+				}
+#endif
+			}
+
+			MappedFile( const MappedFile& ) = delete;
+			MappedFile& operator=( const MappedFile& ) = delete;
+
+			const unsigned char* getData() const { return data; }
+			size_t getSize() const { return size; }
+		};
+
+	}
+
+	std::optional< uint64_t > ModelCache::getKey( const std::string& sourcePath, const std::vector< uint32_t >& options ) {
+		MappedFile source( sourcePath );
+		if( !source.getData() ) {
+			return {};
+		}
+
+		uint64_t hash = Tools::Utility::fnv1a( source.getData(), source.getSize() );
+		return Tools::Utility::fnv1a( options.data(), options.size() * sizeof( uint32_t ), hash );
+	}
+
+	std::string ModelCache::getPath( const std::string& directory, uint64_t key ) {
+		std::stringstream stream;
+		stream << directory << "/" << std::hex << std::setw( 16 ) << std::setfill( '0' ) << key << ".bbmc";
+		return stream.str();
+	}
+
+	std::vector< unsigned char > ModelCache::serialize( const ModelDescription& description, uint64_t key ) {
+		Writer writer;
+
+		writer.write( MAGIC );
+		writer.write( VERSION );
+		writer.write( key );
+
+		writer.write( ( uint32_t ) description.meshes.size() );
+		for( const ModelDescription::Mesh& mesh : description.meshes ) {
+			writer.write( mesh.format );
+			writer.write( ( uint8_t ) mesh.indexed );
+			writer.writeArray( mesh.vertices );
+			writer.writeArray( mesh.indices );
+			writer.write( mesh.boneIds );
+		}
+
+		writer.write( ( uint32_t ) description.materials.size() );
+		for( const ModelDescription::Material& material : description.materials ) {
+			writer.write( material.ambient );
+			writer.write( material.diffuse );
+			writer.write( material.specular );
+			writer.write( material.diffuseTextures );
+			writer.write( material.specularTextures );
+			writer.write( material.shininess );
+			writer.write( material.opacity );
+		}
+
+		writer.write( ( uint32_t ) description.bones.size() );
+		for( const ModelDescription::Bone& bone : description.bones ) {
+			writer.write( bone.id );
+			writer.write( bone.transform );
+			writer.write( ( uint32_t ) bone.channels.size() );
+			for( const auto& [ animation, keyframes ] : bone.channels ) {
+				writer.write( animation );
+				writer.write( ( uint32_t ) keyframes.size() );
+				// Field by field so that struct padding never reaches the file
+				for( const ModelDescription::Keyframe& keyframe : keyframes ) {
+					writer.write( keyframe.time );
+					writer.write( keyframe.translation );
+					writer.write( keyframe.rotation );
+					writer.write( keyframe.scale );
+				}
+			}
+			writer.writeArray( bone.children );
+		}
+
+		writer.write( ( uint32_t ) description.nodes.size() );
+		for( const ModelDescription::Node& node : description.nodes ) {
+			writer.write( node.name );
+			writer.write( ( uint32_t ) node.drawables.size() );
+			for( const ModelDescription::Drawable& drawable : node.drawables ) {
+				writer.write( drawable.mesh );
+				writer.write( drawable.material );
+			}
+			writer.writeArray( node.children );
+			writer.write( node.skeleton );
+		}
+
+		writer.write( ( uint32_t ) description.animations.size() );
+		for( const auto& [ name, animation ] : description.animations ) {
+			writer.write( name );
+			writer.write( animation.id );
+			writer.write( animation.fps );
+			writer.write( animation.duration );
+		}
+
+		return writer.release();
+	}
+
+	std::optional< ModelDescription > ModelCache::deserialize( const unsigned char* data, size_t size, uint64_t key ) {
+		Reader reader( data, size );
+		ModelDescription description;
+
+		try {
+			char magic[ 4 ];
+			for( char& character : magic ) {
+				character = reader.read< char >();
+			}
+			if( std::memcmp( magic, MAGIC, sizeof( MAGIC ) ) || reader.read< uint32_t >() != VERSION || reader.read< uint64_t >() != key ) {
+				return {};
+			}
+
+			description.meshes.resize( reader.read< uint32_t >() );
+			for( ModelDescription::Mesh& mesh : description.meshes ) {
+				uint32_t format = reader.read< uint32_t >();
+				if( format > ( uint32_t ) ModelDescription::VertexFormat::TEXTURED_RIGGED ) {
+					throw CorruptCacheException();
+				}
+				mesh.format = ( ModelDescription::VertexFormat ) format;
+				mesh.indexed = reader.read< uint8_t >();
+				mesh.vertices = reader.readArray< unsigned char >();
+				mesh.indices = reader.readArray< uint32_t >();
+				mesh.boneIds = reader.readStrings();
+
+				size_t vertexSize = ModelDescription::getVertexSize( mesh.format );
+				if( mesh.vertices.size() % vertexSize ) {
+					throw CorruptCacheException();
+				}
+
+				size_t vertexCount = mesh.vertices.size() / vertexSize;
+				for( uint32_t index : mesh.indices ) {
+					if( index >= vertexCount ) {
+						throw CorruptCacheException();
+					}
+				}
+			}
+
+			description.materials.resize( reader.read< uint32_t >() );
+			for( ModelDescription::Material& material : description.materials ) {
+				material.ambient = reader.read< glm::vec3 >();
+				material.diffuse = reader.read< glm::vec3 >();
+				material.specular = reader.read< glm::vec3 >();
+				material.diffuseTextures = reader.readStrings();
+				material.specularTextures = reader.readStrings();
+				material.shininess = reader.read< float >();
+				material.opacity = reader.read< float >();
+			}
+
+			description.bones.resize( reader.read< uint32_t >() );
+			for( ModelDescription::Bone& bone : description.bones ) {
+				bone.id = reader.readString();
+				bone.transform = reader.read< glm::mat4 >();
+
+				uint32_t channels = reader.read< uint32_t >();
+				for( uint32_t i = 0; i != channels; i++ ) {
+					std::vector< ModelDescription::Keyframe >& keyframes = bone.channels[ reader.readString() ];
+					// describe() never produces an empty channel, and there would be nothing in one to sample
+					uint32_t count = reader.read< uint32_t >();
+					if( count == 0 ) {
+						throw CorruptCacheException();
+					}
+					for( uint32_t j = 0; j != count; j++ ) {
+						ModelDescription::Keyframe keyframe;
+						keyframe.time = reader.read< double >();
+						keyframe.translation = reader.read< glm::vec3 >();
+						keyframe.rotation = reader.read< glm::quat >();
+						keyframe.scale = reader.read< glm::vec3 >();
+						keyframes.emplace_back( keyframe );
+					}
+				}
+
+				bone.children = reader.readArray< uint32_t >();
+			}
+
+			description.nodes.resize( reader.read< uint32_t >() );
+			for( ModelDescription::Node& node : description.nodes ) {
+				node.name = reader.readString();
+				node.drawables.resize( reader.read< uint32_t >() );
+				for( ModelDescription::Drawable& drawable : node.drawables ) {
+					drawable.mesh = reader.readIndex( description.meshes.size() );
+					drawable.material = reader.readIndex( description.materials.size() );
+				}
+				node.children = reader.readArray< uint32_t >();
+				node.skeleton = reader.read< int32_t >();
+			}
+
+			uint32_t animations = reader.read< uint32_t >();
+			for( uint32_t i = 0; i != animations; i++ ) {
+				Animation::Animation& animation = description.animations[ reader.readString() ];
+				animation.id = reader.readString();
+				animation.fps = reader.read< double >();
+				animation.duration = reader.read< double >();
+			}
+
+			if( !reader.atEnd() || description.nodes.empty() ) {
+				throw CorruptCacheException();
+			}
+		} catch( CorruptCacheException& e ) {
+			return {};
+		}
+
+		// Children must point forward so that a corrupt file can never make the builder recurse forever
+		for( size_t i = 0; i != description.nodes.size(); i++ ) {
+			const ModelDescription::Node& node = description.nodes[ i ];
+			for( uint32_t child : node.children ) {
+				if( child <= i || child >= description.nodes.size() ) {
+					return {};
+				}
+			}
+			if( node.skeleton < -1 || node.skeleton >= ( int32_t ) description.bones.size() ) {
+				return {};
+			}
+		}
+
+		for( size_t i = 0; i != description.bones.size(); i++ ) {
+			for( uint32_t child : description.bones[ i ].children ) {
+				if( child <= i || child >= description.bones.size() ) {
+					return {};
+				}
+			}
+		}
+
+		return description;
+	}
+
+	std::optional< ModelDescription > ModelCache::load( const std::string& path, uint64_t key ) {
+		MappedFile file( path );
+		if( !file.getData() ) {
+			return {};
+		}
+
+		return deserialize( file.getData(), file.getSize(), key );
+	}
+
+	bool ModelCache::store( const std::string& path, uint64_t key, const ModelDescription& description ) {
+		std::vector< unsigned char > bytes = serialize( description, key );
+		return Tools::Utility::replaceFile( path, { std::string_view( reinterpret_cast< const char* >( bytes.data() ), bytes.size() ) } );
+	}
+
+}
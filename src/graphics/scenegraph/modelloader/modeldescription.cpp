@@ -0,0 +1,69 @@
+#include "graphics/scenegraph/modelloader/modeldescription.hpp"
+#include "graphics/scenegraph/mesh/basicvertex.hpp"
+#include "graphics/scenegraph/mesh/texturedvertex.hpp"
+#include "graphics/scenegraph/mesh/riggedvertex.hpp"
+#include "graphics/scenegraph/mesh/texturedriggedvertex.hpp"
+
+namespace BlueBear::Graphics::SceneGraph::ModelLoader {
+
+	size_t ModelDescription::getVertexSize( VertexFormat format ) {
+		switch( format ) {
+			case VertexFormat::TEXTURED:
+				return sizeof( SceneGraph::Mesh::TexturedVertex );
+			case VertexFormat::RIGGED:
+				return sizeof( SceneGraph::Mesh::RiggedVertex );
+			case VertexFormat::TEXTURED_RIGGED:
+				return sizeof( SceneGraph::Mesh::TexturedRiggedVertex );
+			case VertexFormat::BASIC:
+			default:
+				return sizeof( SceneGraph::Mesh::BasicVertex );
+		}
+	}
+
+	bool ModelDescription::Mesh::operator==( const Mesh& rhs ) const {
+		return format == rhs.format && indexed == rhs.indexed && vertices == rhs.vertices && indices == rhs.indices && boneIds == rhs.boneIds;
+	}
+
+	bool ModelDescription::Material::operator==( const Material& rhs ) const {
+		return
+			ambient == rhs.ambient && diffuse == rhs.diffuse && specular == rhs.specular &&
+			diffuseTextures == rhs.diffuseTextures && specularTextures == rhs.specularTextures &&
+			shininess == rhs.shininess && opacity == rhs.opacity;
+	}
+
+	bool ModelDescription::Drawable::operator==( const Drawable& rhs ) const {
+		return mesh == rhs.mesh && material == rhs.material;
+	}
+
+	bool ModelDescription::Keyframe::operator==( const Keyframe& rhs ) const {
+		return time == rhs.time && translation == rhs.translation && rotation == rhs.rotation && scale == rhs.scale;
+	}
+
+	bool ModelDescription::Bone::operator==( const Bone& rhs ) const {
+		return id == rhs.id && transform == rhs.transform && channels == rhs.channels && children == rhs.children;
+	}
+
+	bool ModelDescription::Node::operator==( const Node& rhs ) const {
+		return name == rhs.name && drawables == rhs.drawables && children == rhs.children && skeleton == rhs.skeleton;
+	}
+
+	bool ModelDescription::operator==( const ModelDescription& rhs ) const {
+		if( animations.size() != rhs.animations.size() ) {
+			return false;
+		}
+
+		for( auto lhsIt = animations.begin(), rhsIt = rhs.animations.begin(); lhsIt != animations.end(); ++lhsIt, ++rhsIt ) {
+			if(
+				lhsIt->first != rhsIt->first ||
+				lhsIt->second.id != rhsIt->second.id ||
+				lhsIt->second.fps != rhsIt->second.fps ||
+				lhsIt->second.duration != rhsIt->second.duration
+			) {
+				return false;
+			}
+		}
+
+		return meshes == rhs.meshes && materials == rhs.materials && bones == rhs.bones && nodes == rhs.nodes;
+	}
+
+}
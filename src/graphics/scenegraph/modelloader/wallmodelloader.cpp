@@ -6,37 +6,60 @@
 #include "graphics/shader.hpp"
 #include "graphics/utilities/shader_manager.hpp"
 #include "graphics/scenegraph/uniforms/level_uniform.hpp"
+#include "graphics/scenegraph/mesh/meshdefinition.hpp"
 #include "exceptions/nullpointerexception.hpp"
 #include "tools/utility.hpp"
+#include "configmanager.hpp"
+#include <algorithm>
 
 namespace BlueBear::Graphics::SceneGraph::ModelLoader {
 
   WallModelLoader::WallModelLoader( const std::vector< Models::Infrastructure::FloorLevel >& floorLevels, Vector::Renderer& renderer, Utilities::ShaderManager& shaderManager )
-    : floorLevels( floorLevels ), shader( shaderManager.getShader( "system/shaders/infr_wall/vertex.glsl", "system/shaders/infr_wall/fragment.glsl" ) ) {
-      initTopTexture( renderer );
+    : WallModelLoader( floorLevels, getShader( shaderManager ), generateTopTexture( renderer ) ) {}
+
+  WallModelLoader::WallModelLoader( const std::vector< Models::Infrastructure::FloorLevel >& floorLevels, std::shared_ptr< Shader > shader, std::shared_ptr< sf::Image > topTexture )
+    : merged( ConfigManager::getInstance().getBoolValue( "wall_merged_meshes" ) ),
+      chunkSize( std::clamp( ConfigManager::getInstance().getIntValue( "wall_chunk_size" ), 1, MAX_CHUNK_SIZE ) ),
+      floorLevels( floorLevels ), shader( shader ) {
+      atlas.addTexture( "__top_side", topTexture );
+    }
+
+  std::shared_ptr< Shader > WallModelLoader::getShader( Utilities::ShaderManager& shaderManager ) {
+    if( ConfigManager::getInstance().getBoolValue( "wall_merged_meshes" ) ) {
+      auto [ vertex, fragment ] = Mesh::WallVertex::getDefaultShader();
+      return shaderManager.getShader( vertex, fragment );
     }
 
-  void WallModelLoader::initTopTexture( Vector::Renderer& renderer ) {
+    return shaderManager.getShader( "system/shaders/infr_wall/vertex.glsl", "system/shaders/infr_wall/fragment.glsl" );
+  }
+
+  bool WallModelLoader::Corner::empty() const {
+    return !horizontal.model && !vertical.model && !diagonal.model && !reverseDiagonal.model;
+  }
+
+  std::shared_ptr< sf::Image > WallModelLoader::generateTopTexture( Vector::Renderer& renderer ) {
+    std::shared_ptr< sf::Image > sfmlImage = std::make_shared< sf::Image >();
+
     renderer.generateBitmap(
       { 48, 192 },
       []( Vector::Renderer& r ) {
         r.drawRect( { 0, 0, 48, 192 }, { 143, 89, 2, 255 } );
       },
       [ & ]( const unsigned char* bitmap ) {
-        std::shared_ptr< sf::Image > sfmlImage = std::make_shared< sf::Image >();
         sfmlImage->create( 48, 192, bitmap );
-
-        atlas.addTexture( "__top_side", sfmlImage );
       }
     );
+
+    return sfmlImage;
   }
 
   void WallModelLoader::initCornerMap() {
-    cornerMap.clear();
+    Level& level = levels[ currentLevel ];
+    level.cornerMap.clear();
 
-    cornerMap.resize( dimensions.y );
-    for( auto& xLevel : cornerMap ) {
-      xLevel.resize( dimensions.x );
+    level.cornerMap.resize( level.dimensions.y );
+    for( auto& xLevel : level.cornerMap ) {
+      xLevel.resize( level.dimensions.x );
     }
   }
 
@@ -182,10 +205,18 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
   }
 
   glm::vec3 WallModelLoader::indexToLocation( const glm::ivec2& position ) {
+    const glm::ivec2& dimensions = levels[ currentLevel ].dimensions;
+
     // TODO: Elevation per vertex
     return { -( dimensions.x * 0.5f ) + position.x, ( dimensions.y * 0.5f ) - position.y, 0.0f };
   }
 
+  glm::ivec2 WallModelLoader::locationToIndex( const glm::vec2& location ) {
+    const glm::ivec2& dimensions = levels[ currentLevel ].dimensions;
+
+    return glm::round( glm::vec2{ location.x + ( dimensions.x * 0.5f ), ( dimensions.y * 0.5f ) - location.y } );
+  }
+
   void WallModelLoader::fixCorners( const glm::ivec2& startingIndex ) {
     // TODO: Elevation per vertex
 
@@ -349,15 +380,17 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
   }
 
   WallModelLoader::Corner* WallModelLoader::getCorner( const glm::ivec2& location ) {
+    Level& level = levels[ currentLevel ];
+
     if( location.x < 0 || location.y < 0 ) {
       return nullptr;
     }
 
-    if( location.x >= dimensions.x || location.y >= dimensions.y ) {
+    if( location.x >= level.dimensions.x || location.y >= level.dimensions.y ) {
       return nullptr;
     }
 
-    return &cornerMap[ location.y ][ location.x ];
+    return &level.cornerMap[ location.y ][ location.x ];
   }
 
   glm::vec3 WallModelLoader::getPositionById( const PlaneGroup& group, const std::string& face, int index ) const {
@@ -386,19 +419,22 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
     }
   }
 
-  void WallModelLoader::insertCornerMapSegment( const Models::WallSegment& segment ) {
+  /**
+   * Walk a segment one cell at a time, passing each cell it covers along with the piece and face it lands on
+   */
+  void WallModelLoader::walkSegment( const Models::WallSegment& segment, const std::function< void( const glm::ivec2&, Piece Corner::*, const Models::Sides& ) >& functor ) {
     glm::ivec2 direction = glm::sign( glm::vec2( segment.end - segment.start ) );
     glm::ivec2 cursor = segment.start;
     int distance = std::abs( glm::distance( glm::vec2( segment.start ), glm::vec2( segment.end ) ) );
 
-    for( int i = 0; i != distance; i++ ) {
+    for( int i = 0; i < distance; i++ ) {
       switch( direction.x ) {
         case -1: {
           switch( direction.y ) {
             case -1: {
               //( -1, -1 ) case
-              if( Corner* corner = getCorner( cursor - glm::ivec2{ -1, -1 } ) ) {
-                corner->diagonal.model = segment.faces[ i ];
+              if( getCorner( cursor - glm::ivec2{ -1, -1 } ) ) {
+                functor( cursor - glm::ivec2{ -1, -1 }, &Corner::diagonal, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -409,8 +445,8 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
             }
             case 0: {
               //( -1, 0 ) case
-              if( Corner* corner = getCorner( cursor - glm::ivec2{ -1, 0 } ) ) {
-                corner->horizontal.model = segment.faces[ i ];
+              if( getCorner( cursor - glm::ivec2{ -1, 0 } ) ) {
+                functor( cursor - glm::ivec2{ -1, 0 }, &Corner::horizontal, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -422,8 +458,8 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
             case 1: {
               //( -1, 1 ) case
               // This is not a mistake! We need to reuse the cell to the left and use its reverseDiagonal
-              if( Corner* corner = getCorner( cursor - glm::ivec2{ -1, 0 } ) ) {
-                corner->reverseDiagonal.model = segment.faces[ i ];
+              if( getCorner( cursor - glm::ivec2{ -1, 0 } ) ) {
+                functor( cursor - glm::ivec2{ -1, 0 }, &Corner::reverseDiagonal, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -438,8 +474,8 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
           switch( direction.y ) {
             case -1: {
               //( 0, -1 ) case
-              if( Corner* corner = getCorner( cursor - glm::ivec2{ 0, -1 } ) ) {
-                corner->vertical.model = segment.faces[ i ];
+              if( getCorner( cursor - glm::ivec2{ 0, -1 } ) ) {
+                functor( cursor - glm::ivec2{ 0, -1 }, &Corner::vertical, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -450,8 +486,8 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
             }
             case 1: {
               //( 0, 1 ) case
-              if( Corner* corner = getCorner( cursor ) ) {
-                corner->vertical.model = segment.faces[ i ];
+              if( getCorner( cursor ) ) {
+                functor( cursor, &Corner::vertical, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -466,8 +502,8 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
           switch( direction.y ) {
             case -1: {
               //( 1, -1 ) case
-              if( Corner* corner = getCorner( cursor - glm::ivec2{ 0, 1 } ) ) {
-                corner->reverseDiagonal.model = segment.faces[ i ];
+              if( getCorner( cursor - glm::ivec2{ 0, 1 } ) ) {
+                functor( cursor - glm::ivec2{ 0, 1 }, &Corner::reverseDiagonal, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -478,8 +514,8 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
             }
             case 0: {
               //( 1, 0 ) case
-              if( Corner* corner = getCorner( cursor ) ) {
-                corner->horizontal.model = segment.faces[ i ];
+              if( getCorner( cursor ) ) {
+                functor( cursor, &Corner::horizontal, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -490,8 +526,8 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
             }
             case 1: {
               //( 1, 1 ) case
-              if( Corner* corner = getCorner( cursor ) ) {
-                corner->diagonal.model = segment.faces[ i ];
+              if( getCorner( cursor ) ) {
+                functor( cursor, &Corner::diagonal, segment.faces[ i ] );
               } else {
                 // Advance to termination event
                 i = distance;
@@ -506,14 +542,34 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
     }
   }
 
-  void WallModelLoader::insertIntoAtlas( const std::vector< Models::Sides >& sides, Utilities::TextureAtlas& atlas ) {
+  void WallModelLoader::insertCornerMapSegment( const Models::WallSegment& segment ) {
+    walkSegment( segment, [ & ]( const glm::ivec2& cell, Piece Corner::* piece, const Models::Sides& sides ) {
+      ( getCorner( cell )->*piece ).model = sides;
+    } );
+  }
+
+  /**
+   * Returns true if any wallpaper was new to the atlas, which moves the texture coordinates of every other wallpaper
+   */
+  bool WallModelLoader::insertIntoAtlas( const std::vector< Models::Sides >& sides, Utilities::TextureAtlas& atlas ) {
+    bool added = false;
+
     for( const auto& side : sides ) {
       const auto& [ frontWallpaperId, frontWallpaper ] = side.front;
       const auto& [ backWallpaperId, backWallpaper ] = side.back;
 
-      atlas.addTexture( frontWallpaperId, frontWallpaper.surface );
-      atlas.addTexture( backWallpaperId, backWallpaper.surface );
+      if( !atlas.hasTexture( frontWallpaperId ) ) {
+        atlas.addTexture( frontWallpaperId, frontWallpaper.surface );
+        added = true;
+      }
+
+      if( !atlas.hasTexture( backWallpaperId ) ) {
+        atlas.addTexture( backWallpaperId, backWallpaper.surface );
+        added = true;
+      }
     }
+
+    return added;
   }
 
   std::array< Mesh::TexturedVertex, 6 > WallModelLoader::getPlane( const glm::vec3& origin, const glm::vec3& width, const glm::vec3& height, const glm::vec3& normal, const std::string& wallpaperId ) {
@@ -553,40 +609,184 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
     return planeGroup;
   }
 
+  void WallModelLoader::stageCorner( const glm::ivec2& cursor ) {
+    Corner& corner = levels[ currentLevel ].cornerMap[ cursor.y ][ cursor.x ];
+
+    // TODO: Elevation per vertex
+    glm::vec3 topLeftCorner = indexToLocation( cursor );
+
+    if( corner.horizontal.model ) {
+      corner.horizontal.stagedMesh = sideToStagedMesh( *corner.horizontal.model, topLeftCorner + glm::vec3{ 0.0f, -0.05f, 0.0f }, { 1.0f, 0.0f, 0.0f } );
+    }
+
+    if( corner.vertical.model ) {
+      corner.vertical.stagedMesh = sideToStagedMesh( *corner.vertical.model, topLeftCorner + glm::vec3{ -0.05f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } );
+    }
+
+    // TODO: Diagonal pieces, non-trivial
+    if( corner.diagonal.model ) {
+      glm::vec3 leftOrigin = Tools::Utility::quickRotate( { -0.05f, 0.0f, 0.0f }, 45.0f );
+      glm::vec3 direction = Tools::Utility::quickRotate( { 1.41421356237f, 0.0f, 0.0f }, -45.0f );
+      corner.diagonal.stagedMesh = sideToStagedMesh( *corner.diagonal.model, topLeftCorner + leftOrigin, direction, 0.055f );
+    }
+
+    if( corner.reverseDiagonal.model ) {
+      glm::vec3 direction = Tools::Utility::quickRotate( { 1.41421356237f, 0.0f, 0.0f }, 45.0f );
+      glm::vec3 leftOrigin = glm::vec3{ 0.0f, -1.0f, 0.0f } + Tools::Utility::quickRotate( { 0.05f, 0.0f, 0.0f }, -45.0f );
+      corner.reverseDiagonal.stagedMesh = sideToStagedMesh( *corner.reverseDiagonal.model, topLeftCorner + leftOrigin, direction, 0.055f );
+    }
+  }
+
   void WallModelLoader::generateDeferredMeshes() {
+    const glm::ivec2& dimensions = levels[ currentLevel ].dimensions;
+
     // Generate deferred meshes
     glm::ivec2 cursor{ 0, 0 };
     for( ; cursor.y != dimensions.y; cursor.y++ ) {
       for( cursor.x = 0; cursor.x != dimensions.x; cursor.x++ ) {
-        Corner& corner = cornerMap[ cursor.y ][ cursor.x ];
+        stageCorner( cursor );
+        fixCorners( cursor );
+      }
+    }
+  }
 
-        // TODO: Elevation per vertex
-        glm::vec3 topLeftCorner = indexToLocation( cursor );
+  void WallModelLoader::loadCornerMap() {
+    levels[ currentLevel ].dimensions = floorLevels[ currentLevel ].dimensions;
+    initCornerMap();
 
-        if( corner.horizontal.model ) {
-          corner.horizontal.stagedMesh = sideToStagedMesh( *corner.horizontal.model, topLeftCorner + glm::vec3{ 0.0f, -0.05f, 0.0f }, { 1.0f, 0.0f, 0.0f } );
+    for( const auto& segment : floorLevels[ currentLevel ].wallSegments ) {
+      // Insert line segment into cornermap
+      insertCornerMapSegment( segment );
+    }
+  }
+
+  /**
+   * Reload the wall models of the current level from its segments, keeping the staged meshes of every cell
+   * whose models did not change. Returns the cells that did change.
+   */
+  std::vector< glm::ivec2 > WallModelLoader::reloadCornerMap() {
+    static constexpr Piece Corner::* pieces[] = { &Corner::horizontal, &Corner::vertical, &Corner::diagonal, &Corner::reverseDiagonal };
+    Level& level = levels[ currentLevel ];
+    std::vector< glm::ivec2 > dirtyCells;
+
+    glm::ivec2 cursor{ 0, 0 };
+    if( level.dimensions != glm::ivec2( floorLevels[ currentLevel ].dimensions ) ) {
+      loadCornerMap();
+
+      for( ; cursor.y != level.dimensions.y; cursor.y++ ) {
+        for( cursor.x = 0; cursor.x != level.dimensions.x; cursor.x++ ) {
+          dirtyCells.emplace_back( cursor );
         }
+      }
 
-        if( corner.vertical.model ) {
-          corner.vertical.stagedMesh = sideToStagedMesh( *corner.vertical.model, topLeftCorner + glm::vec3{ -0.05f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } );
+      return dirtyCells;
+    }
+
+    // Point at the faces instead of copying them; only changed pieces are written back
+    std::vector< std::array< const Models::Sides*, 4 > > models( level.dimensions.x * level.dimensions.y, { nullptr, nullptr, nullptr, nullptr } );
+    for( const auto& segment : floorLevels[ currentLevel ].wallSegments ) {
+      walkSegment( segment, [ & ]( const glm::ivec2& cell, Piece Corner::* piece, const Models::Sides& sides ) {
+        int index = std::find( std::begin( pieces ), std::end( pieces ), piece ) - std::begin( pieces );
+        models[ ( cell.y * level.dimensions.x ) + cell.x ][ index ] = &sides;
+      } );
+    }
+
+    for( ; cursor.y != level.dimensions.y; cursor.y++ ) {
+      for( cursor.x = 0; cursor.x != level.dimensions.x; cursor.x++ ) {
+        Corner& corner = level.cornerMap[ cursor.y ][ cursor.x ];
+        const auto& cellModels = models[ ( cursor.y * level.dimensions.x ) + cursor.x ];
+        bool dirty = false;
+
+        for( int index = 0; index != 4; index++ ) {
+          Piece& piece = corner.*pieces[ index ];
+          const Models::Sides* sides = cellModels[ index ];
+
+          if( sides ? ( !piece.model || *piece.model != *sides ) : piece.model.has_value() ) {
+            if( sides ) {
+              piece.model = *sides;
+            } else {
+              piece.model.reset();
+              piece.stagedMesh.clear();
+            }
+
+            dirty = true;
+          }
         }
 
-        // TODO: Diagonal pieces, non-trivial
-        if( corner.diagonal.model ) {
-          glm::vec3 leftOrigin = Tools::Utility::quickRotate( { -0.05f, 0.0f, 0.0f }, 45.0f );
-          glm::vec3 direction = Tools::Utility::quickRotate( { 1.41421356237f, 0.0f, 0.0f }, -45.0f );
-          corner.diagonal.stagedMesh = sideToStagedMesh( *corner.diagonal.model, topLeftCorner + leftOrigin, direction, 0.055f );
+        if( dirty ) {
+          dirtyCells.emplace_back( cursor );
         }
+      }
+    }
 
-        if( corner.reverseDiagonal.model ) {
-          glm::vec3 direction = Tools::Utility::quickRotate( { 1.41421356237f, 0.0f, 0.0f }, 45.0f );
-          glm::vec3 leftOrigin = glm::vec3{ 0.0f, -1.0f, 0.0f } + Tools::Utility::quickRotate( { 0.05f, 0.0f, 0.0f }, -45.0f );
-          corner.reverseDiagonal.stagedMesh = sideToStagedMesh( *corner.reverseDiagonal.model, topLeftCorner + leftOrigin, direction, 0.055f );
+    return dirtyCells;
+  }
+
+  /**
+   * fixCorners only reads and writes cells that hold a wall and lie within one step of the cell being fixed, so
+   * separate 8-connected runs of wall never affect one another. Replaying every run touching a dirty cell, in the
+   * same raster order generateDeferredMeshes uses, therefore reproduces a full rebuild exactly.
+   *
+   * Returns the replayed cells in raster order.
+   */
+  std::vector< glm::ivec2 > WallModelLoader::restageCells( const std::vector< glm::ivec2 >& dirtyCells ) {
+    const glm::ivec2& dimensions = levels[ currentLevel ].dimensions;
+    std::vector< bool > affected( dimensions.x * dimensions.y, false );
+    std::vector< glm::ivec2 > stack;
+
+    auto visit = [ & ]( const glm::ivec2& cell ) {
+      Corner* corner = getCorner( cell );
+      if( corner && !corner->empty() && !affected[ ( cell.y * dimensions.x ) + cell.x ] ) {
+        affected[ ( cell.y * dimensions.x ) + cell.x ] = true;
+        stack.emplace_back( cell );
+      }
+    };
+
+    for( const glm::ivec2& dirtyCell : dirtyCells ) {
+      // Removing a wall can split a run in two, so seed from every neighbour as well as the cell itself
+      for( int y = -1; y <= 1; y++ ) {
+        for( int x = -1; x <= 1; x++ ) {
+          visit( dirtyCell + glm::ivec2{ x, y } );
+
+          while( !stack.empty() ) {
+            glm::ivec2 cell = stack.back();
+            stack.pop_back();
+
+            for( int ny = -1; ny <= 1; ny++ ) {
+              for( int nx = -1; nx <= 1; nx++ ) {
+                visit( cell + glm::ivec2{ nx, ny } );
+              }
+            }
+          }
         }
+      }
 
-        fixCorners( cursor );
+      // A dirty cell left empty still has pieces to remove
+      if( getCorner( dirtyCell ) ) {
+        affected[ ( dirtyCell.y * dimensions.x ) + dirtyCell.x ] = true;
       }
     }
+
+    std::vector< glm::ivec2 > cells;
+    glm::ivec2 cursor{ 0, 0 };
+    for( ; cursor.y != dimensions.y; cursor.y++ ) {
+      for( cursor.x = 0; cursor.x != dimensions.x; cursor.x++ ) {
+        if( affected[ ( cursor.y * dimensions.x ) + cursor.x ] ) {
+          stageCorner( cursor );
+          fixCorners( cursor );
+          cells.emplace_back( cursor );
+        }
+      }
+    }
+
+    return cells;
+  }
+
+  void WallModelLoader::stageLevel() {
+    loadCornerMap();
+
+    // Walk each line then check joint map to see if vertices need to be stretched to close corners
+    generateDeferredMeshes();
   }
 
   void WallModelLoader::addToGenerator( Mesh::IndexedMeshGenerator< Mesh::TexturedVertex >& generator, const PlaneGroup& planeGroup ) {
@@ -596,52 +796,182 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
     }
   }
 
-  std::shared_ptr< Model > WallModelLoader::getLevel() {
-    std::shared_ptr< Texture > generatedTexture = std::make_shared< Texture >( *atlas.generateAtlas() );
-    std::shared_ptr< Material > generatedMaterial = std::make_shared< Material >( std::vector< std::shared_ptr< Texture > >{ generatedTexture }, std::vector< std::shared_ptr< Texture > >{}, 0.0f, 1.0f );
-    std::shared_ptr< Model > result = Model::create( "__wall_level", {} );
+  std::shared_ptr< Model > WallModelLoader::getPiece( const std::string& id, const PlaneGroup& planeGroup, const glm::ivec2& cell ) {
+    Mesh::IndexedMeshGenerator< Mesh::TexturedVertex> generator;
+    addToGenerator( generator, planeGroup );
 
-    for( size_t y = 0; y != cornerMap.size(); y++ ) {
-      for( size_t x = 0; x != cornerMap[ 0 ].size(); x++ ) {
-        const Corner& corner = cornerMap[ y ][ x ];
+    auto model = Model::create( id, { { generator.generateMesh( deferGLOperations ), shader, material } } );
+    model->setUniform( "level", std::make_unique< Uniforms::LevelUniform >( indexToLocation( cell ), currentLevel ) );
 
-        if( corner.horizontal.model ) {
-          Mesh::IndexedMeshGenerator< Mesh::TexturedVertex> generator;
-          addToGenerator( generator, corner.horizontal.stagedMesh );
+    return model;
+  }
 
-          auto model = Model::create( "__horizontal", { { generator.generateMesh(), shader, generatedMaterial } } );
-          model->setUniform( "level", std::make_unique< Uniforms::LevelUniform >( indexToLocation( { x, y } ), currentLevel ) );
+  void WallModelLoader::addPieces( Model& level, const glm::ivec2& cell ) {
+    const Corner& corner = levels[ currentLevel ].cornerMap[ cell.y ][ cell.x ];
 
-          result->addChild( model );
-        }
-        if( corner.vertical.model ) {
-          Mesh::IndexedMeshGenerator< Mesh::TexturedVertex> generator;
-          addToGenerator( generator, corner.vertical.stagedMesh );
+    if( corner.horizontal.model ) {
+      level.addChild( getPiece( "__horizontal", corner.horizontal.stagedMesh, cell ) );
+    }
 
-          auto model = Model::create( "__vertical", { { generator.generateMesh(), shader, generatedMaterial } } );
-          model->setUniform( "level", std::make_unique< Uniforms::LevelUniform >( indexToLocation( { x, y } ), currentLevel ) );
+    if( corner.vertical.model ) {
+      level.addChild( getPiece( "__vertical", corner.vertical.stagedMesh, cell ) );
+    }
 
-          result->addChild( model );
-        };
-        if( corner.diagonal.model ) {
-          Mesh::IndexedMeshGenerator< Mesh::TexturedVertex> generator;
-          addToGenerator( generator, corner.diagonal.stagedMesh );
+    if( corner.diagonal.model ) {
+      level.addChild( getPiece( "__diagonal", corner.diagonal.stagedMesh, cell ) );
+    }
+
+    if( corner.reverseDiagonal.model ) {
+      level.addChild( getPiece( "__reverseDiagonal", corner.reverseDiagonal.stagedMesh, cell ) );
+    }
+  }
+
+  /**
+   * Every piece is welded on its own, exactly as a standalone piece model would be, then appended to the chunk
+   * under its own piece index so that no vertex is shared between pieces
+   */
+  void WallModelLoader::mergePiece( MergedChunk& chunk, const std::string& id, const PlaneGroup& planeGroup, const glm::ivec2& cell ) {
+    Mesh::IndexedMeshGenerator< Mesh::TexturedVertex > generator;
+    addToGenerator( generator, planeGroup );
+
+    Uniforms::WallPiecesUniform::Piece piece;
+    piece.id = id;
+    piece.position = indexToLocation( cell );
+    piece.vertexBegin = chunk.vertices.size();
+    piece.vertexCount = generator.getVertices().size();
+    piece.indexBegin = chunk.indices.size();
+    piece.indexCount = generator.getTriangles().size() * 3;
+
+    int pieceIndex = chunk.pieces.size();
+    for( const Mesh::TexturedVertex& vertex : generator.getVertices() ) {
+      chunk.vertices.push_back( { vertex.position, vertex.normal, vertex.textureCoordinates, pieceIndex } );
+    }
 
-          auto model = Model::create( "__diagonal", { { generator.generateMesh(), shader, generatedMaterial } } );
-          model->setUniform( "level", std::make_unique< Uniforms::LevelUniform >( indexToLocation( { x, y } ), currentLevel ) );
+    for( const Mesh::Triangle& triangle : generator.getTriangles() ) {
+      for( unsigned int index : triangle ) {
+        chunk.indices.push_back( piece.vertexBegin + index );
+      }
+    }
+
+    chunk.pieces.emplace_back( std::move( piece ) );
+  }
+
+  WallModelLoader::MergedChunk WallModelLoader::mergeChunk( const glm::ivec2& chunk ) {
+    const Level& level = levels[ currentLevel ];
+    glm::ivec2 begin = chunk * chunkSize;
+    glm::ivec2 end = glm::min( begin + chunkSize, level.dimensions );
+
+    MergedChunk result;
+    for( glm::ivec2 cell{ 0, begin.y }; cell.y < end.y; cell.y++ ) {
+      for( cell.x = begin.x; cell.x < end.x; cell.x++ ) {
+        const Corner& corner = level.cornerMap[ cell.y ][ cell.x ];
+
+        if( corner.horizontal.model ) {
+          mergePiece( result, "__horizontal", corner.horizontal.stagedMesh, cell );
+        }
+
+        if( corner.vertical.model ) {
+          mergePiece( result, "__vertical", corner.vertical.stagedMesh, cell );
+        }
 
-          result->addChild( model );
+        if( corner.diagonal.model ) {
+          mergePiece( result, "__diagonal", corner.diagonal.stagedMesh, cell );
         }
+
         if( corner.reverseDiagonal.model ) {
-          Mesh::IndexedMeshGenerator< Mesh::TexturedVertex> generator;
-          addToGenerator( generator, corner.reverseDiagonal.stagedMesh );
+          mergePiece( result, "__reverseDiagonal", corner.reverseDiagonal.stagedMesh, cell );
+        }
+      }
+    }
+
+    return result;
+  }
+
+  std::shared_ptr< Model > WallModelLoader::getChunk( const glm::ivec2& chunk ) {
+    MergedChunk merged = mergeChunk( chunk );
+    if( merged.pieces.empty() ) {
+      return nullptr;
+    }
+
+    auto model = Model::create( "__wall_chunk", { { std::make_shared< Mesh::MeshDefinition< Mesh::WallVertex > >( merged.vertices, merged.indices, deferGLOperations ), shader, material } } );
+    model->setUniform( "level", std::make_unique< Uniforms::LevelUniform >( indexToLocation( chunk * chunkSize ), currentLevel ) );
+    model->setUniform( "pieces", std::make_unique< Uniforms::WallPiecesUniform >( merged.pieces ) );
+
+    return model;
+  }
 
-          auto model = Model::create( "__reverseDiagonal", { { generator.generateMesh(), shader, generatedMaterial } } );
-          model->setUniform( "level", std::make_unique< Uniforms::LevelUniform >( indexToLocation( { x, y } ), currentLevel ) );
+  /**
+   * Replace every piece of a placed level that sits in one of the given cells. Merged levels are patched a chunk at a time.
+   */
+  void WallModelLoader::patchLevel( Model& level, const std::vector< glm::ivec2 >& cells ) {
+    const glm::ivec2& dimensions = levels[ currentLevel ].dimensions;
+    int unitSize = merged ? chunkSize : 1;
+    glm::ivec2 units = ( dimensions + ( unitSize - 1 ) ) / unitSize;
+
+    std::vector< bool > patched( units.x * units.y, false );
+    std::vector< glm::ivec2 > patchedUnits;
+    for( const glm::ivec2& cell : cells ) {
+      glm::ivec2 unit = cell / unitSize;
+      if( !patched[ ( unit.y * units.x ) + unit.x ] ) {
+        patched[ ( unit.y * units.x ) + unit.x ] = true;
+        patchedUnits.emplace_back( unit );
+      }
+    }
 
-          result->addChild( model );
+    std::vector< std::shared_ptr< Model > > stale;
+    for( const auto& child : level.getChildren() ) {
+      Uniforms::LevelUniform* uniform = ( Uniforms::LevelUniform* ) child->getUniform( "level" );
+      glm::ivec2 cell = locationToIndex( uniform->getPosition() );
+
+      bool outside = cell.x < 0 || cell.y < 0 || cell.x >= dimensions.x || cell.y >= dimensions.y;
+      if( outside || patched[ ( ( cell.y / unitSize ) * units.x ) + ( cell.x / unitSize ) ] ) {
+        stale.emplace_back( child );
+      }
+    }
+
+    for( const auto& child : stale ) {
+      child->detach();
+    }
+
+    for( const glm::ivec2& unit : patchedUnits ) {
+      if( !merged ) {
+        addPieces( level, unit );
+      } else if( std::shared_ptr< Model > chunk = getChunk( unit ) ) {
+        level.addChild( chunk );
+      }
+    }
+
+    level.invalidateBoundingVolume();
+  }
+
+  void WallModelLoader::generateMaterial() {
+    std::shared_ptr< Texture > generatedTexture = std::make_shared< Texture >( *atlas.generateAtlas(), deferGLOperations );
+    material = std::make_shared< Material >( std::vector< std::shared_ptr< Texture > >{ generatedTexture }, std::vector< std::shared_ptr< Texture > >{}, 0.0f, 1.0f );
+  }
+
+  std::shared_ptr< Model > WallModelLoader::getLevel() {
+    const glm::ivec2& dimensions = levels[ currentLevel ].dimensions;
+    std::shared_ptr< Model > result = Model::create( "__wall_level", {} );
+
+    if( merged ) {
+      glm::ivec2 chunks = ( dimensions + ( chunkSize - 1 ) ) / chunkSize;
+      glm::ivec2 cursor{ 0, 0 };
+      for( ; cursor.y != chunks.y; cursor.y++ ) {
+        for( cursor.x = 0; cursor.x != chunks.x; cursor.x++ ) {
+          if( std::shared_ptr< Model > chunk = getChunk( cursor ) ) {
+            result->addChild( chunk );
+          }
         }
       }
+
+      return result;
+    }
+
+    glm::ivec2 cursor{ 0, 0 };
+    for( ; cursor.y != dimensions.y; cursor.y++ ) {
+      for( cursor.x = 0; cursor.x != dimensions.x; cursor.x++ ) {
+        addPieces( *result, cursor );
+      }
     }
 
     return result;
@@ -649,35 +979,82 @@ namespace BlueBear::Graphics::SceneGraph::ModelLoader {
 
   std::shared_ptr< Model > WallModelLoader::get() {
     std::shared_ptr< Model > result = Model::create( "__wallrig", {} );
-    currentLevel = 0;
 
+    // Add texture for front and back of every level to one atlas, shared by all levels
     for( const auto& level : floorLevels ) {
-      // If there are no segments, return null pointer and don't waste any time
-      if( level.wallSegments.empty() ) {
-        continue;
+      for( const auto& segment : level.wallSegments ) {
+        insertIntoAtlas( segment.faces, atlas );
       }
+    }
+    generateMaterial();
 
-      // Set state of WallModelLoader for current level
-      dimensions = level.dimensions;
-      initCornerMap();
+    // Levels without walls still get an empty child, so rig children line up with floor levels
+    levels.clear();
+    levels.resize( floorLevels.size() );
+    for( currentLevel = 0; currentLevel != ( int ) floorLevels.size(); currentLevel++ ) {
+      stageLevel();
+      result->addChild( getLevel() );
+    }
+
+    return result;
+  }
 
-      // Walk each line then check joint map to see if vertices need to be stretched to close corners
+  /**
+   * Bring a placed wall rig in line with floorLevels after its wall segments were edited. Only cells whose walls
+   * changed, along with the runs of wall joined to them, are restaged and swapped out in the rig. Levels added or
+   * removed since the last pass are added to or removed from the rig.
+   */
+  void WallModelLoader::update( Model& rig ) {
+    bool atlasChanged = false;
+    for( const auto& level : floorLevels ) {
       for( const auto& segment : level.wallSegments ) {
-        // Add texture for front and back to cache
-        insertIntoAtlas( segment.faces, atlas );
+        if( insertIntoAtlas( segment.faces, atlas ) ) {
+          atlasChanged = true;
+        }
+      }
+    }
 
-        // Insert line segment into cornermap
-        insertCornerMapSegment( segment );
+    // A new wallpaper moves the texture coordinates of every piece
+    if( atlasChanged ) {
+      generateMaterial();
+    }
+
+    levels.resize( floorLevels.size() );
+    for( currentLevel = 0; currentLevel != ( int ) floorLevels.size(); currentLevel++ ) {
+      if( rig.getChildren().size() == ( size_t ) currentLevel ) {
+        rig.addChild( Model::create( "__wall_level", {} ) );
       }
 
-      generateDeferredMeshes();
+      std::vector< glm::ivec2 > cells;
+      if( atlasChanged ) {
+        stageLevel();
 
-      result->addChild( getLevel() );
+        const glm::ivec2& dimensions = levels[ currentLevel ].dimensions;
+        glm::ivec2 cursor{ 0, 0 };
+        for( ; cursor.y != dimensions.y; cursor.y++ ) {
+          for( cursor.x = 0; cursor.x != dimensions.x; cursor.x++ ) {
+            cells.emplace_back( cursor );
+          }
+        }
+      } else {
+        std::vector< glm::ivec2 > dirtyCells = reloadCornerMap();
+        if( dirtyCells.empty() ) {
+          continue;
+        }
 
-      currentLevel++;
+        cells = restageCells( dirtyCells );
+      }
+
+      patchLevel( *rig.getChildren()[ currentLevel ], cells );
     }
 
-    return result;
+    // Levels removed from floorLevels take their children out of the rig with them
+    while( rig.getChildren().size() > floorLevels.size() ) {
+      std::shared_ptr< Model > removed = rig.getChildren().back();
+      removed->detach();
+    }
+
+    rig.invalidateBoundingVolume();
   }
 
 }
@@ -0,0 +1,56 @@
+#include "graphics/scenegraph/modelpicker.hpp"
+#include "graphics/scenegraph/model.hpp"
+#include <algorithm>
+
+namespace BlueBear::Graphics::SceneGraph {
+
+	void ModelPicker::insert( const std::shared_ptr< Model >& model ) {
+		models.emplace_back( model );
+		dirty = true;
+	}
+
+	void ModelPicker::remove( const std::shared_ptr< Model >& model ) {
+		models.erase( std::remove( models.begin(), models.end(), model ), models.end() );
+		dirty = true;
+	}
+
+	void ModelPicker::clear() {
+		models.clear();
+		candidates.clear();
+		hierarchy.clear();
+		dirty = true;
+	}
+
+	std::shared_ptr< Model > ModelPicker::pick( const Geometry::Ray& ray ) {
+		// Models may have moved or animated since the last pick; gather current bounds
+		std::vector< unsigned int > current;
+		std::vector< Geometry::AABB > boxes;
+		current.reserve( models.size() );
+		boxes.reserve( models.size() );
+		for( unsigned int i = 0; i != models.size(); i++ ) {
+			if( std::optional< Geometry::AABB > box = models[ i ]->getBoundingBox() ) {
+				current.emplace_back( i );
+				boxes.emplace_back( *box );
+			}
+		}
+
+		if( dirty || current != candidates ) {
+			candidates = std::move( current );
+			hierarchy.build( boxes );
+			dirty = false;
+		} else {
+			hierarchy.refit( boxes );
+		}
+
+		auto hit = hierarchy.raycast( ray, [ & ]( unsigned int index ) {
+			return models[ candidates[ index ] ]->getIntersectionDistance( ray );
+		} );
+
+		if( hit ) {
+			return models[ candidates[ hit->primitive ] ];
+		}
+
+		return nullptr;
+	}
+
+}
@@ -0,0 +1,208 @@
+#include "graphics/scenegraph/renderqueue.hpp"
+#include "graphics/scenegraph/model.hpp"
+#include "graphics/scenegraph/drawable.hpp"
+#include "graphics/scenegraph/material.hpp"
+#include "graphics/scenegraph/uniform.hpp"
+#include "graphics/scenegraph/mesh/mesh.hpp"
+#include "graphics/scenegraph/mesh/boneuniform.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace BlueBear::Graphics::SceneGraph {
+
+	/**
+	 * Conservative test: the box is rejected only if all eight corners lie outside the same clip plane.
+	 */
+	bool RenderQueue::isVisible( const Geometry::AABB& localBounds, const glm::mat4& clipTransform ) {
+		// One bit per clip plane, cleared when any corner is inside that plane
+		int outside = 0x3F;
+
+		for( int i = 0; i != 8; i++ ) {
+			glm::vec4 corner = clipTransform * glm::vec4{
+				( i & 1 ) ? localBounds.maxima.x : localBounds.minima.x,
+				( i & 2 ) ? localBounds.maxima.y : localBounds.minima.y,
+				( i & 4 ) ? localBounds.maxima.z : localBounds.minima.z,
+				1.0f
+			};
+
+			int planes = 0;
+			if( corner.x < -corner.w ) { planes |= 0x01; }
+			if( corner.x > corner.w ) { planes |= 0x02; }
+			if( corner.y < -corner.w ) { planes |= 0x04; }
+			if( corner.y > corner.w ) { planes |= 0x08; }
+			if( corner.z < -corner.w ) { planes |= 0x10; }
+			if( corner.z > corner.w ) { planes |= 0x20; }
+
+			outside &= planes;
+			if( !outside ) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void RenderQueue::begin( const glm::mat4& viewProjection ) {
+		this->viewProjection = viewProjection;
+
+		items.clear();
+		bonePalette.clear();
+		uniformPool.clear();
+		uniformStack.clear();
+		statistics = Statistics{};
+	}
+
+	void RenderQueue::submit( const Model& model, const Animation::Animator* animator ) {
+		submitTree( model, glm::mat4( 1.0f ), animator );
+	}
+
+	void RenderQueue::submitTree( const Model& model, glm::mat4 transform, const Animation::Animator* animator ) {
+		transform *= model.getLocalTransform().getMatrix();
+
+		size_t stackDepth = uniformStack.size();
+		for( const auto& pair : model.getUniforms() ) {
+			pair.second->update();
+			uniformStack.emplace_back( pair.second.get() );
+		}
+
+		unsigned int uniformsBegin = uniformPool.size();
+		if( !model.getDrawableList().empty() ) {
+			uniformPool.insert( uniformPool.end(), uniformStack.begin(), uniformStack.end() );
+		}
+		unsigned int uniformsEnd = uniformPool.size();
+
+		for( const Drawable& drawable : model.getDrawableList() ) {
+			if( drawable ) {
+				statistics.submitted++;
+
+				// Skinned meshes can leave their bind-pose bounds, so never cull them
+				int boneOffset = -1;
+				if( animator ) {
+					auto it = drawable.mesh->meshUniforms.find( "bone" );
+					if( it != drawable.mesh->meshUniforms.end() ) {
+						boneOffset = bonePalette.add( *( ( Mesh::BoneUniform* ) it->second.get() ), *animator );
+					}
+				} else if( const auto& localBounds = drawable.mesh->getLocalBounds() ) {
+					if( !isVisible( *localBounds, viewProjection * transform ) ) {
+						statistics.culled++;
+						continue;
+					}
+				}
+
+				items.emplace_back( Item{ &drawable, transform, animator, boneOffset, uniformsBegin, uniformsEnd } );
+			}
+		}
+
+		for( const auto& child : model.getChildren() ) {
+			submitTree( *child, transform, animator );
+		}
+
+		uniformStack.resize( stackDepth );
+	}
+
+	/**
+	 * Only opaque draws are batched. Translucent ones blend with whatever is already drawn, so they go last and keep
+	 * the order they were submitted in.
+	 */
+	void RenderQueue::sort() {
+		auto translucent = std::stable_partition( items.begin(), items.end(), []( const Item& item ) {
+			return !item.drawable->material || item.drawable->material->getOpacity() >= 1.0f;
+		} );
+
+		std::stable_sort( items.begin(), translucent, []( const Item& lhs, const Item& rhs ) {
+			return
+				std::make_tuple( lhs.drawable->shader.get(), lhs.drawable->material.get(), lhs.drawable->mesh.get() ) <
+				std::make_tuple( rhs.drawable->shader.get(), rhs.drawable->material.get(), rhs.drawable->mesh.get() );
+		} );
+	}
+
+	bool RenderQueue::sameUniforms( const Item& lhs, const Item& rhs ) const {
+		return std::equal(
+			uniformPool.begin() + lhs.uniformsBegin, uniformPool.begin() + lhs.uniformsEnd,
+			uniformPool.begin() + rhs.uniformsBegin, uniformPool.begin() + rhs.uniformsEnd
+		);
+	}
+
+	void RenderQueue::draw() {
+		Shader* currentShader = nullptr;
+		Material* currentMaterial = nullptr;
+		const Mesh::Mesh* currentMesh = nullptr;
+		const Item* previous = nullptr;
+
+		// One upload for every skinned draw this frame; without storage buffers each draw sends its own bones
+		bool paletteUploaded = !bonePalette.empty() && bonePalette.upload();
+
+		for( const Item& item : items ) {
+			const Drawable& drawable = *item.drawable;
+
+			if( drawable.shader.get() != currentShader ) {
+				currentShader = drawable.shader.get();
+				currentShader->use();
+				statistics.shaderChanges++;
+
+				// Material and model uniforms are per-program state and must be resent
+				if( currentMaterial ) {
+					currentMaterial->releaseTextureUnits();
+					currentMaterial = nullptr;
+				}
+				previous = nullptr;
+			}
+
+			if( drawable.material.get() != currentMaterial ) {
+				if( currentMaterial ) {
+					currentMaterial->releaseTextureUnits();
+				}
+
+				currentMaterial = drawable.material.get();
+				currentMaterial->send( *currentShader );
+				statistics.materialChanges++;
+			}
+
+			if( !previous || !sameUniforms( *previous, item ) ) {
+				for( unsigned int i = item.uniformsBegin; i != item.uniformsEnd; i++ ) {
+					uniformPool[ i ]->send( *currentShader );
+				}
+				statistics.uniformChanges++;
+			}
+
+			if( drawable.mesh.get() != currentMesh ) {
+				currentMesh = drawable.mesh.get();
+				statistics.meshChanges++;
+			}
+
+			// Bone uniforms live on the mesh, which is shared between every instance of a model
+			if( item.boneOffset != -1 ) {
+				Mesh::BoneUniform* boneUniform = ( Mesh::BoneUniform* ) drawable.mesh->meshUniforms.find( "bone" )->second.get();
+				if( paletteUploaded && boneUniform->supportsPalette( *currentShader ) ) {
+					boneUniform->setPaletteOffset( item.boneOffset );
+				} else {
+					boneUniform->setPaletteOffset( {} );
+					boneUniform->configure( *item.animator );
+				}
+			}
+
+			currentShader->sendData( modelUniforms.getUniforms( *currentShader ).transformUniform, item.transform );
+			drawable.mesh->drawElements( *currentShader );
+			statistics.drawCalls++;
+
+			previous = &item;
+		}
+
+		if( currentMaterial ) {
+			currentMaterial->releaseTextureUnits();
+		}
+	}
+
+	const std::vector< RenderQueue::Item >& RenderQueue::getItems() const {
+		return items;
+	}
+
+	const RenderQueue::Statistics& RenderQueue::getStatistics() const {
+		return statistics;
+	}
+
+	const Mesh::BonePalette& RenderQueue::getBonePalette() const {
+		return bonePalette;
+	}
+
+}
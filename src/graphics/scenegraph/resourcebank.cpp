@@ -1,131 +1,161 @@
 #include "graphics/scenegraph/resourcebank.hpp"
 #include "graphics/utilities/shader_manager.hpp"
+#include "graphics/utilities/texture_streamer.hpp"
 #include "graphics/texture.hpp"
 #include "graphics/shader.hpp"
+#include <functional>
 
 namespace BlueBear {
   namespace Graphics {
     namespace SceneGraph {
 
-      ResourceBank::ResourceBank( Utilities::ShaderManager& shaderManager ) : shaderManager( shaderManager ) {}
+      ResourceBank::ResourceBank( Utilities::ShaderManager& shaderManager, Utilities::TextureStreamer* textureStreamer ) :
+        shaderManager( shaderManager ), textureStreamer( textureStreamer ) {}
 
-      bool ResourceBank::listsCongruent( const TextureList& list1, const TextureList& list2 ) {
-        if( list1.size() == list2.size() ) {
-          for( size_t i = 0; i != list1.size(); i++ ) {
-            if( list1.at( i ) != list2.at( i ) ) {
-              return false;
-            }
-          }
+      ResourceBank::MaterialKey::MaterialKey( const glm::vec3& ambient, float shininess, float opacity ) :
+        diffuseTextured( false ), specularTextured( false ), ambient( ambient ), diffuse( 0.0f ), specular( 0.0f ), shininess( shininess ), opacity( opacity ) {}
 
-          return true;
-        }
+      void ResourceBank::MaterialKey::setDiffuse( const glm::vec3& color ) {
+        diffuse = color;
+      }
 
-        return false;
+      void ResourceBank::MaterialKey::setDiffuse( const TextureList& textures ) {
+        diffuseTextured = true;
+        for( const auto& texture : textures ) {
+          diffuseTextures.emplace_back( texture.get() );
+        }
       }
 
-      std::shared_ptr< Shader > ResourceBank::getOrCreateShader( const std::string& vertexPath, const std::string& fragmentPath, bool defer ) {
-        std::lock_guard< std::mutex > lock( shadersMutex );
-        return shaderManager.getShader( vertexPath, fragmentPath, defer );
+      void ResourceBank::MaterialKey::setSpecular( const glm::vec3& color ) {
+        specular = color;
       }
 
-      std::shared_ptr< Texture > ResourceBank::getOrCreateTexture( const std::string& path, bool defer ) {
-        std::lock_guard< std::mutex > lock( texturesMutex );
-        auto it = textures.find( path );
-        if( it != textures.end() ) {
-          return it->second;
-        } else {
-          return textures[ path ] = std::make_shared< Texture >( path, defer );
+      void ResourceBank::MaterialKey::setSpecular( const TextureList& textures ) {
+        specularTextured = true;
+        for( const auto& texture : textures ) {
+          specularTextures.emplace_back( texture.get() );
         }
       }
 
-      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const TextureList& diffuse, const TextureList& specular, float shininess, float opacity ) {
-        for( auto it = materials.begin(); it != materials.end(); ++it ) {
-          std::shared_ptr< Material > sample;
-          {
-            std::lock_guard< std::mutex > lock( materialsMutex );
-            sample = *it;
-          }
+      size_t ResourceBank::MaterialKeyHashCompare::hash( const MaterialKey& key ) {
+        std::hash< float > floatHash;
+        size_t result = ( key.diffuseTextured << 1 ) | key.specularTextured;
 
-          if( sample->getShininess() == shininess && sample->getOpacity() == opacity && sample->getAmbientColor() == ambient ) {
-            if( listsCongruent( diffuse, sample->getDiffuseTextureList() ) && listsCongruent( specular, sample->getSpecularTextureList() ) ) {
-              return sample;
-            }
+        for( const glm::vec3* color : { &key.ambient, &key.diffuse, &key.specular } ) {
+          for( int i = 0; i != 3; i++ ) {
+            result = result * 31 + floatHash( ( *color )[ i ] );
           }
         }
 
-        std::shared_ptr< Material > result = std::make_shared< Material >( ambient, diffuse, specular, shininess, opacity );
-        {
-          std::lock_guard< std::mutex > lock( materialsMutex );
-          materials.push_back( result );
+        for( const auto* list : { &key.diffuseTextures, &key.specularTextures } ) {
+          for( const Texture* texture : *list ) {
+            result = result * 31 + std::hash< const Texture* >()( texture );
+          }
+          result = result * 31 + list->size();
         }
-        return result;
+
+        result = result * 31 + floatHash( key.shininess );
+        return result * 31 + floatHash( key.opacity );
       }
 
-      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const TextureList& diffuse, const glm::vec3& specular, float shininess, float opacity ) {
-        for( auto it = materials.begin(); it != materials.end(); ++it ) {
-          std::shared_ptr< Material > sample;
-          {
-            std::lock_guard< std::mutex > lock( materialsMutex );
-            sample = *it;
-          }
+      bool ResourceBank::MaterialKeyHashCompare::equal( const MaterialKey& lhs, const MaterialKey& rhs ) {
+        return lhs.diffuseTextured == rhs.diffuseTextured && lhs.specularTextured == rhs.specularTextured &&
+          lhs.ambient == rhs.ambient && lhs.diffuse == rhs.diffuse && lhs.specular == rhs.specular &&
+          lhs.diffuseTextures == rhs.diffuseTextures && lhs.specularTextures == rhs.specularTextures &&
+          lhs.shininess == rhs.shininess && lhs.opacity == rhs.opacity;
+      }
+
+      std::shared_ptr< Shader > ResourceBank::getOrCreateShader( const std::string& vertexPath, const std::string& fragmentPath, bool defer ) {
+        return shaderManager.getShader( vertexPath, fragmentPath, defer );
+      }
 
-          if( sample->getShininess() == shininess && sample->getOpacity() == opacity && sample->getAmbientColor() == ambient && sample->getSpecularColor() == specular ) {
-            if( listsCongruent( diffuse, sample->getDiffuseTextureList() ) ) {
-              return sample;
-            }
+      std::shared_ptr< Texture > ResourceBank::getOrCreateTexture( const std::string& path, bool defer ) {
+        std::promise< std::shared_ptr< Texture > > promise;
+        std::shared_future< std::shared_ptr< Texture > > existing;
+        {
+          std::lock_guard< std::mutex > lock( texturesMutex );
+          auto it = textures.find( path );
+          if( it != textures.end() ) {
+            existing = it->second;
+          } else {
+            textures.emplace( path, promise.get_future().share() );
           }
         }
 
-        std::shared_ptr< Material > result = std::make_shared< Material >( ambient, diffuse, specular, shininess, opacity );
-        {
-          std::lock_guard< std::mutex > lock( materialsMutex );
-          materials.push_back( result );
+        if( existing.valid() ) {
+          return existing.get();
+        }
+
+        // With a streamer this returns at once and the file is decoded in the background.
+        // Failures reach everyone already waiting, but the next request tries the file again
+        try {
+          std::shared_ptr< Texture > texture = textureStreamer ? textureStreamer->request( path ) : std::make_shared< Texture >( path, defer );
+          promise.set_value( texture );
+          return texture;
+        } catch( ... ) {
+          promise.set_exception( std::current_exception() );
+          std::lock_guard< std::mutex > lock( texturesMutex );
+          textures.erase( path );
+          throw;
         }
-        return result;
       }
 
-      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const glm::vec3& diffuse, const TextureList& specular, float shininess, float opacity ) {
-        for( auto it = materials.begin(); it != materials.end(); ++it ) {
-          std::shared_ptr< Material > sample;
-          {
-            std::lock_guard< std::mutex > lock( materialsMutex );
-            sample = *it;
+      /**
+       * One probe under a read lock when the material exists. Otherwise the write lock on the new element is held while the
+       * material is built, so threads racing on the same key wait for it rather than building duplicates.
+       */
+      template< typename Diffuse, typename Specular >
+      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const MaterialKey& key, const glm::vec3& ambient, const Diffuse& diffuse, const Specular& specular ) {
+        {
+          decltype( materials )::const_accessor accessor;
+          if( materials.find( accessor, key ) ) {
+            return accessor->second;
           }
+        }
 
-          if( sample->getShininess() == shininess && sample->getOpacity() == opacity && sample->getAmbientColor() == ambient && sample->getDiffuseColor() == diffuse ) {
-            if( listsCongruent( specular, sample->getSpecularTextureList() ) ) {
-              return sample;
-            }
+        decltype( materials )::accessor accessor;
+        if( materials.insert( accessor, key ) ) {
+          try {
+            accessor->second = std::make_shared< Material >( ambient, diffuse, specular, key.shininess, key.opacity );
+          } catch( ... ) {
+            materials.erase( accessor );
+            throw;
           }
         }
 
-        std::shared_ptr< Material > result = std::make_shared< Material >( ambient, diffuse, specular, shininess, opacity );
-        {
-          std::lock_guard< std::mutex > lock( materialsMutex );
-          materials.push_back( result );
-        }
-        return result;
+        return accessor->second;
       }
 
-      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, float shininess, float opacity ) {
-        for( auto it = materials.begin(); it != materials.end(); ++it ) {
-          std::shared_ptr< Material > sample;
-          {
-            std::lock_guard< std::mutex > lock( materialsMutex );
-            sample = *it;
-          }
+      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const TextureList& diffuse, const TextureList& specular, float shininess, float opacity ) {
+        MaterialKey key( ambient, shininess, opacity );
+        key.setDiffuse( diffuse );
+        key.setSpecular( specular );
 
-          if( sample->getShininess() == shininess && sample->getOpacity() == opacity && sample->getAmbientColor() == ambient && sample->getDiffuseColor() == diffuse && sample->getSpecularColor() == specular ) {
-            return sample;
-          }
-        }
+        return getOrCreateMaterial( key, ambient, diffuse, specular );
+      }
 
-        std::shared_ptr< Material > result = std::make_shared< Material >( ambient, diffuse, specular, shininess, opacity );
-        {
-          std::lock_guard< std::mutex > lock( materialsMutex );
-          materials.push_back( result );
-        }
-        return result;
+      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const TextureList& diffuse, const glm::vec3& specular, float shininess, float opacity ) {
+        MaterialKey key( ambient, shininess, opacity );
+        key.setDiffuse( diffuse );
+        key.setSpecular( specular );
+
+        return getOrCreateMaterial( key, ambient, diffuse, specular );
+      }
+
+      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const glm::vec3& diffuse, const TextureList& specular, float shininess, float opacity ) {
+        MaterialKey key( ambient, shininess, opacity );
+        key.setDiffuse( diffuse );
+        key.setSpecular( specular );
+
+        return getOrCreateMaterial( key, ambient, diffuse, specular );
+      }
+
+      std::shared_ptr< Material > ResourceBank::getOrCreateMaterial( const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, float shininess, float opacity ) {
+        MaterialKey key( ambient, shininess, opacity );
+        key.setDiffuse( diffuse );
+        key.setSpecular( specular );
+
+        return getOrCreateMaterial( key, ambient, diffuse, specular );
       }
 
     }
@@ -0,0 +1,43 @@
+#include "graphics/scenegraph/uniforms/wall_pieces_uniform.hpp"
+
+namespace BlueBear::Graphics::SceneGraph::Uniforms {
+
+	WallPiecesUniform::WallPiecesUniform( const std::vector< Piece >& pieces ) : pieces( pieces ), offsets( pieces.size(), 0.0f ) {
+		if( pieces.size() > MAX_PIECES ) {
+			throw TooManyPiecesException();
+		}
+	}
+
+	std::unique_ptr< Uniform > WallPiecesUniform::copy() {
+		std::unique_ptr< WallPiecesUniform > result = std::make_unique< WallPiecesUniform >( pieces );
+		result->offsets = offsets;
+
+		return result;
+	}
+
+	const std::vector< WallPiecesUniform::Piece >& WallPiecesUniform::getPieces() const {
+		return pieces;
+	}
+
+	float WallPiecesUniform::getOffset( unsigned int piece ) const {
+		return offsets.at( piece );
+	}
+
+	void WallPiecesUniform::setOffset( unsigned int piece, float offset ) {
+		offsets.at( piece ) = offset;
+	}
+
+	void WallPiecesUniform::send( const Shader& shader ) {
+		Shader::Uniform uniform;
+
+		auto it = uniforms.find( &shader );
+		if( it != uniforms.end() ) {
+			uniform = it->second;
+		} else {
+			uniform = uniforms[ &shader ] = shader.getUniform( "pieceOffsets" );
+		}
+
+		shader.sendData1fv( uniform, offsets.size(), offsets.data() );
+	}
+
+}
@@ -125,12 +125,29 @@ namespace BlueBear {
       return fragment;
     }
 
+    /**
+     * Read and preprocess the source files without touching GL, so that loader threads can do the file work for sendDeferred.
+     */
+    void Shader::prepare() {
+      std::lock_guard< std::mutex > lock( sourcesMutex );
+      if( !sent && !sources && !vPath.empty() && !fPath.empty() ) {
+        sources = std::make_unique< FilePackage >( getFilePair() );
+      }
+    }
+
     void Shader::sendDeferred() {
-      if( vPath.empty() || fPath.empty() ) {
+      if( vPath.empty() || fPath.empty() || sent ) {
         return;
       }
 
-      FilePackage package = getFilePair();
+      prepare();
+      FilePackage package;
+      {
+        std::lock_guard< std::mutex > lock( sourcesMutex );
+        package = std::move( *sources );
+        sources = nullptr;
+        sent = true;
+      }
 
       GLuint vertex = compileVertex( package.vertex );
       GLuint fragment = compileFragment( package.fragment );
@@ -271,6 +288,16 @@ namespace BlueBear {
       }
     }
 
+    void Shader::sendData1fv( Uniform uniform, unsigned int size, const GLfloat* value ) const {
+      if( program == Shader::CURRENT_PROGRAM ) {
+        if( uniform != -1 ) {
+          glUniform1fv( uniform, size, value );
+        }
+      } else {
+        Log::getInstance().warn( "Shader::sendData1fv", "Shader was not set before sendData1fv was called." );
+      }
+    }
+
     void Shader::use( bool silent ) {
       if( Shader::CURRENT_PROGRAM != program ) {
         glUseProgram( program );
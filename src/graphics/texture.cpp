@@ -1,12 +1,17 @@
 #include "graphics/texture.hpp"
+#include "graphics/utilities/texture_streamer.hpp"
 #include "tools/opengl.hpp"
 #include "log.hpp"
 
 namespace BlueBear {
   namespace Graphics {
 
-    Texture::Texture( const sf::Image& texture ) {
-      prepareTextureFromImage( texture );
+    Texture::Texture( const sf::Image& texture, bool defer ) {
+      if( defer ) {
+        deferred = std::make_unique< sf::Image >( texture );
+      } else {
+        prepareTextureFromImage( texture );
+      }
     }
 
     Texture::Texture( const std::string& texFromFile, bool defer ) {
@@ -24,8 +29,12 @@ namespace BlueBear {
       prepareTextureFromData( dimensions, data );
     }
 
+    Texture::Texture( GLuint placeholder ) : owned( false ), id( placeholder ) {}
+
     Texture::~Texture() {
-      if( !deferred ) {
+      if( uploader ) {
+        uploader->destroy( id );
+      } else if( !deferred && owned ) {
         glDeleteTextures( 1, &id );
       }
     }
@@ -54,6 +63,15 @@ namespace BlueBear {
       glBindTexture( GL_TEXTURE_2D, 0 );
     }
 
+    /**
+     * Replace a region of a texture created from R32F data
+     */
+    void Texture::update( const glm::uvec2& offset, const glm::uvec2& size, const GLvoid* data ) {
+      glBindTexture( GL_TEXTURE_2D, id );
+        glTexSubImage2D( GL_TEXTURE_2D, 0, offset.x, offset.y, size.x, size.y, GL_RED, GL_FLOAT, data );
+      glBindTexture( GL_TEXTURE_2D, 0 );
+    }
+
     void Texture::sendDeferred() {
       if( deferred ) {
         prepareTextureFromImage( *deferred );
@@ -4,6 +4,8 @@
 namespace BlueBear::Graphics::Utilities {
 
 	std::shared_ptr< Shader > ShaderManager::getShader( const std::string& vertex, const std::string& fragment, bool deferGlOperations ) {
+		std::lock_guard< std::mutex > lock( shadersMutex );
+
 		auto it = shaders.find( { vertex, fragment } );
 		if( it != shaders.end() ) {
 			return it->second;
@@ -0,0 +1,219 @@
+#include "graphics/utilities/texture_streamer.hpp"
+#include "graphics/texture.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace BlueBear::Graphics::Utilities {
+
+	static const unsigned char PLACEHOLDER_PIXEL[] = { 128, 128, 128, 255 };
+
+	PixelBufferUploader::~PixelBufferUploader() {
+		if( pixelBuffer ) {
+			glDeleteBuffers( 1, &pixelBuffer );
+		}
+	}
+
+	GLuint PixelBufferUploader::create( const glm::uvec2& size ) {
+		GLuint id;
+		glGenTextures( 1, &id );
+		glBindTexture( GL_TEXTURE_2D, id );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
+
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		return id;
+	}
+
+	void PixelBufferUploader::upload( GLuint id, unsigned int firstRow, const glm::uvec2& size, const unsigned char* pixels ) {
+		GLsizeiptr bytes = ( GLsizeiptr ) size.x * size.y * 4;
+
+		if( !pixelBuffer ) {
+			glGenBuffers( 1, &pixelBuffer );
+		}
+
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, pixelBuffer );
+			// Orphan the last band rather than wait for the driver to finish reading it
+			glBufferData( GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW );
+			if( void* staging = glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT ) ) {
+				std::memcpy( staging, pixels, bytes );
+				glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+
+				glBindTexture( GL_TEXTURE_2D, id );
+					glTexSubImage2D( GL_TEXTURE_2D, 0, 0, firstRow, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+				glBindTexture( GL_TEXTURE_2D, 0 );
+			}
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+	}
+
+	void PixelBufferUploader::finish( GLuint id ) {
+		glBindTexture( GL_TEXTURE_2D, id );
+			glGenerateMipmap( GL_TEXTURE_2D );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+	}
+
+	void PixelBufferUploader::destroy( GLuint id ) {
+		glDeleteTextures( 1, &id );
+	}
+
+	TextureStreamer::TextureStreamer( std::shared_ptr< TextureUploader > uploader, size_t bytesPerFrame, Decoder decode ) :
+		uploader( std::move( uploader ) ), decode( decode ), bytesPerFrame( bytesPerFrame ) {
+		placeholder = this->uploader->create( { 1, 1 } );
+		this->uploader->upload( placeholder, 0, { 1, 1 }, PLACEHOLDER_PIXEL );
+		this->uploader->finish( placeholder );
+	}
+
+	TextureStreamer::~TextureStreamer() {
+		// Decode jobs still queued in the arena call back into load(), so wait for the last of them
+		{
+			std::unique_lock< std::mutex > lock( mutex );
+			decodedCondition.wait( lock, [ & ]() { return decoding == 0; } );
+		}
+
+		for( const Job& job : uploading ) {
+			if( job.id ) {
+				uploader->destroy( job.id );
+			}
+		}
+
+		uploader->destroy( placeholder );
+	}
+
+	std::unique_ptr< sf::Image > TextureStreamer::decodeFile( const std::string& path ) {
+		std::unique_ptr< sf::Image > image = std::make_unique< sf::Image >();
+		if( !image->loadFromFile( path ) ) {
+			return nullptr;
+		}
+
+		return image;
+	}
+
+	void TextureStreamer::load( const std::string& path, std::weak_ptr< Texture > texture ) {
+		std::unique_ptr< sf::Image > image;
+		try {
+			image = decode( path );
+		} catch( std::exception& e ) {
+			Log::getInstance().warn( "TextureStreamer::load", "Could not decode " + path + ": " + e.what() );
+		}
+
+		bool valid = image && image->getSize().x && image->getSize().y;
+		if( !valid ) {
+			Log::getInstance().warn( "TextureStreamer::load", "Could not load texture " + path + "; keeping the placeholder" );
+		}
+
+		std::lock_guard< std::mutex > lock( mutex );
+		if( valid ) {
+			decoded.emplace_back( Job{ std::move( texture ), std::move( image ) } );
+			statistics.decoded++;
+		} else {
+			statistics.failed++;
+		}
+
+		decoding--;
+		decodedCondition.notify_all();
+	}
+
+	/**
+	 * Safe from any thread. The texture is usable at once and shows the placeholder until update() finishes it.
+	 */
+	std::shared_ptr< Texture > TextureStreamer::request( const std::string& path ) {
+		std::shared_ptr< Texture > texture( new Texture( placeholder ) );
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			statistics.requested++;
+			decoding++;
+		}
+
+		arena.enqueue( [ this, path, weak = std::weak_ptr< Texture >( texture ) ]() { load( path, weak ); } );
+		return texture;
+	}
+
+	/**
+	 * Upload decoded rows, oldest texture first, until bytesPerFrame is spent. At least one row goes up per call,
+	 * so an image wider than the budget still finishes. Call once per frame on the GL thread; returns the bytes sent.
+	 */
+	size_t TextureStreamer::update() {
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			std::move( decoded.begin(), decoded.end(), std::back_inserter( uploading ) );
+			decoded.clear();
+		}
+
+		size_t spent = 0;
+		unsigned int finished = 0;
+		while( !uploading.empty() ) {
+			Job& job = uploading.front();
+
+			// Dropped before it was ever shown
+			if( job.texture.expired() ) {
+				if( job.id ) {
+					uploader->destroy( job.id );
+				}
+				uploading.pop_front();
+				continue;
+			}
+
+			glm::uvec2 size( job.image->getSize().x, job.image->getSize().y );
+			size_t rowBytes = ( size_t ) size.x * 4;
+			size_t remaining = spent < bytesPerFrame ? bytesPerFrame - spent : 0;
+			unsigned int rows = std::min< size_t >( size.y - job.nextRow, remaining / rowBytes );
+			if( rows == 0 ) {
+				if( spent ) {
+					break;
+				}
+				rows = 1;
+			}
+
+			if( !job.id ) {
+				job.id = uploader->create( size );
+			}
+
+			uploader->upload( job.id, job.nextRow, { size.x, rows }, job.image->getPixelsPtr() + job.nextRow * rowBytes );
+			job.nextRow += rows;
+			spent += rows * rowBytes;
+
+			if( job.nextRow == size.y ) {
+				uploader->finish( job.id );
+
+				if( std::shared_ptr< Texture > texture = job.texture.lock() ) {
+					texture->id = job.id;
+					texture->owned = true;
+					texture->uploader = uploader;
+				} else {
+					uploader->destroy( job.id );
+				}
+
+				uploading.pop_front();
+				finished++;
+			}
+		}
+
+		std::lock_guard< std::mutex > lock( mutex );
+		statistics.uploaded += finished;
+		statistics.bytesUploaded += spent;
+		return spent;
+	}
+
+	/**
+	 * GL thread only
+	 */
+	bool TextureStreamer::isIdle() const {
+		std::lock_guard< std::mutex > lock( mutex );
+		return decoding == 0 && decoded.empty() && uploading.empty();
+	}
+
+	TextureStreamer::Statistics TextureStreamer::getStatistics() const {
+		std::lock_guard< std::mutex > lock( mutex );
+		return statistics;
+	}
+
+	GLuint TextureStreamer::getPlaceholder() const {
+		return placeholder;
+	}
+
+}
@@ -34,6 +34,10 @@ namespace BlueBear::Graphics::Utilities {
     stored.emplace_back( id, image );
   }
 
+  bool TextureAtlas::hasTexture( const std::string& id ) const {
+    return getPairById( id ).has_value();
+  }
+
   TextureAtlas::TextureData TextureAtlas::getTextureData( const std::string& id ) const {
     if( !getPairById( id ) ) {
       Log::getInstance().warn( "TextureAtlas::getTextureData", "Could not find texture id " + id + " in this atlas!" );
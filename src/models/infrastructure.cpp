@@ -11,6 +11,9 @@ namespace BlueBear::Models {
 
   void Infrastructure::load( const Json::Value& data, Utilities::WorldCache& worldCache ) {
     if( data != Json::Value::null ) {
+      // Replace, don't append to, any levels from a previous load; loaders hold on to this vector
+      levels.clear();
+
       const Json::Value& levelsJson = data[ "levels" ];
       for( auto it = levelsJson.begin(); it != levelsJson.end(); ++it ) {
         const Json::Value& level = *it;
@@ -1,8 +1,6 @@
 #include "models/room.hpp"
 #include "tools/utility.hpp"
 
-#include "log.hpp"
-
 namespace BlueBear::Models {
 
 	Room::Room( const Graphics::SceneGraph::Light::DirectionalLight backgroundLight, const std::vector< glm::vec2 >& points )
@@ -35,13 +33,6 @@ namespace BlueBear::Models {
 
 			glm::vec2 direction = glm::normalize( second - first );
 
-			Log::getInstance().debug( "Room::computeDirections",
-				"index: " + std::to_string( i ) + " " +
-				"first: " + glm::to_string( first ) + " " +
-				"second: " + glm::to_string( second ) + " " +
-				"direction: " + glm::to_string( direction )
-			);
-
 			computedDirections.emplace_back( Normal{ { first, second }, direction, { -direction.y, direction.x } } );
 		}
 	}
@@ -24,6 +24,17 @@ namespace BlueBear::Models {
     back = { backId, *backOptional };
   }
 
+  Sides::Sides( const std::pair< std::string, Wallpaper >& front, const std::pair< std::string, Wallpaper >& back ) : front( front ), back( back ) {}
+
+  // Wallpaper ids are unique within the world cache
+  bool Sides::operator==( const Sides& other ) const {
+    return front.first == other.front.first && back.first == other.back.first;
+  }
+
+  bool Sides::operator!=( const Sides& other ) const {
+    return !( *this == other );
+  }
+
   WallSegment::WallSegment( const Json::Value& segment, Utilities::WorldCache& worldCache ) {
     if( !segment.isObject() ) {
       throw InvalidFormatException();
@@ -37,4 +48,6 @@ namespace BlueBear::Models {
     }
   }
 
+  WallSegment::WallSegment( const glm::ivec2& start, const glm::ivec2& end, const std::vector< Sides >& faces ) : start( start ), end( end ), faces( faces ) {}
+
 }
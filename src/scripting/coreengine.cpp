@@ -8,7 +8,10 @@
 #include "tools/utility.hpp"
 #include "configmanager.hpp"
 #include "log.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <glm/glm.hpp>
 
 namespace BlueBear::Scripting {
@@ -72,12 +75,15 @@ namespace BlueBear::Scripting {
     return temp[ "__closure" ];
   }
 
+  /**
+   * Fires on the update interval ticks after the next one. Negative intervals fire on the next update.
+   */
   int CoreEngine::setTimeout( double interval, Callback f ) {
-    return queuedCallbacks.insert( { std::round( interval ), f } );
+    return queuedCallbacks.schedule( std::clamp( std::round( interval ), 0.0, ( double ) std::numeric_limits< uint32_t >::max() ), std::move( f ) );
   }
 
   void CoreEngine::cancelTimeout( int index ) {
-    queuedCallbacks.remove( index );
+    queuedCallbacks.cancel( index );
   }
 
   double CoreEngine::secondsToTicks( double seconds ) {
@@ -101,44 +107,25 @@ namespace BlueBear::Scripting {
   }
 
   bool CoreEngine::update() {
-    std::vector< int > removalIndices;
-    int i = 0;
-
-    queuedCallbacks.each( [ & ]( std::optional< std::pair< int, std::variant< sol::function, std::function< void() > > > >& optional ) {
-      if( optional ) {
-        std::pair< int, std::variant< sol::function, std::function< void() > > >& callback = *optional;
-
-        if( callback.first == 0 ) {
-          std::visit( overloaded {
-            [ & ]( sol::function function ) {
-              auto result = function();
-              if( !result.valid() ) {
-                sol::error error = result;
-                Log::getInstance().error( "CoreEngine::update", "Exception thrown: " + std::string( error.what() ) );
-              }
-            },
-            []( std::function< void() > function ) {
-              try {
-                function();
-              } catch( std::exception& error ) {
-                Log::getInstance().error( "CoreEngine::update", "Exception thrown: " + std::string( error.what() ) );
-              }
-            }
-          }, callback.second );
-
-          removalIndices.push_back( i );
-        } else {
-          callback.first = std::max( 0, callback.first - 1 );
+    queuedCallbacks.advance( [ & ]( Callback& callback ) {
+      std::visit( overloaded {
+        [ & ]( sol::function& function ) {
+          auto result = function();
+          if( !result.valid() ) {
+            sol::error error = result;
+            Log::getInstance().error( "CoreEngine::update", "Exception thrown: " + std::string( error.what() ) );
+          }
+        },
+        []( std::function< void() >& function ) {
+          try {
+            function();
+          } catch( std::exception& error ) {
+            Log::getInstance().error( "CoreEngine::update", "Exception thrown: " + std::string( error.what() ) );
+          }
         }
-      }
-
-      i++;
+      }, callback );
     } );
 
-    for( int removal : removalIndices ) {
-      queuedCallbacks.remove( removal );
-    }
-
     return true;
   }
 
@@ -1,10 +1,17 @@
 #include "scripting/entitykit/component.hpp"
 #include "scripting/entitykit/entity.hpp"
 #include "log.hpp"
+#include <mutex>
+#include <unordered_map>
 
 namespace BlueBear::Scripting::EntityKit {
 
-  Component::Component( const std::string& componentId ) : componentId( componentId ) {}
+  namespace {
+    std::mutex typesMutex;
+    std::unordered_map< std::string, unsigned int > types;
+  }
+
+  Component::Component( const std::string& componentId ) : componentId( componentId ), type( intern( componentId ) ) {}
 
   Json::Value Component::save() {
     return Json::Value::null;
@@ -16,7 +23,8 @@ namespace BlueBear::Scripting::EntityKit {
     types.new_usertype< EntityKit::Component >( "Component",
       "new", sol::no_constructor,
       "get_entity", &Component::getEntity,
-      "get_component_id", &Component::getId
+      "get_component_id", &Component::getId,
+      "get_component_type", &Component::getType
     );
   }
 
@@ -37,6 +45,31 @@ namespace BlueBear::Scripting::EntityKit {
     return componentId;
   }
 
+  unsigned int Component::getType() const {
+    return type;
+  }
+
+  /**
+   * Type ids are handed out in order of first use and stay fixed for the life of the process; they are not saved.
+   */
+  unsigned int Component::intern( const std::string& componentId ) {
+    std::lock_guard< std::mutex > lock( typesMutex );
+    return types.emplace( componentId, types.size() ).first->second;
+  }
+
+  /**
+   * Unlike intern(), never adds a name, so looking up misspelt or unregistered ids does not grow the table.
+   */
+  std::optional< unsigned int > Component::findType( const std::string& componentId ) {
+    std::lock_guard< std::mutex > lock( typesMutex );
+    auto it = types.find( componentId );
+    if( it == types.end() ) {
+      return {};
+    }
+
+    return it->second;
+  }
+
   void Component::init( sol::object object ) {
     // Abstract
   }
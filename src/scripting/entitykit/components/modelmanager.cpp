@@ -18,6 +18,7 @@ namespace BlueBear::Scripting::EntityKit::Components {
       "get_potential_models", &ModelManager::getPotentialModels,
       "place_object", &ModelManager::placeObject,
       "remove_object", &ModelManager::removeObject,
+      "get_loading_progress", &ModelManager::getLoadingProgress,
       sol::base_classes, sol::bases< SystemComponent, Component >()
     );
   }
@@ -44,7 +45,7 @@ namespace BlueBear::Scripting::EntityKit::Components {
     }
 
     if( paths.size() ) {
-      relevantState->getWorldRenderer().loadPaths( paths );
+      relevantState->getWorldRenderer().loadPathsAsync( paths );
     }
   }
 
@@ -77,6 +78,10 @@ namespace BlueBear::Scripting::EntityKit::Components {
     }
   }
 
+  float ModelManager::getLoadingProgress() const {
+    return relevantState->getWorldRenderer().getLoadingProgress().getFraction();
+  }
+
   std::vector< std::string > ModelManager::getPotentialModels() {
     return potentialModels;
   }
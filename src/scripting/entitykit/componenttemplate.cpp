@@ -0,0 +1,121 @@
+#include "scripting/entitykit/componenttemplate.hpp"
+#include <algorithm>
+
+namespace BlueBear::Scripting::EntityKit {
+
+  ComponentTemplate::ComponentTemplate( sol::table definition ) {
+    lua_State* L = definition.lua_state();
+    int top = lua_gettop( L );
+
+    lua_createtable( L, 0, 0 );
+    lua_createtable( L, 0, 0 );
+    definition.push();
+
+    try {
+      std::vector< const void* > path;
+      compile( L, top + 1, top + 2, top + 3, path );
+    } catch( ... ) {
+      lua_settop( L, top );
+      throw;
+    }
+    lua_pop( L, 1 );
+
+    lua_createtable( L, 0, 1 );
+    lua_pushvalue( L, top + 2 );
+    lua_setfield( L, -2, "__index" );
+    metatable = sol::stack::pop< sol::table >( L );
+
+    lua_pop( L, 1 );
+    constants = sol::stack::pop< sol::table >( L );
+  }
+
+  /**
+   * Records the table at index as a layout and returns its position in layouts. Pass prototypeIndex 0 for nested
+   * tables, which keep their functions as ordinary fields.
+   */
+  int ComponentTemplate::compile( lua_State* L, int constantsIndex, int prototypeIndex, int index, std::vector< const void* >& path ) {
+    const void* identity = lua_topointer( L, index );
+    if( std::find( path.begin(), path.end(), identity ) != path.end() ) {
+      throw CyclicDefinitionException();
+    }
+
+    luaL_checkstack( L, 4, "component definition nested too deeply" );
+    path.push_back( identity );
+
+    int position = layouts.size();
+    layouts.emplace_back();
+    Layout layout{ 0, 0, {} };
+
+    lua_pushnil( L );
+    while( lua_next( L, index ) ) {
+      if( prototypeIndex && lua_type( L, -1 ) == LUA_TFUNCTION ) {
+        lua_pushvalue( L, -2 );
+        lua_pushvalue( L, -2 );
+        lua_rawset( L, prototypeIndex );
+      } else {
+        if( lua_isinteger( L, -2 ) ) {
+          layout.arraySize++;
+        } else {
+          layout.recordSize++;
+        }
+
+        lua_pushvalue( L, -2 );
+        Field field{ addConstant( L, constantsIndex ), 0, -1 };
+        if( lua_type( L, -1 ) == LUA_TTABLE ) {
+          field.child = compile( L, constantsIndex, 0, lua_gettop( L ), path );
+        } else {
+          lua_pushvalue( L, -1 );
+          field.value = addConstant( L, constantsIndex );
+        }
+
+        layout.fields.push_back( field );
+      }
+
+      lua_pop( L, 1 );
+    }
+
+    // Nested compiles may have grown layouts since position was taken
+    layouts[ position ] = std::move( layout );
+    path.pop_back();
+    return position;
+  }
+
+  int ComponentTemplate::addConstant( lua_State* L, int constantsIndex ) {
+    lua_rawseti( L, constantsIndex, ++constantCount );
+    return constantCount;
+  }
+
+  void ComponentTemplate::push( lua_State* L, int constantsIndex, int layout ) const {
+    const Layout& current = layouts[ layout ];
+
+    luaL_checkstack( L, 3, "component definition nested too deeply" );
+    lua_createtable( L, current.arraySize, current.recordSize );
+    for( const Field& field : current.fields ) {
+      lua_rawgeti( L, constantsIndex, field.key );
+      if( field.child == -1 ) {
+        lua_rawgeti( L, constantsIndex, field.value );
+      } else {
+        push( L, constantsIndex, field.child );
+      }
+      lua_rawset( L, -3 );
+    }
+  }
+
+  /**
+   * One presized table per level, filled with raw sets: no iteration of the definition, no type checks and no
+   * metamethods.
+   */
+  sol::table ComponentTemplate::instantiate() const {
+    lua_State* L = constants.lua_state();
+
+    constants.push();
+    push( L, lua_gettop( L ), 0 );
+    metatable.push();
+    lua_setmetatable( L, -2 );
+
+    sol::table instance = sol::stack::pop< sol::table >( L );
+    lua_pop( L, 1 );
+    return instance;
+  }
+
+}
@@ -2,16 +2,22 @@
 #include "scripting/luakit/utility.hpp"
 #include "tools/utility.hpp"
 #include "log.hpp"
+#include <algorithm>
 
 namespace BlueBear::Scripting::EntityKit {
 
   BasicEvent< void*, std::shared_ptr< Entity > > Entity::ENTITY_CLOSING;
 
-  Entity::Entity( const std::string& entityId, const std::vector< std::shared_ptr< Component > >& components ) : entityId( entityId ), components( components ) {}
+  Entity::Entity( const std::string& entityId, const std::vector< std::shared_ptr< Component > >& components ) : entityId( entityId ), components( components ) {
+    for( const auto& component : components ) {
+      addToIndex( component );
+    }
+  }
 
   Entity::Entity( const Entity& entity ) {
     entityId = entity.entityId;
     components = entity.components;
+    index = entity.index;
 
     associate( this );
   }
@@ -28,9 +34,16 @@ namespace BlueBear::Scripting::EntityKit {
   void Entity::submitLuaContributions( sol::state& lua, sol::table types ) {
     types.new_usertype< EntityKit::Entity >( "Entity",
       "new", sol::no_constructor,
-      "find_components", [ &lua ]( Entity& self, const std::string& componentId ) {
-        return LuaKit::Utility::vectorToTable< Components::ComponentReturn >( lua, self.findComponents( componentId ) );
-      },
+      "find_components", sol::overload(
+        [ &lua ]( Entity& self, unsigned int type ) {
+          return LuaKit::Utility::vectorToTable< Components::ComponentReturn >( lua, self.findComponents( type ) );
+        },
+        [ &lua ]( Entity& self, const std::string& componentId ) {
+          return LuaKit::Utility::vectorToTable< Components::ComponentReturn >( lua, self.findComponents( componentId ) );
+        }
+      ),
+      // First match or nil, without building a table; takes a handle from bluebear.entity.component_type
+      "find_component", &Entity::findComponent,
       "attach_component", &Entity::attachComponent,
       "get_entity_id", &Entity::getId
     );
@@ -42,20 +55,50 @@ namespace BlueBear::Scripting::EntityKit {
     }
   }
 
+  void Entity::addToIndex( const std::shared_ptr< Component >& component ) {
+    unsigned int type = component->getType();
+    auto position = std::upper_bound( index.begin(), index.end(), type, []( unsigned int type, const IndexEntry& entry ) {
+      return type < entry.type;
+    } );
+
+    index.insert( position, IndexEntry{ type, Components::cast( component ) } );
+  }
+
   std::vector< Components::ComponentReturn > Entity::findComponents( const std::string& componentId ) {
+    if( std::optional< unsigned int > type = Component::findType( componentId ) ) {
+      return findComponents( *type );
+    }
+
+    return {};
+  }
+
+  std::vector< Components::ComponentReturn > Entity::findComponents( unsigned int type ) {
     std::vector< Components::ComponentReturn > result;
 
-    for( auto& component : components ) {
-      if( component->getId() == componentId ) {
-        result.push_back( Components::cast( component ) );
-      }
+    auto it = std::lower_bound( index.begin(), index.end(), type, []( const IndexEntry& entry, unsigned int type ) {
+      return entry.type < type;
+    } );
+    for( ; it != index.end() && it->type == type; ++it ) {
+      result.push_back( it->component );
     }
 
     return result;
   }
 
+  std::optional< Components::ComponentReturn > Entity::findComponent( unsigned int type ) {
+    auto it = std::lower_bound( index.begin(), index.end(), type, []( const IndexEntry& entry, unsigned int type ) {
+      return entry.type < type;
+    } );
+    if( it == index.end() || it->type != type ) {
+      return {};
+    }
+
+    return it->component;
+  }
+
   void Entity::attachComponent( std::shared_ptr< Component > component ) {
     components.push_back( component );
+    addToIndex( component );
     component->attach( this );
   }
 
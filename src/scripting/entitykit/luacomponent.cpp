@@ -1,6 +1,5 @@
 #include "scripting/entitykit/luacomponent.hpp"
 #include "scripting/luakit/utility.hpp"
-#include "tools/utility.hpp"
 #include "log.hpp"
 
 namespace BlueBear::Scripting::EntityKit {
@@ -9,12 +8,34 @@ namespace BlueBear::Scripting::EntityKit {
 		this->table = table;
 	}
 
+	Json::Value LuaComponent::save() {
+		sol::object object = get( "save" );
+
+		if( object.is< sol::function >() ) {
+			auto result = LuaKit::Utility::cast< sol::function >( object )( *this );
+			if( !result.valid() ) {
+				sol::error error = result;
+				Log::getInstance().error( "LuaComponent::save", error.what() );
+				return Json::Value::null;
+			}
+
+			try {
+				sol::object saved = result;
+				return LuaKit::Utility::savedToJson( saved );
+			} catch( LuaKit::Utility::UnserializableValueException& e ) {
+				Log::getInstance().error( "LuaComponent::save", e.what() );
+			}
+		}
+
+		return Json::Value::null;
+	}
+
 	void LuaComponent::load( const Json::Value& data ) {
 		if( data != Json::Value::null ) {
 			sol::object object = get( "load" );
 
 			if( object.is< sol::function >() ) {
-				LuaKit::Utility::cast< sol::function >( object )( *this, Tools::Utility::jsonToString( data ) );
+				LuaKit::Utility::cast< sol::function >( object )( *this, LuaKit::Utility::jsonToLua( table.lua_state(), data ) );
 			}
 		}
 	}
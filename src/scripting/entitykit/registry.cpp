@@ -6,7 +6,6 @@
 #include "scripting/luakit/utility.hpp"
 #include "graphics/scenegraph/model.hpp"
 #include "containers/visitor.hpp"
-#include "tools/utility.hpp"
 #include "eventmanager.hpp"
 #include "log.hpp"
 #include <functional>
@@ -14,6 +13,17 @@
 namespace BlueBear::Scripting::EntityKit {
 
   Registry::Registry() {
+    components.emplace( "system.component.model_manager", []() -> std::shared_ptr< Component > {
+      return std::make_shared< Components::ModelManager >();
+    } );
+    components.emplace( "system.component.interaction_set", []() -> std::shared_ptr< Component > {
+      return std::make_shared< Components::InteractionSet >();
+    } );
+
+    // Every registered name has its type id before any script asks for a handle
+    Component::intern( "system.component.model_manager" );
+    Component::intern( "system.component.interaction_set" );
+
     eventManager.LUA_STATE_READY.listen( this, std::bind( &Registry::submitLuaContributions, this, std::placeholders::_1 ) );
   }
 
@@ -32,6 +42,8 @@ namespace BlueBear::Scripting::EntityKit {
 
     entity.set_function( "register_component", &Registry::registerComponent, this );
     entity.set_function( "register_entity", &Registry::registerEntity, this );
+    // Handle for find_component and find_components, or nil for an unregistered name; fetch once, outside update loops
+    entity.set_function( "component_type", &Registry::getComponentType, this );
 
     sol::table types = lua[ "bluebear" ][ "entity" ][ "types" ] = lua.create_table();
     Component::submitLuaContributions( lua, types );
@@ -43,8 +55,13 @@ namespace BlueBear::Scripting::EntityKit {
 
   void Registry::registerComponent( const std::string& id, sol::table table ) {
     if( !componentRegistered( id ) ) {
-      components[ id ] = table;
-      Log::getInstance().debug( "Registry::registerComponent", "Registered component " + id );
+      try {
+        components.emplace( id, ComponentTemplate( table ) );
+        Component::intern( id );
+        Log::getInstance().debug( "Registry::registerComponent", "Registered component " + id );
+      } catch( ComponentTemplate::CyclicDefinitionException& e ) {
+        Log::getInstance().error( "Registry::registerComponent", "Component " + id + " could not be registered: " + e.what() );
+      }
     } else {
       Log::getInstance().warn( "Registry::registerComponent", "Component " + id + " already registered!" );
     }
@@ -52,17 +69,18 @@ namespace BlueBear::Scripting::EntityKit {
 
   void Registry::registerEntity( const std::string& id, sol::table componentlist ) {
     if( !entityRegistered( id ) ) {
-      std::vector< std::string > list;
+      std::vector< const ComponentMap::value_type* > list;
 
       // Verify all attached components exist and have been registered
       for( auto& pair : componentlist ) {
         if( pair.second.is< std::string >() ) {
           std::string component = pair.second.as< std::string >();
-          if( !componentRegistered( component ) ) {
+          auto registered = components.find( component );
+          if( registered == components.end() ) {
             Log::getInstance().error( "Registry::registerEntity", "Component " + component + " has not been registered!" );
             return;
           } else {
-            list.push_back( component );
+            list.push_back( &*registered );
           }
         }
       }
@@ -79,13 +97,19 @@ namespace BlueBear::Scripting::EntityKit {
   }
 
   bool Registry::componentRegistered( const std::string& id ) {
-    switch( Tools::Utility::hash( id.c_str() ) ) {
-      case Tools::Utility::hash( "system.component.model_manager" ):
-      case Tools::Utility::hash( "system.component.interaction_set" ):
-        return true;
-      default:
-        return components.find( id ) != components.end();
+    return components.find( id ) != components.end();
+  }
+
+  /**
+   * nil for a name nobody registered, rather than a fresh type id that no component will ever carry
+   */
+  std::optional< unsigned int > Registry::getComponentType( const std::string& id ) {
+    if( !componentRegistered( id ) ) {
+      Log::getInstance().warn( "Registry::getComponentType", "Component " + id + " has not been registered!" );
+      return {};
     }
+
+    return Component::findType( id );
   }
 
   std::shared_ptr< Entity > Registry::createEntity( const std::string& registeredId, bool defaults ) {
@@ -96,15 +120,10 @@ namespace BlueBear::Scripting::EntityKit {
     }
 
     if( defaults ) {
-      std::shared_ptr< Entity > entity;
-
-      for( const auto& stringId : it->second ) {
-        std::shared_ptr< Component > component = createComponent( stringId, sol::nil );
-        if ( !component ) {
-          Log::getInstance().warn( "Registry::createEntity", "Attempted to add component " + stringId + " but component is not registered." );
-        } else {
-          entity->attachComponent( component );
-        }
+      std::shared_ptr< Entity > entity = std::make_shared< Entity >( registeredId, std::vector< std::shared_ptr< Component > >{} );
+
+      for( const ComponentMap::value_type* registered : it->second ) {
+        entity->attachComponent( createComponent( *registered, sol::nil ) );
       }
 
       return entity;
@@ -114,26 +133,27 @@ namespace BlueBear::Scripting::EntityKit {
   }
 
   std::shared_ptr< Component > Registry::createComponent( const std::string& registeredId, sol::object initArgs ) {
-    switch( Tools::Utility::hash( registeredId.c_str() ) ) {
-      case Tools::Utility::hash( "system.component.model_manager" ): {
-        return std::make_shared< Components::ModelManager >();
-      }
-      case Tools::Utility::hash( "system.component.interaction_set" ): {
-        return std::make_shared< Components::InteractionSet >();
-      }
-      default: {
-        auto it = components.find( registeredId );
-        if( it == components.end() ) {
-          Log::getInstance().debug( "Registry::createComponent", "Component not registered: " + registeredId );
-          return nullptr;
-        }
+    auto it = components.find( registeredId );
+    if( it == components.end() ) {
+      Log::getInstance().debug( "Registry::createComponent", "Component not registered: " + registeredId );
+      return nullptr;
+    }
+
+    return createComponent( *it, initArgs );
+  }
 
-        std::shared_ptr< LuaComponent > luaComponent = std::make_shared< LuaComponent >( registeredId, LuaKit::Utility::copyTable( *engineState, it->second, true ) );
+  std::shared_ptr< Component > Registry::createComponent( const ComponentMap::value_type& registered, sol::object initArgs ) {
+    return std::visit( overloaded {
+      []( NativeComponent create ) {
+        return create();
+      },
+      [ & ]( const ComponentTemplate& componentTemplate ) -> std::shared_ptr< Component > {
+        std::shared_ptr< LuaComponent > luaComponent = std::make_shared< LuaComponent >( registered.first, componentTemplate.instantiate() );
         luaComponent->init( initArgs );
 
         return luaComponent;
       }
-    }
+    }, registered.second );
   }
 
 }
@@ -0,0 +1,118 @@
+#include "scripting/luakit/chunkcache.hpp"
+#include "tools/utility.hpp"
+#include <sol.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <optional>
+#include <sstream>
+
+#if defined(_WIN32) || defined(FS_EXPERIMENTAL)
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#include <filesystem>
+namespace fs = std::filesystem;
+#endif
+
+namespace BlueBear::Scripting::LuaKit {
+
+  namespace {
+
+    constexpr char MAGIC[ 4 ] = { 'B', 'B', 'L', 'C' };
+
+    template< typename T > void append( std::string& bytes, const T& value ) {
+      bytes.append( reinterpret_cast< const char* >( &value ), sizeof( T ) );
+    }
+
+    std::optional< std::string > readFile( const std::string& path ) {
+      std::ifstream stream( path, std::ios::binary );
+      if( !stream ) {
+        return {};
+      }
+
+      return std::string( std::istreambuf_iterator< char >( stream ), std::istreambuf_iterator< char >() );
+    }
+
+    // What luaL_loadfile compiles: no UTF-8 BOM, and a leading # line emptied so that line numbers still match
+    std::string getSourceText( const std::string& source ) {
+      size_t start = source.compare( 0, 3, "\xEF\xBB\xBF" ) == 0 ? 3 : 0;
+      if( start < source.size() && source[ start ] == '#' ) {
+        size_t end = source.find( '\n', start );
+        return end == std::string::npos ? "\n" : source.substr( end );
+      }
+
+      return source.substr( start );
+    }
+
+    int writeChunk( lua_State* L, const void* data, size_t size, void* bytecode ) {
+      static_cast< std::string* >( bytecode )->append( static_cast< const char* >( data ), size );
+      return 0;
+    }
+
+  }
+
+  ChunkCache::ChunkCache( const std::string& directory ) : directory( directory ) {}
+
+  std::string ChunkCache::getPath( const std::string& sourcePath ) const {
+    std::stringstream stream;
+    stream << directory << "/" << std::hex << std::setw( 16 ) << std::setfill( '0' ) << Tools::Utility::fnv1a( sourcePath.data(), sourcePath.size() ) << ".luac";
+    return stream.str();
+  }
+
+  /**
+   * Drop-in for luaL_loadfile: same return codes, and on success the same function on top of the stack.
+   */
+  int ChunkCache::load( lua_State* L, const std::string& path ) {
+    std::error_code error;
+    auto modified = fs::last_write_time( path, error );
+    std::optional< std::string > source;
+    if( directory.empty() || error || !( source = readFile( path ) ) ) {
+      return luaL_loadfile( L, path.c_str() );
+    }
+
+    // Everything an entry must match, in the order it is written; the bytecode follows
+    std::string header( MAGIC, sizeof( MAGIC ) );
+    append( header, VERSION );
+    header.append( LUA_RELEASE ).push_back( '\0' );
+    header.append( path ).push_back( '\0' );
+    append( header, ( int64_t ) modified.time_since_epoch().count() );
+    append( header, Tools::Utility::fnv1a( source->data(), source->size() ) );
+
+    std::string cachePath = getPath( path );
+    std::string chunkName = "@" + path;
+    std::optional< std::string > entry = readFile( cachePath );
+    if( entry && entry->size() > header.size() && entry->compare( 0, header.size(), header ) == 0 ) {
+      // Mode "b": a damaged entry that happens to parse as text is still refused
+      if( luaL_loadbufferx( L, entry->data() + header.size(), entry->size() - header.size(), chunkName.c_str(), "b" ) == LUA_OK ) {
+        hits++;
+        return LUA_OK;
+      }
+
+      lua_pop( L, 1 );
+    }
+
+    misses++;
+    // Compile the bytes that were hashed, not whatever is on disk by now
+    std::string text = getSourceText( *source );
+    int status = luaL_loadbufferx( L, text.data(), text.size(), chunkName.c_str(), "t" );
+    if( status == LUA_OK ) {
+      // Debug info is kept so that errors still name source lines
+      std::string bytecode;
+      if( lua_dump( L, writeChunk, &bytecode, 0 ) == 0 ) {
+        Tools::Utility::replaceFile( cachePath, { header, bytecode } );
+      }
+    }
+
+    return status;
+  }
+
+  unsigned int ChunkCache::getHits() const {
+    return hits;
+  }
+
+  unsigned int ChunkCache::getMisses() const {
+    return misses;
+  }
+
+}
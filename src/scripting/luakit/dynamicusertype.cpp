@@ -1,6 +1,5 @@
 #include "scripting/luakit/dynamicusertype.hpp"
 #include "scripting/luakit/utility.hpp"
-#include "tools/utility.hpp"
 
 namespace BlueBear::Scripting::LuaKit {
 
@@ -19,8 +18,20 @@ namespace BlueBear::Scripting::LuaKit {
     sol::object object = get( "save" );
 
     if( object.is< sol::function >() ) {
-      std::function< std::string( DynamicUsertype& ) > saveFunction = Utility::cast< sol::function >( object );
-      return Tools::Utility::stringToJson( saveFunction( *this ) );
+      auto result = Utility::cast< sol::function >( object )( *this );
+      if( !result.valid() ) {
+        sol::error error = result;
+        Log::getInstance().error( "DynamicUsertype::save", error.what() );
+        return {};
+      }
+
+      try {
+        sol::object saved = result;
+        return Utility::savedToJson( saved );
+      } catch( Utility::UnserializableValueException& e ) {
+        Log::getInstance().error( "DynamicUsertype::save", e.what() );
+        return {};
+      }
     } else {
       // Nothing to serialise or return
       return {};
@@ -32,7 +43,7 @@ namespace BlueBear::Scripting::LuaKit {
       sol::object object = get( "load" );
 
       if( object.is< sol::function >() ) {
-        Utility::cast< sol::function >( object )( *this, Tools::Utility::jsonToString( data ) );
+        Utility::cast< sol::function >( object )( *this, Utility::jsonToLua( object.lua_state(), data ) );
       }
     }
   }
@@ -1,11 +1,13 @@
 #include "scripting/luakit/modpackloader.hpp"
 #include "tools/utility.hpp"
+#include "configmanager.hpp"
 #include "log.hpp"
 #include <functional>
 
 namespace BlueBear::Scripting::LuaKit {
 
-  ModpackLoader::ModpackLoader( sol::state& lua, const std::string& currentModpackDirectory ) : lua( lua ), currentModpackDirectory( currentModpackDirectory ) {
+  ModpackLoader::ModpackLoader( sol::state& lua, const std::string& currentModpackDirectory ) :
+    lua( lua ), currentModpackDirectory( currentModpackDirectory ), chunkCache( ConfigManager::getInstance().getValue( "lua_cache_path" ) ) {
     sol::table engine = lua[ "bluebear" ][ "engine" ];
     engine.set_function( "require_modpack", [ & ]( sol::this_state state, const std::string& path ) {
       if( !loadModpack( path ) ) {
@@ -41,8 +43,8 @@ namespace BlueBear::Scripting::LuaKit {
     // Mark the module as LOADING - first if should catch this module if it's called again without completing
     loadedModpacks[ name ] = ModpackStatus::LOADING;
 
-    // dofile pointed to by path
-    if( luaL_loadfile( L, fullPath.c_str() ) || !lua_pushstring( L, path.c_str() ) || lua_pcall( L, 1, LUA_MULTRET, 0 ) ) {
+    // dofile pointed to by path, precompiled if the chunk cache has it
+    if( chunkCache.load( L, fullPath ) || !lua_pushstring( L, path.c_str() ) || lua_pcall( L, 1, LUA_MULTRET, 0 ) ) {
       // Exception occurred during opening the modpack
       // Exception occurred during the integration of this modpack
       Log::getInstance().error( "Engine::loadModpack", "Failed to integrate modpack " + name + ": " + lua_tostring( L, -1 ) );
@@ -2,6 +2,8 @@
 #include "scripting/luakit/library/json.hpp"
 #include "tools/utility.hpp"
 #include "configmanager.hpp"
+#include <algorithm>
+#include <cmath>
 #include <functional>
 
 #include "log.hpp"
@@ -11,6 +13,209 @@ namespace BlueBear::Scripting::LuaKit {
   std::function< sol::table( sol::table, bool ) > Utility::copy;
   std::function< sol::state&() > Utility::getCurrentState;
 
+  namespace {
+
+    void pushJson( lua_State* L, const Json::Value& value ) {
+      if( !lua_checkstack( L, 3 ) ) {
+        throw Utility::UnserializableValueException();
+      }
+
+      switch( value.type() ) {
+        case Json::intValue:
+          lua_pushinteger( L, value.asLargestInt() );
+          break;
+        case Json::uintValue:
+          if( value.isInt64() ) {
+            lua_pushinteger( L, value.asLargestInt() );
+          } else {
+            lua_pushnumber( L, value.asDouble() );
+          }
+          break;
+        case Json::realValue:
+          lua_pushnumber( L, value.asDouble() );
+          break;
+        case Json::stringValue: {
+          const char* begin;
+          const char* end;
+          value.getString( &begin, &end );
+          lua_pushlstring( L, begin, end - begin );
+          break;
+        }
+        case Json::booleanValue:
+          lua_pushboolean( L, value.asBool() );
+          break;
+        case Json::arrayValue: {
+          lua_createtable( L, value.size(), 0 );
+          lua_Integer i = 1;
+          for( const Json::Value& element : value ) {
+            // A null element leaves a hole, as it does decoding with json.lua
+            if( !element.isNull() ) {
+              pushJson( L, element );
+              lua_rawseti( L, -2, i );
+            }
+            i++;
+          }
+          break;
+        }
+        case Json::objectValue: {
+          lua_createtable( L, 0, value.size() );
+          for( auto it = value.begin(); it != value.end(); ++it ) {
+            if( !it->isNull() ) {
+              std::string name = it.name();
+              lua_pushlstring( L, name.data(), name.size() );
+              pushJson( L, *it );
+              lua_rawset( L, -3 );
+            }
+          }
+          break;
+        }
+        case Json::nullValue:
+        default:
+          lua_pushnil( L );
+      }
+    }
+
+    Json::Value toJson( lua_State* L, int index, std::vector< const void* >& path );
+
+    /**
+     * Same rules as json.lua: a table with [1] set, or an empty one, is an array and must be a proper sequence;
+     * anything else is an object and must have only string keys.
+     */
+    Json::Value tableToJson( lua_State* L, int index, std::vector< const void* >& path ) {
+      const void* identity = lua_topointer( L, index );
+      if( std::find( path.begin(), path.end(), identity ) != path.end() || !lua_checkstack( L, 4 ) ) {
+        throw Utility::UnserializableValueException();
+      }
+      path.push_back( identity );
+
+      lua_rawgeti( L, index, 1 );
+      bool array = !lua_isnil( L, -1 );
+      lua_pop( L, 1 );
+
+      lua_pushnil( L );
+      if( !lua_next( L, index ) ) {
+        array = true;
+      } else {
+        lua_pop( L, 2 );
+      }
+
+      Json::Value result( array ? Json::arrayValue : Json::objectValue );
+      if( array ) {
+        lua_Integer count = 0;
+        lua_pushnil( L );
+        while( lua_next( L, index ) ) {
+          lua_pop( L, 1 );
+          if( lua_type( L, -1 ) != LUA_TNUMBER ) {
+            throw Utility::UnserializableValueException();
+          }
+          count++;
+        }
+
+        if( count != ( lua_Integer ) lua_rawlen( L, index ) ) {
+          throw Utility::UnserializableValueException();
+        }
+
+        for( lua_Integer i = 1; i <= count; i++ ) {
+          lua_rawgeti( L, index, i );
+          result.append( toJson( L, -1, path ) );
+          lua_pop( L, 1 );
+        }
+      } else {
+        lua_pushnil( L );
+        while( lua_next( L, index ) ) {
+          if( lua_type( L, -2 ) != LUA_TSTRING ) {
+            throw Utility::UnserializableValueException();
+          }
+
+          size_t length;
+          const char* key = lua_tolstring( L, -2, &length );
+          result[ std::string( key, length ) ] = toJson( L, -1, path );
+          lua_pop( L, 1 );
+        }
+      }
+
+      path.pop_back();
+      return result;
+    }
+
+    Json::Value toJson( lua_State* L, int index, std::vector< const void* >& path ) {
+      index = lua_absindex( L, index );
+
+      switch( lua_type( L, index ) ) {
+        case LUA_TNIL:
+          return Json::Value::null;
+        case LUA_TBOOLEAN:
+          return Json::Value( ( bool ) lua_toboolean( L, index ) );
+        case LUA_TNUMBER: {
+          if( lua_isinteger( L, index ) ) {
+            return Json::Value( ( Json::Int64 ) lua_tointeger( L, index ) );
+          }
+
+          double number = lua_tonumber( L, index );
+          if( !std::isfinite( number ) ) {
+            throw Utility::UnserializableValueException();
+          }
+          return Json::Value( number );
+        }
+        case LUA_TSTRING: {
+          size_t length;
+          const char* string = lua_tolstring( L, index, &length );
+          return Json::Value( string, string + length );
+        }
+        case LUA_TTABLE:
+          return tableToJson( L, index, path );
+        default:
+          throw Utility::UnserializableValueException();
+      }
+    }
+
+  }
+
+  /**
+   * Builds the tables directly on the Lua stack, so no intermediate JSON string and no Lua-side parse.
+   */
+  sol::object Utility::jsonToLua( lua_State* L, const Json::Value& value ) {
+    int top = lua_gettop( L );
+    try {
+      pushJson( L, value );
+    } catch( ... ) {
+      lua_settop( L, top );
+      throw;
+    }
+
+    return sol::stack::pop< sol::object >( L );
+  }
+
+  Json::Value Utility::luaToJson( const sol::object& object ) {
+    lua_State* L = object.lua_state();
+    if( !L ) {
+      return Json::Value::null;
+    }
+
+    int top = lua_gettop( L );
+    object.push();
+    try {
+      std::vector< const void* > path;
+      Json::Value result = toJson( L, -1, path );
+      lua_settop( L, top );
+      return result;
+    } catch( ... ) {
+      lua_settop( L, top );
+      throw;
+    }
+  }
+
+  /**
+   * What a script's save() returned: a table, or the JSON string that scripts written against json.lua still return.
+   */
+  Json::Value Utility::savedToJson( const sol::object& saved ) {
+    if( saved.is< std::string >() ) {
+      return Tools::Utility::stringToJson( saved.as< std::string >() );
+    }
+
+    return luaToJson( saved );
+  }
+
   sol::table Utility::copyTable( sol::state& lua, sol::table original, bool deep ) {
     sol::table newTable = lua.create_table();
 
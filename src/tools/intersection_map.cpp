@@ -1,70 +1,76 @@
 #include "tools/intersection_map.hpp"
-#include <unordered_set>
-#include <map>
-
-#include "log.hpp"
-#include <glm/gtx/string_cast.hpp>
+#include <algorithm>
 
 namespace BlueBear::Tools::Intersection {
 
+	/**
+	 * Split every segment at each interior lattice point it shares with any other segment.
+	 *
+	 * Wall segments are axis-aligned or 45 degree diagonals between lattice points, so instead of testing segments
+	 * pairwise, count how many segments cover each point of a grid spanning the lot. Any point covered more than once
+	 * is an intersection. Both passes walk each segment once: O(total segment length + lot area).
+	 */
 	IntersectionList generateIntersectionalList( IntersectionList lineSegments, const glm::ivec2& totalDimensions ) {
+		// The grid normally spans the lot exactly; grow it for any segment that strays outside
+		glm::ivec2 minimum{ 0, 0 };
+		glm::ivec2 maximum = totalDimensions - 1;
+		for( const auto& lineSegment : lineSegments ) {
+			minimum = glm::min( minimum, glm::min( lineSegment.start, lineSegment.end ) );
+			maximum = glm::max( maximum, glm::max( lineSegment.start, lineSegment.end ) );
+		}
 
-		// Step 1: Get all intersections for each line segment
-		auto comp = [ &totalDimensions ]( const glm::ivec2& left, const glm::ivec2& right ) -> bool {
-			return ( ( left.y * totalDimensions.x ) + left.x ) < ( ( right.y * totalDimensions.x ) + right.x );
+		glm::ivec2 size = glm::max( maximum - minimum + 1, glm::ivec2{ 0, 0 } );
+		std::vector< int > coverage( size.x * size.y, 0 );
+		auto covering = [ & ]( const glm::ivec2& point ) -> int& {
+			glm::ivec2 local = point - minimum;
+			return coverage[ ( local.y * size.x ) + local.x ];
 		};
-		std::map< glm::ivec2, std::unordered_set< IntersectionLineSegment* >, decltype( comp ) > crossedVertices( comp );
 
+		auto getSteps = []( const IntersectionLineSegment& lineSegment ) {
+			glm::ivec2 delta = glm::abs( lineSegment.end - lineSegment.start );
+			return std::max( delta.x, delta.y );
+		};
 
-		Log::getInstance().debug( "intersection_map.cpp:generateIntersectionalList", "List of input line segments" );
-		for( auto& lineSegment : lineSegments ) {
-			Log::getInstance().debug( "intersection_map.cpp:generateIntersectionalList", glm::to_string( lineSegment.start ) + " " + glm::to_string( lineSegment.end ) );
-			glm::ivec2 direction = glm::ivec2( glm::sign( glm::vec2( lineSegment.end ) - glm::vec2( lineSegment.start ) ) );
-			glm::ivec2 cursor = lineSegment.start;
+		// Step 1: Count the segments touching each vertex
+		for( const auto& lineSegment : lineSegments ) {
+			glm::ivec2 direction = glm::sign( lineSegment.end - lineSegment.start );
+			int steps = getSteps( lineSegment );
 
-			while( cursor.x <= lineSegment.end.x && cursor.y <= lineSegment.end.y ) {
-				// For every floor vertex this touches, check every line that isn't this one for an intersection
-				// Lazy, shitty, but I can't be arsed to decode mathspeak in academic papers
-				// Hide this garbage behind a thread/future and design the user experience around paitence
-				for( auto& otherLineSegment : lineSegments ) {
-					if( &lineSegment != &otherLineSegment ) {
-						glm::ivec2 otherDirection = glm::ivec2( glm::sign( glm::vec2( otherLineSegment.end ) - glm::vec2( otherLineSegment.start ) ) );
-						glm::ivec2 otherCursor = otherLineSegment.start;
+			for( int i = 0; i <= steps; i++ ) {
+				covering( lineSegment.start + ( direction * i ) )++;
+			}
+		}
 
-						while( otherCursor.x <= otherLineSegment.end.x && otherCursor.y <= otherLineSegment.end.y ) {
-							if( cursor == otherCursor ) {
-								crossedVertices[ cursor ].emplace( &lineSegment );
-							}
+		// Step 2: Subdivide lines at shared vertices, walking from start to end. Never subdivide at either endpoint.
+		IntersectionList result;
+		result.reserve( lineSegments.size() );
+		for( const auto& lineSegment : lineSegments ) {
+			glm::ivec2 direction = glm::sign( lineSegment.end - lineSegment.start );
+			int steps = getSteps( lineSegment );
 
-							otherCursor += otherDirection;
-						}
-					}
+			glm::ivec2 pieceStart = lineSegment.start;
+			for( int i = 1; i < steps; i++ ) {
+				glm::ivec2 cursor = lineSegment.start + ( direction * i );
+				if( covering( cursor ) > 1 ) {
+					result.emplace_back( IntersectionLineSegment{ pieceStart, cursor } );
+					pieceStart = cursor;
 				}
-
-
-				cursor += direction;
 			}
 
+			result.emplace_back( IntersectionLineSegment{ pieceStart, lineSegment.end } );
 		}
 
-		// Step 2: Subdivide lines at intersection points, top-to-bottom, left-to-right
-		Log::getInstance().debug( "intersection_map.cpp:generateIntersectionalList", "List of crossed vertices, sorted" );
-		for( auto& pair : crossedVertices ) {
-			Log::getInstance().debug( "intersection_map.cpp:generateIntersectionalList", glm::to_string( pair.first ) );
-			for( IntersectionLineSegment* lineSegment : pair.second ) {
-				// Do not subdivide if the point is identical to either start or end
-				if( pair.first != lineSegment->start && pair.first != lineSegment->end ) {
-					// Create new line segment ranging from old.start to pair.first
-					IntersectionLineSegment newLineSegment{ lineSegment->start, pair.first };
-					// Set old segment's new start to pair.first
-					lineSegment->start = pair.first;
-					// Insert new line segment
-					lineSegments.emplace_back( std::move( newLineSegment ) );
-				}
-			}
-		}
+		return result;
+	}
 
-		return lineSegments;
+	/**
+	 * Run generateIntersectionalList on a worker thread. callback receives the result on that thread, so anything
+	 * it hands back to the main thread must be synchronised by the caller; the returned future completes after it.
+	 */
+	std::future< void > generateIntersectionalListAsync( IntersectionList lineSegments, const glm::ivec2& totalDimensions, IntersectionCallback callback ) {
+		return std::async( std::launch::async, [ lineSegments = std::move( lineSegments ), totalDimensions, callback = std::move( callback ) ]() mutable {
+			callback( generateIntersectionalList( std::move( lineSegments ), totalDimensions ) );
+		} );
 	}
 
-}
\ No newline at end of file
+}
@@ -4,6 +4,10 @@
 namespace BlueBear::Tools {
 
 	void SectorIdentifier::addEdge( const glm::ivec2& origin, const glm::ivec2& destination ) {
+		if( origin == destination ) {
+			return;
+		}
+
 		graph[ origin ].links.emplace_back( &graph[ destination ] );
 		graph[ destination ].links.emplace_back( &graph[ origin ] );
 
@@ -11,111 +15,118 @@ namespace BlueBear::Tools {
 		graph[ destination ].position = destination;
 	}
 
-	static bool sectorsEquivalent( const Sector& needle, const Sector& value ) {
-		// All nodes in needle must be in value
-		for( const auto& node : needle ) {
-			if( std::find( value.begin(), value.end(), node ) == value.end() ) {
-				return false;
-			}
+	/**
+	 * Exact counterclockwise ordering of integer directions, starting at +x. Collinear directions are ordered by length.
+	 */
+	bool SectorIdentifier::directionLess( const glm::ivec2& lhs, const glm::ivec2& rhs ) {
+		bool lhsLower = lhs.y < 0 || ( lhs.y == 0 && lhs.x < 0 );
+		bool rhsLower = rhs.y < 0 || ( rhs.y == 0 && rhs.x < 0 );
+		if( lhsLower != rhsLower ) {
+			return rhsLower;
 		}
 
-		return needle.size() == value.size();
-	}
-
-	static bool isSuperset( const Sector& superset, const Sector& set ) {
-		// Every node in set must be in superset
-		for( const auto& node : set ) {
-			if( std::find( superset.begin(), superset.end(), node ) == superset.end() ) {
-				return false;
-			}
+		long long cross = ( ( long long ) lhs.x * rhs.y ) - ( ( long long ) lhs.y * rhs.x );
+		if( cross != 0 ) {
+			return cross > 0;
 		}
 
-		return true;
+		return ( ( long long ) lhs.x * lhs.x ) + ( ( long long ) lhs.y * lhs.y ) < ( ( long long ) rhs.x * rhs.x ) + ( ( long long ) rhs.y * rhs.y );
 	}
 
-	void SectorIdentifier::addSectorToList( SectorBundle& targetSet, const Sector& newSector ) {
-		for( const auto& sector : targetSet ) {
-			if( sectorsEquivalent( sector, newSector ) ) {
-				return;
-			}
+	long long SectorIdentifier::getDoubleArea( const Sector& sector ) {
+		long long area = 0;
+
+		for( size_t i = 0; i != sector.size(); i++ ) {
+			const glm::ivec2& current = sector[ i ]->position;
+			const glm::ivec2& next = sector[ ( i + 1 ) % sector.size() ]->position;
+			area += ( ( long long ) current.x * next.y ) - ( ( long long ) next.x * current.y );
 		}
 
-		targetSet.push_back( newSector );
+		return area;
 	}
 
-	SectorBundle SectorIdentifier::getSectors( SectorDiscoveryNode* node, const SectorDiscoveryNode* parent, std::list< const SectorDiscoveryNode* > discovered ) {
-		SectorBundle result;
-
-		node->visited = true;
-		discovered.push_back( node );
-
-		for( SectorDiscoveryNode* link : node->links ) {
-			if( link != parent ) {
-				Sector potentialSector;
-				bool seen = false;
+	void SectorIdentifier::sortLinks() {
+		for( auto& pair : graph ) {
+			SectorDiscoveryNode& node = pair.second;
 
-				// Have we already seen this item?
-				for( auto iterator = discovered.rbegin(); iterator != discovered.rend(); ++iterator ) {
-					potentialSector.push_back( *iterator );
+			std::sort( node.links.begin(), node.links.end(), [ &node ]( const SectorDiscoveryNode* lhs, const SectorDiscoveryNode* rhs ) {
+				return directionLess( lhs->position - node.position, rhs->position - node.position );
+			} );
+			node.links.erase( std::unique( node.links.begin(), node.links.end() ), node.links.end() );
+			node.walked.assign( node.links.size(), false );
+		}
+	}
 
-					if( seen = ( *iterator == link ) ) {
-						break;
-					}
-				}
+	/**
+	 * A face walk visits a node more than once where it passes along a dangling wall, or around a room attached
+	 * at a single corner. Split it at every repeated node and keep the simple cycles that enclose area on the
+	 * interior side; dangling walls enclose none, and the outer boundary of any component winds the other way.
+	 */
+	void SectorIdentifier::addFace( SectorBundle& result, const Sector& walk ) {
+		Sector stack;
+		std::unordered_map< const SectorDiscoveryNode*, size_t > positions;
+
+		auto emit = [ & ]( Sector cycle ) {
+			if( cycle.size() >= 3 && getDoubleArea( cycle ) > 0 ) {
+				result.emplace_back( std::move( cycle ) );
+			}
+		};
+
+		for( const SectorDiscoveryNode* node : walk ) {
+			auto it = positions.find( node );
+			if( it == positions.end() ) {
+				positions[ node ] = stack.size();
+				stack.push_back( node );
+				continue;
+			}
 
-				if( seen ) {
-					// Item seen
-					addSectorToList( result, potentialSector );
-				} else {
-					// Item not seen and isn't parent. Go through it.
-					SectorBundle linkResult = getSectors( link, node, discovered );
-					for( const Sector& sector : linkResult ) {
-						addSectorToList( result, sector );
-					}
-				}
+			// Close the loop back to the earlier visit of this node, which stays on the stack
+			size_t begin = it->second;
+			emit( Sector( stack.begin() + begin, stack.end() ) );
+			for( size_t i = begin + 1; i != stack.size(); i++ ) {
+				positions.erase( stack[ i ] );
 			}
+			stack.resize( begin + 1 );
 		}
 
-		return result;
+		emit( std::move( stack ) );
 	}
 
 	SectorBundle SectorIdentifier::getSectors() {
-		if( graph.empty() ) {
-			return {};
-		}
+		SectorBundle result;
+		sortLinks();
 
-		std::vector< SectorBundle > sectorGroups;
 		for( auto& pair : graph ) {
-			if( !pair.second.visited ) {
-				sectorGroups.emplace_back( getSectors( &pair.second, nullptr ) );
-			}
-		}
-
-		// Remove sectors that contain other sectors
-		SectorBundle finalSet;
+			SectorDiscoveryNode& start = pair.second;
 
-		for( const auto& result : sectorGroups ) {
-			for( const Sector& needle : result ) {
-				bool superset = false;
-
-				// Does needle set contain any of the other sets?
-				for( const Sector& value : result ) {
-					if( &needle != &value ) {
-						if( superset = isSuperset( needle, value ) ) {
-							break;
-						}
-					}
+			for( size_t startLink = 0; startLink != start.links.size(); startLink++ ) {
+				if( start.walked[ startLink ] ) {
+					continue;
 				}
 
-				if( !superset ) {
-					addSectorToList( finalSet, needle );
+				Sector walk;
+				SectorDiscoveryNode* node = &start;
+				size_t link = startLink;
+				while( !node->walked[ link ] ) {
+					node->walked[ link ] = true;
+					walk.push_back( node );
+
+					// Arrive at the next node, then leave by the link just clockwise of the one we came in on
+					SectorDiscoveryNode* next = node->links[ link ];
+					auto twin = std::lower_bound( next->links.begin(), next->links.end(), node, [ next ]( const SectorDiscoveryNode* lhs, const SectorDiscoveryNode* rhs ) {
+						return directionLess( lhs->position - next->position, rhs->position - next->position );
+					} );
+					size_t twinIndex = twin - next->links.begin();
+
+					link = ( twinIndex + next->links.size() - 1 ) % next->links.size();
+					node = next;
 				}
+
+				addFace( result, walk );
 			}
 		}
 
-		return finalSet;
+		return result;
 	}
 
-
-
-}
\ No newline at end of file
+}
@@ -6,6 +6,7 @@
 #include <cstdio>
 #include <string>
 #include <cstring>
+#include <thread>
 #include <jsoncpp/json/json.h>
 #include <string>
 #include <iterator>
@@ -37,6 +38,42 @@ namespace BlueBear {
 			return result;
 		}
 
+		/**
+		 * Write parts, in order, to a temporary name and rename it over path, so a reader never sees a half-written file.
+		 * Creates the parent directory if needed.
+		 */
+		bool Utility::replaceFile( const std::string& path, const std::vector< std::string_view >& parts ) {
+			std::stringstream temporaryPath;
+			temporaryPath << path << "." << std::hash< std::thread::id >()( std::this_thread::get_id() ) << ".tmp";
+
+			try {
+				fs::path parent = fs::path( path ).parent_path();
+				if( !parent.empty() ) {
+					fs::create_directories( parent );
+				}
+
+				{
+					std::ofstream stream( temporaryPath.str(), std::ios::binary | std::ios::trunc );
+					for( std::string_view part : parts ) {
+						stream.write( part.data(), part.size() );
+					}
+					if( !stream ) {
+						stream.close();
+						fs::remove( temporaryPath.str() );
+						return false;
+					}
+				}
+
+				fs::rename( temporaryPath.str(), path );
+			} catch( fs::filesystem_error& e ) {
+				std::error_code ignored;
+				fs::remove( temporaryPath.str(), ignored );
+				return false;
+			}
+
+			return true;
+		}
+
 		/**
 		 * Tokenise a std::string based on a char value
 		 */
@@ -114,6 +151,19 @@ namespace BlueBear {
 			return reinterpret_cast< void* >( ptr );
 		}
 
+		/**
+		 * 64-bit FNV-1a; pass the previous result as hash to continue over several buffers
+		 */
+		uint64_t Utility::fnv1a( const void* data, size_t size, uint64_t hash ) {
+			const unsigned char* bytes = static_cast< const unsigned char* >( data );
+			for( size_t i = 0; i != size; i++ ) {
+				hash ^= bytes[ i ];
+				hash *= 0x100000001b3ULL;
+			}
+
+			return hash;
+		}
+
 		/**
 		 * Shitty decode method for the UTF-8 strings JsonCpp produces
 		 */
@@ -0,0 +1,14 @@
+#include "system/shaders/common/ubo_bindings.glsl"
+
+// Skinning matrices for every animated instance drawn this frame
+layout (std140, binding = BLUEBEAR_BONE_PALETTE_BINDING) readonly buffer BonePalette {
+  mat4 bonePalette[];
+};
+
+// Start of this draw's matrices in bonePalette; negative selects the per-draw bones array instead
+uniform int boneOffset = -1;
+uniform mat4 bones[ 16 ];
+
+mat4 getBone( const int boneID ) {
+  return boneOffset < 0 ? bones[ boneID ] : bonePalette[ boneOffset + boneID ];
+}
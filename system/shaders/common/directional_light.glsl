@@ -1,3 +1,5 @@
+#include "system/shaders/common/ubo_bindings.glsl"
+
 struct DirectionalLight {
   vec3 direction;
   vec3 ambient;
@@ -5,5 +7,7 @@ struct DirectionalLight {
   vec3 specular;
 };
 
-uniform DirectionalLight directionalLights[ 16 ];
-uniform uint numDirectionalLights;
\ No newline at end of file
+// Light 0 is outdoors; the room in slot n is lit by light n + 1
+layout (std140, binding = BLUEBEAR_DIRECTIONAL_LIGHTS_BINDING) readonly buffer DirectionalLights {
+  DirectionalLight directionalLights[];
+};
@@ -1,6 +1,6 @@
+#include "system/shaders/common/ubo_bindings.glsl"
 #include "system/shaders/common/directional_light.glsl"
 
-#define MAX_ROOMS 16
 #define MAP_RESOLUTION 100.0f
 
 struct Room {
@@ -10,12 +10,24 @@ struct Room {
 	int level; // -1 for invalid room
 };
 
-uniform Room rooms[ MAX_ROOMS ];
+layout (std140, binding = BLUEBEAR_ROOMS_BINDING) readonly buffer Rooms {
+	// xy: world tile at texel ( 0, 0 ) of roomIndex; zw: tiles per level
+	ivec4 roomGrid;
+	Room rooms[];
+};
+
+// Room slots overlapping each tile, in slot order
+layout (std430, binding = BLUEBEAR_ROOM_TILES_BINDING) readonly buffer RoomTiles {
+	int tileRooms[];
+};
 
 // roomData shall be a 2d array flipped vertically for opengl
 // Pack these in a manner that is space-efficient
 uniform sampler2D roomData;
 
+// ( first, count ) into tileRooms for each tile; levels are stacked vertically, roomGrid.w rows apiece
+uniform isampler2D roomIndex;
+
 bool fragmentInBox( const Room room, const vec2 fragment ) {
 	return fragment.x >= room.lowerLeft.x &&
 		fragment.x <= room.upperRight.x &&
@@ -38,10 +50,14 @@ DirectionalLight getRoomLight( const vec3 fragment ) {
 	// Clamp z to all positive values
 	int level = int( clamp( fragment.z, 0.0f, 3.402823466e+38 ) / 4.0f );
 
+	ivec2 tile = ivec2( floor( fragment.xy ) ) - roomGrid.xy;
+	ivec2 texel = ivec2( tile.x, ( level * roomGrid.w ) + tile.y );
+
 	float lightIndex = 0.0f;
-	for( int i = 0; i != MAX_ROOMS; i++ ) {
-		if( rooms[ i ].level == level ) {
-			float lookupResult = lookupFragment( rooms[ i ], fragment.xy );
+	if( all( greaterThanEqual( tile, ivec2( 0 ) ) ) && all( lessThan( tile, roomGrid.zw ) ) && texel.y < textureSize( roomIndex, 0 ).y ) {
+		ivec2 entry = texelFetch( roomIndex, texel, 0 ).xy;
+		for( int i = entry.x; i != entry.x + entry.y; i++ ) {
+			float lookupResult = lookupFragment( rooms[ tileRooms[ i ] ], fragment.xy );
 			if( lookupResult != 0.0f ) {
 				lightIndex = lookupResult;
 				break;
@@ -50,4 +66,4 @@ DirectionalLight getRoomLight( const vec3 fragment ) {
 	}
 
 	return directionalLights[ int( lightIndex ) ];					// If we truly don't hit on a sector, return the outdoor light at position 0
-}
\ No newline at end of file
+}
@@ -1 +1,5 @@
 #define		BLUEBEAR_CAMERA_BINDING		0
+#define		BLUEBEAR_BONE_PALETTE_BINDING		1
+#define		BLUEBEAR_DIRECTIONAL_LIGHTS_BINDING		2
+#define		BLUEBEAR_ROOMS_BINDING		3
+#define		BLUEBEAR_ROOM_TILES_BINDING		4
\ No newline at end of file
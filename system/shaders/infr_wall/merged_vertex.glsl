@@ -0,0 +1,23 @@
+#version 450 core
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 normal;
+layout (location = 2) in vec2 texture;
+layout (location = 3) in int piece;
+
+out vec2 fragTexture;
+out vec3 fragNormal;
+out vec3 fragPos;
+
+uniform mat4 model;
+// Sink offset of each piece in this chunk; size matches WallPiecesUniform::MAX_PIECES
+uniform float pieceOffsets[ 256 ];
+#include "system/shaders/common/camera.glsl"
+
+void main() {
+  vec3 piecePosition = position + vec3( 0.0f, 0.0f, pieceOffsets[ piece ] );
+
+  gl_Position = projection * view * model * vec4( piecePosition, 1.0f );
+  fragTexture = texture;
+  fragNormal = mat3( transpose( inverse( model ) ) ) * normal;
+  fragPos = vec3( model * vec4( piecePosition, 1.0 ) );
+}
@@ -12,14 +12,14 @@ out vec3 fragPos;
 uniform mat4 model;
 #include "system/shaders/common/camera.glsl"
 
-uniform mat4 bones[ 16 ];
+#include "system/shaders/common/bone_palette.glsl"
 
 void main() {
   mat4 boneTransform =
-    ( bones[ boneIDs[ 0 ] ] * boneWeights[ 0 ] ) +
-    ( bones[ boneIDs[ 1 ] ] * boneWeights[ 1 ] ) +
-    ( bones[ boneIDs[ 2 ] ] * boneWeights[ 2 ] ) +
-    ( bones[ boneIDs[ 3 ] ] * boneWeights[ 3 ] );
+    ( getBone( boneIDs[ 0 ] ) * boneWeights[ 0 ] ) +
+    ( getBone( boneIDs[ 1 ] ) * boneWeights[ 1 ] ) +
+    ( getBone( boneIDs[ 2 ] ) * boneWeights[ 2 ] ) +
+    ( getBone( boneIDs[ 3 ] ) * boneWeights[ 3 ] );
 
   gl_Position = projection * view * model * boneTransform * vec4( position, 1.0f );
   fragTexture = texture;
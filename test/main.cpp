@@ -1,5 +1,82 @@
+#include "geometry/methods.hpp"
+#include "graphics/scenegraph/model.hpp"
+#include "graphics/scenegraph/modelpicker.hpp"
+#include "graphics/scenegraph/renderqueue.hpp"
+#include "graphics/scenegraph/animation/animator.hpp"
+#include "graphics/scenegraph/animation/bone.hpp"
+#include "graphics/scenegraph/animation/channel.hpp"
+#include "graphics/scenegraph/transform.hpp"
+#include "graphics/scenegraph/material.hpp"
+#include "graphics/scenegraph/resourcebank.hpp"
+#include "graphics/utilities/shader_manager.hpp"
+#include "graphics/utilities/texture_streamer.hpp"
+#include "graphics/texture.hpp"
+#include "graphics/shader.hpp"
+#include "graphics/scenegraph/mesh/basicvertex.hpp"
+#include "graphics/scenegraph/mesh/meshdefinition.hpp"
+#include "graphics/scenegraph/mesh/riggedvertex.hpp"
+#include "graphics/scenegraph/mesh/texturedriggedvertex.hpp"
+#include "graphics/scenegraph/mesh/boneuniform.hpp"
+#include "graphics/scenegraph/mesh/bonepalette.hpp"
+#include "graphics/scenegraph/mesh/texturedvertex.hpp"
+#include "graphics/scenegraph/mesh/indexedmeshgenerator.hpp"
+#include "graphics/scenegraph/modelloader/wallmodelloader.hpp"
+#include "graphics/scenegraph/modelloader/assimpmodelloader.hpp"
+#include "graphics/scenegraph/modelloader/modelcache.hpp"
+#include "graphics/scenegraph/modelloader/loadscheduler.hpp"
+#include "gameplay/wallpanelindex.hpp"
+#include "graphics/scenegraph/uniforms/level_uniform.hpp"
+#include "models/infrastructure.hpp"
+#include "models/room.hpp"
+#include "tools/sector_discovery.hpp"
+#include "graphics/scenegraph/light/lightmap_manager.hpp"
+#include "graphics/scenegraph/light/lightmap_buffers.hpp"
+#include "containers/packed_cell.hpp"
+#include "containers/rectanglepacker.hpp"
+#include "containers/reusableobjectvector.hpp"
+#include "containers/timerwheel.hpp"
+#include "scripting/entitykit/componenttemplate.hpp"
+#include "scripting/entitykit/entity.hpp"
+#include "scripting/entitykit/luacomponent.hpp"
+#include "scripting/entitykit/registry.hpp"
+#include "scripting/luakit/chunkcache.hpp"
+#include "scripting/luakit/utility.hpp"
+#include "scripting/luakit/library/json.hpp"
+#include "tools/utility.hpp"
+#include "tools/intersection_map.hpp"
+#include "models/wallsegment.hpp"
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <limits>
+#include <tbb/parallel_for.h>
+#include <tbb/concurrent_vector.h>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <jsoncpp/json/json.h>
+#include <sol.hpp>
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace BlueBear;
 
 #define   YES    1.0f
 #define   NO     0.0f
@@ -70,13 +147,3845 @@ float lineIntersect3() {
 	return segmentsIntersect( line1, line2 );
 }
 
-int main() {
-	std::cout << "Concordia TestSuite v0.0.1" << std::endl;
+// Closed cube with each face split into subdivisions x subdivisions quads, wound CCW from outside
+std::shared_ptr< Graphics::SceneGraph::Model > subdividedCube( int subdivisions ) {
+	using Vertex = Graphics::SceneGraph::Mesh::BasicVertex;
+	std::vector< Vertex > vertices;
+	const glm::vec3 normals[] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
 
-	// Line segment code as used in fragment.glsl for infrastructure
-	std::cout << "Expect line 0,0-0,3 and 1,0-1,3 not to intersect: " << ( lineIntersect1() == NO ? "pass" : "fail" ) << std::endl;
-	std::cout << "Expect line 1,1-1,3 and 0,2-3,2 to intersect: " << 	( lineIntersect2() == YES ? "pass" : "fail" ) << std::endl;
-	std::cout << "Expect line 0,0-3,3 and 0,3-3,0 to intersect: " << 	( lineIntersect3() == YES ? "pass" : "fail" ) << std::endl;
+	for( const glm::vec3& normal : normals ) {
+		glm::vec3 u = glm::abs( normal.z ) > 0.5f ? glm::vec3{ 1, 0, 0 } : glm::vec3{ 0, 0, 1 };
+		glm::vec3 v = glm::cross( normal, u );
+		for( int i = 0; i != subdivisions; i++ ) {
+			for( int j = 0; j != subdivisions; j++ ) {
+				auto point = [ & ]( int a, int b ) {
+					glm::vec2 uv = ( glm::vec2{ a, b } / float( subdivisions ) ) - 0.5f;
+					return Vertex{ ( normal * 0.5f ) + ( u * uv.x ) + ( v * uv.y ), normal };
+				};
+
+				vertices.insert( vertices.end(), { point( i, j ), point( i + 1, j ), point( i + 1, j + 1 ) } );
+				vertices.insert( vertices.end(), { point( i, j ), point( i + 1, j + 1 ), point( i, j + 1 ) } );
+			}
+		}
+	}
+
+	return Graphics::SceneGraph::Model::create( "cube", {
+		{ std::make_shared< Graphics::SceneGraph::Mesh::MeshDefinition< Vertex > >( vertices, true ), nullptr, nullptr }
+	} );
+}
+
+// Profiler layout from modpacks/system/debug/profiler.lua
+std::vector< std::shared_ptr< Graphics::SceneGraph::Model > > profilerGrid( int subdivisions ) {
+	std::vector< std::shared_ptr< Graphics::SceneGraph::Model > > result;
+	std::shared_ptr< Graphics::SceneGraph::Model > original = subdividedCube( subdivisions );
+	const glm::vec2 origin{ -9.5f, 9.5f };
+
+	for( int y = 10; y >= 0; y-- ) {
+		for( int x = 0; x <= 10; x++ ) {
+			std::shared_ptr< Graphics::SceneGraph::Model > instance = original->copy();
+			instance->getLocalTransform().setPosition( { origin.x + ( x * 2 ), origin.y - ( y * 2 ), 0.0f } );
+			result.emplace_back( instance );
+		}
+	}
+
+	return result;
+}
+
+std::shared_ptr< Graphics::SceneGraph::Model > bruteForcePick( const std::vector< std::shared_ptr< Graphics::SceneGraph::Model > >& models, const Geometry::Ray& ray ) {
+	std::shared_ptr< Graphics::SceneGraph::Model > result;
+	float nearest = std::numeric_limits< float >::max();
+
+	for( const auto& model : models ) {
+		for( const auto& modelTriangle : model->getModelTriangles() ) {
+			Geometry::Triangle triangle{
+				modelTriangle.second * glm::vec4{ modelTriangle.first[ 0 ], 1.0f },
+				modelTriangle.second * glm::vec4{ modelTriangle.first[ 1 ], 1.0f },
+				modelTriangle.second * glm::vec4{ modelTriangle.first[ 2 ], 1.0f }
+			};
+
+			if( auto distance = Geometry::getIntersectionDistance( ray, triangle ) ) {
+				if( *distance >= 0.0f && *distance < nearest ) {
+					nearest = *distance;
+					result = model;
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+bool pickingMatchesBruteForce() {
+	auto models = profilerGrid( 8 );
+	Graphics::SceneGraph::ModelPicker picker;
+	for( const auto& model : models ) {
+		picker.insert( model );
+	}
+
+	for( float x = -12.0f; x <= 12.0f; x += 0.37f ) {
+		for( float y = -12.0f; y <= 12.0f; y += 0.41f ) {
+			Geometry::Ray ray{ { x, y, 20.0f }, glm::normalize( glm::vec3{ 0.3f, -0.2f, -1.0f } ) };
+			if( picker.pick( ray ) != bruteForcePick( models, ray ) ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void benchmarkPicking() {
+	auto models = profilerGrid( 16 );
+	Graphics::SceneGraph::ModelPicker picker;
+	for( const auto& model : models ) {
+		picker.insert( model );
+	}
+
+	// First pick builds every per-model hierarchy
+	auto start = std::chrono::steady_clock::now();
+	picker.pick( { { 0.0f, 0.0f, 20.0f }, { 0.0f, 0.0f, -1.0f } } );
+	auto built = std::chrono::steady_clock::now();
+
+	const int picks = 10000;
+	int hits = 0;
+	for( int i = 0; i != picks; i++ ) {
+		float x = -11.0f + ( 22.0f * ( i % 100 ) / 100.0f );
+		float y = -11.0f + ( 22.0f * ( i / 100 ) / 100.0f );
+		if( picker.pick( { { x, y, 20.0f }, glm::normalize( glm::vec3{ 0.3f, -0.2f, -1.0f } ) } ) ) {
+			hits++;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	std::cout << "Picking benchmark (121 models, " << models.size() * 6 * 16 * 16 * 2 << " triangles): build "
+		<< std::chrono::duration< double, std::milli >( built - start ).count() << " ms, "
+		<< std::chrono::duration< double, std::micro >( end - built ).count() / picks << " us per pick ("
+		<< hits << "/" << picks << " hits)" << std::endl;
+}
+
+bool renderQueueCullsAndSorts() {
+	auto shaderA = std::make_shared< Graphics::Shader >( "a.vert", "a.frag", true );
+	auto shaderB = std::make_shared< Graphics::Shader >( "b.vert", "b.frag", true );
+	auto materialA = std::make_shared< Graphics::SceneGraph::Material >( glm::vec3{ 1.0f }, glm::vec3{ 1.0f }, 0.0f, 1.0f );
+	auto materialB = std::make_shared< Graphics::SceneGraph::Material >( glm::vec3{ 0.5f }, glm::vec3{ 0.5f }, 0.0f, 1.0f );
+
+	auto models = profilerGrid( 1 );
+	for( size_t i = 0; i != models.size(); i++ ) {
+		Graphics::SceneGraph::Drawable& drawable = models[ i ]->getDrawable( 0 );
+		drawable.shader = ( i % 2 ) ? shaderA : shaderB;
+		drawable.material = ( i % 3 ) ? materialA : materialB;
+	}
+
+	// Same volume as Camera::getOrthoView/getOrthoMatrix at zoom 0.25, rotation 0
+	glm::mat4 view;
+	view = glm::rotate( view, glm::radians( -60.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
+	view = glm::rotate( view, glm::radians( 45.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
+	view = glm::scale( view, glm::vec3{ 25.0f } );
+	glm::mat4 projection = glm::ortho( -576.0f, 576.0f, -432.0f, 432.0f, -10000.0f, 10000.0f );
+
+	// Move the first row far offscreen
+	for( int i = 0; i != 11; i++ ) {
+		models[ i ]->getLocalTransform().setPosition( { 500.0f + i, 500.0f, 0.0f } );
+	}
+
+	Graphics::SceneGraph::RenderQueue queue;
+	queue.begin( projection * view );
+	for( const auto& model : models ) {
+		queue.submit( *model, nullptr );
+	}
+	queue.sort();
+
+	int shaderChanges = 0;
+	int materialChanges = 0;
+	const Graphics::SceneGraph::Drawable* previous = nullptr;
+	for( const auto& item : queue.getItems() ) {
+		if( !previous || previous->shader != item.drawable->shader ) {
+			shaderChanges++;
+			materialChanges++;
+		} else if( previous->material != item.drawable->material ) {
+			materialChanges++;
+		}
+		previous = item.drawable;
+	}
+
+	return queue.getStatistics().submitted == 121 &&
+		queue.getStatistics().culled == 11 &&
+		queue.getItems().size() == 110 &&
+		shaderChanges == 2 &&
+		materialChanges == 4;
+}
+
+bool meshBoundsFollowTransformMethod() {
+	std::vector< Graphics::SceneGraph::Mesh::BasicVertex > vertices( 3 );
+	vertices[ 0 ].position = { -1.0f, 0.0f, 0.0f };
+	vertices[ 1 ].position = { 1.0f, 2.0f, 0.0f };
+	vertices[ 2 ].position = { 0.0f, 0.0f, 3.0f };
+	Graphics::SceneGraph::Mesh::MeshDefinition< Graphics::SceneGraph::Mesh::BasicVertex > mesh( vertices, true );
+
+	auto matches = [ & ]( const glm::vec3& minima, const glm::vec3& maxima ) {
+		const auto& bounds = mesh.getLocalBounds();
+		return bounds && bounds->minima == minima && bounds->maxima == maxima;
+	};
+
+	bool original = matches( { -1.0f, 0.0f, 0.0f }, { 1.0f, 2.0f, 3.0f } );
+	mesh.setGenericTransformMethod( []( const Graphics::SceneGraph::Mesh::BasicVertex& vertex ) { return vertex.position * 2.0f; } );
+	bool scaled = matches( { -2.0f, 0.0f, 0.0f }, { 2.0f, 4.0f, 6.0f } );
+	mesh.setGenericTransformMethod( nullptr );
+	bool restored = matches( { -1.0f, 0.0f, 0.0f }, { 1.0f, 2.0f, 3.0f } );
+
+	return original && scaled && restored;
+}
+
+bool renderQueueKeepsTranslucentOrder() {
+	auto shaderA = std::make_shared< Graphics::Shader >( "a.vert", "a.frag", true );
+	auto shaderB = std::make_shared< Graphics::Shader >( "b.vert", "b.frag", true );
+	auto opaque = std::make_shared< Graphics::SceneGraph::Material >( glm::vec3{ 1.0f }, glm::vec3{ 1.0f }, 0.0f, 1.0f );
+
+	// Every fourth model is translucent, alternating shaders and each with its own material, so any batching would reorder them
+	auto models = profilerGrid( 1 );
+	std::vector< const Graphics::SceneGraph::Drawable* > submitted;
+	for( size_t i = 0; i != models.size(); i++ ) {
+		Graphics::SceneGraph::Drawable& drawable = models[ i ]->getDrawable( 0 );
+		drawable.shader = ( i % 2 ) ? shaderA : shaderB;
+		if( i % 4 == 0 ) {
+			drawable.material = std::make_shared< Graphics::SceneGraph::Material >( glm::vec3{ 1.0f }, glm::vec3{ 1.0f }, 0.0f, 0.5f );
+			submitted.push_back( &drawable );
+		} else {
+			drawable.material = opaque;
+		}
+	}
+
+	Graphics::SceneGraph::RenderQueue queue;
+	// Same volume as renderQueueCullsAndSorts, which keeps the whole grid in view
+	glm::mat4 view;
+	view = glm::rotate( view, glm::radians( -60.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
+	view = glm::rotate( view, glm::radians( 45.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
+	view = glm::scale( view, glm::vec3{ 25.0f } );
+	queue.begin( glm::ortho( -576.0f, 576.0f, -432.0f, 432.0f, -10000.0f, 10000.0f ) * view );
+	for( const auto& model : models ) {
+		queue.submit( *model, nullptr );
+	}
+	queue.sort();
+
+	const std::vector< Graphics::SceneGraph::RenderQueue::Item >& items = queue.getItems();
+	if( items.size() != models.size() ) {
+		return false;
+	}
+
+	size_t firstTranslucent = items.size() - submitted.size();
+	for( size_t i = 0; i != items.size(); i++ ) {
+		bool translucent = items[ i ].drawable->material->getOpacity() < 1.0f;
+		if( translucent != ( i >= firstTranslucent ) || ( translucent && items[ i ].drawable != submitted[ i - firstTranslucent ] ) ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Branching rig: a spine of "depth" joints, each carrying a limb of two joints, with one looping animation
+Graphics::SceneGraph::Animation::Bone riggedSkeleton( int depth ) {
+	using Graphics::SceneGraph::Animation::Bone;
+
+	auto makeAnimations = []( int seed ) {
+		auto animations = std::make_shared< Bone::AnimationMap >();
+		Graphics::SceneGraph::Animation::Channel& channel = ( *animations )[ "walk" ];
+		for( int key = 0; key <= 4; key++ ) {
+			channel.addKeyframe(
+				key * 10.0,
+				glm::vec3{ 0.1f * key, 1.0f, 0.05f * seed },
+				glm::angleAxis( glm::radians( 7.0f * key + seed ), glm::normalize( glm::vec3{ 1.0f, seed % 3, 0.5f } ) ),
+				glm::vec3{ 1.0f + 0.01f * key }
+			);
+		}
+		return animations;
+	};
+
+	auto bindMatrix = []( int seed ) {
+		glm::mat4 matrix;
+		matrix = glm::translate( matrix, glm::vec3{ 0.0f, 1.0f, 0.1f * seed } );
+		return glm::rotate( matrix, glm::radians( 3.0f * seed ), glm::vec3{ 0.0f, 0.0f, 1.0f } );
+	};
+
+	std::function< Bone( int ) > spine = [ & ]( int level ) {
+		Bone bone( "spine" + std::to_string( level ), bindMatrix( level ), makeAnimations( level ) );
+
+		Bone upper( "upper" + std::to_string( level ), bindMatrix( level + 100 ), makeAnimations( level + 100 ) );
+		upper.addChild( Bone( "lower" + std::to_string( level ), bindMatrix( level + 200 ), makeAnimations( level + 200 ) ) );
+		bone.addChild( upper );
+
+		if( level + 1 != depth ) {
+			bone.addChild( spine( level + 1 ) );
+		}
+		return bone;
+	};
+
+	return spine( 0 );
+}
+
+bool animatorMatchesBoneTree() {
+	using namespace Graphics::SceneGraph::Animation;
+
+	Bone bind = riggedSkeleton( 8 );
+	Animator animator( bind, { { "walk", Animation{ "walk", 24.0, 40.0 } } } );
+	animator.setCurrentAnimation( "walk" );
+	animator.setPause( true );
+
+	const Skeleton& skeleton = *animator.getSkeleton();
+	for( double tick : { 0.0, 2.5, 10.0, 17.25, 33.3, 40.0 } ) {
+		animator.setFrame( tick );
+		animator.update();
+
+		Bone current = bind.getAnimationCopy( "walk", tick );
+		for( const std::string& id : bind.getAllIds() ) {
+			glm::mat4 expected = current.getMatrixById( id ) * glm::inverse( bind.getMatrixById( id ) );
+			const glm::mat4& actual = animator.getComputedMatrices()[ skeleton.getIndex( id ) ];
+
+			for( int column = 0; column != 4; column++ ) {
+				for( int row = 0; row != 4; row++ ) {
+					// Parent chains are accumulated root-first instead of leaf-first, which only reassociates the products.
+					// The products carry translations of several units down the spine that mostly cancel against the
+					// inverse bind matrix, so a few ulps of those survive into unit-sized results: the worst seen is
+					// 1.14e-5 (lower6 at the last keyframe), just past 1e-5, hence 1e-4.
+					if( std::abs( expected[ column ][ row ] - actual[ column ][ row ] ) > 1e-4f * std::max( 1.0f, std::abs( expected[ column ][ row ] ) ) ) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	// Returning to the bind pose must give identity skinning matrices
+	animator.reset();
+	animator.update();
+	for( const glm::mat4& matrix : animator.getComputedMatrices() ) {
+		for( int column = 0; column != 4; column++ ) {
+			for( int row = 0; row != 4; row++ ) {
+				if( std::abs( matrix[ column ][ row ] - ( column == row ? 1.0f : 0.0f ) ) > 1e-4f ) {
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void benchmarkAnimator() {
+	using namespace Graphics::SceneGraph::Animation;
+
+	// 121 sims, as in the profiler modpack
+	Bone bind = riggedSkeleton( 8 );
+	std::vector< Animator > animators( 121, Animator( bind, { { "walk", Animation{ "walk", 24.0, 40.0 } } } ) );
+	for( Animator& animator : animators ) {
+		animator.setCurrentAnimation( "walk" );
+		animator.setPause( true );
+	}
+
+	const int frames = 40;
+	float checksum = 0.0f;
+
+	auto start = std::chrono::steady_clock::now();
+	for( int frame = 0; frame != frames; frame++ ) {
+		for( Animator& animator : animators ) {
+			animator.setFrame( frame );
+			animator.update();
+			checksum += animator.getComputedMatrices().back()[ 3 ][ 0 ];
+		}
+	}
+	auto flat = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	std::vector< std::string > ids = bind.getAllIds();
+	for( int frame = 0; frame != frames; frame++ ) {
+		for( size_t i = 0; i != animators.size(); i++ ) {
+			Bone current = bind.getAnimationCopy( "walk", frame );
+			std::map< std::string, glm::mat4 > computed;
+			for( const std::string& id : ids ) {
+				computed[ id ] = current.getMatrixById( id ) * glm::inverse( bind.getMatrixById( id ) );
+			}
+			checksum += computed.begin()->second[ 3 ][ 0 ];
+		}
+	}
+	auto tree = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Animator: " << ( flat / frames ) << " ms/frame flat, " << ( tree / frames ) << " ms/frame bone tree ("
+		<< animators.size() << " animators, " << ids.size() << " bones, checksum " << checksum << ")" << std::endl;
+}
+
+// Keyframe sampling as Bone::setToAnimation did it before channels: matrices in a map, decomposed on every sample
+glm::mat4 sampleMatrixKeyframes( const std::map< double, glm::mat4 >& keyframes, double tick ) {
+	auto keyframe = keyframes.find( tick );
+	if( keyframe != keyframes.end() ) {
+		return keyframe->second;
+	}
+
+	auto last = keyframes.upper_bound( tick );
+	auto first = std::prev( last, 1 );
+
+	return Graphics::SceneGraph::Transform::interpolate(
+		Graphics::SceneGraph::Transform( first->second ),
+		Graphics::SceneGraph::Transform( last->second ),
+		( tick - first->first ) / ( last->first - first->first )
+	).getMatrix();
+}
+
+struct KeyframeTrack {
+	Graphics::SceneGraph::Animation::Channel channel;
+	std::map< double, glm::mat4 > matrices;
+};
+
+KeyframeTrack keyframeTrack( int seed, int keys ) {
+	KeyframeTrack track;
+
+	for( int key = 0; key != keys; key++ ) {
+		glm::vec3 translation{ 0.1f * key, 0.2f * seed, -0.05f * key };
+		glm::quat rotation = glm::angleAxis( glm::radians( 4.0f * key + seed ), glm::normalize( glm::vec3{ 1.0f, seed % 5, 0.5f } ) );
+		glm::vec3 scale{ 1.0f + 0.01f * key, 1.0f, 1.0f + 0.02f * seed };
+
+		track.channel.addKeyframe( key * 2.0, translation, rotation, scale );
+		track.matrices[ key * 2.0 ] = Graphics::SceneGraph::Transform::componentsToMatrix( translation, rotation, scale );
+	}
+
+	return track;
+}
+
+bool matricesClose( const glm::mat4& lhs, const glm::mat4& rhs, float epsilon ) {
+	for( int column = 0; column != 4; column++ ) {
+		for( int row = 0; row != 4; row++ ) {
+			if( std::abs( lhs[ column ][ row ] - rhs[ column ][ row ] ) > epsilon ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool channelMatchesMatrixKeyframes() {
+	KeyframeTrack track = keyframeTrack( 3, 12 );
+
+	// Forward playback with a cursor, then a jump backwards
+	unsigned int cursor = 0;
+	std::vector< double > ticks;
+	for( double tick = 0.0; tick <= 22.0; tick += 0.4 ) {
+		ticks.push_back( tick );
+	}
+	ticks.insert( ticks.end(), { 5.0, 3.3, 21.9, 0.1, 22.0 } );
+
+	for( double tick : ticks ) {
+		glm::mat4 withCursor = track.channel.sample( tick, cursor );
+
+		if( withCursor != track.channel.sample( tick ) ) {
+			return false;
+		}
+
+		if( !matricesClose( withCursor, sampleMatrixKeyframes( track.matrices, tick ), 1e-4f ) ) {
+			return false;
+		}
+	}
+
+	// No keyframes at all samples as identity instead of reading past the arrays
+	Graphics::SceneGraph::Animation::Channel empty;
+	unsigned int emptyCursor = 5;
+	if( empty.sample( 3.0, emptyCursor ) != glm::mat4( 1.0f ) || emptyCursor != 0 || empty.sample( 3.0 ) != glm::mat4( 1.0f ) ) {
+		return false;
+	}
+
+	// Outside the timeline clamps to the end keyframes
+	return track.channel.sample( -1.0 ) == track.matrices.begin()->second &&
+		matricesClose( track.channel.sample( 100.0 ), track.matrices.rbegin()->second, 1e-6f );
+}
+
+void benchmarkChannelSampling() {
+	// One channel per bone of an 80 bone rig, played sequentially
+	std::vector< KeyframeTrack > tracks;
+	for( int bone = 0; bone != 80; bone++ ) {
+		tracks.push_back( keyframeTrack( bone, 60 ) );
+	}
+
+	const int frames = 2000;
+	const double step = 118.0 / frames;
+	float checksum = 0.0f;
+
+	auto start = std::chrono::steady_clock::now();
+	for( int frame = 0; frame != frames; frame++ ) {
+		for( const KeyframeTrack& track : tracks ) {
+			checksum += sampleMatrixKeyframes( track.matrices, frame * step )[ 3 ][ 0 ];
+		}
+	}
+	auto matrices = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+
+	std::vector< unsigned int > cursors( tracks.size(), 0 );
+	start = std::chrono::steady_clock::now();
+	for( int frame = 0; frame != frames; frame++ ) {
+		for( size_t i = 0; i != tracks.size(); i++ ) {
+			checksum += tracks[ i ].channel.sample( frame * step, cursors[ i ] )[ 3 ][ 0 ];
+		}
+	}
+	auto channels = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+
+	double samples = frames * tracks.size();
+	std::cout << "Keyframe sampling: " << ( channels / samples ) << " ns/sample TRS channel, " << ( matrices / samples )
+		<< " ns/sample matrix map (" << tracks.size() << " bones, 60 keys, checksum " << checksum << ")" << std::endl;
+}
+
+bool renderQueuePacksBonePalette() {
+	using namespace Graphics::SceneGraph;
+
+	std::vector< std::string > boneIDs{ "spine0", "upper1", "lower2" };
+	auto mesh = std::make_shared< Mesh::MeshDefinition< Mesh::RiggedVertex > >( std::vector< Mesh::RiggedVertex >{
+		{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1, 2, 0, 0 }, { 0.5f, 0.5f, 0.0f, 0.0f } },
+		{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 2, 0, 0, 0 }, { 1.0f, 0.0f, 0.0f, 0.0f } },
+		{ { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 3, 0, 0, 0 }, { 1.0f, 0.0f, 0.0f, 0.0f } }
+	}, true );
+	mesh->meshUniforms.emplace( "bone", std::make_unique< Mesh::BoneUniform >( boneIDs ) );
+
+	Drawable drawable{
+		mesh,
+		std::make_shared< Graphics::Shader >( "rigged.vert", "rigged.frag", true ),
+		std::make_shared< Material >( glm::vec3{ 1.0f }, glm::vec3{ 1.0f }, 0.0f, 1.0f )
+	};
+
+	Animation::Bone bind = riggedSkeleton( 3 );
+	std::vector< std::shared_ptr< Model > > models;
+	for( int i = 0; i != 3; i++ ) {
+		// Same mesh twice per instance: it should only be packed once for each animator
+		auto model = Model::create( "sim" + std::to_string( i ), { drawable, drawable } );
+		auto animator = std::make_shared< Animation::Animator >( bind, std::map< std::string, Animation::Animation >{ { "walk", Animation::Animation{ "walk", 24.0, 40.0 } } } );
+		animator->setCurrentAnimation( "walk" );
+		animator->setPause( true );
+		animator->setFrame( 7.5 * i );
+		animator->update();
+		model->setAnimator( animator );
+		models.push_back( model );
+	}
+
+	RenderQueue queue;
+	queue.begin( glm::mat4( 1.0f ) );
+	for( const auto& model : models ) {
+		queue.submit( *model, model->getAnimator().get() );
+	}
+
+	const std::vector< glm::mat4 >& palette = queue.getBonePalette().getMatrices();
+	const std::vector< RenderQueue::Item >& items = queue.getItems();
+	if( items.size() != 6 || palette.size() != 3 * ( boneIDs.size() + 1 ) ) {
+		return false;
+	}
+
+	for( size_t i = 0; i != items.size(); i++ ) {
+		int expectedOffset = ( i / 2 ) * ( boneIDs.size() + 1 );
+		if( items[ i ].boneOffset != expectedOffset ) {
+			return false;
+		}
+
+		const Animation::Animator& animator = *items[ i ].animator;
+		if( palette[ expectedOffset ] != glm::mat4( 1.0f ) ) {
+			return false;
+		}
+
+		for( size_t bone = 0; bone != boneIDs.size(); bone++ ) {
+			const glm::mat4& expected = animator.getComputedMatrices()[ animator.getSkeleton()->getIndex( boneIDs[ bone ] ) ];
+			if( palette[ expectedOffset + bone + 1 ] != expected ) {
+				return false;
+			}
+		}
+	}
+
+	// A new frame starts with an empty palette
+	queue.begin( glm::mat4( 1.0f ) );
+	return queue.getBonePalette().empty();
+}
+
+// IndexedMeshGenerator as it was before spatial hashing: linear welding and O(V*T) normals
+template< typename VertexType >
+struct ReferenceMeshGenerator {
+	std::vector< VertexType > vertices;
+	std::vector< Graphics::SceneGraph::Mesh::Triangle > triangles;
+
+	unsigned int insertVertex( const VertexType& vertex ) {
+		for( unsigned int i = 0; i != vertices.size(); i++ ) {
+			if( vertex == vertices[ i ] ) {
+				return i;
+			}
+		}
+
+		vertices.push_back( vertex );
+		return vertices.size() - 1;
+	}
+
+	void addTriangle( const VertexType& v1, const VertexType& v2, const VertexType& v3 ) {
+		triangles.push_back( { insertVertex( v1 ), insertVertex( v2 ), insertVertex( v3 ) } );
+	}
+
+	void generateNormals() {
+		std::vector< glm::vec3 > triangleNormals;
+		for( const auto& triangle : triangles ) {
+			triangleNormals.emplace_back( glm::cross(
+				vertices[ triangle[ 1 ] ].position - vertices[ triangle[ 0 ] ].position,
+				vertices[ triangle[ 2 ] ].position - vertices[ triangle[ 0 ] ].position
+			) );
+		}
+
+		for( unsigned int vertexIndex = 0; vertexIndex != vertices.size(); vertexIndex++ ) {
+			glm::vec3 normalTotal( 0.0f, 0.0f, 0.0f );
+			float numTriangles = 0.0f;
+			for( unsigned int triangleIndex = 0; triangleIndex != triangles.size(); triangleIndex++ ) {
+				for( unsigned int triangleVertexIndex : triangles[ triangleIndex ] ) {
+					if( triangleVertexIndex == vertexIndex ) {
+						normalTotal += triangleNormals[ triangleIndex ];
+						numTriangles++;
+						break;
+					}
+				}
+			}
+
+			vertices[ vertexIndex ].normal = glm::normalize( normalTotal / numTriangles );
+		}
+	}
+};
+
+template< typename VertexType >
+struct ExposedMeshGenerator : public Graphics::SceneGraph::Mesh::IndexedMeshGenerator< VertexType > {
+	using Graphics::SceneGraph::Mesh::IndexedMeshGenerator< VertexType >::vertices;
+	using Graphics::SceneGraph::Mesh::IndexedMeshGenerator< VertexType >::triangles;
+};
+
+using WallPiece = std::vector< std::array< Graphics::SceneGraph::Mesh::TexturedVertex, 3 > >;
+
+// Same plane layout as WallModelLoader::getPlane
+void addWallPlane( WallPiece& piece, const glm::vec3& origin, const glm::vec3& width, const glm::vec3& height, const glm::vec3& normal, const glm::vec2& lower, const glm::vec2& upper ) {
+	piece.push_back( { {
+		{ origin, normal, lower },
+		{ origin + width, normal, { upper.x, lower.y } },
+		{ origin + height, normal, { lower.x, upper.y } }
+	} } );
+	piece.push_back( { {
+		{ origin + width, normal, { upper.x, lower.y } },
+		{ origin + width + height, normal, upper },
+		{ origin + height, normal, { lower.x, upper.y } }
+	} } );
+}
+
+// Same box as WallModelLoader::sideToStagedMesh: back, right, front, left and top planes
+WallPiece wallPiece( const glm::vec3& origin, const glm::vec3& width, float thickness ) {
+	glm::vec3 direction = glm::sign( width );
+	glm::vec3 perpendicular{ -direction.y, direction.x, 0.0f };
+	glm::vec3 height{ 0.0f, 0.0f, 4.0f };
+
+	WallPiece piece;
+	addWallPlane( piece, origin, width, height, -perpendicular, { 0.0f, 0.0f }, { 0.25f, 0.5f } );
+	addWallPlane( piece, origin + width, thickness * perpendicular, height, direction, { 0.5f, 0.5f }, { 0.55f, 1.0f } );
+	addWallPlane( piece, origin + width + ( thickness * perpendicular ), -direction, height, perpendicular, { 0.25f, 0.0f }, { 0.5f, 0.5f } );
+	addWallPlane( piece, origin + ( thickness * perpendicular ), -thickness * perpendicular, height, -direction, { 0.5f, 0.5f }, { 0.55f, 1.0f } );
+	addWallPlane( piece, origin + height, direction, thickness * perpendicular, { 0.0f, 0.0f, 1.0f }, { 0.5f, 0.5f }, { 0.55f, 1.0f } );
+	return piece;
+}
+
+/**
+ * Wall pieces for every level of lots/01.json, with each level's segments repeated to cover a 64x64 lot.
+ * Segments are walked one tile at a time as in WallModelLoader::insertCornerMapSegment.
+ */
+std::vector< std::vector< WallPiece > > scaledLotWalls( const std::string& path, int scale ) {
+	std::vector< std::vector< WallPiece > > result;
+
+	std::ifstream file( path );
+	Json::Value lot;
+	file >> lot;
+
+	for( const Json::Value& level : lot[ "infrastructure" ][ "levels" ] ) {
+		glm::ivec2 dimensions{ level[ "dimensions" ][ 0 ].asInt(), level[ "dimensions" ][ 1 ].asInt() };
+		std::vector< WallPiece >& pieces = result.emplace_back();
+
+		for( int tileY = 0; tileY < scale; tileY += dimensions.y ) {
+			for( int tileX = 0; tileX < scale; tileX += dimensions.x ) {
+				for( const Json::Value& segment : level[ "wallpaper" ] ) {
+					glm::ivec2 start{ segment[ "start" ][ 0 ].asInt() + tileX, segment[ "start" ][ 1 ].asInt() + tileY };
+					glm::ivec2 end{ segment[ "end" ][ 0 ].asInt() + tileX, segment[ "end" ][ 1 ].asInt() + tileY };
+					glm::ivec2 step = glm::sign( glm::vec2( end - start ) );
+					int distance = std::max( std::abs( end.x - start.x ), std::abs( end.y - start.y ) );
+					bool diagonal = step.x && step.y;
+
+					for( int i = 0; i != distance; i++ ) {
+						glm::ivec2 cell = start + ( step * i );
+						if( cell.x < 0 || cell.y < 0 || cell.x >= scale || cell.y >= scale ) {
+							continue;
+						}
+
+						glm::vec3 origin{ -( scale * 0.5f ) + cell.x, ( scale * 0.5f ) - cell.y, 0.0f };
+						pieces.push_back( wallPiece( origin, { step.x, -step.y, 0.0f }, diagonal ? 0.055f : 0.1f ) );
+					}
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+// Same grid as FloorModelLoader::get, with a gentle height field so that normals vary
+template< typename Generator >
+void addFloorLevel( Generator& generator, int size ) {
+	auto elevation = []( int x, int y ) { return 0.05f * std::sin( x * 0.3f ) * std::cos( y * 0.2f ); };
+	glm::vec2 origin{ -( size * 0.5f ), size * 0.5f };
+	glm::vec2 last{ size, size };
+
+	for( int y = 0; y != size; y++ ) {
+		for( int x = 0; x != size; x++ ) {
+			glm::vec2 current{ x, y };
+			glm::vec2 base{ origin.x + x, origin.y - y };
+
+			Graphics::SceneGraph::Mesh::TexturedVertex down{ { base.x, base.y - 1.0f, elevation( x, y + 1 ) }, {}, { current.x / last.x, 1.0f - ( ( current.y + 1.0f ) / last.y ) } };
+			Graphics::SceneGraph::Mesh::TexturedVertex right{ { base.x + 1.0f, base.y, elevation( x + 1, y ) }, {}, { ( current.x + 1.0f ) / last.x, 1.0f - ( current.y / last.y ) } };
+			Graphics::SceneGraph::Mesh::TexturedVertex here{ { base.x, base.y, elevation( x, y ) }, {}, { current.x / last.x, 1.0f - ( current.y / last.y ) } };
+			Graphics::SceneGraph::Mesh::TexturedVertex diagonal{ { base.x + 1.0f, base.y - 1.0f, elevation( x + 1, y + 1 ) }, {}, { ( current.x + 1.0f ) / last.x, 1.0f - ( ( current.y + 1.0f ) / last.y ) } };
+
+			generator.addTriangle( down, right, here );
+			generator.addTriangle( down, diagonal, right );
+		}
+	}
+}
+
+template< typename Lhs, typename Rhs >
+bool sameIndexedMesh( const Lhs& lhs, const Rhs& rhs ) {
+	if( lhs.triangles != rhs.triangles || lhs.vertices.size() != rhs.vertices.size() ) {
+		return false;
+	}
+
+	for( size_t i = 0; i != lhs.vertices.size(); i++ ) {
+		const auto& a = lhs.vertices[ i ];
+		const auto& b = rhs.vertices[ i ];
+		if( a.position != b.position || a.textureCoordinates != b.textureCoordinates ) {
+			return false;
+		}
+
+		// Bitwise, so that NaN normals from unreferenced vertices also compare equal
+		if( std::memcmp( &a.normal, &b.normal, sizeof( glm::vec3 ) ) ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool meshGeneratorMatchesReference() {
+	using Graphics::SceneGraph::Mesh::TexturedVertex;
+
+	// Near-duplicates straddling bucket boundaries, signed zeroes and a degenerate triangle
+	std::vector< TexturedVertex > awkward{
+		{ { 0.0f, 0.0f, 0.0f }, {}, { 0.0f, 0.0f } },
+		{ { -0.0f, 0.0f, 0.0f }, {}, { 0.0f, 0.0f } },
+		{ { 1.0f, 0.0f, 0.0f }, {}, { 1.0f, 0.0f } },
+		{ { 1.00015f, 0.0f, 0.0f }, {}, { 1.0f, 0.0f } },
+		{ { 0.99988f, 0.0f, 0.0f }, {}, { 1.0f, 0.0f } },
+		{ { 1024.0f, 512.0f, -3.0f }, {}, { 0.5f, 0.5f } },
+		{ { 1024.1f, 512.0f, -3.0f }, {}, { 0.5f, 0.5f } },
+		{ { 1023.95f, 511.97f, -3.0002f }, {}, { 0.5f, 0.5f } },
+		{ { 0.0f, 1.0f, 0.0f }, {}, { 0.0f, 1.0f } }
+	};
+
+	ReferenceMeshGenerator< TexturedVertex > reference;
+	ExposedMeshGenerator< TexturedVertex > hashed;
+
+	// Enough distinct vertices first that the awkward ones go through the spatial hash
+	for( int i = 0; i != 16; i++ ) {
+		TexturedVertex a{ { 10.0f + i, -4.0f, 2.0f }, {}, { 0.0f, 0.0f } };
+		TexturedVertex b{ { 10.0f + i, -3.0f, 2.0f }, {}, { 0.0f, 1.0f } };
+		TexturedVertex c{ { 10.5f + i, -3.5f, 2.5f }, {}, { 1.0f, 0.0f } };
+		reference.addTriangle( a, b, c );
+		hashed.addTriangle( a, b, c );
+	}
+
+	for( size_t i = 0; i + 2 < awkward.size(); i++ ) {
+		reference.addTriangle( awkward[ i ], awkward[ i + 1 ], awkward[ i + 2 ] );
+		hashed.addTriangle( awkward[ i ], awkward[ i + 1 ], awkward[ i + 2 ] );
+	}
+	reference.addTriangle( awkward[ 2 ], awkward[ 3 ], awkward[ 8 ] );
+	hashed.addTriangle( awkward[ 2 ], awkward[ 3 ], awkward[ 8 ] );
+	reference.generateNormals();
+	hashed.generateNormals();
+
+	if( !sameIndexedMesh( reference, hashed ) ) {
+		return false;
+	}
+
+	// Whole floor level and every wall piece of the scaled lot
+	ReferenceMeshGenerator< TexturedVertex > referenceFloor;
+	ExposedMeshGenerator< TexturedVertex > hashedFloor;
+	addFloorLevel( referenceFloor, 24 );
+	addFloorLevel( hashedFloor, 24 );
+	referenceFloor.generateNormals();
+	hashedFloor.generateNormals();
+
+	if( !sameIndexedMesh( referenceFloor, hashedFloor ) ) {
+		return false;
+	}
+
+	for( const auto& level : scaledLotWalls( "../lots/01.json", 24 ) ) {
+		ReferenceMeshGenerator< TexturedVertex > referenceLevel;
+		ExposedMeshGenerator< TexturedVertex > hashedLevel;
+
+		for( const WallPiece& piece : level ) {
+			for( const auto& triangle : piece ) {
+				referenceLevel.addTriangle( triangle[ 0 ], triangle[ 1 ], triangle[ 2 ] );
+				hashedLevel.addTriangle( triangle[ 0 ], triangle[ 1 ], triangle[ 2 ] );
+			}
+		}
+
+		if( level.empty() || !sameIndexedMesh( referenceLevel, hashedLevel ) ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template< typename Generator >
+double timeWallGeneration( const std::vector< std::vector< WallPiece > >& levels, bool merged, size_t& vertexCount ) {
+	auto start = std::chrono::steady_clock::now();
+
+	vertexCount = 0;
+	for( const auto& level : levels ) {
+		// Per piece, as WallModelLoader::getLevel does now; merged, as a single mesh per level
+		std::optional< Generator > generator;
+		for( const WallPiece& piece : level ) {
+			if( !generator || !merged ) {
+				if( generator ) {
+					vertexCount += generator->vertices.size();
+				}
+				generator.emplace();
+			}
+
+			for( const auto& triangle : piece ) {
+				generator->addTriangle( triangle[ 0 ], triangle[ 1 ], triangle[ 2 ] );
+			}
+		}
+
+		if( generator ) {
+			vertexCount += generator->vertices.size();
+		}
+	}
+
+	return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+}
+
+template< typename Generator >
+double timeFloorGeneration( int size ) {
+	auto start = std::chrono::steady_clock::now();
+
+	Generator generator;
+	addFloorLevel( generator, size );
+	generator.generateNormals();
+
+	return std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+}
+
+void benchmarkMeshGenerator() {
+	using Graphics::SceneGraph::Mesh::TexturedVertex;
+
+	auto levels = scaledLotWalls( "../lots/01.json", 64 );
+	size_t pieces = 0;
+	for( const auto& level : levels ) {
+		pieces += level.size();
+	}
+
+	size_t vertices = 0;
+	double perPieceHashed = timeWallGeneration< ExposedMeshGenerator< TexturedVertex > >( levels, false, vertices );
+	double perPieceLinear = timeWallGeneration< ReferenceMeshGenerator< TexturedVertex > >( levels, false, vertices );
+	double mergedHashed = timeWallGeneration< ExposedMeshGenerator< TexturedVertex > >( levels, true, vertices );
+	double mergedLinear = timeWallGeneration< ReferenceMeshGenerator< TexturedVertex > >( levels, true, vertices );
+
+	std::cout << "Mesh generator, lots/01.json walls at 64x64 (" << pieces << " pieces, " << vertices << " merged vertices): "
+		<< "per piece " << perPieceHashed << " ms hashed vs " << perPieceLinear << " ms linear, "
+		<< "merged " << mergedHashed << " ms hashed vs " << mergedLinear << " ms linear" << std::endl;
+
+	std::cout << "Mesh generator, 64x64 floor level with normals: "
+		<< timeFloorGeneration< ExposedMeshGenerator< TexturedVertex > >( 64 ) << " ms hashed vs "
+		<< timeFloorGeneration< ReferenceMeshGenerator< TexturedVertex > >( 64 ) << " ms linear" << std::endl;
+}
+
+struct ExposedWallModelLoader : public Graphics::SceneGraph::ModelLoader::WallModelLoader {
+	using WallModelLoader::WallModelLoader;
+	using WallModelLoader::levels;
+	using WallModelLoader::currentLevel;
+	using WallModelLoader::atlas;
+	using WallModelLoader::insertIntoAtlas;
+	using WallModelLoader::stageLevel;
+	using WallModelLoader::reloadCornerMap;
+	using WallModelLoader::restageCells;
+	using WallModelLoader::chunkSize;
+	using WallModelLoader::addToGenerator;
+	using WallModelLoader::mergeChunk;
+	using WallModelLoader::merged;
+	using WallModelLoader::Piece;
+};
+
+std::shared_ptr< sf::Image > blankImage( unsigned int width, unsigned int height ) {
+	std::shared_ptr< sf::Image > image = std::make_shared< sf::Image >();
+	image->create( width, height );
+	return image;
+}
+
+std::vector< Models::Sides > wallPalette() {
+	Models::Wallpaper brick{ blankImage( 64, 128 ), 10.0 };
+	Models::Wallpaper plaster{ blankImage( 32, 128 ), 5.0 };
+
+	return {
+		{ { "test_brick", brick }, { "test_plaster", plaster } },
+		{ { "test_plaster", plaster }, { "test_brick", brick } },
+		{ { "test_plaster", plaster }, { "test_plaster", plaster } }
+	};
+}
+
+// Loader staged on level 0 only; nothing here touches GL
+std::unique_ptr< ExposedWallModelLoader > stagedWallLoader( const std::vector< Models::Infrastructure::FloorLevel >& floorLevels, const std::vector< Models::Sides >& palette ) {
+	auto loader = std::make_unique< ExposedWallModelLoader >( floorLevels, std::make_shared< Graphics::Shader >( "wall.vert", "wall.frag", true ), blankImage( 48, 192 ) );
+	loader->insertIntoAtlas( palette, loader->atlas );
+	loader->levels.resize( floorLevels.size() );
+	loader->currentLevel = 0;
+	loader->stageLevel();
+
+	return loader;
+}
+
+Models::WallSegment randomWallSegment( std::mt19937& random, int size, const std::vector< Models::Sides >& palette ) {
+	static const glm::ivec2 directions[] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 } };
+	std::uniform_int_distribution< int > cell( 0, size );
+	std::uniform_int_distribution< int > length( 1, 4 );
+	std::uniform_int_distribution< int > direction( 0, 7 );
+	std::uniform_int_distribution< int > side( 0, palette.size() - 1 );
+
+	glm::ivec2 start{ cell( random ), cell( random ) };
+	glm::ivec2 end = start + ( directions[ direction( random ) ] * length( random ) );
+
+	// One face per step, counted the same way as WallModelLoader::insertCornerMapSegment
+	std::vector< Models::Sides > faces;
+	int steps = std::abs( glm::distance( glm::vec2( start ), glm::vec2( end ) ) );
+	for( int i = 0; i != steps; i++ ) {
+		faces.push_back( palette[ side( random ) ] );
+	}
+
+	return { start, end, faces };
+}
+
+// Add, remove or repaint one segment
+void randomWallEdit( std::mt19937& random, std::vector< Models::WallSegment >& segments, int size, const std::vector< Models::Sides >& palette ) {
+	std::uniform_int_distribution< int > action( 0, 9 );
+	int choice = action( random );
+
+	if( segments.empty() || choice < 5 ) {
+		segments.push_back( randomWallSegment( random, size, palette ) );
+		return;
+	}
+
+	std::uniform_int_distribution< int > which( 0, segments.size() - 1 );
+	auto it = segments.begin() + which( random );
+	if( choice < 8 ) {
+		segments.erase( it );
+	} else {
+		std::uniform_int_distribution< int > side( 0, palette.size() - 1 );
+		for( auto& face : it->faces ) {
+			face = palette[ side( random ) ];
+		}
+	}
+}
+
+bool sameStagedMesh( const std::map< std::string, std::array< Graphics::SceneGraph::Mesh::TexturedVertex, 6 > >& lhs, const std::map< std::string, std::array< Graphics::SceneGraph::Mesh::TexturedVertex, 6 > >& rhs ) {
+	return std::equal( lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), []( const auto& lhsPair, const auto& rhsPair ) {
+		return lhsPair.first == rhsPair.first && std::equal(
+			lhsPair.second.begin(), lhsPair.second.end(), rhsPair.second.begin(),
+			[]( const Graphics::SceneGraph::Mesh::TexturedVertex& lhsVertex, const Graphics::SceneGraph::Mesh::TexturedVertex& rhsVertex ) {
+				return lhsVertex.position == rhsVertex.position && lhsVertex.normal == rhsVertex.normal && lhsVertex.textureCoordinates == rhsVertex.textureCoordinates;
+			}
+		);
+	} );
+}
+
+bool sameStagedLevel( const ExposedWallModelLoader& lhs, const ExposedWallModelLoader& rhs ) {
+	const auto& lhsMap = lhs.levels[ 0 ].cornerMap;
+	const auto& rhsMap = rhs.levels[ 0 ].cornerMap;
+	if( lhsMap.size() != rhsMap.size() ) {
+		return false;
+	}
+
+	auto samePiece = []( const auto& lhsPiece, const auto& rhsPiece ) {
+		return lhsPiece.model == rhsPiece.model && sameStagedMesh( lhsPiece.stagedMesh, rhsPiece.stagedMesh );
+	};
+
+	for( size_t y = 0; y != lhsMap.size(); y++ ) {
+		for( size_t x = 0; x != lhsMap[ y ].size(); x++ ) {
+			const auto& lhsCorner = lhsMap[ y ][ x ];
+			const auto& rhsCorner = rhsMap[ y ][ x ];
+
+			if(
+				!samePiece( lhsCorner.horizontal, rhsCorner.horizontal ) || !samePiece( lhsCorner.vertical, rhsCorner.vertical ) ||
+				!samePiece( lhsCorner.diagonal, rhsCorner.diagonal ) || !samePiece( lhsCorner.reverseDiagonal, rhsCorner.reverseDiagonal )
+			) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Apply random wall edits to a small, crowded level, restaging only the dirty cells each time, and compare
+ * every staged piece against a loader that rebuilt the whole level from scratch.
+ */
+bool incrementalWallsMatchFullRebuild() {
+	const int size = 12;
+	std::mt19937 random( 1337 );
+	std::vector< Models::Sides > palette = wallPalette();
+
+	std::vector< Models::Infrastructure::FloorLevel > floorLevels( 1 );
+	floorLevels[ 0 ].dimensions = { size, size };
+
+	auto incremental = stagedWallLoader( floorLevels, palette );
+
+	for( int edit = 0; edit != 400; edit++ ) {
+		randomWallEdit( random, floorLevels[ 0 ].wallSegments, size, palette );
+		incremental->restageCells( incremental->reloadCornerMap() );
+
+		auto full = stagedWallLoader( floorLevels, palette );
+		if( !sameStagedLevel( *incremental, *full ) ) {
+			std::cout << "Incremental walls diverged from full rebuild after edit " << edit << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Every level of two placed rigs holds the same pieces (or chunks), at the same cells, drawing the same meshes
+template< typename VertexType >
+bool sameWallRig( const Graphics::SceneGraph::Model& lhs, const Graphics::SceneGraph::Model& rhs ) {
+	using namespace Graphics::SceneGraph;
+
+	struct Placed {
+		std::string id;
+		glm::vec2 position;
+		const Mesh::MeshDefinition< VertexType >* mesh;
+	};
+
+	auto flatten = []( const Model& level ) {
+		std::vector< Placed > result;
+		for( const auto& child : level.getChildren() ) {
+			const glm::vec2& position = ( ( Uniforms::LevelUniform* ) child->getUniform( "level" ) )->getPosition();
+			result.push_back( { child->getId(), position, ( const Mesh::MeshDefinition< VertexType >* ) child->getDrawable( 0 ).mesh.get() } );
+		}
+
+		// Patched pieces are appended to the level, so only the set of children is comparable
+		std::sort( result.begin(), result.end(), []( const Placed& a, const Placed& b ) {
+			return std::tie( a.id, a.position.x, a.position.y ) < std::tie( b.id, b.position.x, b.position.y );
+		} );
+		return result;
+	};
+
+	if( lhs.getChildren().size() != rhs.getChildren().size() ) {
+		return false;
+	}
+
+	for( size_t level = 0; level != lhs.getChildren().size(); level++ ) {
+		std::vector< Placed > lhsPieces = flatten( *lhs.getChildren()[ level ] );
+		std::vector< Placed > rhsPieces = flatten( *rhs.getChildren()[ level ] );
+
+		bool same = std::equal( lhsPieces.begin(), lhsPieces.end(), rhsPieces.begin(), rhsPieces.end(), []( const Placed& a, const Placed& b ) {
+			return a.id == b.id && a.position == b.position && a.mesh->getVertices() == b.mesh->getVertices() && a.mesh->getIndices() == b.mesh->getIndices();
+		} );
+		if( !same ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Drive WallModelLoader::update on a placed two-level rig, in both piece and merged-chunk modes, and compare it after
+ * every edit against a rig freshly built with get(). Level 0 takes random edits; halfway through, a brick wall that
+ * stays put goes up on level 1, so one update takes the new-wallpaper path that restages everything. Three quarters
+ * of the way through, level 1 is removed, and the rig has to drop it too.
+ */
+bool wallRigUpdatesMatchFreshRig() {
+	const int size = 12;
+	std::vector< Models::Sides > palette = wallPalette();
+	std::vector< Models::Sides > plasterOnly{ palette[ 2 ] };
+
+	for( bool merged : { false, true } ) {
+		std::mt19937 random( 4242 );
+		std::vector< Models::Infrastructure::FloorLevel > floorLevels( 2 );
+		floorLevels[ 0 ].dimensions = floorLevels[ 1 ].dimensions = { size, size };
+
+		auto makeLoader = [ & ]() {
+			auto loader = std::make_unique< ExposedWallModelLoader >( floorLevels, std::make_shared< Graphics::Shader >( "wall.vert", "wall.frag", true ), blankImage( 48, 192 ) );
+			loader->deferGLOperations = true;
+			loader->merged = merged;
+			// Same insertion order in both loaders, so the same atlas coordinates
+			loader->insertIntoAtlas( plasterOnly, loader->atlas );
+			return loader;
+		};
+
+		auto incremental = makeLoader();
+		std::shared_ptr< Graphics::SceneGraph::Model > rig = incremental->get();
+
+		for( int edit = 0; edit != 100; edit++ ) {
+			if( edit == 50 ) {
+				floorLevels[ 1 ].wallSegments.emplace_back( glm::ivec2{ 2, 2 }, glm::ivec2{ 2, 6 }, std::vector< Models::Sides >( 4, palette[ 0 ] ) );
+			} else if( edit == 75 ) {
+				floorLevels.pop_back();
+			} else {
+				randomWallEdit( random, floorLevels[ 0 ].wallSegments, size, edit < 50 ? plasterOnly : palette );
+			}
+			incremental->update( *rig );
+
+			std::shared_ptr< Graphics::SceneGraph::Model > fresh = makeLoader()->get();
+			bool same = merged ?
+				sameWallRig< Graphics::SceneGraph::Mesh::WallVertex >( *rig, *fresh ) :
+				sameWallRig< Graphics::SceneGraph::Mesh::TexturedVertex >( *rig, *fresh );
+			if( !same ) {
+				std::cout << "Updated wall rig diverged from a fresh one after edit " << edit << ( merged ? " (merged)" : "" ) << std::endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Tile the first level of lots/01.json across a size x size level
+std::vector< Models::Infrastructure::FloorLevel > tiledWallLevel( int size, const std::vector< Models::Sides >& palette ) {
+	std::ifstream file( "../lots/01.json" );
+	Json::Value lot;
+	file >> lot;
+	const Json::Value& level = lot[ "infrastructure" ][ "levels" ][ 0 ];
+	glm::ivec2 dimensions{ level[ "dimensions" ][ 0 ].asInt(), level[ "dimensions" ][ 1 ].asInt() };
+
+	std::vector< Models::Infrastructure::FloorLevel > floorLevels( 1 );
+	floorLevels[ 0 ].dimensions = { size, size };
+	for( int tileY = 0; tileY < size; tileY += dimensions.y ) {
+		for( int tileX = 0; tileX < size; tileX += dimensions.x ) {
+			for( const Json::Value& segment : level[ "wallpaper" ] ) {
+				glm::ivec2 start{ segment[ "start" ][ 0 ].asInt() + tileX, segment[ "start" ][ 1 ].asInt() + tileY };
+				glm::ivec2 end{ segment[ "end" ][ 0 ].asInt() + tileX, segment[ "end" ][ 1 ].asInt() + tileY };
+				int steps = std::abs( glm::distance( glm::vec2( start ), glm::vec2( end ) ) );
+				floorLevels[ 0 ].wallSegments.emplace_back( start, end, std::vector< Models::Sides >( steps, palette[ 0 ] ) );
+			}
+		}
+	}
+
+	return floorLevels;
+}
+
+void benchmarkWallRestaging() {
+	const int size = 64;
+	std::mt19937 random( 7 );
+	std::vector< Models::Sides > palette = wallPalette();
+	std::vector< Models::Infrastructure::FloorLevel > floorLevels = tiledWallLevel( size, palette );
+
+	auto loader = stagedWallLoader( floorLevels, palette );
+	const int edits = 100;
+	size_t restaged = 0;
+	double incrementalTime = 0.0;
+	double fullTime = 0.0;
+
+	for( int edit = 0; edit != edits; edit++ ) {
+		floorLevels[ 0 ].wallSegments.push_back( randomWallSegment( random, size, palette ) );
+
+		auto start = std::chrono::steady_clock::now();
+		restaged += loader->restageCells( loader->reloadCornerMap() ).size();
+		incrementalTime += std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		start = std::chrono::steady_clock::now();
+		loader->stageLevel();
+		fullTime += std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	std::cout << "Wall restaging, lots/01.json walls at 64x64 (" << floorLevels[ 0 ].wallSegments.size() << " segments): "
+		<< ( incrementalTime / edits ) << " ms incremental (" << ( restaged / edits ) << " cells) vs "
+		<< ( fullTime / edits ) << " ms full rebuild per edit" << std::endl;
+}
+
+/**
+ * Merge every chunk of a staged level and check that each piece's range holds exactly the welded mesh
+ * a standalone piece model would have drawn, tagged with its own piece index.
+ */
+bool mergedChunksMatchPieces( ExposedWallModelLoader& loader ) {
+	const auto& level = loader.levels[ 0 ];
+	glm::ivec2 chunks = ( level.dimensions + ( loader.chunkSize - 1 ) ) / loader.chunkSize;
+	size_t expectedPieces = 0;
+	size_t mergedPieces = 0;
+
+	for( const auto& row : level.cornerMap ) {
+		for( const auto& corner : row ) {
+			expectedPieces += ( bool ) corner.horizontal.model + ( bool ) corner.vertical.model + ( bool ) corner.diagonal.model + ( bool ) corner.reverseDiagonal.model;
+		}
+	}
+
+	for( int chunkY = 0; chunkY != chunks.y; chunkY++ ) {
+		for( int chunkX = 0; chunkX != chunks.x; chunkX++ ) {
+			auto chunk = loader.mergeChunk( { chunkX, chunkY } );
+			if( chunk.pieces.size() > Graphics::SceneGraph::Uniforms::WallPiecesUniform::MAX_PIECES ) {
+				return false;
+			}
+
+			unsigned int vertexCursor = 0;
+			unsigned int indexCursor = 0;
+			for( size_t i = 0; i != chunk.pieces.size(); i++ ) {
+				const auto& piece = chunk.pieces[ i ];
+
+				// Ranges are contiguous and in piece order
+				if( piece.vertexBegin != vertexCursor || piece.indexBegin != indexCursor ) {
+					return false;
+				}
+				vertexCursor += piece.vertexCount;
+				indexCursor += piece.indexCount;
+
+				glm::ivec2 cell{ std::round( piece.position.x + ( level.dimensions.x * 0.5f ) ), std::round( ( level.dimensions.y * 0.5f ) - piece.position.y ) };
+				if( cell.x / loader.chunkSize != chunkX || cell.y / loader.chunkSize != chunkY ) {
+					return false;
+				}
+
+				const auto& corner = level.cornerMap[ cell.y ][ cell.x ];
+				const ExposedWallModelLoader::Piece* source =
+					piece.id == "__horizontal" ? &corner.horizontal :
+					piece.id == "__vertical" ? &corner.vertical :
+					piece.id == "__diagonal" ? &corner.diagonal :
+					piece.id == "__reverseDiagonal" ? &corner.reverseDiagonal : nullptr;
+				if( !source || !source->model ) {
+					return false;
+				}
+
+				Graphics::SceneGraph::Mesh::IndexedMeshGenerator< Graphics::SceneGraph::Mesh::TexturedVertex > generator;
+				loader.addToGenerator( generator, source->stagedMesh );
+				if( generator.getVertices().size() != piece.vertexCount || generator.getTriangles().size() * 3 != piece.indexCount ) {
+					return false;
+				}
+
+				for( size_t v = 0; v != generator.getVertices().size(); v++ ) {
+					const auto& expected = generator.getVertices()[ v ];
+					const auto& actual = chunk.vertices[ piece.vertexBegin + v ];
+					if( actual.position != expected.position || actual.normal != expected.normal || actual.textureCoordinates != expected.textureCoordinates || actual.piece != ( int ) i ) {
+						return false;
+					}
+				}
+
+				for( size_t t = 0; t != generator.getTriangles().size(); t++ ) {
+					for( int corner = 0; corner != 3; corner++ ) {
+						if( chunk.indices[ piece.indexBegin + ( t * 3 ) + corner ] != piece.vertexBegin + generator.getTriangles()[ t ][ corner ] ) {
+							return false;
+						}
+					}
+				}
+			}
+
+			if( vertexCursor != chunk.vertices.size() || indexCursor != chunk.indices.size() ) {
+				return false;
+			}
+
+			mergedPieces += chunk.pieces.size();
+		}
+	}
+
+	return mergedPieces == expectedPieces;
+}
+
+bool mergedWallChunksKeepPieceRanges() {
+	std::vector< Models::Sides > palette = wallPalette();
+
+	// Crowded random level, with a chunk size that does not divide the level evenly
+	const int size = 13;
+	std::mt19937 random( 4242 );
+	std::vector< Models::Infrastructure::FloorLevel > floorLevels( 1 );
+	floorLevels[ 0 ].dimensions = { size, size };
+	for( int i = 0; i != 60; i++ ) {
+		floorLevels[ 0 ].wallSegments.push_back( randomWallSegment( random, size, palette ) );
+	}
+
+	auto loader = stagedWallLoader( floorLevels, palette );
+	for( int chunkSize : { 1, 3, 8 } ) {
+		loader->chunkSize = chunkSize;
+		if( !mergedChunksMatchPieces( *loader ) ) {
+			std::cout << "Merged wall chunks diverged from standalone pieces at chunk size " << chunkSize << std::endl;
+			return false;
+		}
+	}
+
+	auto tiled = stagedWallLoader( tiledWallLevel( 64, palette ), palette );
+	return mergedChunksMatchPieces( *tiled );
+}
+
+void benchmarkWallMerging() {
+	std::vector< Models::Sides > palette = wallPalette();
+	auto loader = stagedWallLoader( tiledWallLevel( 64, palette ), palette );
+	glm::ivec2 chunks = ( loader->levels[ 0 ].dimensions + ( loader->chunkSize - 1 ) ) / loader->chunkSize;
+
+	size_t pieces = 0;
+	size_t draws = 0;
+	auto start = std::chrono::steady_clock::now();
+	for( int chunkY = 0; chunkY != chunks.y; chunkY++ ) {
+		for( int chunkX = 0; chunkX != chunks.x; chunkX++ ) {
+			auto chunk = loader->mergeChunk( { chunkX, chunkY } );
+			pieces += chunk.pieces.size();
+			draws += !chunk.pieces.empty();
+		}
+	}
+	double mergeTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Wall merging, lots/01.json walls at 64x64: " << pieces << " piece draws become " << draws
+		<< " chunk draws (" << loader->chunkSize << "x" << loader->chunkSize << " cells), merged in " << mergeTime << " ms" << std::endl;
+}
+
+struct CutawayLevel {
+	std::shared_ptr< Graphics::SceneGraph::Model > level;
+	std::vector< Models::Room > rooms;
+};
+
+// size x size level split into square rooms, with one standalone panel model per wall step
+CutawayLevel generateCutawayLevel( int size, int roomSize, int levelIndex ) {
+	CutawayLevel result{ Graphics::SceneGraph::Model::create( "__wall_level", {} ), {} };
+	glm::vec2 origin{ -( size * 0.5f ), size * 0.5f };
+
+	auto addPanel = [ & ]( const std::string& id, const glm::ivec2& cell ) {
+		auto panel = Graphics::SceneGraph::Model::create( id, {} );
+		panel->setUniform( "level", std::make_unique< Graphics::SceneGraph::Uniforms::LevelUniform >( glm::vec2{ origin.x + cell.x, origin.y - cell.y }, levelIndex ) );
+		result.level->addChild( panel );
+	};
+
+	for( int line = 0; line < size; line += roomSize ) {
+		for( int step = 0; step != size; step++ ) {
+			addPanel( "__horizontal", { step, line } );
+			addPanel( "__vertical", { line, step } );
+		}
+	}
+
+	for( int y = 0; y < size; y += roomSize ) {
+		for( int x = 0; x < size; x += roomSize ) {
+			Geometry::Polygon2D points;
+			for( const glm::ivec2& corner : { glm::ivec2{ x, y }, glm::ivec2{ x + roomSize, y }, glm::ivec2{ x + roomSize, y + roomSize }, glm::ivec2{ x, y + roomSize } } ) {
+				points.emplace_back( origin.x + corner.x, origin.y - corner.y );
+			}
+
+			if( !Geometry::polygonClockwise( points ) ) {
+				points = Geometry::polygonReverse( points );
+			}
+
+			result.rooms.emplace_back( Graphics::SceneGraph::Light::DirectionalLight{ { 0.5, 0.5, -0.1 }, { 0.1, 0.1, 0.1 }, { 0.3, 0.3, 0.3 }, { 0.1, 0.1, 0.1 } }, points );
+			result.rooms.back().getWallNormals();
+		}
+	}
+
+	return result;
+}
+
+// The linear scan setWallCutaways used before the panel index
+std::set< Gameplay::WallPanel > linearCutaways( const Graphics::SceneGraph::Model& level, std::vector< Models::Room >& rooms, float cameraRotation, int currentLevel ) {
+	std::set< Gameplay::WallPanel > result;
+	const auto& segments = level.getChildren();
+
+	for( auto& room : rooms ) {
+		for( const auto& wall : room.getWallNormals() ) {
+			float angle = Tools::Utility::positiveAngle( Tools::Utility::positiveAngle( glm::degrees( glm::atan( wall.perpendicular.y, wall.perpendicular.x ) ) ) + cameraRotation );
+			if( angle < 225.0f || angle > 315.0f ) {
+				continue;
+			}
+
+			bool reversed = wall.direction == glm::vec2{ -1.0f, 0.0f } || wall.direction == glm::vec2{ 0.0f, 1.0f } || wall.direction == glm::vec2{ -1.0f, -1.0f } || wall.direction == glm::vec2{ -1.0f, 1.0f };
+			glm::vec2 start = reversed ? wall.segment.second : wall.segment.first;
+			glm::vec2 finish = reversed ? wall.segment.first : wall.segment.second;
+			glm::vec2 direction = reversed ? -wall.direction : wall.direction;
+
+			std::string match;
+			if( direction == glm::vec2{ 1.0f, 0.0f } ) {
+				match = "__horizontal";
+			} else if ( direction == glm::vec2{ 0.0f, -1.0f } ) {
+				match = "__vertical";
+			} else if ( direction == glm::vec2{ 1.0f, -1.0f } ) {
+				match = "__diagonal";
+			} else if ( direction == glm::vec2{ 1.0f, 1.0f } ) {
+				match = "__reverseDiagonal";
+			}
+
+			int totalSteps = std::abs( glm::distance( finish, start ) );
+			glm::vec2 cursor = start;
+			for( int i = 0; i < totalSteps; i++ ) {
+				for( const auto& model : segments ) {
+					Graphics::SceneGraph::Uniforms::LevelUniform* uniform = ( Graphics::SceneGraph::Uniforms::LevelUniform* ) model->getUniform( "level" );
+					if( model->getId() == match && uniform->getLevel() == currentLevel && uniform->getPosition() == cursor ) {
+						result.insert( { model.get(), -1 } );
+					}
+				}
+
+				cursor += direction;
+			}
+		}
+	}
+
+	return result;
+}
+
+bool wallPanelIndexMatchesLinearScan() {
+	for( int levelIndex = 0; levelIndex != 2; levelIndex++ ) {
+		CutawayLevel level = generateCutawayLevel( 24, 4 + levelIndex, levelIndex );
+		Gameplay::WallPanelIndex index( *level.level, { 24, 24 } );
+
+		for( float rotation : { 0.0f, 90.0f, 180.0f, 270.0f } ) {
+			std::set< Gameplay::WallPanel > expected = linearCutaways( *level.level, level.rooms, rotation, levelIndex );
+			if( expected.empty() || index.getCutaways( level.rooms, rotation ) != expected ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void benchmarkWallCutaways() {
+	const int size = 64;
+	const int levelCount = 4;
+	const int passes = 4;
+
+	std::vector< CutawayLevel > levels;
+	for( int i = 0; i != levelCount; i++ ) {
+		levels.emplace_back( generateCutawayLevel( size, 4, i ) );
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector< Gameplay::WallPanelIndex > indices;
+	for( const CutawayLevel& level : levels ) {
+		indices.emplace_back( *level.level, glm::ivec2{ size, size } );
+	}
+	double buildTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	size_t selected = 0;
+	start = std::chrono::steady_clock::now();
+	for( int pass = 0; pass != passes; pass++ ) {
+		for( int i = 0; i != levelCount; i++ ) {
+			selected += indices[ i ].getCutaways( levels[ i ].rooms, pass * 90.0f ).size();
+		}
+	}
+	double indexTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	for( int pass = 0; pass != passes; pass++ ) {
+		for( int i = 0; i != levelCount; i++ ) {
+			selected -= linearCutaways( *levels[ i ].level, levels[ i ].rooms, pass * 90.0f, i ).size();
+		}
+	}
+	double linearTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Wall cutaways, 64x64 lot with 4 levels (" << indices[ 0 ].getPanels().size() * levelCount << " panels, " << levels[ 0 ].rooms.size() * levelCount << " rooms): "
+		<< ( indexTime / passes ) << " ms indexed vs " << ( linearTime / passes ) << " ms linear per full pass, index built in " << buildTime << " ms"
+		<< ( selected ? " (selections differ)" : "" ) << std::endl;
+}
+
+// The cycle enumeration SectorIdentifier used before the planar face walk
+class ReferenceSectorIdentifier {
+	struct Node {
+		glm::ivec2 position;
+		std::list< Node* > links;
+	};
+	using Cycle = std::vector< const Node* >;
+
+	std::unordered_map< glm::ivec2, Node > graph;
+	std::set< const Node* > visited;
+
+	static bool contains( const Cycle& superset, const Cycle& set ) {
+		for( const auto& node : set ) {
+			if( std::find( superset.begin(), superset.end(), node ) == superset.end() ) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static void addCycle( std::vector< Cycle >& target, const Cycle& cycle ) {
+		for( const auto& existing : target ) {
+			if( existing.size() == cycle.size() && contains( cycle, existing ) ) {
+				return;
+			}
+		}
+
+		target.push_back( cycle );
+	}
+
+	std::vector< Cycle > getCycles( Node* node, const Node* parent, std::list< const Node* > discovered ) {
+		std::vector< Cycle > result;
+		visited.insert( node );
+		discovered.push_back( node );
+
+		for( Node* link : node->links ) {
+			if( link != parent ) {
+				Cycle potential;
+				bool seen = false;
+				for( auto iterator = discovered.rbegin(); iterator != discovered.rend(); ++iterator ) {
+					potential.push_back( *iterator );
+					if( ( seen = ( *iterator == link ) ) ) {
+						break;
+					}
+				}
+
+				if( seen ) {
+					addCycle( result, potential );
+				} else {
+					for( const Cycle& cycle : getCycles( link, node, discovered ) ) {
+						addCycle( result, cycle );
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+public:
+	void addEdge( const glm::ivec2& origin, const glm::ivec2& destination ) {
+		graph[ origin ].links.emplace_back( &graph[ destination ] );
+		graph[ destination ].links.emplace_back( &graph[ origin ] );
+		graph[ origin ].position = origin;
+		graph[ destination ].position = destination;
+	}
+
+	std::vector< std::vector< glm::ivec2 > > getSectors() {
+		std::vector< std::vector< Cycle > > groups;
+		for( auto& pair : graph ) {
+			if( !visited.count( &pair.second ) ) {
+				groups.emplace_back( getCycles( &pair.second, nullptr, {} ) );
+			}
+		}
+
+		std::vector< Cycle > finalSet;
+		for( const auto& group : groups ) {
+			for( const Cycle& needle : group ) {
+				bool superset = false;
+				for( const Cycle& value : group ) {
+					if( &needle != &value && ( superset = contains( needle, value ) ) ) {
+						break;
+					}
+				}
+
+				if( !superset ) {
+					addCycle( finalSet, needle );
+				}
+			}
+		}
+
+		std::vector< std::vector< glm::ivec2 > > result;
+		for( const Cycle& cycle : finalSet ) {
+			result.emplace_back();
+			for( const Node* node : cycle ) {
+				result.back().push_back( node->position );
+			}
+		}
+
+		return result;
+	}
+};
+
+// Order-independent form of a set of sectors, for comparing the two identifiers
+std::vector< std::vector< std::pair< int, int > > > canonicalSectors( const std::vector< std::vector< glm::ivec2 > >& sectors ) {
+	std::vector< std::vector< std::pair< int, int > > > result;
+	for( const auto& sector : sectors ) {
+		result.emplace_back();
+		for( const glm::ivec2& position : sector ) {
+			result.back().emplace_back( position.x, position.y );
+		}
+		std::sort( result.back().begin(), result.back().end() );
+	}
+	std::sort( result.begin(), result.end() );
+
+	return result;
+}
+
+std::vector< std::vector< glm::ivec2 > > sectorPositions( const Tools::SectorBundle& sectors ) {
+	std::vector< std::vector< glm::ivec2 > > result;
+	for( const Tools::Sector& sector : sectors ) {
+		result.emplace_back();
+		for( const Tools::SectorDiscoveryNode* node : sector ) {
+			result.back().push_back( node->position );
+		}
+	}
+
+	return result;
+}
+
+// A rectangle recursively split into up to the given number of rooms, as ( minimum, maximum ) corners
+std::vector< std::pair< glm::ivec2, glm::ivec2 > > randomRooms( std::mt19937& random, glm::ivec2 size, int rooms ) {
+	std::vector< std::pair< glm::ivec2, glm::ivec2 > > regions{ { { 0, 0 }, size } };
+	for( int attempt = 0; ( int ) regions.size() < rooms && attempt != rooms * 20; attempt++ ) {
+		size_t index = std::uniform_int_distribution< size_t >( 0, regions.size() - 1 )( random );
+		auto [ minimum, maximum ] = regions[ index ];
+		glm::ivec2 extent = maximum - minimum;
+		int axis = std::uniform_int_distribution< int >( 0, 1 )( random );
+		if( extent[ axis ] < 2 ) {
+			continue;
+		}
+
+		int split = minimum[ axis ] + std::uniform_int_distribution< int >( 1, extent[ axis ] - 1 )( random );
+		glm::ivec2 firstMaximum = maximum;
+		glm::ivec2 secondMinimum = minimum;
+		firstMaximum[ axis ] = split;
+		secondMinimum[ axis ] = split;
+		regions[ index ] = { minimum, firstMaximum };
+		regions.push_back( { secondMinimum, maximum } );
+	}
+
+	return regions;
+}
+
+/**
+ * Random floor plan: a rectangle recursively split into rooms, plus a few dangling walls poking into rooms.
+ * Returned as unit-length wall edges.
+ */
+std::vector< std::pair< glm::ivec2, glm::ivec2 > > randomFloorPlan( std::mt19937& random, glm::ivec2 size, int rooms, int stubs ) {
+	std::set< std::pair< std::pair< int, int >, std::pair< int, int > > > edges;
+	auto addWall = [ & ]( glm::ivec2 start, glm::ivec2 end ) {
+		glm::ivec2 step = glm::sign( end - start );
+		for( glm::ivec2 cursor = start; cursor != end; cursor += step ) {
+			std::pair< int, int > lhs{ cursor.x, cursor.y };
+			std::pair< int, int > rhs{ cursor.x + step.x, cursor.y + step.y };
+			edges.insert( std::minmax( lhs, rhs ) );
+		}
+	};
+
+	std::vector< std::pair< glm::ivec2, glm::ivec2 > > regions = randomRooms( random, size, rooms );
+	for( const auto& [ minimum, maximum ] : regions ) {
+		addWall( minimum, { maximum.x, minimum.y } );
+		addWall( { maximum.x, minimum.y }, maximum );
+		addWall( maximum, { minimum.x, maximum.y } );
+		addWall( { minimum.x, maximum.y }, minimum );
+	}
+
+	// One-step dangling walls from the middle of a room's side, where they cannot meet another wall
+	for( int i = 0; i != stubs; i++ ) {
+		const auto& [ minimum, maximum ] = regions[ std::uniform_int_distribution< size_t >( 0, regions.size() - 1 )( random ) ];
+		glm::ivec2 extent = maximum - minimum;
+		if( extent.x >= 3 && extent.y >= 3 ) {
+			int x = minimum.x + std::uniform_int_distribution< int >( 1, extent.x - 1 )( random );
+			addWall( { x, minimum.y }, { x, minimum.y + 1 } );
+		}
+	}
+
+	std::vector< std::pair< glm::ivec2, glm::ivec2 > > result;
+	for( const auto& [ lhs, rhs ] : edges ) {
+		result.push_back( { { lhs.first, lhs.second }, { rhs.first, rhs.second } } );
+	}
+	std::shuffle( result.begin(), result.end(), random );
+
+	return result;
+}
+
+/**
+ * Cycle enumeration also keeps unions of rooms whenever no single room has all of its corners on the union's
+ * boundary (any T-junction or four-way junction), so the face walk cannot match it exactly. Instead, every
+ * room the face walk finds must be one of the enumerated cycles, and together the rooms must tile the plan.
+ */
+bool faceWalkMatchesCycleEnumeration() {
+	std::mt19937 random( 90210 );
+
+	for( int plan = 0; plan != 200; plan++ ) {
+		glm::ivec2 size{ std::uniform_int_distribution< int >( 2, 7 )( random ), std::uniform_int_distribution< int >( 2, 7 )( random ) };
+		auto edges = randomFloorPlan( random, size, std::uniform_int_distribution< int >( 1, 6 )( random ), 2 );
+
+		ReferenceSectorIdentifier reference;
+		Tools::SectorIdentifier faceWalk;
+		for( const auto& [ origin, destination ] : edges ) {
+			reference.addEdge( origin, destination );
+			faceWalk.addEdge( origin, destination );
+		}
+
+		auto enumerated = canonicalSectors( reference.getSectors() );
+		auto faces = sectorPositions( faceWalk.getSectors() );
+
+		long long doubleArea = 0;
+		for( const auto& face : faces ) {
+			for( size_t i = 0; i != face.size(); i++ ) {
+				const glm::ivec2& current = face[ i ];
+				const glm::ivec2& next = face[ ( i + 1 ) % face.size() ];
+				doubleArea += ( ( long long ) current.x * next.y ) - ( ( long long ) next.x * current.y );
+			}
+		}
+
+		bool subset = true;
+		for( const auto& face : canonicalSectors( faces ) ) {
+			subset = subset && std::binary_search( enumerated.begin(), enumerated.end(), face );
+		}
+
+		if( !subset || std::abs( doubleArea ) != 2ll * size.x * size.y ) {
+			std::cout << "Face walk sectors diverged from cycle enumeration on plan " << plan << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void benchmarkSectorIdentification() {
+	std::mt19937 random( 31337 );
+
+	for( int rooms : { 2, 4, 6, 8 } ) {
+		auto edges = randomFloorPlan( random, { 8, 8 }, rooms, 0 );
+
+		auto start = std::chrono::steady_clock::now();
+		ReferenceSectorIdentifier reference;
+		for( const auto& [ origin, destination ] : edges ) {
+			reference.addEdge( origin, destination );
+		}
+		size_t referenceSectors = reference.getSectors().size();
+		double referenceTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		start = std::chrono::steady_clock::now();
+		Tools::SectorIdentifier faceWalk;
+		for( const auto& [ origin, destination ] : edges ) {
+			faceWalk.addEdge( origin, destination );
+		}
+		size_t faceWalkSectors = faceWalk.getSectors().size();
+		double faceWalkTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		std::cout << "Sector identification, 8x8 plan with " << faceWalkSectors << " rooms (" << edges.size() << " edges): "
+			<< faceWalkTime << " ms face walk vs " << referenceTime << " ms cycle enumeration (" << referenceSectors << " cycles kept)" << std::endl;
+	}
+
+	auto edges = randomFloorPlan( random, { 64, 64 }, 400, 100 );
+	auto start = std::chrono::steady_clock::now();
+	Tools::SectorIdentifier faceWalk;
+	for( const auto& [ origin, destination ] : edges ) {
+		faceWalk.addEdge( origin, destination );
+	}
+	size_t faceWalkSectors = faceWalk.getSectors().size();
+	double faceWalkTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Sector identification, 64x64 plan with " << faceWalkSectors << " rooms (" << edges.size() << " edges): "
+		<< faceWalkTime << " ms face walk" << std::endl;
+}
+
+// The cell walk generateIntersectionalList used before grid bucketing. Only walks segments heading toward +x/+y.
+Tools::Intersection::IntersectionList referenceIntersectionalList( Tools::Intersection::IntersectionList lineSegments, const glm::ivec2& totalDimensions ) {
+	using namespace Tools::Intersection;
+
+	// The original appended to lineSegments while holding pointers into it
+	lineSegments.reserve( lineSegments.size() * 64 );
+
+	auto comp = [ &totalDimensions ]( const glm::ivec2& left, const glm::ivec2& right ) -> bool {
+		return ( ( left.y * totalDimensions.x ) + left.x ) < ( ( right.y * totalDimensions.x ) + right.x );
+	};
+	std::map< glm::ivec2, std::unordered_set< IntersectionLineSegment* >, decltype( comp ) > crossedVertices( comp );
+
+	for( auto& lineSegment : lineSegments ) {
+		glm::ivec2 direction = glm::ivec2( glm::sign( glm::vec2( lineSegment.end ) - glm::vec2( lineSegment.start ) ) );
+		glm::ivec2 cursor = lineSegment.start;
+
+		while( cursor.x <= lineSegment.end.x && cursor.y <= lineSegment.end.y ) {
+			for( auto& otherLineSegment : lineSegments ) {
+				if( &lineSegment != &otherLineSegment ) {
+					glm::ivec2 otherDirection = glm::ivec2( glm::sign( glm::vec2( otherLineSegment.end ) - glm::vec2( otherLineSegment.start ) ) );
+					glm::ivec2 otherCursor = otherLineSegment.start;
+
+					while( otherCursor.x <= otherLineSegment.end.x && otherCursor.y <= otherLineSegment.end.y ) {
+						if( cursor == otherCursor ) {
+							crossedVertices[ cursor ].emplace( &lineSegment );
+						}
+
+						otherCursor += otherDirection;
+					}
+				}
+			}
+
+			cursor += direction;
+		}
+	}
+
+	for( auto& pair : crossedVertices ) {
+		for( IntersectionLineSegment* lineSegment : pair.second ) {
+			if( pair.first != lineSegment->start && pair.first != lineSegment->end ) {
+				IntersectionLineSegment newLineSegment{ lineSegment->start, pair.first };
+				lineSegment->start = pair.first;
+				lineSegments.emplace_back( std::move( newLineSegment ) );
+			}
+		}
+	}
+
+	return lineSegments;
+}
+
+std::vector< std::array< int, 4 > > canonicalSegments( const Tools::Intersection::IntersectionList& segments ) {
+	std::vector< std::array< int, 4 > > result;
+	for( const auto& segment : segments ) {
+		result.push_back( { segment.start.x, segment.start.y, segment.end.x, segment.end.y } );
+	}
+	std::sort( result.begin(), result.end() );
+
+	return result;
+}
+
+// Whole room walls heading toward +x/+y, overlapping wherever rooms share a wall, plus a few diagonals
+Tools::Intersection::IntersectionList randomWallPlan( std::mt19937& random, glm::ivec2 size, int rooms, int diagonals ) {
+	Tools::Intersection::IntersectionList result;
+	for( const auto& [ minimum, maximum ] : randomRooms( random, size, rooms ) ) {
+		result.push_back( { minimum, { maximum.x, minimum.y } } );
+		result.push_back( { { maximum.x, minimum.y }, maximum } );
+		result.push_back( { { minimum.x, maximum.y }, maximum } );
+		result.push_back( { minimum, { minimum.x, maximum.y } } );
+	}
+
+	for( int i = 0; i != diagonals; i++ ) {
+		glm::ivec2 start{ std::uniform_int_distribution< int >( 0, size.x - 1 )( random ), std::uniform_int_distribution< int >( 0, size.y - 1 )( random ) };
+		int length = std::uniform_int_distribution< int >( 1, std::min( size.x - start.x, size.y - start.y ) )( random );
+		result.push_back( { start, start + length } );
+	}
+	std::shuffle( result.begin(), result.end(), random );
+
+	return result;
+}
+
+bool gridIntersectionsMatchCellWalk() {
+	std::mt19937 random( 2718 );
+
+	for( int plan = 0; plan != 200; plan++ ) {
+		glm::ivec2 size{ std::uniform_int_distribution< int >( 2, 16 )( random ), std::uniform_int_distribution< int >( 2, 16 )( random ) };
+		auto segments = randomWallPlan( random, size, std::uniform_int_distribution< int >( 1, 12 )( random ), 3 );
+
+		if( canonicalSegments( Tools::Intersection::generateIntersectionalList( segments, size + 1 ) ) != canonicalSegments( referenceIntersectionalList( segments, size + 1 ) ) ) {
+			std::cout << "Grid intersections diverged from cell walk on plan " << plan << std::endl;
+			return false;
+		}
+	}
+
+	// Reverse diagonals were skipped by the cell walk; they now split like any other wall
+	auto crossing = Tools::Intersection::generateIntersectionalList( { { { 0, 0 }, { 2, 2 } }, { { 0, 2 }, { 2, 0 } } }, { 3, 3 } );
+	if( canonicalSegments( crossing ) != canonicalSegments( { { { 0, 0 }, { 1, 1 } }, { { 1, 1 }, { 2, 2 } }, { { 0, 2 }, { 1, 1 } }, { { 1, 1 }, { 2, 0 } } } ) ) {
+		return false;
+	}
+
+	// Off-thread pass hands the same result to its callback
+	auto segments = randomWallPlan( random, { 32, 32 }, 40, 10 );
+	Tools::Intersection::IntersectionList asyncResult;
+	Tools::Intersection::generateIntersectionalListAsync( segments, { 33, 33 }, [ &asyncResult ]( Tools::Intersection::IntersectionList result ) {
+		asyncResult = std::move( result );
+	} ).wait();
+
+	return canonicalSegments( asyncResult ) == canonicalSegments( Tools::Intersection::generateIntersectionalList( segments, { 33, 33 } ) );
+}
+
+void benchmarkIntersections() {
+	std::mt19937 random( 1618 );
+
+	for( int rooms : { 250, 1000, 4000 } ) {
+		glm::ivec2 size{ 256, 256 };
+		auto segments = randomWallPlan( random, size, rooms, rooms / 10 );
+
+		auto start = std::chrono::steady_clock::now();
+		size_t pieces = Tools::Intersection::generateIntersectionalList( segments, size + 1 ).size();
+		double gridTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		std::cout << "Wall intersections, 256x256 plan with " << segments.size() << " segments (" << pieces << " pieces): " << gridTime << " ms grid";
+		if( rooms <= 250 ) {
+			start = std::chrono::steady_clock::now();
+			referenceIntersectionalList( segments, size + 1 );
+			std::cout << " vs " << std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count() << " ms cell walk";
+		}
+		std::cout << std::endl;
+	}
+}
+
+struct ExposedLightmapManager : public Graphics::SceneGraph::Light::LightmapManager {
+	using LightmapManager::ShaderRoom;
+	using LightmapManager::RegionUpdate;
+	using LightmapManager::generatedRooms;
+	using LightmapManager::textureSize;
+	using LightmapManager::getFragmentData;
+	using LightmapManager::updateRegions;
+	using LightmapManager::getStd140Rooms;
+};
+
+// Rooms of one level, found the same way as InfrastructureManager::generateRooms
+std::vector< Models::Room > roomsFromWalls( const Tools::Intersection::IntersectionList& walls, const glm::ivec2& dimensions ) {
+	Tools::SectorIdentifier sectorIdentifier;
+	for( const auto& segment : Tools::Intersection::generateIntersectionalList( walls, dimensions + 1 ) ) {
+		sectorIdentifier.addEdge( segment.start, segment.end );
+	}
+
+	std::vector< Models::Room > result;
+	for( const Tools::Sector& sector : sectorIdentifier.getSectors() ) {
+		Geometry::Polygon2D points;
+		for( const Tools::SectorDiscoveryNode* node : sector ) {
+			points.emplace_back( -( dimensions.x * 0.5f ) + node->position.x, ( dimensions.y * 0.5f ) - node->position.y );
+		}
+
+		if( !Geometry::polygonClockwise( points ) ) {
+			points = Geometry::polygonReverse( points );
+		}
+
+		result.emplace_back( Graphics::SceneGraph::Light::DirectionalLight{ { 0.5, 0.5, -0.1 }, { 0.1, 0.1, 0.1 }, { 0.3, 0.3, 0.3 }, { 0.1, 0.1, 0.1 } }, points );
+	}
+
+	return result;
+}
+
+// The per-texel ray cast LightmapManager::getFragmentData used before scanline rasterization
+std::vector< float > referenceRoomMask( const Models::Room& room, int lightIndex ) {
+	glm::vec2 min{ std::numeric_limits< float >::max(), std::numeric_limits< float >::max() };
+	glm::vec2 max{ std::numeric_limits< float >::lowest(), std::numeric_limits< float >::lowest() };
+	for( const glm::vec2& point : room.getPoints() ) {
+		min = glm::min( min, point );
+		max = glm::max( max, point );
+	}
+
+	glm::ivec2 start{ std::floor( min.x * LIGHTMAP_SECTOR_RESOLUTION ), std::floor( max.y * LIGHTMAP_SECTOR_RESOLUTION ) };
+	glm::ivec2 end{ std::floor( max.x * LIGHTMAP_SECTOR_RESOLUTION ), std::floor( min.y * LIGHTMAP_SECTOR_RESOLUTION ) };
+	int arrayWidth = ( end.x - start.x );
+	std::vector< float > result( arrayWidth * ( start.y - end.y ), 0.0f );
+
+	std::vector< Geometry::LineSegment< glm::vec2 > > edges;
+	const auto& points = room.getPoints();
+	for( size_t i = 0; i != points.size(); i++ ) {
+		edges.push_back( { points[ i ], points[ ( i + 1 ) % points.size() ] } );
+	}
+
+	for( int y = start.y; y > end.y; y-- ) {
+		for( int x = start.x; x < end.x; x++ ) {
+			glm::vec2 asFloat{ x / ( float ) LIGHTMAP_SECTOR_RESOLUTION, y / ( float ) LIGHTMAP_SECTOR_RESOLUTION };
+			Geometry::LineSegment< glm::vec2 > needle{ { asFloat.x, asFloat.y }, { asFloat.x + arrayWidth, asFloat.y } };
+
+			unsigned int intersections = 0;
+			for( const auto& edge : edges ) {
+				if( Geometry::segmentsIntersect( needle, edge ) ) {
+					intersections++;
+				}
+			}
+
+			if( ( intersections % 2 ) != 0 ) {
+				result[ ( ( start.y - y ) * arrayWidth ) + ( x - start.x ) ] = lightIndex;
+			}
+		}
+	}
+
+	return result;
+}
+
+std::vector< Models::Room > shippedLotRooms() {
+	std::ifstream file( "../lots/01.json" );
+	Json::Value lot;
+	file >> lot;
+
+	std::vector< Models::Room > result;
+	for( const Json::Value& level : lot[ "infrastructure" ][ "levels" ] ) {
+		Tools::Intersection::IntersectionList walls;
+		for( const Json::Value& segment : level[ "wallpaper" ] ) {
+			walls.push_back( { { segment[ "start" ][ 0 ].asInt(), segment[ "start" ][ 1 ].asInt() }, { segment[ "end" ][ 0 ].asInt(), segment[ "end" ][ 1 ].asInt() } } );
+		}
+
+		for( auto& room : roomsFromWalls( walls, { level[ "dimensions" ][ 0 ].asInt(), level[ "dimensions" ][ 1 ].asInt() } ) ) {
+			result.emplace_back( std::move( room ) );
+		}
+	}
+
+	return result;
+}
+
+std::vector< Models::Room > generatedHouseRooms( int size, int rooms ) {
+	std::mt19937 random( 1234 );
+	return roomsFromWalls( randomWallPlan( random, { size, size }, rooms, 0 ), { size, size } );
+}
+
+bool scanlineMatchesRayCast( ExposedLightmapManager& manager, const std::vector< Models::Room >& rooms ) {
+	for( size_t i = 0; i != rooms.size(); i++ ) {
+		std::vector< float > expected = referenceRoomMask( rooms[ i ], i + 1 );
+		ExposedLightmapManager::ShaderRoom actual = manager.getFragmentData( rooms[ i ], 0, i + 1 );
+		if( expected.empty() || ( size_t ) ( actual.dimensions.x * actual.dimensions.y ) != expected.size() ) {
+			return false;
+		}
+
+		// The ray cast wrote rows top to bottom; masks are now written in texture order
+		for( int row = 0; row != actual.dimensions.y; row++ ) {
+			const float* expectedRow = &expected[ ( actual.dimensions.y - 1 - row ) * actual.dimensions.x ];
+			if( std::memcmp( expectedRow, &actual.mapData[ row * actual.dimensions.x ], actual.dimensions.x * sizeof( float ) ) != 0 ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool lightmapScanlineMatchesRayCast() {
+	ExposedLightmapManager manager;
+	std::vector< Models::Room > shipped = shippedLotRooms();
+
+	return !shipped.empty() && scanlineMatchesRayCast( manager, shipped ) && scanlineMatchesRayCast( manager, generatedHouseRooms( 24, 20 ) );
+}
+
+bool lightmapRegionsValid( const ExposedLightmapManager& manager ) {
+	for( size_t i = 0; i != manager.generatedRooms.size(); i++ ) {
+		const auto& lhs = manager.generatedRooms[ i ];
+		if( lhs.level == -1 ) {
+			continue;
+		}
+
+		if( lhs.region.width != lhs.dimensions.x || lhs.region.height != lhs.dimensions.y || lhs.mapLocation != glm::ivec2{ lhs.region.x, lhs.region.y - 1 } ||
+			lhs.region.x + lhs.region.width > manager.textureSize.x || lhs.region.y + lhs.region.height > manager.textureSize.y ) {
+			return false;
+		}
+
+		for( size_t j = i + 1; j != manager.generatedRooms.size(); j++ ) {
+			if( manager.generatedRooms[ j ].level != -1 && lhs.region.overlaps( manager.generatedRooms[ j ].region ) ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool lightmapRegionsUpdateOnlyChangedRooms() {
+	ExposedLightmapManager manager;
+	std::vector< Models::Room > rooms = generatedHouseRooms( 24, 12 );
+
+	manager.setRooms( { rooms } );
+	ExposedLightmapManager::RegionUpdate initial = manager.updateRegions();
+	bool allRasterized = initial.dirty.size() == rooms.size() && initial.resized && lightmapRegionsValid( manager );
+
+	std::vector< glm::ivec2 > locations;
+	for( const auto& shaderRoom : manager.generatedRooms ) {
+		locations.emplace_back( shaderRoom.mapLocation );
+	}
+
+	bool unchangedSkipped = manager.updateRegions().dirty.empty();
+
+	// Move one room half a tile; it alone is rasterized again, and nobody else moves in the atlas
+	std::vector< glm::vec2 > moved = rooms[ 3 ].getPoints();
+	for( auto& point : moved ) {
+		point.x += 0.5f;
+	}
+	rooms[ 3 ] = Models::Room( rooms[ 3 ].getBackgroundLight(), moved );
+	manager.setRooms( { rooms } );
+
+	ExposedLightmapManager::RegionUpdate changed = manager.updateRegions();
+	bool onlyChanged = changed.dirty == std::vector< size_t >{ 3 } && changed.cleared.size() == 1 && !changed.resized && lightmapRegionsValid( manager );
+	for( size_t i = 0; i != rooms.size(); i++ ) {
+		if( i != 3 && manager.generatedRooms[ i ].mapLocation != locations[ i ] ) {
+			onlyChanged = false;
+		}
+	}
+
+	ExposedLightmapManager::ShaderRoom expected = manager.getFragmentData( rooms[ 3 ], 0, 4 );
+	const auto& actual = manager.generatedRooms[ 3 ];
+	bool maskMatches = actual.dimensions == expected.dimensions &&
+		std::memcmp( actual.mapData.get(), expected.mapData.get(), expected.dimensions.x * expected.dimensions.y * sizeof( float ) ) == 0;
+
+	// A removed room frees its slot and region, which the next new room takes
+	Models::Room removed = rooms[ 1 ];
+	rooms.erase( rooms.begin() + 1 );
+	manager.setRooms( { rooms } );
+	ExposedLightmapManager::RegionUpdate removal = manager.updateRegions();
+	bool slotFreed = removal.dirty.empty() && removal.cleared.size() == 1 && manager.generatedRooms[ 1 ].level == -1 && lightmapRegionsValid( manager );
+
+	rooms.push_back( removed );
+	manager.setRooms( { rooms } );
+	ExposedLightmapManager::RegionUpdate addition = manager.updateRegions();
+	bool slotReused = addition.dirty == std::vector< size_t >{ 1 } && addition.cleared.empty() && manager.generatedRooms[ 1 ].level == 0 && lightmapRegionsValid( manager );
+
+	return allRasterized && unchangedSkipped && onlyChanged && maskMatches && slotFreed && slotReused;
+}
+
+template< typename T >
+T readBuffer( const std::vector< unsigned char >& buffer, size_t offset ) {
+	T result;
+	std::memcpy( &result, buffer.data() + offset, sizeof( T ) );
+	return result;
+}
+
+bool lightBuffersUseStd140Layout() {
+	using namespace Graphics::SceneGraph::Light;
+
+	DirectionalLight first{ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 }, { 10, 11, 12 } };
+	DirectionalLight second{ { 13, 14, 15 }, { 16, 17, 18 }, { 19, 20, 21 }, { 22, 23, 24 } };
+	std::vector< unsigned char > lights = packLights( { &first, &second } );
+
+	// vec3 members sit on 16-byte boundaries
+	bool lightsPacked = lights.size() == 128 &&
+		readBuffer< glm::vec3 >( lights, 0 ) == glm::vec3{ 1, 2, 3 } && readBuffer< glm::vec3 >( lights, 16 ) == glm::vec3{ 4, 5, 6 } &&
+		readBuffer< glm::vec3 >( lights, 32 ) == glm::vec3{ 7, 8, 9 } && readBuffer< glm::vec3 >( lights, 48 ) == glm::vec3{ 10, 11, 12 } &&
+		readBuffer< glm::vec3 >( lights, 64 ) == glm::vec3{ 13, 14, 15 } && readBuffer< glm::vec3 >( lights, 112 ) == glm::vec3{ 22, 23, 24 };
+
+	std::vector< Std140Room > rooms{
+		Std140Room{ { -2.5f, -1.5f }, { 0.5f, 1.0f }, { 10, 20 }, 0 },
+		Std140Room{},
+		Std140Room{ { 1.0f, -3.0f }, { 2.5f, -0.5f }, { 30, 40 }, 1 }
+	};
+	RoomTileIndex index = indexRoomTiles( rooms );
+	std::vector< unsigned char > roomBuffer = packRooms( rooms, index );
+
+	// ivec4 grid header, then 32-byte rooms: vec2 at 0, vec2 at 8, ivec2 at 16, int at 24
+	bool roomsPacked = roomBuffer.size() == 16 + ( 3 * 32 ) &&
+		readBuffer< glm::ivec4 >( roomBuffer, 0 ) == glm::ivec4{ -3, -3, 6, 5 } &&
+		readBuffer< glm::vec2 >( roomBuffer, 16 ) == glm::vec2{ -2.5f, -1.5f } && readBuffer< glm::vec2 >( roomBuffer, 24 ) == glm::vec2{ 0.5f, 1.0f } &&
+		readBuffer< glm::ivec2 >( roomBuffer, 32 ) == glm::ivec2{ 10, 20 } && readBuffer< int >( roomBuffer, 40 ) == 0 &&
+		readBuffer< int >( roomBuffer, 48 + 24 ) == -1 &&
+		readBuffer< glm::vec2 >( roomBuffer, 80 ) == glm::vec2{ 1.0f, -3.0f } && readBuffer< int >( roomBuffer, 80 + 24 ) == 1;
+
+	// Tile ( 2, -1 ) of level 1 holds only the third slot; the tile list is a plain int array
+	glm::ivec2 entry = index.entries[ ( ( ( 1 * index.size.y ) + ( -1 - index.origin.y ) ) * index.size.x ) + ( 2 - index.origin.x ) ];
+	std::vector< unsigned char > tileRooms = packTileRooms( index );
+	bool tilesPacked = index.levels == 2 && index.entries.size() == ( size_t ) ( 6 * 5 * 2 ) && entry.y == 1 &&
+		readBuffer< int >( tileRooms, entry.x * sizeof( int ) ) == 2 && tileRooms.size() == index.rooms.size() * sizeof( int ) &&
+		packTileRooms( indexRoomTiles( {} ) ).size() == sizeof( int );
+
+	return lightsPacked && roomsPacked && tilesPacked;
+}
+
+bool roomTileIndexMatchesLinearScan() {
+	ExposedLightmapManager manager;
+
+	// Two levels and well past the old sixteen-room limit
+	std::vector< Models::Room > ground = generatedHouseRooms( 32, 30 );
+	std::vector< Models::Room > upper = generatedHouseRooms( 24, 14 );
+	manager.setRooms( { ground, upper } );
+	manager.updateRegions();
+
+	std::vector< Graphics::SceneGraph::Light::Std140Room > rooms = manager.getStd140Rooms();
+	Graphics::SceneGraph::Light::RoomTileIndex index = Graphics::SceneGraph::Light::indexRoomTiles( rooms );
+	if( rooms.size() <= 16 ) {
+		return false;
+	}
+
+	auto inBox = []( const Graphics::SceneGraph::Light::Std140Room& room, const glm::vec2& fragment ) {
+		return fragment.x >= room.lowerLeft.x && fragment.x <= room.upperRight.x && fragment.y >= room.lowerLeft.y && fragment.y <= room.upperRight.y;
+	};
+
+	std::mt19937 random( 5 );
+	std::uniform_real_distribution< float > coordinate( -18.0f, 18.0f );
+	for( int i = 0; i != 20000; i++ ) {
+		// Whole and half units land on room edges, where the closed boxes of neighbours meet
+		glm::vec2 fragment{ coordinate( random ), coordinate( random ) };
+		if( i % 4 == 0 ) {
+			fragment = glm::round( fragment * 2.0f ) * 0.5f;
+		}
+		int level = i % 3;
+
+		std::vector< int > expected;
+		for( size_t slot = 0; slot != rooms.size(); slot++ ) {
+			if( rooms[ slot ].level == level && inBox( rooms[ slot ], fragment ) ) {
+				expected.push_back( slot );
+			}
+		}
+
+		std::vector< int > actual;
+		glm::ivec2 tile = glm::ivec2( glm::floor( fragment ) ) - index.origin;
+		if( tile.x >= 0 && tile.y >= 0 && tile.x < index.size.x && tile.y < index.size.y && level < index.levels ) {
+			glm::ivec2 entry = index.entries[ ( ( ( level * index.size.y ) + tile.y ) * index.size.x ) + tile.x ];
+			for( int j = entry.x; j != entry.x + entry.y; j++ ) {
+				if( inBox( rooms[ index.rooms[ j ] ], fragment ) ) {
+					actual.push_back( index.rooms[ j ] );
+				}
+			}
+		}
+
+		if( actual != expected ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void benchmarkLightmaps() {
+	ExposedLightmapManager manager;
+	std::vector< Models::Room > rooms = generatedHouseRooms( 32, 40 );
+
+	auto start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i != rooms.size(); i++ ) {
+		manager.getFragmentData( rooms[ i ], 0, i + 1 );
+	}
+	double scanlineTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	std::vector< ExposedLightmapManager::ShaderRoom > parallel( rooms.size() );
+	tbb::parallel_for( ( size_t ) 0, rooms.size(), [ & ]( size_t i ) {
+		parallel[ i ] = manager.getFragmentData( rooms[ i ], 0, i + 1 );
+	} );
+	double parallelTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	for( size_t i = 0; i != rooms.size(); i++ ) {
+		referenceRoomMask( rooms[ i ], i + 1 );
+	}
+	double rayCastTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Lightmap masks, 32x32 house with " << rooms.size() << " rooms: " << scanlineTime << " ms scanline ("
+		<< parallelTime << " ms across rooms in parallel) vs " << rayCastTime << " ms per-texel ray cast" << std::endl;
+}
+
+// The guillotine first-fit Containers::packCells used before MaxRects
+Containers::PackedCellMap< int > referenceGuillotinePack( std::vector< Containers::BoundedObject< int > > items, int defaultWidth, int defaultHeight ) {
+	int totalWidth = defaultWidth;
+	int totalHeight = defaultHeight;
+	std::vector< Containers::PackedCell< int > > packed;
+	std::vector< Containers::PackedCell< int > > unpacked{ Containers::PackedCell< int >{ 0, 0, defaultWidth, defaultHeight, {} } };
+
+	std::sort( items.begin(), items.end(), []( const Containers::BoundedObject< int >& lhs, const Containers::BoundedObject< int >& rhs ) {
+		return std::max( lhs.width, lhs.height ) < std::max( rhs.width, rhs.height );
+	} );
+
+	for( const auto& item : items ) {
+		auto nextFreeBox = std::find_if( unpacked.begin(), unpacked.end(), [ &item ]( const Containers::PackedCell< int >& box ) {
+			return item.width <= box.width && item.height <= box.height;
+		} );
+
+		if( nextFreeBox != unpacked.end() ) {
+			Containers::PackedCell< int > rightEmpty{ nextFreeBox->x + item.width, nextFreeBox->y, nextFreeBox->width - item.width, item.height, {} };
+			Containers::PackedCell< int > bottomEmpty{ nextFreeBox->x, nextFreeBox->y + item.height, nextFreeBox->width, nextFreeBox->height - item.height, {} };
+			packed.push_back( { nextFreeBox->x, nextFreeBox->y, item.width, item.height, item.object } );
+
+			unpacked.erase( nextFreeBox );
+			if( rightEmpty.width > 0 && rightEmpty.height > 0 ) { unpacked.push_back( rightEmpty ); }
+			if( bottomEmpty.width > 0 && bottomEmpty.height > 0 ) { unpacked.push_back( bottomEmpty ); }
+		} else {
+			packed.push_back( { totalWidth, 0, item.width, item.height, item.object } );
+
+			int difference = item.height - totalHeight;
+			if( difference > 0 ) {
+				unpacked.push_back( { 0, totalHeight, totalWidth, difference, {} } );
+				totalHeight += difference;
+			} else {
+				unpacked.push_back( { totalWidth, item.height, item.width, totalHeight - item.height, {} } );
+			}
+			totalWidth += item.width;
+		}
+	}
+
+	double usedArea = 0.0;
+	for( const auto& cell : packed ) {
+		usedArea += ( double ) cell.width * cell.height;
+	}
+
+	return { packed, totalWidth, totalHeight, usedArea / ( ( double ) totalWidth * totalHeight ) };
+}
+
+// Room lightmaps at LIGHTMAP_SECTOR_RESOLUTION texels per tile, one to twelve tiles a side
+std::vector< Containers::BoundedObject< int > > randomRoomMaps( std::mt19937& random, int count ) {
+	std::uniform_int_distribution< int > side( 1 * LIGHTMAP_SECTOR_RESOLUTION, 12 * LIGHTMAP_SECTOR_RESOLUTION );
+
+	std::vector< Containers::BoundedObject< int > > result;
+	for( int i = 0; i != count; i++ ) {
+		result.push_back( { side( random ), side( random ), i } );
+	}
+
+	return result;
+}
+
+bool packedCellsValid( const Containers::PackedCellMap< int >& map, const std::vector< Containers::BoundedObject< int > >& items ) {
+	if( map.cells.size() != items.size() ) {
+		return false;
+	}
+
+	for( size_t i = 0; i != map.cells.size(); i++ ) {
+		const auto& cell = map.cells[ i ];
+		const auto& item = items[ *cell.object ];
+		if( cell.width != item.width || cell.height != item.height || cell.x < 0 || cell.y < 0 ||
+			cell.x + cell.width > map.totalWidth || cell.y + cell.height > map.totalHeight ) {
+			return false;
+		}
+
+		for( size_t j = i + 1; j != map.cells.size(); j++ ) {
+			Containers::RectanglePacker::Rectangle lhs{ cell.x, cell.y, cell.width, cell.height };
+			Containers::RectanglePacker::Rectangle rhs{ map.cells[ j ].x, map.cells[ j ].y, map.cells[ j ].width, map.cells[ j ].height };
+			if( lhs.overlaps( rhs ) ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool maxRectsPacksWithoutOverlap() {
+	std::mt19937 random( 99 );
+
+	for( auto heuristic : { Containers::RectanglePacker::Heuristic::BEST_SHORT_SIDE_FIT, Containers::RectanglePacker::Heuristic::BEST_LONG_SIDE_FIT,
+		Containers::RectanglePacker::Heuristic::BEST_AREA_FIT, Containers::RectanglePacker::Heuristic::BOTTOM_LEFT } ) {
+		for( int count : { 1, 16, 100 } ) {
+			auto items = randomRoomMaps( random, count );
+			if( !packedCellsValid( Containers::packCells( items, 1000, 1000, heuristic ), items ) ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool maxRectsReusesRemovedSpace() {
+	Containers::RectanglePacker packer( 1000, 1000 );
+	std::vector< Containers::RectanglePacker::Rectangle > placed;
+	for( int i = 0; i != 4; i++ ) {
+		placed.emplace_back( *packer.insert( 500, 500 ) );
+	}
+
+	// Bin is full until one room goes away; its replacement must land in the same spot without moving the others
+	bool fullBefore = !packer.insert( 300, 300 );
+	bool removed = packer.remove( placed[ 2 ] );
+	auto replacement = packer.insert( 500, 400 );
+
+	packer.grow( 500, 500 );
+	auto afterGrowth = packer.insert( 1000, 1000 );
+
+	return fullBefore && removed && !packer.remove( placed[ 2 ] ) && replacement && replacement->x == placed[ 2 ].x && replacement->y == placed[ 2 ].y &&
+		afterGrowth && packer.getWidth() == 2000 && packer.getUsedRectangles().size() == 5;
+}
+
+bool maxRectsChurnStaysConsistent() {
+	std::mt19937 random( 7 );
+	std::uniform_int_distribution< int > sizes( 20, 200 );
+	Containers::RectanglePacker packer( 1000, 1000 );
+	std::vector< Containers::RectanglePacker::Rectangle > placed;
+
+	// Rooms come and go, as when a lot is edited; placed rectangles must never overlap
+	for( int step = 0; step != 2000; step++ ) {
+		if( !placed.empty() && random() % 3 == 0 ) {
+			size_t index = random() % placed.size();
+			if( !packer.remove( placed[ index ] ) ) {
+				return false;
+			}
+			placed.erase( placed.begin() + index );
+		} else if( auto rectangle = packer.insert( sizes( random ), sizes( random ) ) ) {
+			for( const auto& other : placed ) {
+				if( rectangle->overlaps( other ) ) {
+					return false;
+				}
+			}
+			if( rectangle->x < 0 || rectangle->y < 0 || rectangle->x + rectangle->width > 1000 || rectangle->y + rectangle->height > 1000 ) {
+				return false;
+			}
+			placed.emplace_back( *rectangle );
+		}
+	}
+
+	// With everything gone the whole bin is free again
+	std::shuffle( placed.begin(), placed.end(), random );
+	for( const auto& rectangle : placed ) {
+		packer.remove( rectangle );
+	}
+
+	return packer.getUsedRectangles().empty() && packer.insert( 1000, 1000 );
+}
+
+void benchmarkRoomPacking() {
+	for( int count : { 50, 200 } ) {
+		std::mt19937 random( count );
+		auto items = randomRoomMaps( random, count );
+
+		auto start = std::chrono::steady_clock::now();
+		auto guillotine = referenceGuillotinePack( items, 1000, 1000 );
+		double guillotineTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+		std::cout << "Room packing, " << count << " rooms: guillotine " << guillotineTime << " ms, " << guillotine.totalWidth << "x" << guillotine.totalHeight
+			<< ", " << guillotine.occupancy * 100.0 << "% filled" << std::endl;
+
+		for( const std::string& name : { "best_short_side_fit", "best_long_side_fit", "best_area_fit", "bottom_left" } ) {
+			start = std::chrono::steady_clock::now();
+			auto maxRects = Containers::packCells( items, 1000, 1000, Containers::RectanglePacker::getHeuristic( name ) );
+			double maxRectsTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+			std::cout << "Room packing, " << count << " rooms: maxrects " << name << " " << maxRectsTime << " ms, " << maxRects.totalWidth << "x" << maxRects.totalHeight
+				<< ", " << maxRects.occupancy * 100.0 << "% filled" << std::endl;
+		}
+	}
+}
+
+// The material lookup ResourceBank::getOrCreateMaterial used before hashing: a locked linear scan
+struct ReferenceMaterialBank {
+	tbb::concurrent_vector< std::shared_ptr< Graphics::SceneGraph::Material > > materials;
+	std::mutex materialsMutex;
+
+	std::shared_ptr< Graphics::SceneGraph::Material > getOrCreateMaterial( const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular, float shininess, float opacity ) {
+		for( auto it = materials.begin(); it != materials.end(); ++it ) {
+			std::shared_ptr< Graphics::SceneGraph::Material > sample;
+			{
+				std::lock_guard< std::mutex > lock( materialsMutex );
+				sample = *it;
+			}
+
+			if( sample->getShininess() == shininess && sample->getOpacity() == opacity && sample->getAmbientColor() == ambient && sample->getDiffuseColor() == diffuse && sample->getSpecularColor() == specular ) {
+				return sample;
+			}
+		}
+
+		auto result = std::make_shared< Graphics::SceneGraph::Material >( ambient, diffuse, specular, shininess, opacity );
+		{
+			std::lock_guard< std::mutex > lock( materialsMutex );
+			materials.push_back( result );
+		}
+		return result;
+	}
+};
+
+// Texture identities without a GL context; nothing is ever dereferenced or freed
+Graphics::SceneGraph::TextureList fakeTextures( std::initializer_list< uintptr_t > identities ) {
+	Graphics::SceneGraph::TextureList result;
+	for( uintptr_t identity : identities ) {
+		result.emplace_back( std::shared_ptr< Graphics::Texture >( reinterpret_cast< Graphics::Texture* >( identity * 16 ), []( Graphics::Texture* ) {} ) );
+	}
+
+	return result;
+}
+
+glm::vec3 materialColor( int index ) {
+	return { ( index % 8 ) / 8.0f, ( ( index / 8 ) % 8 ) / 8.0f, ( index / 64 ) / 8.0f };
+}
+
+bool materialIndexDeduplicates() {
+	Graphics::Utilities::ShaderManager shaderManager;
+	Graphics::SceneGraph::ResourceBank bank( shaderManager );
+
+	glm::vec3 ambient{ 0.1f, 0.2f, 0.3f };
+	auto plain = bank.getOrCreateMaterial( ambient, glm::vec3{ 1, 0, 0 }, glm::vec3{ 0, 1, 0 }, 8.0f, 1.0f );
+	bool colorsShared = plain == bank.getOrCreateMaterial( ambient, glm::vec3{ 1, 0, 0 }, glm::vec3{ 0, 1, 0 }, 8.0f, 1.0f ) &&
+		plain != bank.getOrCreateMaterial( ambient, glm::vec3{ 1, 0, 0 }, glm::vec3{ 0, 1, 0 }, 8.0f, 0.5f ) &&
+		plain != bank.getOrCreateMaterial( ambient, glm::vec3{ 1, 0, 0 }, glm::vec3{ 0, 1, 1 }, 8.0f, 1.0f );
+
+	// Texture lists compare by identity and order, and an empty list is not a colour
+	auto textured = bank.getOrCreateMaterial( ambient, fakeTextures( { 1, 2 } ), fakeTextures( { 3 } ), 8.0f, 1.0f );
+	bool texturesShared = textured == bank.getOrCreateMaterial( ambient, fakeTextures( { 1, 2 } ), fakeTextures( { 3 } ), 8.0f, 1.0f ) &&
+		textured != bank.getOrCreateMaterial( ambient, fakeTextures( { 2, 1 } ), fakeTextures( { 3 } ), 8.0f, 1.0f ) &&
+		textured != bank.getOrCreateMaterial( ambient, fakeTextures( { 1, 2 } ), glm::vec3{ 0, 0, 0 }, 8.0f, 1.0f ) &&
+		bank.getOrCreateMaterial( ambient, fakeTextures( {} ), fakeTextures( {} ), 8.0f, 1.0f ) != bank.getOrCreateMaterial( ambient, glm::vec3{ 0, 0, 0 }, glm::vec3{ 0, 0, 0 }, 8.0f, 1.0f );
+
+	// Threads racing to create the same materials all get one instance apiece
+	std::vector< std::vector< std::shared_ptr< Graphics::SceneGraph::Material > > > seen( 8 );
+	std::vector< std::thread > threads;
+	for( int t = 0; t != 8; t++ ) {
+		threads.emplace_back( [ &, t ]() {
+			for( int i = 0; i != 64; i++ ) {
+				seen[ t ].emplace_back( bank.getOrCreateMaterial( materialColor( i ), fakeTextures( { ( uintptr_t ) i + 100 } ), glm::vec3{ 0, 0, 0 }, 4.0f, 1.0f ) );
+			}
+		} );
+	}
+	for( auto& thread : threads ) {
+		thread.join();
+	}
+
+	bool racesShared = true;
+	for( int t = 1; t != 8; t++ ) {
+		racesShared = racesShared && seen[ t ] == seen[ 0 ];
+	}
+
+	return colorsShared && texturesShared && racesShared;
+}
+
+void benchmarkMaterialLookups() {
+	constexpr int MATERIALS = 512;
+	constexpr int LOOKUPS = 256000;
+
+	Graphics::Utilities::ShaderManager shaderManager;
+	Graphics::SceneGraph::ResourceBank bank( shaderManager );
+	ReferenceMaterialBank reference;
+	for( int i = 0; i != MATERIALS; i++ ) {
+		bank.getOrCreateMaterial( materialColor( i ), glm::vec3{ 1, 1, 1 }, glm::vec3{ 0, 0, 0 }, 8.0f, 1.0f );
+		reference.getOrCreateMaterial( materialColor( i ), glm::vec3{ 1, 1, 1 }, glm::vec3{ 0, 0, 0 }, 8.0f, 1.0f );
+	}
+
+	auto run = []( int threadCount, int lookups, auto lookup ) {
+		auto start = std::chrono::steady_clock::now();
+
+		std::vector< std::thread > threads;
+		for( int t = 0; t != threadCount; t++ ) {
+			threads.emplace_back( [ &, t ]() {
+				for( int i = t; i < lookups; i += threadCount ) {
+					lookup( ( i * 7919 ) % MATERIALS );
+				}
+			} );
+		}
+		for( auto& thread : threads ) {
+			thread.join();
+		}
+
+		return lookups / std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+	};
+
+	for( int threadCount : { 1, 4, 16 } ) {
+		double hashed = run( threadCount, LOOKUPS, [ & ]( int i ) {
+			bank.getOrCreateMaterial( materialColor( i ), glm::vec3{ 1, 1, 1 }, glm::vec3{ 0, 0, 0 }, 8.0f, 1.0f );
+		} );
+		double linear = run( threadCount, LOOKUPS / 64, [ & ]( int i ) {
+			reference.getOrCreateMaterial( materialColor( i ), glm::vec3{ 1, 1, 1 }, glm::vec3{ 0, 0, 0 }, 8.0f, 1.0f );
+		} );
+
+		std::cout << "Material lookups over " << MATERIALS << " materials, " << threadCount << " threads: " << hashed << " per ms hashed vs "
+			<< linear << " per ms linear scan" << std::endl;
+	}
+}
+
+template < typename VertexType >
+std::vector< unsigned char > vertexBytes( const std::vector< VertexType >& vertices ) {
+	const unsigned char* data = reinterpret_cast< const unsigned char* >( vertices.data() );
+	return std::vector< unsigned char >( data, data + ( vertices.size() * sizeof( VertexType ) ) );
+}
+
+// One of everything AssimpModelLoader can describe: all four vertex formats, both index modes, nested nodes and an animated skeleton
+Graphics::SceneGraph::ModelLoader::ModelDescription syntheticModelDescription() {
+	using Description = Graphics::SceneGraph::ModelLoader::ModelDescription;
+	std::mt19937 generator( 4321 );
+	std::uniform_real_distribution< float > real( -1.0f, 1.0f );
+	auto vec3 = [ & ]() { return glm::vec3{ real( generator ), real( generator ), real( generator ) }; };
+
+	Description description;
+
+	std::vector< Graphics::SceneGraph::Mesh::BasicVertex > basic( 24 );
+	std::vector< Graphics::SceneGraph::Mesh::TexturedVertex > textured( 36 );
+	std::vector< Graphics::SceneGraph::Mesh::RiggedVertex > rigged( 24 );
+	std::vector< Graphics::SceneGraph::Mesh::TexturedRiggedVertex > texturedRigged( 24 );
+	for( auto& vertex : basic ) { vertex.position = vec3(); vertex.normal = vec3(); }
+	for( auto& vertex : textured ) { vertex.position = vec3(); vertex.normal = vec3(); vertex.textureCoordinates = { real( generator ), real( generator ) }; }
+	for( size_t i = 0; i != rigged.size(); i++ ) {
+		rigged[ i ].position = vec3(); rigged[ i ].normal = vec3();
+		rigged[ i ].boneIDs = { 1 + ( i % 3 ), 0, 0, 0 };
+	}
+	for( size_t i = 0; i != texturedRigged.size(); i++ ) {
+		texturedRigged[ i ].position = vec3(); texturedRigged[ i ].normal = vec3(); texturedRigged[ i ].textureCoordinates = { real( generator ), real( generator ) };
+		texturedRigged[ i ].boneIDs = { 1, 2, 0, 0 };
+		texturedRigged[ i ].boneWeights = { 0.25f, 0.75f, 0.0f, 0.0f };
+	}
+
+	std::vector< uint32_t > indices( 36 );
+	for( size_t i = 0; i != indices.size(); i++ ) {
+		indices[ i ] = ( i * 7 ) % 24;
+	}
+
+	description.meshes = {
+		{ Description::VertexFormat::BASIC, true, vertexBytes( basic ), indices, {} },
+		{ Description::VertexFormat::TEXTURED, false, vertexBytes( textured ), {}, {} },
+		{ Description::VertexFormat::RIGGED, true, vertexBytes( rigged ), indices, { "Root", "Spine", "Head" } },
+		{ Description::VertexFormat::TEXTURED_RIGGED, true, vertexBytes( texturedRigged ), indices, { "Spine", "Head" } }
+	};
+
+	// Texture names are only resolved by the builder for drawables that use them; the last material is for the file format alone
+	description.materials = {
+		{ vec3(), vec3(), vec3(), {}, {}, 8.0f, 1.0f },
+		{ vec3(), vec3(), vec3(), {}, {}, 32.0f, 0.5f },
+		{ vec3(), vec3(), vec3(), { "a.png", "textures/b.png" }, { "c.png" }, 2.0f, 1.0f }
+	};
+
+	auto keyframes = [ & ]( int count ) {
+		std::vector< Description::Keyframe > result;
+		for( int i = 0; i != count; i++ ) {
+			result.emplace_back( Description::Keyframe{ i * 2.0, vec3(), glm::normalize( glm::quat( real( generator ), real( generator ), real( generator ), real( generator ) ) ), glm::vec3{ 1.0f } + ( vec3() * 0.1f ) } );
+		}
+		return result;
+	};
+
+	description.bones = {
+		{ "Root", glm::translate( glm::mat4( 1.0f ), vec3() ), { { "Walk", keyframes( 5 ) }, { "Wave", keyframes( 3 ) } }, { 1 } },
+		{ "Spine", glm::rotate( glm::mat4( 1.0f ), 0.5f, glm::vec3{ 0, 0, 1 } ), { { "Walk", keyframes( 4 ) } }, { 2 } },
+		{ "Head", glm::translate( glm::mat4( 1.0f ), vec3() ), {}, {} }
+	};
+
+	description.nodes = {
+		{ "Scene", { { 0, 0 }, { 1, 1 } }, { 1, 2 }, 0 },
+		{ "Body", { { 2, 0 } }, {}, -1 },
+		{ "Hat", { { 3, 1 } }, {}, -1 }
+	};
+
+	description.animations[ "Walk" ] = { "Walk", 24.0, 8.0 };
+	description.animations[ "Wave" ] = { "Wave", 30.0, 4.0 };
+
+	return description;
+}
+
+bool sameModel( const Graphics::SceneGraph::Model& lhs, const Graphics::SceneGraph::Model& rhs, const std::vector< std::string >& animations = { "Walk", "Wave" } ) {
+	if( lhs.getId() != rhs.getId() || lhs.getDrawableList().size() != rhs.getDrawableList().size() || lhs.getChildren().size() != rhs.getChildren().size() ) {
+		return false;
+	}
+
+	auto lhsAnimator = lhs.getAnimator();
+	auto rhsAnimator = rhs.getAnimator();
+	if( !lhsAnimator != !rhsAnimator ) {
+		return false;
+	}
+	if( lhsAnimator ) {
+		for( const std::string& animation : animations ) {
+			lhsAnimator->setCurrentAnimation( animation );
+			rhsAnimator->setCurrentAnimation( animation );
+			// Play each animation through to the end, comparing every pose
+			for( int frame = 0; frame != 16; frame++ ) {
+				lhsAnimator->update();
+				rhsAnimator->update();
+				if( lhsAnimator->getComputedMatrices() != rhsAnimator->getComputedMatrices() ) {
+					return false;
+				}
+			}
+		}
+	}
+
+	for( size_t i = 0; i != lhs.getDrawableList().size(); i++ ) {
+		const Graphics::SceneGraph::Drawable& left = lhs.getDrawableList()[ i ];
+		const Graphics::SceneGraph::Drawable& right = rhs.getDrawableList()[ i ];
+
+		bool sameTriangles = left.mesh->getTriangles() == right.mesh->getTriangles();
+
+		bool sameMaterial =
+			left.material->getAmbientColor() == right.material->getAmbientColor() &&
+			left.material->getDiffuseColor() == right.material->getDiffuseColor() &&
+			left.material->getSpecularColor() == right.material->getSpecularColor() &&
+			left.material->getShininess() == right.material->getShininess() &&
+			left.material->getOpacity() == right.material->getOpacity();
+
+		auto leftBones = left.mesh->meshUniforms.find( "bone" );
+		auto rightBones = right.mesh->meshUniforms.find( "bone" );
+		bool sameBones = ( leftBones == left.mesh->meshUniforms.end() ) == ( rightBones == right.mesh->meshUniforms.end() );
+		if( sameBones && leftBones != left.mesh->meshUniforms.end() && lhsAnimator ) {
+			auto* leftUniform = ( Graphics::SceneGraph::Mesh::BoneUniform* ) leftBones->second.get();
+			auto* rightUniform = ( Graphics::SceneGraph::Mesh::BoneUniform* ) rightBones->second.get();
+			leftUniform->configure( *lhsAnimator );
+			rightUniform->configure( *rhsAnimator );
+			sameBones = leftUniform->getBoneList() == rightUniform->getBoneList();
+		}
+
+		if( !sameTriangles || !sameMaterial || !sameBones || left.shader != right.shader ) {
+			return false;
+		}
+	}
+
+	for( auto lhsIt = lhs.getChildren().begin(), rhsIt = rhs.getChildren().begin(); lhsIt != lhs.getChildren().end(); ++lhsIt, ++rhsIt ) {
+		if( !sameModel( **lhsIt, **rhsIt, animations ) ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool modelCacheRoundTrips() {
+	using Graphics::SceneGraph::ModelLoader::ModelCache;
+
+	Graphics::SceneGraph::ModelLoader::ModelDescription imported = syntheticModelDescription();
+	constexpr uint64_t key = 0x0123456789abcdefULL;
+	const std::string path = ModelCache::getPath( "model_cache_test", key );
+
+	if( !ModelCache::store( path, key, imported ) ) {
+		return false;
+	}
+	std::optional< Graphics::SceneGraph::ModelLoader::ModelDescription > loaded = ModelCache::load( path, key );
+	bool staleKeyMisses = !ModelCache::load( path, key + 1 );
+	std::remove( path.c_str() );
+	std::remove( "model_cache_test" );
+
+	if( !loaded || !( *loaded == imported ) ) {
+		return false;
+	}
+
+	// Truncation anywhere, or a file from another format version, must miss rather than half-load
+	std::vector< unsigned char > bytes = ModelCache::serialize( imported, key );
+	bool truncatedMisses = true;
+	for( size_t size = 0; size < bytes.size(); size += 7 ) {
+		truncatedMisses = truncatedMisses && !ModelCache::deserialize( bytes.data(), size, key );
+	}
+	bytes[ 4 ]++;
+	bool versionMisses = !ModelCache::deserialize( bytes.data(), bytes.size(), key );
+
+	// Well-formed files whose contents the builder would trip over are rejected too
+	auto rejected = [ & ]( auto corrupt ) {
+		Graphics::SceneGraph::ModelLoader::ModelDescription description = imported;
+		corrupt( description );
+		std::vector< unsigned char > corruptBytes = ModelCache::serialize( description, key );
+		return !ModelCache::deserialize( corruptBytes.data(), corruptBytes.size(), key );
+	};
+	bool malformedMisses =
+		rejected( []( auto& description ) { description.nodes[ 0 ].skeleton = -2; } ) &&
+		rejected( []( auto& description ) { description.nodes[ 0 ].skeleton = description.bones.size(); } ) &&
+		rejected( []( auto& description ) { description.bones[ 1 ].channels[ "Walk" ].clear(); } ) &&
+		rejected( []( auto& description ) { description.meshes[ 0 ].indices.back() = 24; } );
+
+	// Models built from the mapped file and from the fresh description are indistinguishable
+	Graphics::Utilities::ShaderManager shaderManager;
+	Graphics::SceneGraph::ModelLoader::AssimpModelLoader loader( shaderManager );
+	loader.deferGLOperations = true;
+	bool sameModels = sameModel( *loader.build( imported, "assets" ), *loader.build( *loaded, "assets" ) );
+
+	return staleKeyMisses && truncatedMisses && versionMisses && malformedMisses && sameModels;
+}
+
+struct ExposedAssimpModelLoader : public Graphics::SceneGraph::ModelLoader::AssimpModelLoader {
+	using AssimpModelLoader::AssimpModelLoader;
+	using AssimpModelLoader::getBoneInfluences;
+	using AssimpModelLoader::getCacheKey;
+};
+
+bool modelCacheRoundTripsThroughLoader() {
+	using Graphics::SceneGraph::ModelLoader::ModelCache;
+	const std::string source = "../dev/box/armaturebox.fbx";
+
+	Graphics::Utilities::ShaderManager shaderManager;
+	ExposedAssimpModelLoader uncached( shaderManager );
+	uncached.deferGLOperations = true;
+	uncached.cacheDirectory = "";
+	ExposedAssimpModelLoader loader( shaderManager );
+	loader.deferGLOperations = true;
+	loader.cacheDirectory = "model_cache_loader_test";
+
+	std::optional< uint64_t > key = loader.getCacheKey( source );
+	if( !key ) {
+		return false;
+	}
+	const std::string path = ModelCache::getPath( loader.cacheDirectory, *key );
+	std::remove( path.c_str() );
+
+	std::shared_ptr< Graphics::SceneGraph::Model > imported = uncached.get( source );
+	std::shared_ptr< Graphics::SceneGraph::Model > cold = loader.get( source );
+	std::optional< Graphics::SceneGraph::ModelLoader::ModelDescription > stored = ModelCache::load( path, *key );
+	std::shared_ptr< Graphics::SceneGraph::Model > warm = loader.get( source );
+
+	bool result = imported && cold && warm && stored && !stored->bones.empty() && !stored->animations.empty();
+	if( result ) {
+		std::vector< std::string > animations;
+		for( const auto& pair : stored->animations ) {
+			animations.emplace_back( pair.first );
+		}
+
+		// sameModel plays the animators forward, so the warm model gets a fresh import of its own to compare against
+		result = sameModel( *imported, *cold, animations ) && sameModel( *uncached.get( source ), *warm, animations );
+
+		// Prove the warm load came from the cache file and not another import
+		stored->nodes[ 0 ].name = "Cached";
+		result = result && ModelCache::store( path, *key, *stored ) && loader.get( source )->getId() == "Cached";
+	}
+
+	std::remove( path.c_str() );
+	std::remove( loader.cacheDirectory.c_str() );
+
+	return result;
+}
+
+// Bones with externally owned weight lists, so the same data works against Assimp's own aiBone destructor
+struct SyntheticBones {
+	std::vector< std::vector< aiVertexWeight > > weights;
+	std::vector< std::unique_ptr< aiBone > > storage;
+	std::vector< aiBone* > bones;
+
+	SyntheticBones( unsigned int count ) : weights( count ) {}
+
+	~SyntheticBones() {
+		for( aiBone* bone : bones ) {
+			bone->mWeights = nullptr;
+		}
+	}
+
+	void finish() {
+		for( std::vector< aiVertexWeight >& list : weights ) {
+			storage.emplace_back( std::make_unique< aiBone >() );
+			storage.back()->mNumWeights = list.size();
+			storage.back()->mWeights = list.data();
+			bones.emplace_back( storage.back().get() );
+		}
+	}
+};
+
+// Every vertex gets up to maxInfluences distinct bones with normalised random weights, as an exporter limited to four would write them
+std::unique_ptr< SyntheticBones > syntheticBoneWeights( unsigned int vertices, unsigned int boneCount, unsigned int maxInfluences, unsigned int seed ) {
+	std::mt19937 generator( seed );
+	std::uniform_real_distribution< float > weight( 0.05f, 1.0f );
+	auto result = std::make_unique< SyntheticBones >( boneCount );
+
+	std::vector< unsigned int > boneOrder( boneCount );
+	std::iota( boneOrder.begin(), boneOrder.end(), 0 );
+	for( unsigned int vertex = 0; vertex != vertices; vertex++ ) {
+		unsigned int influences = generator() % ( maxInfluences + 1 );
+		std::shuffle( boneOrder.begin(), boneOrder.end(), generator );
+
+		std::vector< float > weights( influences );
+		float total = 0.0f;
+		for( float& value : weights ) {
+			value = weight( generator );
+			total += value;
+		}
+
+		for( unsigned int i = 0; i != influences; i++ ) {
+			result->weights[ boneOrder[ i ] ].emplace_back( aiVertexWeight{ vertex, weights[ i ] / total } );
+		}
+	}
+
+	result->finish();
+	return result;
+}
+
+// The bone assignment AssimpModelLoader used before: for each vertex, scan every weight of every bone
+bool referenceAssignBones( Graphics::SceneGraph::Mesh::RiggedVertex& vertex, unsigned int vertexIndex, aiBone** bones, unsigned int numBones ) {
+	unsigned int vertexBoneNumber = 0;
+
+	for( size_t boneIndex = 0; boneIndex < numBones; boneIndex++ ) {
+		aiBone* bone = bones[ boneIndex ];
+
+		for( size_t weightIndex = 0; weightIndex < bone->mNumWeights; weightIndex++ ) {
+			aiVertexWeight& vertexWeight = bone->mWeights[ weightIndex ];
+
+			if( vertexWeight.mVertexId == vertexIndex ) {
+				if( vertexBoneNumber >= 4 ) {
+					return false;
+				}
+
+				vertex.boneIDs[ vertexBoneNumber ] = boneIndex + 1;
+				vertex.boneWeights[ vertexBoneNumber ] = vertexWeight.mWeight;
+				vertexBoneNumber++;
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool boneInfluencesMatchReference() {
+	for( unsigned int seed : { 1u, 2u, 3u } ) {
+		auto bones = syntheticBoneWeights( 2000, 24, 4, seed );
+		// A bone naming the same vertex twice keeps its first weight
+		bones->weights[ 5 ].emplace_back( aiVertexWeight{ bones->weights[ 5 ].front().mVertexId, 0.5f } );
+		bones->bones[ 5 ]->mNumWeights = bones->weights[ 5 ].size();
+		bones->bones[ 5 ]->mWeights = bones->weights[ 5 ].data();
+
+		auto influences = ExposedAssimpModelLoader::getBoneInfluences( bones->bones.data(), bones->bones.size(), 2000 );
+		for( unsigned int i = 0; i != 2000; i++ ) {
+			Graphics::SceneGraph::Mesh::RiggedVertex reference;
+			if( !referenceAssignBones( reference, i, bones->bones.data(), bones->bones.size() ) ) {
+				return false;
+			}
+
+			if( influences[ i ].truncated || influences[ i ].boneIDs != reference.boneIDs || influences[ i ].boneWeights != reference.boneWeights ) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool boneInfluencesKeepStrongestFour() {
+	SyntheticBones bones( 6 );
+	const float weights[] = { 0.1f, 0.3f, 0.05f, 0.25f, 0.1f, 0.2f };
+	for( unsigned int bone = 0; bone != 6; bone++ ) {
+		bones.weights[ bone ].emplace_back( aiVertexWeight{ 0, weights[ bone ] } );
+	}
+	// Vertex 1 is full before bone 5 repeats it; the weak first weight is dropped, and so must the strong repeat be
+	for( unsigned int bone = 0; bone != 4; bone++ ) {
+		bones.weights[ bone ].emplace_back( aiVertexWeight{ 1, 0.25f } );
+	}
+	bones.weights[ 4 ].emplace_back( aiVertexWeight{ 1, 0.01f } );
+	bones.weights[ 4 ].emplace_back( aiVertexWeight{ 1, 0.9f } );
+	bones.finish();
+
+	auto influences = ExposedAssimpModelLoader::getBoneInfluences( bones.bones.data(), bones.bones.size(), 2 );
+	const auto& influence = influences[ 0 ];
+	const auto& full = influences[ 1 ];
+	bool repeatIgnored = full.boneIDs == glm::ivec4( 1, 2, 3, 4 ) && full.boneWeights == glm::vec4( 0.25f );
+
+	std::set< int > kept;
+	for( int slot = 0; slot != 4; slot++ ) {
+		kept.insert( influence.boneIDs[ slot ] );
+	}
+
+	// Bones 1 and 5 tie at 0.1 and the earlier one is kept; the weights renormalise from 0.85
+	float total = influence.boneWeights.x + influence.boneWeights.y + influence.boneWeights.z + influence.boneWeights.w;
+	bool normalised = std::abs( total - 1.0f ) < 0.0001f;
+	bool scaled = true;
+	for( int slot = 0; slot != 4; slot++ ) {
+		scaled = scaled && std::abs( influence.boneWeights[ slot ] - ( weights[ influence.boneIDs[ slot ] - 1 ] / 0.85f ) ) < 0.0001f;
+	}
+
+	return influence.truncated && kept == std::set< int >{ 1, 2, 4, 6 } && normalised && scaled && repeatIgnored;
+}
+
+void benchmarkBoneInfluences() {
+	constexpr unsigned int VERTICES = 50000;
+	constexpr unsigned int BONES = 80;
+	constexpr unsigned int REFERENCE_VERTICES = 1000;
+
+	auto bones = syntheticBoneWeights( VERTICES, BONES, 4, 5678 );
+
+	auto start = std::chrono::steady_clock::now();
+	auto influences = ExposedAssimpModelLoader::getBoneInfluences( bones->bones.data(), bones->bones.size(), VERTICES );
+	double scatterTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	// The per-vertex scan is timed on a slice and scaled up; the whole mesh takes minutes
+	start = std::chrono::steady_clock::now();
+	for( unsigned int i = 0; i != REFERENCE_VERTICES; i++ ) {
+		Graphics::SceneGraph::Mesh::RiggedVertex vertex;
+		referenceAssignBones( vertex, i, bones->bones.data(), bones->bones.size() );
+	}
+	double scanTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count() * ( VERTICES / REFERENCE_VERTICES );
+
+	std::cout << "Bone weights, " << VERTICES << " vertices and " << BONES << " bones: " << scatterTime << " ms single pass vs ~" << scanTime
+		<< " ms per-vertex scan (" << influences.size() << " vertices)" << std::endl;
+}
+
+// Stands in for AssimpModelLoader: every file takes a fixed time to "parse", files named missing* fail and thrown* throw
+struct FakeModelLoader : public Graphics::SceneGraph::ModelLoader::FileModelLoader {
+	std::map< std::string, int >& loads;
+	std::mutex& loadsMutex;
+	std::chrono::microseconds parseTime;
+
+	FakeModelLoader( std::map< std::string, int >& loads, std::mutex& loadsMutex, std::chrono::microseconds parseTime ) :
+		loads( loads ), loadsMutex( loadsMutex ), parseTime( parseTime ) {}
+
+	std::shared_ptr< Graphics::SceneGraph::Model > get( const std::string& filename ) override {
+		std::this_thread::sleep_for( parseTime );
+		{
+			std::lock_guard< std::mutex > lock( loadsMutex );
+			loads[ filename ]++;
+		}
+
+		if( filename.find( "missing" ) == 0 ) {
+			return nullptr;
+		}
+		if( filename.find( "thrown" ) == 0 ) {
+			// Not a std::exception, so only a catch-all sees it
+			throw 1;
+		}
+
+		return Graphics::SceneGraph::Model::create( filename, {} );
+	}
+};
+
+bool loadSchedulerStreamsAndDeduplicates() {
+	std::map< std::string, int > loads;
+	std::mutex loadsMutex;
+	Graphics::SceneGraph::ModelLoader::LoadScheduler scheduler( [ & ]() {
+		return std::make_unique< FakeModelLoader >( loads, loadsMutex, std::chrono::microseconds( 500 ) );
+	} );
+
+	// Two ids per file, plus two files that fail and one whose loader throws
+	for( int i = 0; i != 40; i++ ) {
+		scheduler.enqueue( "object" + std::to_string( i ), "file" + std::to_string( i / 2 ) );
+	}
+	scheduler.enqueue( "broken0", "missing0" );
+	scheduler.enqueue( "broken1", "missing1" );
+	scheduler.enqueue( "broken2", "thrown0" );
+	bool duplicateRejected = !scheduler.enqueue( "object7", "file3" );
+
+	// Out of turn, as when a lot places an object before its model has been uploaded
+	std::map< std::string, std::shared_ptr< Graphics::SceneGraph::Model > > originals;
+	originals[ "object39" ] = scheduler.finish( "object39" );
+	bool finishedOutOfTurn = originals[ "object39" ] && !scheduler.isPending( "object39" ) && !scheduler.finish( "broken0" ) && !scheduler.finish( "broken2" );
+
+	bool bounded = true;
+	for( int frame = 0; frame != 10000 && scheduler.getProgress().getFraction() < 1.0f; frame++ ) {
+		auto batch = scheduler.collect( 5 );
+		bounded = bounded && batch.size() <= 5;
+		for( auto& pair : batch ) {
+			originals[ pair.first ] = pair.second;
+		}
+		std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+	}
+
+	bool shared = originals.size() == 40;
+	for( int i = 0; i != 40 && shared; i += 2 ) {
+		shared = originals[ "object" + std::to_string( i ) ] && originals[ "object" + std::to_string( i ) ] == originals[ "object" + std::to_string( i + 1 ) ];
+	}
+
+	bool loadedOnce = loads.size() == 23 && std::all_of( loads.begin(), loads.end(), []( const auto& pair ) { return pair.second == 1; } );
+
+	auto progress = scheduler.getProgress();
+	bool counted = progress.requested == 43 && progress.parsed == 43 && progress.uploaded == 40 && progress.failed == 3;
+
+	return duplicateRejected && finishedOutOfTurn && bounded && shared && loadedOnce && counted;
+}
+
+void benchmarkLoadScheduler() {
+	constexpr int MODELS = 200;
+	constexpr unsigned int BUDGET = 8;
+	const std::chrono::microseconds parseTime( 2000 );
+
+	std::map< std::string, int > loads;
+	std::mutex loadsMutex;
+
+	// Serial: what ModelManager::load did through WorldRenderer::loadPaths, all in one frame
+	auto start = std::chrono::steady_clock::now();
+	{
+		FakeModelLoader loader( loads, loadsMutex, parseTime );
+		for( int i = 0; i != MODELS; i++ ) {
+			loader.get( "serial" + std::to_string( i ) );
+		}
+	}
+	double serialTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	double longestFrame = 0.0;
+	int frames = 0;
+	{
+		Graphics::SceneGraph::ModelLoader::LoadScheduler scheduler( [ & ]() {
+			return std::make_unique< FakeModelLoader >( loads, loadsMutex, parseTime );
+		} );
+		for( int i = 0; i != MODELS; i++ ) {
+			scheduler.enqueue( "model" + std::to_string( i ), "scheduled" + std::to_string( i ) );
+		}
+
+		while( scheduler.getProgress().getFraction() < 1.0f ) {
+			auto frameStart = std::chrono::steady_clock::now();
+			scheduler.collect( BUDGET );
+			longestFrame = std::max( longestFrame, std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - frameStart ).count() );
+			frames++;
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+	}
+	double scheduledTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Model loading, " << MODELS << " models at " << parseTime.count() / 1000.0 << " ms each: serial " << serialTime << " ms in one frame vs scheduled "
+		<< scheduledTime << " ms over " << frames << " frames, longest frame " << longestFrame << " ms (" << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+}
+
+// Records what a GL uploader would have done, into host memory
+struct StubTextureUploader : public Graphics::Utilities::TextureUploader {
+	struct Storage {
+		glm::uvec2 size;
+		std::vector< unsigned char > pixels;
+		bool finished = false;
+	};
+
+	std::map< GLuint, Storage > textures;
+	GLuint next = 1;
+	size_t bytes = 0;
+
+	GLuint create( const glm::uvec2& size ) override {
+		textures[ next ] = Storage{ size, std::vector< unsigned char >( size.x * size.y * 4 ) };
+		return next++;
+	}
+
+	void upload( GLuint id, unsigned int firstRow, const glm::uvec2& size, const unsigned char* pixels ) override {
+		Storage& storage = textures.at( id );
+		std::memcpy( storage.pixels.data() + firstRow * storage.size.x * 4, pixels, size.x * size.y * 4 );
+		bytes += size.x * size.y * 4;
+	}
+
+	void finish( GLuint id ) override {
+		textures.at( id ).finished = true;
+	}
+
+	void destroy( GLuint id ) override {
+		textures.erase( id );
+	}
+};
+
+// Stands in for PNG decode: a fixed amount of arithmetic per pixel. Paths are "width/height/seed"
+std::unique_ptr< sf::Image > decodeSyntheticImage( const std::string& path ) {
+	unsigned int width, height, seed;
+	std::sscanf( path.c_str(), "%u/%u/%u", &width, &height, &seed );
+
+	std::vector< unsigned char > pixels( width * height * 4 );
+	for( size_t i = 0; i != pixels.size(); i++ ) {
+		uint32_t value = seed * 2654435761u + i;
+		for( int round = 0; round != 8; round++ ) {
+			value ^= value << 13;
+			value ^= value >> 17;
+			value ^= value << 5;
+		}
+		pixels[ i ] = value;
+	}
+
+	std::unique_ptr< sf::Image > image = std::make_unique< sf::Image >();
+	image->create( width, height, pixels.data() );
+	return image;
+}
+
+std::string syntheticImagePath( unsigned int width, unsigned int height, unsigned int seed ) {
+	return std::to_string( width ) + "/" + std::to_string( height ) + "/" + std::to_string( seed );
+}
+
+bool textureStreamerStaysWithinBudget() {
+	constexpr size_t BUDGET = 64 * 1024;
+	auto stub = std::make_shared< StubTextureUploader >();
+	Graphics::Utilities::TextureStreamer streamer( stub, BUDGET, decodeSyntheticImage );
+	GLuint placeholder = streamer.getPlaceholder();
+
+	std::vector< std::string > paths;
+	std::vector< std::shared_ptr< Graphics::Texture > > textures;
+	for( unsigned int i = 0; i != 12; i++ ) {
+		paths.emplace_back( syntheticImagePath( 256, 64 + 16 * i, i ) );
+		textures.emplace_back( streamer.request( paths.back() ) );
+	}
+	bool placeholdersFirst = std::all_of( textures.begin(), textures.end(), [ & ]( const auto& texture ) { return texture->id == placeholder; } );
+
+	// Nobody wants this one any more; its storage should not outlive the streamer's next look at it
+	std::weak_ptr< Graphics::Texture > dropped = textures[ 3 ];
+	textures[ 3 ] = nullptr;
+
+	bool bounded = true;
+	for( int frame = 0; frame != 100000 && !streamer.isIdle(); frame++ ) {
+		size_t before = stub->bytes;
+		size_t sent = streamer.update();
+		bounded = bounded && sent <= BUDGET && sent == stub->bytes - before;
+		std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+	}
+
+	bool contents = true;
+	std::set< GLuint > ids;
+	for( unsigned int i = 0; i != textures.size(); i++ ) {
+		if( i == 3 ) {
+			continue;
+		}
+
+		auto it = stub->textures.find( textures[ i ]->id );
+		std::unique_ptr< sf::Image > expected = decodeSyntheticImage( paths[ i ] );
+		contents = contents && textures[ i ]->id != placeholder && it != stub->textures.end() && it->second.finished &&
+			std::equal( it->second.pixels.begin(), it->second.pixels.end(), expected->getPixelsPtr() );
+		ids.insert( textures[ i ]->id );
+	}
+
+	// The placeholder plus the eleven that were kept
+	bool noLeaks = dropped.expired() && ids.size() == 11 && stub->textures.size() == 12;
+
+	auto statistics = streamer.getStatistics();
+	bool counted = statistics.requested == 12 && statistics.decoded == 12 && statistics.failed == 0 && statistics.uploaded == 11;
+
+	// Finished textures give their storage back through the uploader, leaving only the placeholder
+	textures.clear();
+	bool released = stub->textures.size() == 1 && stub->textures.count( placeholder );
+
+	return placeholdersFirst && bounded && contents && noLeaks && counted && released;
+}
+
+void benchmarkTextureStreamer() {
+	constexpr unsigned int TEXTURES = 64;
+	constexpr unsigned int SIZE = 512;
+	constexpr size_t BUDGET = 4 * 1024 * 1024;
+	const size_t textureBytes = SIZE * SIZE * 4;
+
+	// Synchronous: what the Texture constructor does, decode and upload in the frame that asked
+	auto start = std::chrono::steady_clock::now();
+	{
+		StubTextureUploader uploader;
+		for( unsigned int i = 0; i != TEXTURES; i++ ) {
+			std::unique_ptr< sf::Image > image = decodeSyntheticImage( syntheticImagePath( SIZE, SIZE, i ) );
+			GLuint id = uploader.create( { SIZE, SIZE } );
+			uploader.upload( id, 0, { SIZE, SIZE }, image->getPixelsPtr() );
+			uploader.finish( id );
+		}
+	}
+	double synchronousTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	auto uploader = std::make_unique< StubTextureUploader >();
+	Graphics::Utilities::TextureStreamer streamer( std::move( uploader ), BUDGET, decodeSyntheticImage );
+
+	start = std::chrono::steady_clock::now();
+	std::vector< std::shared_ptr< Graphics::Texture > > textures;
+	for( unsigned int i = 0; i != TEXTURES; i++ ) {
+		textures.emplace_back( streamer.request( syntheticImagePath( SIZE, SIZE, i ) ) );
+	}
+	double requestTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	int frames = 0;
+	double longestFrame = 0.0;
+	size_t largestFrame = 0;
+	while( !streamer.isIdle() ) {
+		auto frameStart = std::chrono::steady_clock::now();
+		largestFrame = std::max( largestFrame, streamer.update() );
+		longestFrame = std::max( longestFrame, std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - frameStart ).count() );
+		frames++;
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+	double streamedTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	double megabytes = TEXTURES * textureBytes / ( 1024.0 * 1024.0 );
+	std::cout << "Texture streaming, " << TEXTURES << " " << SIZE << "x" << SIZE << " textures: synchronous " << synchronousTime << " ms in one frame ("
+		<< megabytes / ( synchronousTime / 1000.0 ) << " MB/s decoded) vs streamed " << streamedTime << " ms over " << frames << " frames ("
+		<< megabytes / ( streamedTime / 1000.0 ) << " MB/s), requests " << requestTime << " ms, longest frame " << longestFrame << " ms, largest frame "
+		<< largestFrame << " of " << BUDGET << " bytes budgeted" << std::endl;
+}
+
+bool timerWheelFiresOnTime() {
+	Containers::TimerWheel< int > wheel;
+	std::mt19937 generator( 21 );
+	std::vector< uint64_t > expected;
+	std::vector< uint64_t > fired;
+	std::vector< int > ids;
+
+	auto add = [ & ]( uint64_t now, uint64_t delay ) {
+		expected.push_back( now + 1 + delay );
+		fired.push_back( 0 );
+		ids.push_back( wheel.schedule( delay, expected.size() - 1 ) );
+	};
+
+	// Either side of every level boundary
+	for( uint64_t delay : { 0ull, 1ull, 254ull, 255ull, 256ull, 257ull, 65535ull, 65536ull, 65537ull, 16777215ull, 16777216ull, 16777217ull, 20000000ull } ) {
+		add( 0, delay );
+	}
+
+	std::uniform_int_distribution< uint64_t > delays( 0, 300000 );
+	for( int i = 0; i != 3000; i++ ) {
+		add( 0, delays( generator ) );
+	}
+
+	std::set< int > cancelled;
+	for( int i = 13; i < 3013; i += 5 ) {
+		wheel.cancel( ids[ i ] );
+		cancelled.insert( i );
+	}
+
+	// Two timers due on the same tick; whichever fires first cancels the other
+	add( 0, 500 );
+	add( 0, 500 );
+	int pairFirst = expected.size() - 2;
+
+	bool reentrant = true;
+	for( uint64_t tick = 1; tick <= 20000001; tick++ ) {
+		wheel.advance( [ & ]( int index ) {
+			fired[ index ] = tick;
+
+			if( index == pairFirst || index == pairFirst + 1 ) {
+				reentrant = reentrant && wheel.cancel( ids[ index == pairFirst ? pairFirst + 1 : pairFirst ] );
+			} else if( index % 7 == 0 && expected.size() < 4000 ) {
+				// Follow-ups scheduled from inside a callback count from the tick being fired
+				add( tick, index % 300 );
+			}
+		} );
+	}
+
+	bool onTime = true;
+	for( int i = 0; i != expected.size(); i++ ) {
+		if( cancelled.count( i ) ) {
+			onTime = onTime && fired[ i ] == 0;
+		} else if( i != pairFirst && i != pairFirst + 1 ) {
+			onTime = onTime && fired[ i ] == expected[ i ];
+		}
+	}
+
+	bool oneOfPair = ( fired[ pairFirst ] == 501 ) != ( fired[ pairFirst + 1 ] == 501 );
+	return onTime && reentrant && oneOfPair && wheel.size() == 0 && !wheel.cancel( ids[ 0 ] );
+}
+
+// CoreEngine::update before the timer wheel
+void referenceTimerTick( Containers::ReusableObjectVector< std::pair< int, std::function< void() > > >& queuedCallbacks ) {
+	std::vector< int > removalIndices;
+	int i = 0;
+
+	queuedCallbacks.each( [ & ]( std::optional< std::pair< int, std::function< void() > > >& optional ) {
+		if( optional ) {
+			std::pair< int, std::function< void() > >& callback = *optional;
+
+			if( callback.first == 0 ) {
+				callback.second();
+				removalIndices.push_back( i );
+			} else {
+				callback.first = std::max( 0, callback.first - 1 );
+			}
+		}
+
+		i++;
+	} );
+
+	for( int removal : removalIndices ) {
+		queuedCallbacks.remove( removal );
+	}
+}
+
+void benchmarkTimerWheel() {
+	// The vector's insert scans for a free slot, so filling it is quadratic; beyond this it only slows the suite down
+	constexpr int REFERENCE_PENDING = 10000;
+
+	for( int pending : { 10000, 100000 } ) {
+		std::mt19937 generator( 21 );
+		// Long enough that nothing fires while ticking, like idle think loops and listeners
+		std::uniform_int_distribution< int > delays( 10000, 100000 );
+		std::vector< int > intervals( pending );
+		std::generate( intervals.begin(), intervals.end(), [ & ]() { return delays( generator ); } );
+		int fired = 0;
+		constexpr int TICKS = 100;
+
+		std::stringstream vectorTimes;
+		if( pending <= REFERENCE_PENDING ) {
+			auto start = std::chrono::steady_clock::now();
+			Containers::ReusableObjectVector< std::pair< int, std::function< void() > > > vector;
+			for( int interval : intervals ) {
+				vector.insert( { interval, [ & ]() { fired++; } } );
+			}
+			double vectorSchedule = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+			start = std::chrono::steady_clock::now();
+			for( int tick = 0; tick != TICKS; tick++ ) {
+				referenceTimerTick( vector );
+			}
+			double vectorTick = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count() / TICKS;
+
+			vectorTimes << "schedule all " << vectorSchedule << " ms, idle tick " << vectorTick << " ms vector; ";
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		Containers::TimerWheel< std::function< void() > > wheel;
+		std::vector< int > ids;
+		for( int interval : intervals ) {
+			ids.push_back( wheel.schedule( interval, [ & ]() { fired++; } ) );
+		}
+		double wheelSchedule = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		start = std::chrono::steady_clock::now();
+		for( int tick = 0; tick != TICKS; tick++ ) {
+			wheel.advance( []( std::function< void() >& callback ) { callback(); } );
+		}
+		double wheelTick = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count() / TICKS;
+
+		start = std::chrono::steady_clock::now();
+		for( int id : ids ) {
+			wheel.cancel( id );
+		}
+		double wheelCancel = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		std::cout << "Timers, " << pending << " pending: " << vectorTimes.str() << "schedule all " << wheelSchedule << " ms, idle tick " << wheelTick
+			<< " ms, cancel all " << wheelCancel << " ms wheel (" << fired << " fired)" << std::endl;
+	}
+}
+
+// What lua_dump writes for the function on top of the stack, which is popped
+std::string dumpTopChunk( lua_State* L ) {
+	std::string bytes;
+	lua_dump( L, []( lua_State*, const void* data, size_t size, void* bytes ) {
+		static_cast< std::string* >( bytes )->append( static_cast< const char* >( data ), size );
+		return 0;
+	}, &bytes, 0 );
+	lua_pop( L, 1 );
+
+	return bytes;
+}
+
+// The scripts ModpackLoader runs at startup
+std::vector< std::string > modpackScripts() {
+	std::vector< std::string > scripts;
+	for( const char* directory : { "../modpacks/system/", "../modpacks/user/" } ) {
+		for( const std::string& modpack : Tools::Utility::getSubdirectoryList( directory ) ) {
+			scripts.emplace_back( std::string( directory ) + modpack + "/main.lua" );
+		}
+	}
+
+	return scripts;
+}
+
+bool chunkCacheMatchesSource() {
+	const std::string directory = "../cache/lua-test";
+	Scripting::LuaKit::ChunkCache cache( directory );
+	lua_State* L = luaL_newstate();
+	std::vector< std::string > scripts = modpackScripts();
+
+	bool identical = !scripts.empty();
+	for( const std::string& script : scripts ) {
+		std::remove( cache.getPath( script ).c_str() );
+
+		luaL_loadfile( L, script.c_str() );
+		std::string fromSource = dumpTopChunk( L );
+		cache.load( L, script );
+		std::string cold = dumpTopChunk( L );
+		cache.load( L, script );
+		std::string warm = dumpTopChunk( L );
+
+		identical = identical && cold == fromSource && warm == fromSource;
+	}
+	bool counted = cache.getMisses() == scripts.size() && cache.getHits() == scripts.size();
+
+	// An edited script is compiled again, and a damaged entry falls back to source
+	std::string scratch = directory + "/scratch.lua";
+	auto run = [ & ]() {
+		long long result = -1;
+		if( cache.load( L, scratch ) == LUA_OK && lua_pcall( L, 0, 1, 0 ) == LUA_OK ) {
+			result = lua_tointeger( L, -1 );
+		}
+		lua_pop( L, 1 );
+		return result;
+	};
+
+	std::ofstream( scratch, std::ios::trunc ) << "return 1";
+	bool first = run() == 1 && run() == 1;
+	std::ofstream( scratch, std::ios::trunc ) << "return 22";
+	bool edited = run() == 22;
+	std::ofstream( cache.getPath( scratch ), std::ios::trunc ) << "not bytecode";
+	bool damaged = run() == 22 && run() == 22;
+	bool scratchCounted = cache.getMisses() == scripts.size() + 3 && cache.getHits() == scripts.size() + 2;
+
+	// A BOM and a #! line are skipped exactly as luaL_loadfile skips them, line numbers included
+	std::remove( cache.getPath( scratch ).c_str() );
+	std::ofstream( scratch, std::ios::trunc ) << "\xEF\xBB\xBF#!/usr/bin/env lua\nlocal x = 333\nreturn x";
+	luaL_loadfile( L, scratch.c_str() );
+	std::string preambleSource = dumpTopChunk( L );
+	cache.load( L, scratch );
+	bool preamble = dumpTopChunk( L ) == preambleSource && run() == 333;
+
+	std::remove( cache.getPath( scratch ).c_str() );
+	std::remove( scratch.c_str() );
+	lua_close( L );
+	return identical && counted && first && edited && damaged && scratchCounted && preamble;
+}
+
+void benchmarkChunkCache() {
+	constexpr int LAUNCHES = 200;
+	Scripting::LuaKit::ChunkCache cache( "../cache/lua-test" );
+	std::vector< std::string > scripts = modpackScripts();
+	lua_State* L = luaL_newstate();
+
+	for( const std::string& script : scripts ) {
+		cache.load( L, script );
+		lua_pop( L, 1 );
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for( int launch = 0; launch != LAUNCHES; launch++ ) {
+		for( const std::string& script : scripts ) {
+			luaL_loadfile( L, script.c_str() );
+			lua_pop( L, 1 );
+		}
+	}
+	double sourceTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count() / LAUNCHES;
+
+	start = std::chrono::steady_clock::now();
+	for( int launch = 0; launch != LAUNCHES; launch++ ) {
+		for( const std::string& script : scripts ) {
+			cache.load( L, script );
+			lua_pop( L, 1 );
+		}
+	}
+	double cachedTime = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count() / LAUNCHES;
+
+	lua_close( L );
+	std::cout << "Modpack scripts, " << scripts.size() << " main.lua files: " << sourceTime << " ms compiled from source vs " << cachedTime
+		<< " ms from the chunk cache per startup" << std::endl;
+}
+
+// One component's saved state in a generated lot
+Json::Value syntheticComponentData( int index ) {
+	Json::Value data;
+	data[ "level" ] = 100 - index % 100;
+	data[ "decay_rate" ] = 10.5;
+	data[ "name" ] = "entity \"" + std::to_string( index ) + "\"";
+	data[ "enabled" ] = index % 2 == 0;
+
+	Json::Value position( Json::arrayValue );
+	position.append( index * 0.5 );
+	position.append( index % 40 );
+	position.append( 0 );
+	data[ "position" ] = position;
+
+	Json::Value inventory( Json::arrayValue );
+	for( int i = 0; i != 4; i++ ) {
+		Json::Value item;
+		item[ "id" ] = "item." + std::to_string( i );
+		item[ "count" ] = ( i * index ) % 7;
+		item[ "tags" ].append( "food" );
+		item[ "tags" ].append( "tier" + std::to_string( i ) );
+		inventory.append( item );
+	}
+	data[ "inventory" ] = inventory;
+
+	data[ "memory" ][ "last_meal" ] = index * 3;
+	data[ "memory" ][ "friends" ] = Json::Value( Json::arrayValue );
+	for( int i = 0; i != index % 5; i++ ) {
+		data[ "memory" ][ "friends" ].append( ( index + i ) % 2000 );
+	}
+
+	return data;
+}
+
+Json::Value syntheticLot( int entities ) {
+	Json::Value lot;
+	for( int i = 0; i != entities; i++ ) {
+		Json::Value entity;
+		entity[ "id" ] = "game.entity.plant";
+		for( int component = 0; component != 2; component++ ) {
+			Json::Value componentObject;
+			componentObject[ "id" ] = "game.component." + std::to_string( component );
+			componentObject[ "data" ] = syntheticComponentData( i * 2 + component );
+			entity[ "components" ].append( componentObject );
+		}
+		lot[ "entities" ].append( entity );
+	}
+
+	return lot;
+}
+
+bool jsonBridgeMatchesJsonLua() {
+	using Bridge = Scripting::LuaKit::Utility;
+
+	sol::state lua;
+	lua.open_libraries( sol::lib::base, sol::lib::string, sol::lib::table, sol::lib::math );
+	sol::table json = lua.script( Scripting::LuaKit::Library::JSON );
+	sol::function decode = json[ "decode" ];
+	lua_State* L = lua.lua_state();
+
+	// Nesting, both number kinds, an integer past double precision, escapes, and nulls that should vanish
+	Json::Value value = Tools::Utility::stringToJson( R"({
+		"int": 5, "negative": -3, "real": 2.5, "big": 9007199254740993, "text": "quote \" and é", "flag": false,
+		"nested": { "list": [ 1, [ 2, 3 ], { "deep": true } ], "empty_list": [] }, "gone": null
+	})" );
+	Json::Value expected = value;
+	expected.removeMember( "gone" );
+	bool roundTrips = Bridge::luaToJson( Bridge::jsonToLua( L, value ) ) == expected;
+
+	// Same tables as decoding the JSON text in Lua
+	bool matchesDecode = true;
+	for( int i = 0; i != 50; i++ ) {
+		Json::Value data = syntheticComponentData( i );
+		sol::object decoded = decode( Tools::Utility::jsonToString( data ) );
+		matchesDecode = matchesDecode && Bridge::luaToJson( Bridge::jsonToLua( L, data ) ) == data && Bridge::luaToJson( decoded ) == data;
+	}
+
+	// Null array elements leave a hole rather than shifting the rest down
+	sol::table holes = Bridge::jsonToLua( L, Tools::Utility::stringToJson( "[ 1, null, 3 ]" ) );
+	bool holed = holes.get< int >( 1 ) == 1 && !holes[ 2 ].valid() && holes.get< int >( 3 ) == 3;
+
+	// What json.lua refuses to encode is refused here too, without leaving anything on the stack
+	int top = lua_gettop( L );
+	int refused = 0;
+	for( const char* script : {
+		"return { 1, 2, name = 'mixed' }",
+		"return { [ 1 ] = 1, [ 3 ] = 3 }",
+		"local t = {} t.self = t return t",
+		"return { f = print }",
+		"return { nan = 0/0 }"
+	} ) {
+		try {
+			Bridge::luaToJson( lua.script( script ) );
+		} catch( Bridge::UnserializableValueException& e ) {
+			refused++;
+		}
+	}
+	bool stackClean = lua_gettop( L ) == top;
+
+	// Scripts written against json.lua still return encoded strings from save()
+	bool legacy = Bridge::savedToJson( sol::make_object( lua, std::string( "{ \"level\": 3 }" ) ) ) == Tools::Utility::stringToJson( "{ \"level\": 3 }" );
+
+	return roundTrips && matchesDecode && holed && refused == 5 && stackClean && legacy;
+}
+
+void benchmarkJsonBridge() {
+	using Bridge = Scripting::LuaKit::Utility;
+	constexpr int ENTITIES = 2000;
+
+	sol::state lua;
+	lua.open_libraries( sol::lib::base, sol::lib::string, sol::lib::table, sol::lib::math );
+	sol::table json = lua.script( Scripting::LuaKit::Library::JSON );
+	sol::function decode = json[ "decode" ];
+	sol::function encode = json[ "encode" ];
+	lua_State* L = lua.lua_state();
+
+	Json::Value lot = syntheticLot( ENTITIES );
+	std::vector< sol::object > loaded;
+
+	// Before: LuaComponent::load wrote each component's data out as text, and the script decoded it with json.lua
+	auto start = std::chrono::steady_clock::now();
+	for( const Json::Value& entity : lot[ "entities" ] ) {
+		for( const Json::Value& component : entity[ "components" ] ) {
+			loaded.emplace_back( decode( Tools::Utility::jsonToString( component[ "data" ] ) ) );
+		}
+	}
+	double stringLoad = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	for( const sol::object& table : loaded ) {
+		std::string encoded = encode( table );
+		Tools::Utility::stringToJson( encoded );
+	}
+	double stringSave = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+	loaded.clear();
+
+	start = std::chrono::steady_clock::now();
+	for( const Json::Value& entity : lot[ "entities" ] ) {
+		for( const Json::Value& component : entity[ "components" ] ) {
+			loaded.emplace_back( Bridge::jsonToLua( L, component[ "data" ] ) );
+		}
+	}
+	double nativeLoad = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	for( const sol::object& table : loaded ) {
+		Bridge::luaToJson( table );
+	}
+	double nativeSave = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Lot component data, " << ENTITIES << " entities: load " << stringLoad << " ms through json.lua vs " << nativeLoad << " ms native; save "
+		<< stringSave << " ms through json.lua vs " << nativeSave << " ms native" << std::endl;
+}
+
+const char* CROWD_COMPONENTS = R"(
+	local Walker = {
+		mood = 'idle', speed = 1.5, steps = 0, awake = true,
+		goals = { 'eat', 'sleep', { weight = 3, tags = { 'social' } } },
+		memory = { seen = {}, last = { x = 0, y = 0 } }
+	}
+	function Walker:init() self.steps = 1 end
+	function Walker:walk() self.steps = self.steps + 1 return self.speed end
+	function Walker:load( saved ) self.steps = saved.steps end
+	function Walker:save() return { steps = self.steps } end
+	function Walker:close() end
+	function Walker:remember( name ) table.insert( self.memory.seen, name ) end
+
+	local Hunger = { level = 100, rate = 0.25, foods = { 'bread', 'soup' } }
+	function Hunger:init() end
+	function Hunger:tick() self.level = self.level - self.rate end
+	function Hunger:close() end
+
+	bluebear.entity.register_component( 'test.component.walker', Walker )
+	bluebear.entity.register_component( 'test.component.hunger', Hunger )
+	bluebear.entity.register_entity( 'test.entity.crowd', { 'test.component.walker', 'test.component.hunger' } )
+	return Walker
+)";
+
+bool componentTemplateMatchesCopy() {
+	using namespace Scripting::EntityKit;
+
+	sol::state lua;
+	lua.open_libraries( sol::lib::base, sol::lib::string, sol::lib::table, sol::lib::math );
+	lua[ "bluebear" ] = lua.create_table();
+	Registry registry;
+	eventManager.LUA_STATE_READY.trigger( lua );
+	sol::table walker = lua.script( CROWD_COMPONENTS );
+
+	// Every field the old deep copy had reads the same through an instance, functions included
+	sol::function same = lua.script( R"(
+		local function same( a, b )
+			if type( a ) ~= 'table' or type( b ) ~= 'table' then return a == b end
+			for k, v in pairs( b ) do if not same( a[ k ], v ) then return false end end
+			for k, v in pairs( a ) do if b[ k ] == nil then return false end end
+			return true
+		end
+		return same
+	)" );
+	ComponentTemplate componentTemplate( walker );
+	sol::table first = componentTemplate.instantiate();
+	sol::table second = componentTemplate.instantiate();
+	bool matches = same( first, Scripting::LuaKit::Utility::copyTable( lua, walker, true ) );
+
+	// Instances own their nested tables, exactly as copies did
+	sol::function independent = lua.script( R"(
+		return function( first, second, definition )
+			first:remember( 'bob' )
+			first.goals[ 3 ].weight = 10
+			return first:walk() == 1.5 and first.steps == 1 and #second.memory.seen == 0 and #definition.memory.seen == 0
+				and second.goals[ 3 ].weight == 3 and definition.goals[ 3 ].tags ~= first.goals[ 3 ].tags
+		end
+	)" );
+	bool separate = independent( first, second, walker );
+
+	bool refused = false;
+	try {
+		ComponentTemplate cyclic( lua.script( "local t = { name = 'loop' } t.child = { parent = t } return t" ) );
+	} catch( ComponentTemplate::CyclicDefinitionException& e ) {
+		refused = true;
+	}
+
+	std::shared_ptr< Entity > entity = registry.createEntity( "test.entity.crowd" );
+	bool spawned = entity && entity->findComponents( "test.component.walker" ).size() == 1 && entity->findComponents( "test.component.hunger" ).size() == 1;
+
+	return matches && separate && refused && spawned;
+}
+
+// Registry::createEntity before component templates: a hash switch and a recursive copyTable per component
+std::shared_ptr< Scripting::EntityKit::Entity > referenceCreateEntity( sol::state& lua, const std::string& id, const std::map< std::string, sol::table >& definitions, const std::vector< std::string >& list ) {
+	using namespace Scripting::EntityKit;
+
+	std::shared_ptr< Entity > entity = std::make_shared< Entity >( id, std::vector< std::shared_ptr< Component > >{} );
+	for( const std::string& componentId : list ) {
+		switch( Tools::Utility::hash( componentId.c_str() ) ) {
+			case Tools::Utility::hash( "system.component.model_manager" ):
+			case Tools::Utility::hash( "system.component.interaction_set" ):
+				break;
+			default: {
+				std::shared_ptr< LuaComponent > component = std::make_shared< LuaComponent >( componentId, Scripting::LuaKit::Utility::copyTable( lua, definitions.find( componentId )->second, true ) );
+				component->init( sol::nil );
+				entity->attachComponent( component );
+			}
+		}
+	}
+
+	return entity;
+}
+
+void benchmarkComponentSpawn() {
+	using namespace Scripting::EntityKit;
+	constexpr int ENTITIES = 20000;
+
+	// Headless: a bare state with only what component scripts use, no window or GL
+	sol::state lua;
+	lua.open_libraries( sol::lib::base, sol::lib::string, sol::lib::table, sol::lib::math );
+	lua[ "bluebear" ] = lua.create_table();
+	Registry registry;
+	eventManager.LUA_STATE_READY.trigger( lua );
+
+	// Keep the registered definitions for the copyTable path
+	lua.script( R"(
+		captured = {}
+		local register = bluebear.entity.register_component
+		bluebear.entity.register_component = function( id, definition ) captured[ id ] = definition return register( id, definition ) end
+	)" );
+	lua.script( CROWD_COMPONENTS );
+	std::map< std::string, sol::table > definitions;
+	for( const std::string& id : { "test.component.walker", "test.component.hunger" } ) {
+		sol::table definition = lua[ "captured" ][ id ];
+		definitions.emplace( id, definition );
+	}
+	std::vector< std::string > list = { "test.component.walker", "test.component.hunger" };
+
+	std::vector< std::shared_ptr< Entity > > crowd;
+	crowd.reserve( ENTITIES );
+
+	auto start = std::chrono::steady_clock::now();
+	for( int i = 0; i != ENTITIES; i++ ) {
+		crowd.emplace_back( referenceCreateEntity( lua, "test.entity.crowd", definitions, list ) );
+	}
+	double copied = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+	crowd.clear();
+	lua.collect_garbage();
+
+	start = std::chrono::steady_clock::now();
+	for( int i = 0; i != ENTITIES; i++ ) {
+		crowd.emplace_back( registry.createEntity( "test.entity.crowd" ) );
+	}
+	double templated = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+	std::cout << "Spawning " << ENTITIES << " two-component entities: " << ( int ) ( ENTITIES / copied ) << " entities/s with copyTable vs "
+		<< ( int ) ( ENTITIES / templated ) << " entities/s with component templates" << std::endl;
+}
+
+// Entity::findComponents before type ids: a string compare against every component, and a cast per match
+std::vector< Scripting::EntityKit::Components::ComponentReturn > referenceFindComponents( const std::vector< std::shared_ptr< Scripting::EntityKit::Component > >& components, const std::string& componentId ) {
+	std::vector< Scripting::EntityKit::Components::ComponentReturn > result;
+
+	for( auto& component : components ) {
+		if( component->getId() == componentId ) {
+			result.push_back( Scripting::EntityKit::Components::cast( component ) );
+		}
+	}
+
+	return result;
+}
+
+bool entityIndexMatchesScan() {
+	using namespace Scripting::EntityKit;
+
+	std::vector< std::shared_ptr< Component > > attached;
+	for( const char* id : { "test.index.a", "test.index.b", "test.index.a", "test.index.c", "test.index.b", "test.index.a" } ) {
+		attached.emplace_back( std::make_shared< Component >( id ) );
+	}
+
+	// Half through the constructor, half attached afterwards
+	std::shared_ptr< Entity > entity = std::make_shared< Entity >( "test.entity.index", std::vector< std::shared_ptr< Component > >( attached.begin(), attached.begin() + 3 ) );
+	for( auto it = attached.begin() + 3; it != attached.end(); ++it ) {
+		entity->attachComponent( *it );
+	}
+
+	bool matches = true;
+	for( const char* id : { "test.index.a", "test.index.b", "test.index.c" } ) {
+		std::vector< Components::ComponentReturn > expected = referenceFindComponents( attached, id );
+		unsigned int type = Component::intern( id );
+		matches = matches && entity->findComponents( id ) == expected && entity->findComponents( type ) == expected && entity->findComponent( type ) == expected.front();
+	}
+
+	// Asking for a name nobody registered finds nothing, and doesn't intern it
+	bool unknown = entity->findComponents( "test.index.missing" ).empty() && !Component::findType( "test.index.missing" );
+
+	Entity copy( *entity );
+	bool copied = copy.findComponents( "test.index.a" ) == referenceFindComponents( attached, "test.index.a" );
+
+	return matches && unknown && copied;
+}
+
+void benchmarkEntityLookup() {
+	using namespace Scripting::EntityKit;
+	constexpr int LOOKUPS = 1000000;
+
+	for( int count : { 2, 8, 32 } ) {
+		std::vector< std::shared_ptr< Component > > attached;
+		std::shared_ptr< Entity > entity = std::make_shared< Entity >( "test.entity.lookup", std::vector< std::shared_ptr< Component > >{} );
+		for( int i = 0; i != count; i++ ) {
+			attached.emplace_back( std::make_shared< Component >( "test.component.lookup." + std::to_string( i ) ) );
+			entity->attachComponent( attached.back() );
+		}
+
+		// The last attached is the old scan's worst case
+		std::string target = "test.component.lookup." + std::to_string( count - 1 );
+		unsigned int type = Component::intern( target );
+		size_t found = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		for( int i = 0; i != LOOKUPS; i++ ) {
+			found += referenceFindComponents( attached, target ).size();
+		}
+		double scanned = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		start = std::chrono::steady_clock::now();
+		for( int i = 0; i != LOOKUPS; i++ ) {
+			found += entity->findComponents( target ).size();
+		}
+		double byName = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		start = std::chrono::steady_clock::now();
+		for( int i = 0; i != LOOKUPS; i++ ) {
+			found += entity->findComponents( type ).size();
+		}
+		double byType = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		start = std::chrono::steady_clock::now();
+		for( int i = 0; i != LOOKUPS; i++ ) {
+			found += entity->findComponent( type ).has_value();
+		}
+		double single = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count();
+
+		std::cout << LOOKUPS << " component lookups on an entity with " << count << " components: " << scanned << " ms string scan, "
+			<< byName << " ms by name, " << byType << " ms by type id, " << single << " ms for the first by type id (" << found << " found)" << std::endl;
+	}
+}
+
+int main() {
+	std::cout << "Concordia TestSuite v0.0.1" << std::endl;
+
+	// Line segment code as used in fragment.glsl for infrastructure
+	std::cout << "Expect line 0,0-0,3 and 1,0-1,3 not to intersect: " << ( lineIntersect1() == NO ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect line 1,1-1,3 and 0,2-3,2 to intersect: " << 	( lineIntersect2() == YES ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect line 0,0-3,3 and 0,3-3,0 to intersect: " << 	( lineIntersect3() == YES ? "pass" : "fail" ) << std::endl;
+
+	std::cout << "Expect BVH picking to match brute-force picking on the profiler grid: " << ( pickingMatchesBruteForce() ? "pass" : "fail" ) << std::endl;
+	benchmarkPicking();
+	std::cout << "Expect render queue to cull offscreen models and group draws by shader and material: " << ( renderQueueCullsAndSorts() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect mesh bounds to follow a changed generic transform method: " << ( meshBoundsFollowTransformMethod() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect render queue to draw translucent models last, in submission order: " << ( renderQueueKeepsTranslucentOrder() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect flat animator pose to match the bone tree path: " << ( animatorMatchesBoneTree() ? "pass" : "fail" ) << std::endl;
+	benchmarkAnimator();
+	std::cout << "Expect TRS channel sampling to match decomposed matrix keyframes: " << ( channelMatchesMatrixKeyframes() ? "pass" : "fail" ) << std::endl;
+	benchmarkChannelSampling();
+	std::cout << "Expect render queue to pack one bone palette entry per animated instance: " << ( renderQueuePacksBonePalette() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect hashed mesh generator to weld and shade identically to linear search: " << ( meshGeneratorMatchesReference() ? "pass" : "fail" ) << std::endl;
+	benchmarkMeshGenerator();
+	std::cout << "Expect incremental wall restaging to match a full rebuild over random edits: " << ( incrementalWallsMatchFullRebuild() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect a wall rig patched by update() to match a freshly built one: " << ( wallRigUpdatesMatchFreshRig() ? "pass" : "fail" ) << std::endl;
+	benchmarkWallRestaging();
+	std::cout << "Expect merged wall chunks to keep an exact range per wall piece: " << ( mergedWallChunksKeepPieceRanges() ? "pass" : "fail" ) << std::endl;
+	benchmarkWallMerging();
+	std::cout << "Expect the wall panel grid to select the same cutaways as a linear scan: " << ( wallPanelIndexMatchesLinearScan() ? "pass" : "fail" ) << std::endl;
+	benchmarkWallCutaways();
+	std::cout << "Expect planar face walk rooms to tile the plan and match enumerated cycles: " << ( faceWalkMatchesCycleEnumeration() ? "pass" : "fail" ) << std::endl;
+	benchmarkSectorIdentification();
+	std::cout << "Expect grid-bucketed intersections to split walls like the cell walk: " << ( gridIntersectionsMatchCellWalk() ? "pass" : "fail" ) << std::endl;
+	benchmarkIntersections();
+	std::cout << "Expect scanline room masks to match the per-texel ray cast bit for bit: " << ( lightmapScanlineMatchesRayCast() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect lightmap updates to rasterize and place only changed rooms: " << ( lightmapRegionsUpdateOnlyChangedRooms() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect room and light buffers to follow std140 layout: " << ( lightBuffersUseStd140Layout() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect the tile room index to find the same rooms as a scan over every room: " << ( roomTileIndexMatchesLinearScan() ? "pass" : "fail" ) << std::endl;
+	benchmarkLightmaps();
+	std::cout << "Expect MaxRects room packing to place every room without overlap: " << ( maxRectsPacksWithoutOverlap() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect removed rooms to free their space for the next insert: " << ( maxRectsReusesRemovedSpace() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect rooms inserted and removed at random to stay disjoint and free the whole bin: " << ( maxRectsChurnStaysConsistent() ? "pass" : "fail" ) << std::endl;
+	benchmarkRoomPacking();
+	std::cout << "Expect hashed materials to be shared only between identical parameters: " << ( materialIndexDeduplicates() ? "pass" : "fail" ) << std::endl;
+	benchmarkMaterialLookups();
+	std::cout << "Expect models loaded from the binary model cache to match freshly imported ones: " << ( modelCacheRoundTrips() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect single-pass bone weights to match the per-vertex scan: " << ( boneInfluencesMatchReference() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect AssimpModelLoader to build the same rigged model with a cold and a warm model cache: " << ( modelCacheRoundTripsThroughLoader() ? "pass" : "fail" ) << std::endl;
+	std::cout << "Expect vertices with more than four bones to keep the strongest four, renormalised: " << ( boneInfluencesKeepStrongestFour() ? "pass" : "fail" ) << std::endl;
+	benchmarkBoneInfluences();
+	std::cout << "Expect the load scheduler to share files between ids and upload in bounded batches: " << ( loadSchedulerStreamsAndDeduplicates() ? "pass" : "fail" ) << std::endl;
+	benchmarkLoadScheduler();
+	std::cout << "Expect streamed textures to upload within the byte budget and replace their placeholder: " << ( textureStreamerStaysWithinBudget() ? "pass" : "fail" ) << std::endl;
+	benchmarkTextureStreamer();
+	std::cout << "Expect timer wheel callbacks to fire on their tick across every level, cancelled ones never: " << ( timerWheelFiresOnTime() ? "pass" : "fail" ) << std::endl;
+	benchmarkTimerWheel();
+	std::cout << "Expect cached Lua chunks to match source, and edited or damaged entries to fall back to it: " << ( chunkCacheMatchesSource() ? "pass" : "fail" ) << std::endl;
+	benchmarkChunkCache();
+	std::cout << "Expect the native JSON bridge to build the same tables as json.lua and refuse what it refuses: " << ( jsonBridgeMatchesJsonLua() ? "pass" : "fail" ) << std::endl;
+	benchmarkJsonBridge();
+	std::cout << "Expect component template instances to read like deep copies and own their nested tables: " << ( componentTemplateMatchesCopy() ? "pass" : "fail" ) << std::endl;
+	benchmarkComponentSpawn();
+	std::cout << "Expect indexed component lookup to return what the string scan did, in the same order: " << ( entityIndexMatchesScan() ? "pass" : "fail" ) << std::endl;
+	benchmarkEntityLookup();
 
 
 	return 0;